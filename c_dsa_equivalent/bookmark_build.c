@@ -0,0 +1,750 @@
+/**
+ * Bookmark Parallel Index Build in C
+ * Rebuilds every index of a BookmarkStore from its record table using
+ * all cores
+ * 
+ * bookmark_store_end_bulk builds the trie and heap on one thread. After
+ * a large load, bookmark_build_indexes rebuilds the URL index, title
+ * trie and heap instead, spreading each phase over a work-stealing pool:
+ * 
+ *   URL index  - slots are split into P ranges by home slot (the top hash
+ *                bits). Threads count and scatter ids by range, then
+ *                each range is filled by one thread with plain linear
+ *                probing. A probe that runs off the end of its range is
+ *                set aside and placed afterwards, so no slot is written
+ *                by two threads.
+ *   Title trie - keys are partitioned by their first two (folded) bytes.
+ *                Each partition is sorted and inserted into a private
+ *                trie in the worker's own node arena, with no locking.
+ *                The worker arenas are then adopted into the store's
+ *                trie arena (slabs move, slots do not), each subtree's
+ *                handles are rebased in parallel, and the subtrees are
+ *                stitched under the root: one node per first byte
+ *                branching on the second byte, or the subtree itself
+ *                when a first byte has only one partition. The result
+ *                has the same shape as inserting the keys one by one.
+ *   Heap       - entries are appended, subtrees rooted on a level with
+ *                at least BUILD_TASKS_PER_THREAD nodes per thread are
+ *                heapified in parallel (they share no entries), and the
+ *                few levels above them are finished on one thread.
+ * Sorted views of ids still pending from bulk mode are loaded on the
+ * calling thread, as end_bulk does (bookmark_views_add).
+ * 
+ * Tasks go to workers in contiguous blocks. A worker claims the front
+ * task of its block with one CAS; when its block is empty it steals the
+ * back half of another worker's. Partitions vary a lot in size (many
+ * titles start with "th"), so stealing keeps every core busy to the end.
+ * 
+ * Compile: gcc -O2 -pthread -DBOOKMARK_STORE_NO_MAIN -DTRIE_NO_MAIN -DMIN_HEAP_NO_MAIN -DHASH_TABLE_NO_MAIN -DBOOKMARK_TEXT_NO_MAIN -DROARING_BITMAP_NO_MAIN -DBPLUS_TREE_NO_MAIN -DBOOKMARK_TAGS_NO_MAIN -o bookmark_build bookmark_build.c bookmark_store.c bookmark_text.c roaring_bitmap.c bookmark_tags.c bplus_tree.c trie.c min_heap.c hash_table.c node_arena.c -lm
+ * Run: ./bookmark_build [bookmarks] [max_threads]
+ * Define BOOKMARK_BUILD_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bookmark_build.h"
+
+#define BUILD_RANGE(begin, end) (((unsigned long long)(end) << 32) | (unsigned int)(begin))
+#define BUILD_RANGE_BEGIN(range) ((int)((range) & 0xFFFFFFFFu))
+#define BUILD_RANGE_END(range) ((int)((range) >> 32))
+#define BUILD_TRIE_PARTITIONS 65536  // first two key bytes
+
+/**
+ * Monotonic seconds
+ */
+double build_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ---------------------------------------------------------------- Pool
+
+/**
+ * Create a pool for threads workers (the calling thread is worker 0)
+ * Time Complexity: O(threads)
+ */
+void build_pool_init(BuildPool *pool, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > BUILD_MAX_THREADS) threads = BUILD_MAX_THREADS;
+    pool->threads = threads;
+    pool->queues = (BuildQueue *)aligned_alloc(BUILD_CACHE_LINE, threads * sizeof(BuildQueue));
+    for (int w = 0; w < threads; w++) atomic_init(&pool->queues[w].range, 0);
+    atomic_init(&pool->remaining, 0);
+    atomic_init(&pool->steals, 0);
+}
+
+/**
+ * Claim the front task of worker w's own block, or -1
+ */
+int build_pool_pop(BuildPool *pool, int w) {
+    atomic_ullong *range = &pool->queues[w].range;
+    unsigned long long current = atomic_load(range);
+    while (1) {
+        int begin = BUILD_RANGE_BEGIN(current), end = BUILD_RANGE_END(current);
+        if (begin >= end) return -1;
+        if (atomic_compare_exchange_weak(range, &current, BUILD_RANGE(begin + 1, end))) return begin;
+    }
+}
+
+/**
+ * Take the back half of another worker's block
+ * Keeps the first stolen task to run and the rest as w's new block.
+ * Returns the task, or -1 if every block is empty
+ */
+int build_pool_steal(BuildPool *pool, int w) {
+    for (int i = 1; i < pool->threads; i++) {
+        atomic_ullong *range = &pool->queues[(w + i) % pool->threads].range;
+        unsigned long long current = atomic_load(range);
+        int begin = BUILD_RANGE_BEGIN(current), end = BUILD_RANGE_END(current);
+        if (begin >= end) continue;
+        
+        int split = end - (end - begin + 1) / 2;
+        if (!atomic_compare_exchange_strong(range, &current, BUILD_RANGE(begin, split))) continue;
+        
+        // Our block is empty, so no thief can be updating it now
+        atomic_store(&pool->queues[w].range, BUILD_RANGE(split + 1, end));
+        atomic_fetch_add(&pool->steals, 1);
+        return split;
+    }
+    return -1;
+}
+
+/**
+ * Worker loop: own tasks first, then steal until every task is done
+ */
+void build_pool_work(BuildPool *pool, int w) {
+    while (atomic_load(&pool->remaining) > 0) {
+        int task = build_pool_pop(pool, w);
+        if (task < 0) task = build_pool_steal(pool, w);
+        if (task < 0) {
+            sched_yield();
+            continue;
+        }
+        pool->run(pool->context, task, w);
+        atomic_fetch_sub(&pool->remaining, 1);
+    }
+}
+
+typedef struct {
+    BuildPool *pool;
+    int worker;
+} BuildWorkerArg;
+
+void *build_pool_thread(void *arg) {
+    BuildWorkerArg *worker = (BuildWorkerArg *)arg;
+    build_pool_work(worker->pool, worker->worker);
+    return NULL;
+}
+
+/**
+ * Run tasks 0 .. task_count - 1 on every worker and wait for all of them
+ * run(context, task, worker) may use per-worker state indexed by worker.
+ * Time Complexity: O(task_count / threads) rounds of tasks, plus thread start-up
+ */
+void build_pool_run(BuildPool *pool, BuildTaskFn run, void *context, int task_count) {
+    if (task_count <= 0) return;
+    pool->run = run;
+    pool->context = context;
+    atomic_store(&pool->remaining, task_count);
+    
+    int threads = pool->threads < task_count ? pool->threads : task_count;
+    for (int w = 0; w < pool->threads; w++) {
+        int begin = w < threads ? (int)((long)task_count * w / threads) : task_count;
+        int end = w < threads ? (int)((long)task_count * (w + 1) / threads) : task_count;
+        atomic_store(&pool->queues[w].range, BUILD_RANGE(begin, end));
+    }
+    
+    pthread_t ids[BUILD_MAX_THREADS];
+    BuildWorkerArg args[BUILD_MAX_THREADS];
+    for (int w = 1; w < threads; w++) {
+        args[w].pool = pool;
+        args[w].worker = w;
+        pthread_create(&ids[w], NULL, build_pool_thread, &args[w]);
+    }
+    build_pool_work(pool, 0);
+    for (int w = 1; w < threads; w++) {
+        pthread_join(ids[w], NULL);
+    }
+}
+
+void build_pool_destroy(BuildPool *pool) {
+    free(pool->queues);
+    pool->queues = NULL;
+}
+
+// ----------------------------------------------------------- URL index
+
+typedef struct {
+    BookmarkStore *store;
+    int chunks;                  // id ranges, one task each
+    int partitions;              // slot ranges (power of two)
+    int partition_shift;         // home slot >> shift = partition
+    int *counts;                 // [chunk][partition], then scatter cursors
+    int *partition_start;        // [partition + 1] into ids
+    BookmarkId *ids;             // live ids grouped by partition
+    BookmarkId **overflow;       // per partition: ids whose probe left the range
+    int *overflow_count;
+} BuildUrlJob;
+
+/**
+ * Partition of a record's home slot
+ */
+int build_url_partition(BuildUrlJob *job, BookmarkId id) {
+    BookmarkStore *store = job->store;
+    return bookmark_url_home(store->url_index_size, store->records[id].url_hash) >> job->partition_shift;
+}
+
+void build_url_count(void *context, int chunk, int worker) {
+    (void)worker;
+    BuildUrlJob *job = (BuildUrlJob *)context;
+    int *counts = job->counts + (size_t)chunk * job->partitions;
+    int first = (int)((long)job->store->record_count * chunk / job->chunks);
+    int last = (int)((long)job->store->record_count * (chunk + 1) / job->chunks);
+    
+    for (int id = first; id < last; id++) {
+        if (job->store->records[id].live) counts[build_url_partition(job, id)]++;
+    }
+}
+
+void build_url_scatter(void *context, int chunk, int worker) {
+    (void)worker;
+    BuildUrlJob *job = (BuildUrlJob *)context;
+    int *cursors = job->counts + (size_t)chunk * job->partitions;
+    int first = (int)((long)job->store->record_count * chunk / job->chunks);
+    int last = (int)((long)job->store->record_count * (chunk + 1) / job->chunks);
+    
+    for (int id = first; id < last; id++) {
+        if (job->store->records[id].live) job->ids[cursors[build_url_partition(job, id)]++] = id;
+    }
+}
+
+/**
+ * Fill one slot range; probes never write outside it
+ */
+void build_url_fill(void *context, int partition, int worker) {
+    (void)worker;
+    BuildUrlJob *job = (BuildUrlJob *)context;
+    BookmarkStore *store = job->store;
+    int first_slot = partition << job->partition_shift;
+    int end_slot = first_slot + (1 << job->partition_shift);
+    
+    for (int i = first_slot; i < end_slot; i++) store->url_index[i].id = BOOKMARK_NONE;
+    
+    int capacity = 0;
+    for (int k = job->partition_start[partition]; k < job->partition_start[partition + 1]; k++) {
+        BookmarkId id = job->ids[k];
+        uint32_t hash = store->records[id].url_hash;
+        int i = bookmark_url_home(store->url_index_size, hash);
+        while (i < end_slot && store->url_index[i].id != BOOKMARK_NONE) i++;
+        
+        if (i == end_slot) {
+            if (job->overflow_count[partition] == capacity) {
+                capacity = capacity ? capacity * 2 : 16;
+                job->overflow[partition] = (BookmarkId *)realloc(job->overflow[partition], capacity * sizeof(BookmarkId));
+            }
+            job->overflow[partition][job->overflow_count[partition]++] = id;
+            continue;
+        }
+        store->url_index[i].hash = hash;
+        store->url_index[i].id = id;
+    }
+}
+
+/**
+ * Refill the URL index from the records (same size, same probing)
+ * Time Complexity: O(n / threads + P * chunks)
+ */
+void bookmark_build_url_index(BookmarkStore *store, BuildPool *pool) {
+    BuildUrlJob job;
+    job.store = store;
+    job.chunks = pool->threads * BUILD_TASKS_PER_THREAD;
+    job.partitions = 1;
+    while (job.partitions < job.chunks && job.partitions < store->url_index_size / 64) job.partitions *= 2;
+    job.partition_shift = __builtin_ctz(store->url_index_size) - __builtin_ctz(job.partitions);
+    
+    job.counts = (int *)calloc((size_t)job.chunks * job.partitions, sizeof(int));
+    job.partition_start = (int *)malloc((job.partitions + 1) * sizeof(int));
+    job.ids = (BookmarkId *)malloc((store->live_count + 1) * sizeof(BookmarkId));
+    job.overflow = (BookmarkId **)calloc(job.partitions, sizeof(BookmarkId *));
+    job.overflow_count = (int *)calloc(job.partitions, sizeof(int));
+    
+    build_pool_run(pool, build_url_count, &job, job.chunks);
+    
+    // Counts become scatter cursors: partition-major, chunk order within
+    int next = 0;
+    for (int p = 0; p < job.partitions; p++) {
+        job.partition_start[p] = next;
+        for (int c = 0; c < job.chunks; c++) {
+            int count = job.counts[(size_t)c * job.partitions + p];
+            job.counts[(size_t)c * job.partitions + p] = next;
+            next += count;
+        }
+    }
+    job.partition_start[job.partitions] = next;
+    
+    build_pool_run(pool, build_url_scatter, &job, job.chunks);
+    build_pool_run(pool, build_url_fill, &job, job.partitions);
+    
+    // Probes that crossed a range boundary (or wrapped) continue normally
+    int mask = store->url_index_size - 1;
+    for (int p = 0; p < job.partitions; p++) {
+        for (int k = 0; k < job.overflow_count[p]; k++) {
+            BookmarkId id = job.overflow[p][k];
+            uint32_t hash = store->records[id].url_hash;
+            int i = bookmark_url_home(store->url_index_size, hash);
+            while (store->url_index[i].id != BOOKMARK_NONE) i = (i + 1) & mask;
+            store->url_index[i].hash = hash;
+            store->url_index[i].id = id;
+        }
+        free(job.overflow[p]);
+    }
+    
+    free(job.counts);
+    free(job.partition_start);
+    free(job.ids);
+    free(job.overflow);
+    free(job.overflow_count);
+}
+
+// ---------------------------------------------------------------- Trie
+
+typedef struct {
+    BookmarkStore *store;
+    Trie *target;                // the new title trie
+    Trie *workers;               // one private trie (and arena) per worker
+    int chunks;                  // id ranges for computing partitions
+    uint16_t *partition_of;      // by id: first two folded key bytes
+    BookmarkId *ids;             // live ids grouped by partition
+    int *task_start;             // [task + 1] into ids
+    uint16_t *task_partition;
+    NodeHandle *task_root;       // subtree below the first key byte
+    int *task_worker;            // whose arena task_root lives in
+    uint32_t *offsets;           // [worker][class] after adoption
+} BuildTrieJob;
+
+/**
+ * First two key bytes as the trie will see them
+ * Three bytes are folded so a two-byte sequence starting at the second
+ * byte folds as it does in the full key.
+ */
+void build_trie_partitions(void *context, int chunk, int worker) {
+    (void)worker;
+    BuildTrieJob *job = (BuildTrieJob *)context;
+    BookmarkStore *store = job->store;
+    int first = (int)((long)store->record_count * chunk / job->chunks);
+    int last = (int)((long)store->record_count * (chunk + 1) / job->chunks);
+    char key[MAX_WORD_LENGTH];
+    unsigned char folded[MAX_WORD_LENGTH];
+    
+    for (int id = first; id < last; id++) {
+        if (!store->records[id].live) continue;
+        bookmark_title_key(store->records[id].title, id, key);
+        key[3] = '\0';
+        trie_fold_key(job->target, key, folded);
+        job->partition_of[id] = (uint16_t)(folded[0] << 8 | folded[1]);
+    }
+}
+
+/**
+ * Build one partition's subtree in the worker's private trie
+ */
+void build_trie_task(void *context, int task, int worker) {
+    BuildTrieJob *job = (BuildTrieJob *)context;
+    BookmarkStore *store = job->store;
+    Trie *trie = &job->workers[worker];
+    int first = job->task_start[task];
+    int count = job->task_start[task + 1] - first;
+    
+    BookmarkTitleRef *refs = (BookmarkTitleRef *)malloc(count * sizeof(BookmarkTitleRef));
+    for (int i = 0; i < count; i++) {
+        refs[i].id = job->ids[first + i];
+        refs[i].title = store->records[refs[i].id].title;
+    }
+    qsort(refs, count, sizeof(BookmarkTitleRef), bookmark_title_ref_compare);
+    
+    trie->root = trie_node_create(trie, NODE_LEAF, NULL, 0);
+    char key[MAX_WORD_LENGTH];
+    for (int i = 0; i < count; i++) {
+        bookmark_title_key(refs[i].title, refs[i].id, key);
+        trie_insert_scored(trie, key, store->records[refs[i].id].frecency);
+    }
+    free(refs);
+    
+    // Every key starts with the same byte: keep that child, drop the root
+    unsigned char byte;
+    job->task_root[task] = trie_next_child(TRIE_NODE(trie, trie->root), 0, &byte);
+    job->task_worker[task] = worker;
+    node_arena_free(&trie->arena, trie->root);
+}
+
+/**
+ * Rewrite a subtree's child handles for the arena it was adopted into
+ * handle is already rebased.
+ */
+void build_trie_rebase(Trie *trie, NodeHandle handle, const uint32_t *offsets) {
+    TrieNode *node = TRIE_NODE(trie, handle);
+    NodeHandle *children = NULL;
+    int slots = 0;
+    
+    switch (node->type) {
+        case NODE4: children = ((TrieNode4 *)node)->children; slots = node->num_children; break;
+        case NODE16: children = ((TrieNode16 *)node)->children; slots = node->num_children; break;
+        case NODE48: children = ((TrieNode48 *)node)->children; slots = 48; break;
+        case NODE256: children = ((TrieNode256 *)node)->children; slots = 256; break;
+    }
+    
+    for (int i = 0; i < slots; i++) {
+        if (children[i] == NODE_NULL) continue;
+        children[i] = node_arena_rebase(children[i], offsets);
+        build_trie_rebase(trie, children[i], offsets);
+    }
+}
+
+void build_trie_rebase_task(void *context, int task, int worker) {
+    (void)worker;
+    BuildTrieJob *job = (BuildTrieJob *)context;
+    const uint32_t *offsets = job->offsets + (size_t)job->task_worker[task] * job->target->arena.class_count;
+    job->task_root[task] = node_arena_rebase(job->task_root[task], offsets);
+    build_trie_rebase(job->target, job->task_root[task], offsets);
+}
+
+/**
+ * Hang the subtrees for first byte tasks [first, last) under the root
+ */
+void build_trie_stitch(BuildTrieJob *job, int first, int last) {
+    Trie *trie = job->target;
+    unsigned char byte = job->task_partition[first] >> 8;
+    NodeHandle subtree = job->task_root[first];
+    
+    if (last - first > 1) {
+        // Branch on the second byte; each subtree's prefix starts with it
+        subtree = trie_node_create(trie, NODE_LEAF, NULL, 0);
+        for (int t = first; t < last; t++) {
+            TrieNode *child = TRIE_NODE(trie, job->task_root[t]);
+            unsigned char *prefix = trie_node_prefix(child);
+            memmove(prefix, prefix + 1, child->prefix_len - 1);
+            child->prefix_len--;
+            trie_add_child(trie, &subtree, job->task_partition[t] & 0xFF, job->task_root[t]);
+        }
+        trie_refresh_max(trie, TRIE_NODE(trie, subtree));
+    }
+    trie_add_child(trie, &trie->root, byte, subtree);
+}
+
+/**
+ * Build a new title trie (same flags) from the live records
+ * Returns NULL if the merged arena would run out of handles
+ * Time Complexity: O(sum of key lengths / threads + partitions)
+ */
+Trie *bookmark_build_trie(BookmarkStore *store, BuildPool *pool, BookmarkBuildStats *stats) {
+    BuildTrieJob job;
+    job.store = store;
+    job.target = trie_create_with(store->titles->flags);
+    int classes = job.target->arena.class_count;
+    
+    // Partition ids by first two key bytes (counting sort)
+    job.chunks = pool->threads * BUILD_TASKS_PER_THREAD;
+    job.partition_of = (uint16_t *)malloc((store->record_count + 1) * sizeof(uint16_t));
+    build_pool_run(pool, build_trie_partitions, &job, job.chunks);
+    
+    int *starts = (int *)calloc(BUILD_TRIE_PARTITIONS + 1, sizeof(int));
+    for (int id = 0; id < store->record_count; id++) {
+        if (store->records[id].live) starts[job.partition_of[id] + 1]++;
+    }
+    int tasks = 0;
+    for (int p = 0; p < BUILD_TRIE_PARTITIONS; p++) {
+        if (starts[p + 1] > 0) tasks++;
+        starts[p + 1] += starts[p];
+    }
+    
+    job.ids = (BookmarkId *)malloc((store->live_count + 1) * sizeof(BookmarkId));
+    int *cursor = (int *)malloc(BUILD_TRIE_PARTITIONS * sizeof(int));
+    memcpy(cursor, starts, BUILD_TRIE_PARTITIONS * sizeof(int));
+    for (int id = 0; id < store->record_count; id++) {
+        if (store->records[id].live) job.ids[cursor[job.partition_of[id]]++] = id;
+    }
+    free(cursor);
+    
+    job.task_start = (int *)malloc((tasks + 1) * sizeof(int));
+    job.task_partition = (uint16_t *)malloc((tasks + 1) * sizeof(uint16_t));
+    job.task_root = (NodeHandle *)malloc((tasks + 1) * sizeof(NodeHandle));
+    job.task_worker = (int *)malloc((tasks + 1) * sizeof(int));
+    int task = 0;
+    for (int p = 0; p < BUILD_TRIE_PARTITIONS; p++) {
+        if (starts[p + 1] == starts[p]) continue;
+        job.task_start[task] = starts[p];
+        job.task_partition[task++] = (uint16_t)p;
+    }
+    job.task_start[tasks] = store->live_count;
+    free(starts);
+    
+    // Private tries, one per worker
+    job.workers = (Trie *)calloc(pool->threads, sizeof(Trie));
+    for (int w = 0; w < pool->threads; w++) {
+        node_arena_init_like(&job.workers[w].arena, &job.target->arena);
+        job.workers[w].flags = job.target->flags;
+    }
+    build_pool_run(pool, build_trie_task, &job, tasks);
+    
+    // Adopt every worker arena into the new trie's arena
+    int ok = 1;
+    job.offsets = (uint32_t *)malloc((size_t)pool->threads * classes * sizeof(uint32_t));
+    for (int w = 0; w < pool->threads && ok; w++) {
+        ok = node_arena_adopt(&job.target->arena, &job.workers[w].arena, job.offsets + (size_t)w * classes);
+        job.target->word_count += job.workers[w].word_count;
+    }
+    
+    if (ok) {
+        build_pool_run(pool, build_trie_rebase_task, &job, tasks);
+        for (int first = 0; first < tasks; ) {
+            int last = first + 1;
+            while (last < tasks && job.task_partition[last] >> 8 == job.task_partition[first] >> 8) last++;
+            build_trie_stitch(&job, first, last);
+            first = last;
+        }
+        trie_refresh_max(job.target, TRIE_NODE(job.target, job.target->root));
+    } else {
+        trie_free(job.target);
+        job.target = NULL;
+    }
+    
+    for (int w = 0; w < pool->threads; w++) {
+        node_arena_destroy(&job.workers[w].arena);
+    }
+    stats->trie_tasks = tasks;
+    free(job.workers);
+    free(job.offsets);
+    free(job.partition_of);
+    free(job.ids);
+    free(job.task_start);
+    free(job.task_partition);
+    free(job.task_root);
+    free(job.task_worker);
+    return job.target;
+}
+
+// ---------------------------------------------------------------- Heap
+
+typedef struct {
+    MinHeap *heap;
+    int first_root;
+} BuildHeapJob;
+
+void build_heap_task(void *context, int task, int worker) {
+    (void)worker;
+    BuildHeapJob *job = (BuildHeapJob *)context;
+    min_heap_heapify_subtree(job->heap, job->first_root + task);
+}
+
+/**
+ * Build a new least-used (frecency) heap from the live records
+ * Time Complexity: O(n) appends + O(n / threads) heapify
+ */
+MinHeap *bookmark_build_heap(BookmarkStore *store, BuildPool *pool) {
+    MinHeap *heap = min_heap_create(store->live_count > 16 ? store->live_count : 16);
+    for (int id = 0; id < store->record_count; id++) {
+        if (store->records[id].live) min_heap_append(heap, id, (int)store->records[id].frecency, NULL);
+    }
+    
+    // Deepest level worth splitting: enough subtrees to keep threads busy
+    long first = 0, width = 1;
+    while (width < (long)pool->threads * BUILD_TASKS_PER_THREAD && first < heap->size) {
+        first = (first << heap->arity_shift) + 1;
+        width <<= heap->arity_shift;
+    }
+    
+    if (pool->threads == 1 || first >= heap->size) {
+        min_heap_heapify(heap);
+        return heap;
+    }
+    
+    BuildHeapJob job = { heap, (int)first };
+    long roots = heap->size - first < width ? heap->size - first : width;
+    build_pool_run(pool, build_heap_task, &job, (int)roots);
+    min_heap_heapify_above(heap, (int)first);
+    return heap;
+}
+
+// ------------------------------------------------------------- Driver
+
+/**
+ * Rebuild the URL index, title trie and heap from the record table
+ * threads <= 0 uses every online core. Ends bulk mode: ids added in bulk
+ * are indexed by the rebuild (and put in the sorted views). Returns 0 (store unchanged but for the
+ * URL index, which is rebuilt identically) if the trie does not fit.
+ * Time Complexity: O((n + total key length) / threads) plus O(partitions)
+ */
+int bookmark_build_indexes(BookmarkStore *store, int threads, BookmarkBuildStats *stats_out) {
+    BookmarkBuildStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    
+    BuildPool pool;
+    build_pool_init(&pool, threads);
+    stats.threads = pool.threads;
+    
+    double start = build_now();
+    bookmark_build_url_index(store, &pool);
+    stats.url_seconds = build_now() - start;
+    
+    start = build_now();
+    Trie *titles = bookmark_build_trie(store, &pool, &stats);
+    stats.trie_seconds = build_now() - start;
+    
+    if (titles) {
+        start = build_now();
+        MinHeap *heap = bookmark_build_heap(store, &pool);
+        stats.heap_seconds = build_now() - start;
+        
+        trie_free(store->titles);
+        store->titles = titles;
+        min_heap_free(store->least_visited);
+        store->least_visited = heap;
+        
+        bookmark_views_add(store, store->bulk_ids, store->bulk_count);
+        free(store->bulk_ids);
+        store->bulk_ids = NULL;
+        store->bulk_count = 0;
+        store->bulk_capacity = 0;
+    }
+    
+    stats.steals = atomic_load(&pool.steals);
+    build_pool_destroy(&pool);
+    if (stats_out) *stats_out = stats;
+    return titles != NULL;
+}
+
+#ifndef BOOKMARK_BUILD_NO_MAIN
+
+#define DEMO_DEFAULT_BOOKMARKS 1000000
+
+static const char *DEMO_WORDS[] = {
+    "the", "how", "best", "guide", "news", "recipe", "rust", "linux", "travel", "music",
+    "python", "review", "learn", "weather", "video", "docs", "api", "home", "shop", "blog",
+    "Über", "Café", "Москва", "Ελλάδα", "tips", "free", "top", "open", "data", "game"
+};
+
+/**
+ * Fill a store in bulk mode with n bookmarks and random visit counts
+ */
+BookmarkStore *build_demo_store(int n) {
+    BookmarkStore *store = bookmark_store_create(20);
+    int words = sizeof(DEMO_WORDS) / sizeof(DEMO_WORDS[0]);
+    char title[128], url[64];
+    
+    srand(42);
+    bookmark_store_begin_bulk(store);
+    for (int i = 0; i < n; i++) {
+        snprintf(title, sizeof(title), "%s %s %s %d", DEMO_WORDS[rand() % words], DEMO_WORDS[rand() % words],
+                 DEMO_WORDS[rand() % words], rand() % 1000);
+        snprintf(url, sizeof(url), "https://example%d.com/%d", i % 997, i);
+        BookmarkId id = bookmark_store_add(store, title, url, "demo");
+        // Visit counts and frecency as a loaded snapshot would carry them
+        store->records[id].visit_count = rand() % 50;
+        if (store->records[id].visit_count > 0) {
+            store->records[id].frecency = BOOKMARK_FRECENCY_OFFSET + rand() % (8 * BOOKMARK_FRECENCY_SCALE);
+        }
+    }
+    return store;
+}
+
+/**
+ * Do two tries have the same nodes (types, prefixes, scores, children)?
+ */
+int build_demo_same_trie(Trie *a, NodeHandle ha, Trie *b, NodeHandle hb) {
+    TrieNode *na = TRIE_NODE(a, ha), *nb = TRIE_NODE(b, hb);
+    if (na->type != nb->type || na->num_children != nb->num_children || na->prefix_len != nb->prefix_len ||
+        na->is_end_of_word != nb->is_end_of_word || na->max_score != nb->max_score ||
+        (na->is_end_of_word && na->score != nb->score) ||
+        memcmp(trie_node_prefix(na), trie_node_prefix(nb), na->prefix_len) != 0) {
+        return 0;
+    }
+    
+    unsigned char byte_a, byte_b;
+    NodeHandle ca, cb;
+    for (int from = 0; (ca = trie_next_child(na, from, &byte_a)) != NODE_NULL; from = byte_a + 1) {
+        cb = trie_next_child(nb, from, &byte_b);
+        if (cb == NODE_NULL || byte_a != byte_b || !build_demo_same_trie(a, ca, b, cb)) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Do two stores answer the same queries?
+ */
+int build_demo_same_answers(BookmarkStore *a, BookmarkStore *b) {
+    const char *prefixes[] = { "", "t", "th", "the best", "über", "мос", "café", "zzz" };
+    BookmarkId ids_a[50], ids_b[50];
+    
+    for (int p = 0; p < (int)(sizeof(prefixes) / sizeof(prefixes[0])); p++) {
+        int count = bookmark_store_search(a, prefixes[p], 50, ids_a);
+        if (count != bookmark_store_search(b, prefixes[p], 50, ids_b)) return 0;
+        for (int i = 0; i < count; i++) {
+            if (a->records[ids_a[i]].frecency != b->records[ids_b[i]].frecency) return 0;
+        }
+    }
+    
+    int count = bookmark_store_least_visited(a, 50, ids_a);
+    if (count != bookmark_store_least_visited(b, 50, ids_b)) return 0;
+    for (int i = 0; i < count; i++) {
+        if (a->records[ids_a[i]].frecency != b->records[ids_b[i]].frecency) return 0;
+    }
+    
+    for (int id = 0; id < a->record_count; id += 997) {
+        if (a->records[id].live && bookmark_store_find_url(b, a->records[id].url) != (BookmarkId)id) return 0;
+    }
+    return a->least_visited->size == b->least_visited->size && a->titles->word_count == b->titles->word_count;
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    printf("=== Parallel Bookmark Index Build in C ===\n");
+    printf("Data Structure: Work-stealing pool over partitioned hash, trie and heap builds\n\n");
+    
+    int n = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_BOOKMARKS;
+    if (n < 1) n = DEMO_DEFAULT_BOOKMARKS;
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 2 ? atoi(argv[2]) : cores;
+    if (max_threads < 1) max_threads = 1;
+    
+    printf("1. Sequential build (bookmark_store_end_bulk), %d bookmarks\n", n);
+    BookmarkStore *reference = build_demo_store(n);
+    double start = build_now();
+    bookmark_store_end_bulk(reference);
+    printf("   trie + heap: %.3f s\n\n", build_now() - start);
+    
+    printf("2. Parallel rebuild of URL index, trie and heap (%d cores online)\n", cores);
+    printf("   threads   url (s)  trie (s)  heap (s)  total (s)  partitions  steals  same trie\n");
+    BookmarkStore *store = build_demo_store(n);
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        BookmarkBuildStats stats;
+        bookmark_build_indexes(store, threads, &stats);
+        int same = build_demo_same_trie(reference->titles, reference->titles->root, store->titles, store->titles->root) &&
+                   build_demo_same_answers(reference, store);
+        printf("   %7d  %8.3f  %8.3f  %8.3f  %9.3f  %10d  %6ld  %s\n", stats.threads, stats.url_seconds,
+               stats.trie_seconds, stats.heap_seconds, stats.url_seconds + stats.trie_seconds + stats.heap_seconds,
+               stats.trie_tasks, stats.steals, same ? "yes" : "NO");
+        if (threads < max_threads && threads * 2 > max_threads) threads = max_threads / 2;
+    }
+    
+    printf("\n3. Store after the rebuild\n");
+    BookmarkId ids[3];
+    int count = bookmark_store_search(store, "the best", 3, ids);
+    for (int i = 0; i < count; i++) {
+        printf("   %-32s visits=%u frecency=%.2f\n", store->records[ids[i]].title, store->records[ids[i]].visit_count,
+               bookmark_store_frecency(store, ids[i]));
+    }
+    
+    bookmark_store_free(reference);
+    bookmark_store_free(store);
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
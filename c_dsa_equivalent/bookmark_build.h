@@ -0,0 +1,62 @@
+/**
+ * Bookmark Parallel Build Interface
+ * Rebuilds a BookmarkStore's URL index, title trie and heap from its
+ * record table on several threads (see bookmark_build.c)
+ */
+
+#ifndef BOOKMARK_BUILD_H
+#define BOOKMARK_BUILD_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bookmark_store.h"
+
+#define BUILD_MAX_THREADS 256
+#define BUILD_TASKS_PER_THREAD 8     // URL chunks / heap subtrees per thread
+#define BUILD_CACHE_LINE 64
+
+typedef void (*BuildTaskFn)(void *context, int task, int worker);
+
+/**
+ * One worker's share of the tasks: the range [begin, end) packed into
+ * one word (end in the high half) so owner and thieves can claim tasks
+ * with a single compare-and-swap
+ */
+typedef struct {
+    _Alignas(BUILD_CACHE_LINE) atomic_ullong range;
+} BuildQueue;
+
+/**
+ * Work-stealing pool for one build
+ * Each run hands every worker a contiguous block of task numbers; a
+ * worker that runs dry steals the back half of another's block.
+ */
+typedef struct {
+    int threads;
+    BuildQueue *queues;
+    atomic_int remaining;        // tasks not yet finished in this run
+    atomic_long steals;          // successful steals (stats)
+    BuildTaskFn run;
+    void *context;
+} BuildPool;
+
+/**
+ * Time spent in each phase of a build
+ */
+typedef struct {
+    int threads;
+    double url_seconds;
+    double trie_seconds;
+    double heap_seconds;
+    int trie_tasks;              // title partitions built independently
+    long steals;
+} BookmarkBuildStats;
+
+void build_pool_init(BuildPool *pool, int threads);
+void build_pool_run(BuildPool *pool, BuildTaskFn run, void *context, int task_count);
+void build_pool_destroy(BuildPool *pool);
+
+int bookmark_build_indexes(BookmarkStore *store, int threads, BookmarkBuildStats *stats_out);
+
+#endif
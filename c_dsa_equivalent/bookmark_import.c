@@ -0,0 +1,1019 @@
+/**
+ * Bookmark Import Implementation in C
+ * Streams large bookmark exports into a BookmarkStore
+ * 
+ * The importer is a push parser: input arrives in chunks of any size
+ * (bookmark_import_file reads IMPORT_CHUNK_SIZE at a time) and each
+ * format is a byte-at-a-time state machine, so a token split across two
+ * chunks needs no special handling and the whole file is never in
+ * memory. Every field is a bounded buffer: memory is the chunk plus a
+ * few fixed buffers, whatever the file size.
+ * 
+ * Formats (IMPORT_FORMAT_AUTO picks by the first non-blank byte):
+ *   HTML  Netscape bookmark file: <A HREF=... ADD_DATE=... TAGS=...>
+ *         title</A>; the innermost <H3> folder becomes the category
+ *   JSON  any nesting of objects and arrays; an object with a url/uri/
+ *         href member is a bookmark, title/name gives its title, and
+ *         category/folder (or the nearest enclosing object's name seen
+ *         so far) its category, and tags (an array of strings or one
+ *         comma-separated string) its tags. Covers the app's own {title,
+ *         url, category, tags} arrays and Firefox/Chrome style folder
+ *         trees.
+ *   CSV   RFC 4180 quoting; a header row naming title/url/category
+ *         columns (any order), otherwise columns are title,url,category
+ * 
+ * Bookmarks are added with the store in bulk mode: the URL index rejects
+ * duplicates as they arrive, and the trie and heap are built once when
+ * the import finishes (bookmark_store_end_bulk).
+ * 
+ * Compile: gcc -O2 -DBOOKMARK_STORE_NO_MAIN -DTRIE_NO_MAIN -DMIN_HEAP_NO_MAIN -DHASH_TABLE_NO_MAIN -DBOOKMARK_TEXT_NO_MAIN -DROARING_BITMAP_NO_MAIN -DBPLUS_TREE_NO_MAIN -DBOOKMARK_TAGS_NO_MAIN -o bookmark_import bookmark_import.c bookmark_store.c bookmark_text.c roaring_bitmap.c bookmark_tags.c bplus_tree.c trie.c min_heap.c hash_table.c node_arena.c -lm
+ * Run: ./bookmark_import [bookmarks]         (generate exports and import them)
+ *      ./bookmark_import --file <path>       (import one export)
+ * Define BOOKMARK_IMPORT_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <strings.h>
+#include <time.h>
+
+#include "bookmark_import.h"
+
+// Parser states
+#define HTML_TEXT 0
+#define HTML_TAG 1
+#define HTML_TAG_QUOTE 2
+#define HTML_COMMENT 3
+
+#define JSON_VALUE 0
+#define JSON_STRING 1
+#define JSON_ESCAPE 2
+#define JSON_UNICODE 3
+#define JSON_LITERAL 4
+
+#define CSV_FIELD_START 0
+#define CSV_UNQUOTED 1
+#define CSV_QUOTED 2
+#define CSV_QUOTE 3
+
+// Where captured text goes
+#define CAPTURE_NONE 0
+#define CAPTURE_TITLE 1
+#define CAPTURE_FOLDER 2
+
+// JSON member names we use
+#define KEY_OTHER 0
+#define KEY_TITLE 1
+#define KEY_URL 2
+#define KEY_CATEGORY 3
+#define KEY_DATE_MS 4            // createdAt: ms since the epoch
+#define KEY_DATE_US 5            // dateAdded (Firefox): us since the epoch
+#define KEY_DATE_CHROME 6        // date_added (Chrome): us since 1601, as a string
+#define KEY_TAGS 7
+
+#define CHROME_EPOCH_OFFSET_MS 11644473600000LL
+
+/**
+ * Allocate a field that keeps up to cap bytes
+ */
+void import_field_init(ImportField *field, int cap) {
+    field->data = (char *)malloc(cap + 1);
+    field->len = 0;
+    field->cap = cap;
+    field->overflow = 0;
+}
+
+void import_field_reset(ImportField *field) {
+    field->len = 0;
+    field->overflow = 0;
+}
+
+/**
+ * Append one byte, or note that the field overflowed
+ */
+void import_field_push(ImportField *field, char c) {
+    if (field->len < field->cap) {
+        field->data[field->len++] = c;
+    } else {
+        field->overflow = 1;
+    }
+}
+
+/**
+ * Append a code point as UTF-8
+ */
+void import_field_push_utf8(ImportField *field, unsigned int cp) {
+    if (cp < 0x80) {
+        import_field_push(field, (char)cp);
+    } else if (cp < 0x800) {
+        import_field_push(field, (char)(0xC0 | (cp >> 6)));
+        import_field_push(field, (char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        import_field_push(field, (char)(0xE0 | (cp >> 12)));
+        import_field_push(field, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        import_field_push(field, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        import_field_push(field, (char)(0xF0 | (cp >> 18)));
+        import_field_push(field, (char)(0x80 | ((cp >> 12) & 0x3F)));
+        import_field_push(field, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        import_field_push(field, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+/**
+ * Copy src into dst, keeping dst's cap (overflow carries over)
+ */
+void import_field_copy(ImportField *dst, const ImportField *src) {
+    int len = src->len < dst->cap ? src->len : dst->cap;
+    memcpy(dst->data, src->data, len);
+    dst->len = len;
+    dst->overflow = src->overflow || src->len > dst->cap;
+}
+
+/**
+ * NUL-terminated contents with surrounding whitespace trimmed
+ */
+char *import_field_text(ImportField *field) {
+    int start = 0, end = field->len;
+    while (start < end && isspace((unsigned char)field->data[start])) start++;
+    while (end > start && isspace((unsigned char)field->data[end - 1])) end--;
+    field->data[end] = '\0';
+    return field->data + start;
+}
+
+/**
+ * Tag a new bookmark with each name in a comma-separated list
+ * Splits the field in place; the caller resets it afterwards.
+ */
+void import_tag(BookmarkImporter *importer, BookmarkId id, ImportField *tags_field) {
+    char *name = import_field_text(tags_field);
+    while (*name) {
+        char *comma = strchr(name, ',');
+        if (comma) *comma = '\0';
+        bookmark_store_tag(importer->store, id, name);  // trims; skips empty names
+        if (!comma) break;
+        name = comma + 1;
+    }
+}
+
+/**
+ * Hand one parsed bookmark to the store
+ * tags_field is a comma-separated list, or NULL
+ */
+void import_emit(BookmarkImporter *importer, ImportField *title_field, ImportField *category_field,
+                 ImportField *tags_field) {
+    BookmarkImportStats *stats = &importer->stats;
+    char *url = import_field_text(&importer->url);
+    stats->parsed++;
+    
+    if (url[0] == '\0' || importer->url.overflow) {
+        stats->rejected++;
+        return;
+    }
+    
+    char *title = title_field ? import_field_text(title_field) : "";
+    char *category = category_field ? import_field_text(category_field) : "";
+    if (title[0] == '\0') title = url;
+    
+    long long created_at = importer->created_at > 0 ? importer->created_at : bookmark_store_now_ms();
+    BookmarkId id = bookmark_store_add_at(importer->store, title, url, category, created_at);
+    if (id == BOOKMARK_NONE) {
+        stats->duplicates++;
+        return;
+    }
+    stats->added++;
+    if (tags_field && tags_field->len > 0) import_tag(importer, id, tags_field);
+}
+
+/**
+ * Create an importer that adds into store
+ * Puts the store in bulk mode until bookmark_importer_finish.
+ * Time Complexity: O(1)
+ */
+BookmarkImporter *bookmark_importer_create(BookmarkStore *store, BookmarkImportFormat format) {
+    BookmarkImporter *importer = (BookmarkImporter *)calloc(1, sizeof(BookmarkImporter));
+    importer->store = store;
+    importer->format = format;
+    
+    import_field_init(&importer->title, IMPORT_MAX_TITLE);
+    import_field_init(&importer->url, IMPORT_MAX_URL);
+    import_field_init(&importer->category, IMPORT_MAX_CATEGORY);
+    import_field_init(&importer->tags, IMPORT_MAX_TAGS);
+    import_field_init(&importer->text, IMPORT_MAX_TAG > IMPORT_MAX_URL ? IMPORT_MAX_TAG : IMPORT_MAX_URL);
+    import_field_init(&importer->pending_folder, IMPORT_MAX_CATEGORY);
+    for (int d = 0; d < IMPORT_MAX_DEPTH; d++) {
+        import_field_init(&importer->folders[d], IMPORT_MAX_CATEGORY);
+        import_field_init(&importer->json_name[d], IMPORT_MAX_TITLE);
+    }
+    importer->entity = -1;
+    importer->json_url_depth = importer->json_category_depth = importer->json_date_depth = -1;
+    importer->json_tags_depth = importer->json_tags_array = -1;
+    importer->csv_title_column = importer->csv_url_column = importer->csv_category_column = -1;
+    
+    bookmark_store_begin_bulk(store);
+    return importer;
+}
+
+// ---------------------------------------------------------------- HTML
+
+/**
+ * Decode an entity name (without & and ;) to a code point, -1 if unknown
+ */
+long import_html_entity(const char *name) {
+    if (name[0] == '#') {
+        char *end;
+        long cp = (name[1] == 'x' || name[1] == 'X') ? strtol(name + 2, &end, 16) : strtol(name + 1, &end, 10);
+        return (*end == '\0' && cp > 0 && cp < 0x110000) ? cp : -1;
+    }
+    if (strcmp(name, "amp") == 0) return '&';
+    if (strcmp(name, "lt") == 0) return '<';
+    if (strcmp(name, "gt") == 0) return '>';
+    if (strcmp(name, "quot") == 0) return '"';
+    if (strcmp(name, "apos") == 0) return '\'';
+    if (strcmp(name, "nbsp") == 0) return ' ';
+    return -1;
+}
+
+/**
+ * Copy text into field, decoding entities (attribute values)
+ */
+void import_html_decode(ImportField *field, const char *text, int len) {
+    import_field_reset(field);
+    for (int i = 0; i < len; i++) {
+        if (text[i] == '&') {
+            int j = i + 1;
+            while (j < len && j - i <= 10 && text[j] != ';' && text[j] != '&') j++;
+            if (j < len && text[j] == ';') {
+                char name[12];
+                memcpy(name, text + i + 1, j - i - 1);
+                name[j - i - 1] = '\0';
+                long cp = import_html_entity(name);
+                if (cp >= 0) {
+                    import_field_push_utf8(field, (unsigned int)cp);
+                    i = j;
+                    continue;
+                }
+            }
+        }
+        import_field_push(field, text[i]);
+    }
+}
+
+/**
+ * Find attribute name (case-insensitive) in tag text
+ * Returns a pointer to its value and sets *len, or NULL
+ */
+const char *import_html_attribute(const char *tag, int tag_len, const char *name, int *len) {
+    int name_len = strlen(name);
+    int i = 0;
+    
+    // Skip the tag name
+    while (i < tag_len && !isspace((unsigned char)tag[i])) i++;
+    
+    while (i < tag_len) {
+        while (i < tag_len && isspace((unsigned char)tag[i])) i++;
+        int attr_start = i;
+        while (i < tag_len && tag[i] != '=' && !isspace((unsigned char)tag[i])) i++;
+        int attr_len = i - attr_start;
+        while (i < tag_len && isspace((unsigned char)tag[i])) i++;
+        
+        const char *value = tag + i;
+        int value_len = 0;
+        if (i < tag_len && tag[i] == '=') {
+            i++;
+            while (i < tag_len && isspace((unsigned char)tag[i])) i++;
+            if (i < tag_len && (tag[i] == '"' || tag[i] == '\'')) {
+                char quote = tag[i++];
+                value = tag + i;
+                while (i < tag_len && tag[i] != quote) i++;
+                value_len = tag + i - value;
+                i++;
+            } else {
+                value = tag + i;
+                while (i < tag_len && !isspace((unsigned char)tag[i])) i++;
+                value_len = tag + i - value;
+            }
+        }
+        
+        if (attr_len == name_len && strncasecmp(tag + attr_start, name, name_len) == 0) {
+            *len = value_len;
+            return value;
+        }
+        if (attr_len == 0) i++;
+    }
+    return NULL;
+}
+
+/**
+ * Act on a complete tag (text between < and >)
+ */
+void import_html_tag(BookmarkImporter *importer) {
+    ImportField *tag = &importer->text;
+    tag->data[tag->len] = '\0';
+    const char *text = tag->data;
+    int name_len = 0;
+    while (name_len < tag->len && !isspace((unsigned char)text[name_len]) && text[name_len] != '>') name_len++;
+    
+    if (name_len == 1 && (text[0] == 'A' || text[0] == 'a')) {
+        int len;
+        const char *href = import_html_attribute(text, tag->len, "HREF", &len);
+        import_field_reset(&importer->url);
+        if (href) import_html_decode(&importer->url, href, len);
+        if (tag->overflow) importer->url.overflow = 1;  // tag cut short: href may be too
+        
+        const char *date = import_html_attribute(text, tag->len, "ADD_DATE", &len);
+        importer->created_at = date ? strtoll(date, NULL, 10) * 1000 : 0;
+        
+        const char *tags = import_html_attribute(text, tag->len, "TAGS", &len);
+        import_field_reset(&importer->tags);
+        if (tags) import_html_decode(&importer->tags, tags, len);
+        
+        import_field_reset(&importer->title);
+        importer->capture = CAPTURE_TITLE;
+    } else if (name_len == 2 && strncasecmp(text, "/A", 2) == 0) {
+        if (importer->capture == CAPTURE_TITLE) {
+            int depth = importer->folder_depth;
+            ImportField *folder = depth > 0 && depth <= IMPORT_MAX_DEPTH ? &importer->folders[depth - 1] : NULL;
+            import_emit(importer, &importer->title, folder, &importer->tags);
+        }
+        importer->capture = CAPTURE_NONE;
+    } else if (name_len == 2 && strncasecmp(text, "H3", 2) == 0) {
+        import_field_reset(&importer->pending_folder);
+        importer->capture = CAPTURE_FOLDER;
+    } else if (name_len == 3 && strncasecmp(text, "/H3", 3) == 0) {
+        importer->capture = CAPTURE_NONE;
+    } else if (name_len == 2 && strncasecmp(text, "DL", 2) == 0) {
+        if (importer->folder_depth < IMPORT_MAX_DEPTH) {
+            import_field_copy(&importer->folders[importer->folder_depth], &importer->pending_folder);
+        }
+        importer->folder_depth++;
+        import_field_reset(&importer->pending_folder);
+    } else if (name_len == 3 && strncasecmp(text, "/DL", 3) == 0) {
+        if (importer->folder_depth > 0) importer->folder_depth--;
+    }
+}
+
+/**
+ * Add one byte of element text to whatever is being captured
+ */
+void import_html_capture(BookmarkImporter *importer, char c) {
+    ImportField *field = importer->capture == CAPTURE_TITLE ? &importer->title : &importer->pending_folder;
+    if (c == '\n' || c == '\r' || c == '\t') c = ' ';
+    import_field_push(field, c);
+}
+
+/**
+ * Emit a pending "&name" that turned out not to be an entity
+ */
+void import_html_flush_entity(BookmarkImporter *importer) {
+    if (importer->entity < 0) return;
+    import_html_capture(importer, '&');
+    for (int i = 0; i < importer->entity; i++) import_html_capture(importer, importer->entity_buf[i]);
+    importer->entity = -1;
+}
+
+/**
+ * Element text byte, decoding entities as they complete
+ */
+void import_html_text(BookmarkImporter *importer, char c) {
+    if (importer->capture == CAPTURE_NONE) return;
+    
+    if (importer->entity >= 0) {
+        if (c == ';') {
+            importer->entity_buf[importer->entity] = '\0';
+            long cp = import_html_entity(importer->entity_buf);
+            if (cp >= 0) {
+                ImportField *field = importer->capture == CAPTURE_TITLE ? &importer->title : &importer->pending_folder;
+                import_field_push_utf8(field, (unsigned int)cp);
+                importer->entity = -1;
+                return;
+            }
+            import_html_flush_entity(importer);
+            import_html_capture(importer, c);
+            return;
+        }
+        if ((isalnum((unsigned char)c) || c == '#') && importer->entity < (int)sizeof(importer->entity_buf) - 1) {
+            importer->entity_buf[importer->entity++] = c;
+            return;
+        }
+        import_html_flush_entity(importer);
+    }
+    
+    if (c == '&') {
+        importer->entity = 0;
+    } else {
+        import_html_capture(importer, c);
+    }
+}
+
+/**
+ * HTML state machine over one chunk
+ */
+void import_html_feed(BookmarkImporter *importer, const char *data, size_t len) {
+    ImportField *tag = &importer->text;
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        switch (importer->state) {
+        case HTML_TEXT:
+            if (c == '<') {
+                import_html_flush_entity(importer);
+                import_field_reset(tag);
+                importer->state = HTML_TAG;
+            } else {
+                import_html_text(importer, c);
+            }
+            break;
+        case HTML_TAG:
+            if (c == '>') {
+                import_html_tag(importer);
+                importer->state = HTML_TEXT;
+                break;
+            }
+            import_field_push(tag, c);
+            if (c == '"') importer->state = HTML_TAG_QUOTE;
+            if (tag->len == 3 && memcmp(tag->data, "!--", 3) == 0) {
+                importer->state = HTML_COMMENT;
+                tag->len = 0;  // counts trailing dashes from here on
+            }
+            break;
+        case HTML_TAG_QUOTE:
+            import_field_push(tag, c);
+            if (c == '"') importer->state = HTML_TAG;
+            break;
+        case HTML_COMMENT:
+            if (c == '>' && tag->len >= 2) {
+                importer->state = HTML_TEXT;
+            } else {
+                tag->len = c == '-' ? tag->len + 1 : 0;
+            }
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------- JSON
+
+/**
+ * Which bookmark field a member name feeds
+ */
+int import_json_key(const char *name) {
+    if (strcmp(name, "title") == 0 || strcmp(name, "name") == 0) return KEY_TITLE;
+    if (strcmp(name, "url") == 0 || strcmp(name, "uri") == 0 || strcmp(name, "href") == 0) return KEY_URL;
+    if (strcmp(name, "category") == 0 || strcmp(name, "folder") == 0) return KEY_CATEGORY;
+    if (strcmp(name, "createdAt") == 0 || strcmp(name, "created_at") == 0) return KEY_DATE_MS;
+    if (strcmp(name, "dateAdded") == 0) return KEY_DATE_US;
+    if (strcmp(name, "date_added") == 0) return KEY_DATE_CHROME;
+    if (strcmp(name, "tags") == 0) return KEY_TAGS;
+    return KEY_OTHER;
+}
+
+/**
+ * A string or literal value finished at the current depth
+ * Bookmark fields are tagged with their depth so that an object only
+ * claims the url, category and date that are its own members.
+ */
+void import_json_value(BookmarkImporter *importer) {
+    int depth = importer->json_depth;
+    ImportField *tags = &importer->tags;
+    if (depth == importer->json_tags_array) {
+        // One string of a "tags" array
+        if (tags->len > 0) import_field_push(tags, ',');
+        for (int i = 0; i < importer->text.len; i++) import_field_push(tags, importer->text.data[i]);
+        return;
+    }
+    if (depth < 1 || depth > IMPORT_MAX_DEPTH || !importer->json_is_object[depth - 1]) return;
+    
+    ImportField *text = &importer->text;
+    text->data[text->len] = '\0';
+    switch (importer->json_key) {
+    case KEY_TITLE:
+        import_field_copy(&importer->json_name[depth - 1], text);
+        break;
+    case KEY_URL:
+        import_field_copy(&importer->url, text);
+        importer->json_url_depth = depth;
+        break;
+    case KEY_CATEGORY:
+        import_field_copy(&importer->category, text);
+        importer->json_category_depth = depth;
+        break;
+    case KEY_DATE_MS:
+        importer->created_at = strtoll(text->data, NULL, 10);
+        importer->json_date_depth = depth;
+        break;
+    case KEY_DATE_US:
+        importer->created_at = strtoll(text->data, NULL, 10) / 1000;
+        importer->json_date_depth = depth;
+        break;
+    case KEY_DATE_CHROME:
+        importer->created_at = strtoll(text->data, NULL, 10) / 1000 - CHROME_EPOCH_OFFSET_MS;
+        importer->json_date_depth = depth;
+        break;
+    case KEY_TAGS:
+        import_field_copy(tags, text);
+        importer->json_tags_depth = depth;
+        break;
+    }
+    importer->json_key = KEY_OTHER;
+}
+
+/**
+ * Closing an object: emit it if it had a url
+ */
+void import_json_close_object(BookmarkImporter *importer) {
+    int depth = importer->json_depth;
+    if (depth > IMPORT_MAX_DEPTH || importer->json_url_depth != depth) return;
+    
+    ImportField *category = NULL;
+    if (importer->json_category_depth == depth) {
+        category = &importer->category;
+    } else {
+        // Nearest enclosing object with a name: its folder
+        for (int d = depth - 2; d >= 0 && !category; d--) {
+            if (importer->json_is_object[d] && importer->json_name[d].len > 0) category = &importer->json_name[d];
+        }
+    }
+    if (importer->json_date_depth != depth) importer->created_at = 0;
+    ImportField *tags = importer->json_tags_depth == depth ? &importer->tags : NULL;
+    
+    import_emit(importer, &importer->json_name[depth - 1], category, tags);
+    importer->json_url_depth = importer->json_category_depth = importer->json_date_depth = -1;
+    importer->json_tags_depth = -1;
+}
+
+/**
+ * Structural byte or the start of a token
+ */
+void import_json_structure(BookmarkImporter *importer, char c) {
+    int depth = importer->json_depth;
+    switch (c) {
+    case '{':
+    case '[':
+        if (depth < IMPORT_MAX_DEPTH) {
+            importer->json_is_object[depth] = c == '{';
+            importer->json_expect_key[depth] = c == '{';
+            import_field_reset(&importer->json_name[depth]);
+        }
+        // Forget fields left by an earlier sibling that had no url
+        if (importer->json_url_depth == depth + 1) importer->json_url_depth = -1;
+        if (importer->json_category_depth == depth + 1) importer->json_category_depth = -1;
+        if (importer->json_date_depth == depth + 1) importer->json_date_depth = -1;
+        if (importer->json_tags_depth == depth + 1) importer->json_tags_depth = -1;
+        if (c == '[' && importer->json_key == KEY_TAGS && importer->json_tags_array < 0) {
+            import_field_reset(&importer->tags);
+            importer->json_tags_depth = depth;
+            importer->json_tags_array = depth + 1;
+        }
+        importer->json_depth++;
+        importer->json_key = KEY_OTHER;
+        break;
+    case '}':
+    case ']':
+        if (depth == 0) break;
+        if (c == '}') import_json_close_object(importer);
+        if (depth == importer->json_tags_array) importer->json_tags_array = -1;
+        importer->json_depth--;
+        importer->json_key = KEY_OTHER;
+        break;
+    case ',':
+        if (depth > 0 && depth <= IMPORT_MAX_DEPTH && importer->json_is_object[depth - 1]) {
+            importer->json_expect_key[depth - 1] = 1;
+        }
+        break;
+    case ':':
+        if (depth > 0 && depth <= IMPORT_MAX_DEPTH) importer->json_expect_key[depth - 1] = 0;
+        break;
+    case '"':
+        import_field_reset(&importer->text);
+        importer->json_high_surrogate = 0;
+        importer->state = JSON_STRING;
+        break;
+    default:
+        if (!isspace((unsigned char)c)) {
+            import_field_reset(&importer->text);
+            import_field_push(&importer->text, c);
+            importer->state = JSON_LITERAL;
+        }
+    }
+}
+
+/**
+ * A string token ended: member name or value
+ */
+void import_json_string_end(BookmarkImporter *importer) {
+    int depth = importer->json_depth;
+    importer->state = JSON_VALUE;
+    if (depth > 0 && depth <= IMPORT_MAX_DEPTH && importer->json_is_object[depth - 1] &&
+        importer->json_expect_key[depth - 1]) {
+        importer->text.data[importer->text.len] = '\0';
+        importer->json_key = import_json_key(importer->text.data);
+    } else {
+        import_json_value(importer);
+    }
+}
+
+/**
+ * JSON state machine over one chunk
+ */
+void import_json_feed(BookmarkImporter *importer, const char *data, size_t len) {
+    ImportField *text = &importer->text;
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        switch (importer->state) {
+        case JSON_VALUE:
+            import_json_structure(importer, c);
+            break;
+        case JSON_STRING:
+            if (c == '"') {
+                import_json_string_end(importer);
+            } else if (c == '\\') {
+                importer->state = JSON_ESCAPE;
+            } else {
+                import_field_push(text, c);
+            }
+            break;
+        case JSON_ESCAPE:
+            importer->state = JSON_STRING;
+            switch (c) {
+            case 'n': case 'r': case 't': import_field_push(text, ' '); break;
+            case 'b': case 'f': break;
+            case 'u':
+                importer->json_unicode = 0;
+                importer->json_unicode_digits = 0;
+                importer->state = JSON_UNICODE;
+                break;
+            default: import_field_push(text, c);  // " \ /
+            }
+            break;
+        case JSON_UNICODE:
+            importer->json_unicode = importer->json_unicode * 16 +
+                (isdigit((unsigned char)c) ? c - '0' : (tolower((unsigned char)c) - 'a' + 10) & 0xF);
+            if (++importer->json_unicode_digits < 4) break;
+            importer->state = JSON_STRING;
+            if (importer->json_unicode >= 0xD800 && importer->json_unicode < 0xDC00) {
+                importer->json_high_surrogate = importer->json_unicode;
+            } else if (importer->json_unicode >= 0xDC00 && importer->json_unicode < 0xE000) {
+                if (importer->json_high_surrogate) {
+                    import_field_push_utf8(text, 0x10000 + ((importer->json_high_surrogate - 0xD800) << 10) +
+                                                 (importer->json_unicode - 0xDC00));
+                }
+                importer->json_high_surrogate = 0;
+            } else {
+                import_field_push_utf8(text, importer->json_unicode);
+            }
+            break;
+        case JSON_LITERAL:
+            if (c == ',' || c == '}' || c == ']' || isspace((unsigned char)c)) {
+                importer->state = JSON_VALUE;
+                import_json_value(importer);
+                import_json_structure(importer, c);
+            } else {
+                import_field_push(text, c);
+            }
+            break;
+        }
+    }
+}
+
+// ----------------------------------------------------------------- CSV
+
+/**
+ * Map a header cell to a column role
+ */
+void import_csv_header_cell(BookmarkImporter *importer, int column, const char *name) {
+    if (strcasecmp(name, "title") == 0 || strcasecmp(name, "name") == 0) {
+        importer->csv_title_column = column;
+    } else if (strcasecmp(name, "url") == 0 || strcasecmp(name, "href") == 0 ||
+               strcasecmp(name, "link") == 0 || strcasecmp(name, "uri") == 0) {
+        importer->csv_url_column = column;
+    } else if (strcasecmp(name, "category") == 0 || strcasecmp(name, "folder") == 0 ||
+               strcasecmp(name, "tags") == 0) {
+        importer->csv_category_column = column;
+    }
+}
+
+/**
+ * A cell ended; route it by column
+ * Header cells are also kept positionally in case the first row turns
+ * out to be data.
+ */
+void import_csv_cell(BookmarkImporter *importer) {
+    ImportField *cell = &importer->text;
+    int column = importer->csv_column++;
+    
+    if (!importer->csv_header_done) {
+        import_csv_header_cell(importer, column, import_field_text(cell));
+        if (column == 0) import_field_copy(&importer->title, cell);
+        if (column == 1) import_field_copy(&importer->url, cell);
+        if (column == 2) import_field_copy(&importer->category, cell);
+    } else if (column == importer->csv_title_column) {
+        import_field_copy(&importer->title, cell);
+    } else if (column == importer->csv_url_column) {
+        import_field_copy(&importer->url, cell);
+    } else if (column == importer->csv_category_column) {
+        import_field_copy(&importer->category, cell);
+    }
+    import_field_reset(cell);
+}
+
+/**
+ * A row ended: header, blank line or bookmark
+ */
+void import_csv_row(BookmarkImporter *importer) {
+    int blank = importer->csv_column == 1 && importer->url.len == 0 && importer->title.len == 0;
+    
+    if (!importer->csv_header_done) {
+        importer->csv_header_done = 1;
+        if (importer->csv_url_column < 0 && !blank) {
+            // No url header: positional columns, and this row is data
+            importer->csv_title_column = 0;
+            importer->csv_url_column = 1;
+            importer->csv_category_column = 2;
+            import_emit(importer, &importer->title, &importer->category, NULL);
+        } else if (blank) {
+            importer->csv_header_done = 0;
+        }
+    } else if (!blank) {
+        import_emit(importer, &importer->title, &importer->category, NULL);
+    }
+    
+    importer->csv_column = 0;
+    import_field_reset(&importer->title);
+    import_field_reset(&importer->url);
+    import_field_reset(&importer->category);
+}
+
+/**
+ * CSV state machine over one chunk
+ */
+void import_csv_feed(BookmarkImporter *importer, const char *data, size_t len) {
+    ImportField *cell = &importer->text;
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\r' && importer->state != CSV_QUOTED) continue;
+        
+        switch (importer->state) {
+        case CSV_QUOTED:
+            if (c == '"') {
+                importer->state = CSV_QUOTE;
+            } else {
+                import_field_push(cell, c);
+            }
+            break;
+        case CSV_QUOTE:
+            if (c == '"') {
+                import_field_push(cell, '"');
+                importer->state = CSV_QUOTED;
+                break;
+            }
+            importer->state = CSV_UNQUOTED;
+            // fall through - the quote closed the field
+        case CSV_FIELD_START:
+        case CSV_UNQUOTED:
+            if (c == ',') {
+                import_csv_cell(importer);
+                importer->state = CSV_FIELD_START;
+            } else if (c == '\n') {
+                import_csv_cell(importer);
+                import_csv_row(importer);
+                importer->state = CSV_FIELD_START;
+            } else if (c == '"' && importer->state == CSV_FIELD_START) {
+                importer->state = CSV_QUOTED;
+            } else {
+                import_field_push(cell, c);
+                importer->state = CSV_UNQUOTED;
+            }
+            break;
+        }
+    }
+}
+
+// -------------------------------------------------------------- Driver
+
+/**
+ * Pick a format from the first non-blank byte (after a UTF-8 BOM)
+ * Returns the number of bytes to skip, or -1 if data is still all blank
+ */
+int import_detect_format(BookmarkImporter *importer, const char *data, size_t len) {
+    static const char bom[] = "\xEF\xBB\xBF";
+    size_t i = 0;
+    while (i < len) {
+        long long offset = importer->stats.bytes + i;  // the BOM may be split across chunks
+        if (!(offset < 3 && data[i] == bom[offset]) && !isspace((unsigned char)data[i])) break;
+        i++;
+    }
+    if (i == len) return -1;
+    
+    if (data[i] == '<') {
+        importer->format = IMPORT_FORMAT_HTML;
+    } else if (data[i] == '[' || data[i] == '{') {
+        importer->format = IMPORT_FORMAT_JSON;
+    } else {
+        importer->format = IMPORT_FORMAT_CSV;
+    }
+    return (int)i;
+}
+
+/**
+ * Parse the next chunk of input
+ * Time Complexity: O(len) plus the store adds it triggers
+ */
+void bookmark_importer_feed(BookmarkImporter *importer, const char *data, size_t len) {
+    if (importer->format == IMPORT_FORMAT_AUTO) {
+        int skip = import_detect_format(importer, data, len);
+        importer->stats.bytes += len;
+        if (skip < 0) return;
+        data += skip;
+        len -= skip;
+    } else {
+        importer->stats.bytes += len;
+    }
+    
+    switch (importer->format) {
+    case IMPORT_FORMAT_HTML: import_html_feed(importer, data, len); break;
+    case IMPORT_FORMAT_JSON: import_json_feed(importer, data, len); break;
+    case IMPORT_FORMAT_CSV: import_csv_feed(importer, data, len); break;
+    default: break;
+    }
+}
+
+/**
+ * End of input: flush a last unterminated CSV row, build the trie and
+ * heap in one pass and free the importer
+ * Time Complexity: O(n + b log b) for b = bookmarks added (see bookmark_store_end_bulk)
+ */
+void bookmark_importer_finish(BookmarkImporter *importer, BookmarkImportStats *stats_out) {
+    if (importer->format == IMPORT_FORMAT_CSV &&
+        (importer->csv_column > 0 || importer->text.len > 0 || importer->state == CSV_QUOTED)) {
+        import_csv_cell(importer);
+        import_csv_row(importer);
+    }
+    
+    bookmark_store_end_bulk(importer->store);
+    if (stats_out) *stats_out = importer->stats;
+    
+    free(importer->title.data);
+    free(importer->url.data);
+    free(importer->category.data);
+    free(importer->tags.data);
+    free(importer->text.data);
+    free(importer->pending_folder.data);
+    for (int d = 0; d < IMPORT_MAX_DEPTH; d++) {
+        free(importer->folders[d].data);
+        free(importer->json_name[d].data);
+    }
+    free(importer);
+}
+
+/**
+ * Import a file in IMPORT_CHUNK_SIZE reads
+ * Returns 0 if the file cannot be read
+ * Time Complexity: O(file size + b log b)
+ */
+int bookmark_import_file(BookmarkStore *store, const char *path, BookmarkImportFormat format,
+                         BookmarkImportStats *stats_out) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+    
+    char *chunk = (char *)malloc(IMPORT_CHUNK_SIZE);
+    BookmarkImporter *importer = bookmark_importer_create(store, format);
+    size_t got;
+    while ((got = fread(chunk, 1, IMPORT_CHUNK_SIZE, file)) > 0) {
+        bookmark_importer_feed(importer, chunk, got);
+    }
+    int ok = !ferror(file);
+    
+    bookmark_importer_finish(importer, stats_out);
+    free(chunk);
+    fclose(file);
+    return ok;
+}
+
+#ifndef BOOKMARK_IMPORT_NO_MAIN
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define DEMO_DEFAULT_BOOKMARKS 1000000
+
+/**
+ * Monotonic seconds
+ */
+double import_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Write a synthetic export of n bookmarks (10% repeated urls)
+ */
+void import_write_demo(const char *path, BookmarkImportFormat format, int n) {
+    static const char *folders[] = { "Development", "News & Media", "Recipes", "Travel", "Music" };
+    FILE *file = fopen(path, "w");
+    
+    if (format == IMPORT_FORMAT_HTML) {
+        fprintf(file, "<!DOCTYPE NETSCAPE-Bookmark-file-1>\n<!-- This is an automatically generated file. -->\n"
+                      "<TITLE>Bookmarks</TITLE>\n<H1>Bookmarks</H1>\n<DL><p>\n");
+    } else if (format == IMPORT_FORMAT_JSON) {
+        fprintf(file, "[\n");
+    } else {
+        fprintf(file, "title,url,category\n");
+    }
+    
+    int per_folder = n / 5 + 1;
+    for (int i = 0; i < n; i++) {
+        int u = i % 10 == 9 ? i - 9 : i;  // every tenth url repeats an earlier one
+        const char *folder = folders[i / per_folder];
+        const char *parity = i % 2 ? "odd" : "even";
+        if (format == IMPORT_FORMAT_HTML) {
+            if (i % per_folder == 0) fprintf(file, "    <DT><H3 ADD_DATE=\"1700000000\">%s</H3>\n    <DL><p>\n",
+                                             i / per_folder == 1 ? "News &amp; Media" : folder);
+            fprintf(file, "        <DT><A HREF=\"https://site%d.example.com/page?id=%d&amp;ref=bm\" "
+                          "ADD_DATE=\"%d\" TAGS=\"demo,%s\">Page %d &#8211; %s</A>\n", u % 5000, u, 1700000000 + i,
+                    parity, i, folder);
+            if (i % per_folder == per_folder - 1 || i == n - 1) fprintf(file, "    </DL><p>\n");
+        } else if (format == IMPORT_FORMAT_JSON) {
+            fprintf(file, "  {\"title\": \"Page %d \\u2013 \\\"%s\\\"\", \"url\": \"https://site%d.example.com/page?id=%d\","
+                          " \"category\": \"%s\", \"tags\": [\"demo\", \"%s\"], \"createdAt\": %lld}%s\n",
+                    i, folder, u % 5000, u, folder, parity, 1700000000000LL + i, i == n - 1 ? "" : ",");
+        } else {
+            fprintf(file, "\"Page %d, \"\"%s\"\"\",https://site%d.example.com/page?id=%d,%s\n", i, folder, u % 5000, u,
+                    folder);
+        }
+    }
+    
+    if (format == IMPORT_FORMAT_HTML) fprintf(file, "</DL><p>\n");
+    if (format == IMPORT_FORMAT_JSON) fprintf(file, "]\n");
+    fclose(file);
+}
+
+/**
+ * Import one file into a fresh store and report
+ */
+void import_run(const char *label, const char *path) {
+    BookmarkStore *store = bookmark_store_create(20);
+    BookmarkImportStats stats;
+    
+    double start = import_now();
+    if (!bookmark_import_file(store, path, IMPORT_FORMAT_AUTO, &stats)) {
+        printf("   %s: cannot read %s\n", label, path);
+        bookmark_store_free(store);
+        return;
+    }
+    double elapsed = import_now() - start;
+    
+    printf("   %-5s %8ld parsed, %8ld added, %7ld duplicates, %ld rejected, %.1f MB in %.2f s = %.1fM bookmarks/min\n",
+           label, stats.parsed, stats.added, stats.duplicates, stats.rejected, stats.bytes / 1048576.0, elapsed,
+           stats.parsed / elapsed * 60 / 1e6);
+    
+    BookmarkId ids[1];
+    if (bookmark_store_search(store, "page 1", 1, ids) == 1) {
+        const BookmarkRecord *record = bookmark_store_get(store, ids[0]);
+        const char *tags[4];
+        int tag_count = bookmark_store_tags_of(store, ids[0], tags, 4);
+        printf("         e.g. \"%s\"  %s  [%s]", record->title, record->url, record->category);
+        for (int t = 0; t < tag_count; t++) printf(" #%s", tags[t]);
+        printf("\n");
+    }
+    bookmark_store_free(store);
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    printf("=== Streaming Bookmark Importer in C ===\n");
+    printf("Data Structure: Chunked push parsers feeding a bulk-mode store\n\n");
+    
+    if (argc > 2 && strcmp(argv[1], "--file") == 0) {
+        import_run("file", argv[2]);
+        return 0;
+    }
+    
+    int n = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_BOOKMARKS;
+    if (n < 1) n = DEMO_DEFAULT_BOOKMARKS;
+    
+    printf("1. Writing exports with %d bookmarks each (every 10th url repeats)\n\n", n);
+    import_write_demo("import_demo.html", IMPORT_FORMAT_HTML, n);
+    import_write_demo("import_demo.json", IMPORT_FORMAT_JSON, n);
+    import_write_demo("import_demo.csv", IMPORT_FORMAT_CSV, n);
+    
+    printf("2. Importing (%d KB chunks, format auto-detected)\n", IMPORT_CHUNK_SIZE / 1024);
+    import_run("HTML", "import_demo.html");
+    import_run("JSON", "import_demo.json");
+    import_run("CSV", "import_demo.csv");
+    
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("\n   Peak RSS %.1f MB (the store itself; parser state is fixed-size)\n", usage.ru_maxrss / 1024.0);
+    
+    unlink("import_demo.html");
+    unlink("import_demo.json");
+    unlink("import_demo.csv");
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
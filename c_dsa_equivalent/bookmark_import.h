@@ -0,0 +1,98 @@
+/**
+ * Bookmark Import Interface
+ * Streaming importer for Netscape HTML, JSON and CSV bookmark exports
+ * (see bookmark_import.c for the accepted shapes)
+ */
+
+#ifndef BOOKMARK_IMPORT_H
+#define BOOKMARK_IMPORT_H
+
+#include "bookmark_store.h"
+
+#define IMPORT_CHUNK_SIZE 65536      // bytes read per call to the parser
+#define IMPORT_MAX_TITLE 1024        // longer titles are truncated
+#define IMPORT_MAX_URL 8192          // longer urls are rejected
+#define IMPORT_MAX_CATEGORY 256      // longer categories are truncated
+#define IMPORT_MAX_TAGS 1024         // comma-separated tags kept per bookmark
+#define IMPORT_MAX_TAG 16384         // HTML tag text kept for attribute parsing
+#define IMPORT_MAX_DEPTH 64          // folder / JSON nesting tracked
+
+typedef enum {
+    IMPORT_FORMAT_AUTO,
+    IMPORT_FORMAT_HTML,
+    IMPORT_FORMAT_JSON,
+    IMPORT_FORMAT_CSV
+} BookmarkImportFormat;
+
+typedef struct {
+    long parsed;                 // bookmarks found in the input
+    long added;
+    long duplicates;             // url already in the store
+    long rejected;               // no url, or url too long
+    long long bytes;
+} BookmarkImportStats;
+
+/**
+ * Bounded text buffer for one field
+ */
+typedef struct {
+    char *data;
+    int len;
+    int cap;                     // max bytes kept (without terminator)
+    int overflow;                // input was longer than cap
+} ImportField;
+
+/**
+ * Push parser state; feed it chunks of any size
+ */
+typedef struct {
+    BookmarkStore *store;
+    BookmarkImportFormat format;
+    BookmarkImportStats stats;
+    int state;
+    
+    ImportField title;
+    ImportField url;
+    ImportField category;
+    ImportField tags;            // comma-separated
+    ImportField text;            // HTML tag / JSON string / CSV cell in progress
+    long long created_at;        // ms, 0 if the export has none
+    
+    // HTML: folder stack (H3 names, pushed on <DL>)
+    ImportField folders[IMPORT_MAX_DEPTH];
+    int folder_depth;
+    ImportField pending_folder;
+    int capture;                 // 0, or which field element text goes to
+    int entity;                  // bytes of a pending &entity; in text, -1 if none
+    char entity_buf[12];
+    
+    // JSON: one frame per open object / array
+    unsigned char json_is_object[IMPORT_MAX_DEPTH];
+    unsigned char json_expect_key[IMPORT_MAX_DEPTH];
+    ImportField json_name[IMPORT_MAX_DEPTH];     // object's title/name (folders)
+    int json_depth;
+    int json_key;                // field the next value fills
+    unsigned int json_unicode;   // \uXXXX escape in progress
+    int json_unicode_digits;
+    unsigned int json_high_surrogate;
+    int json_url_depth;          // depth of the object that set url, -1 if none
+    int json_category_depth;     // ... category
+    int json_date_depth;         // ... created_at
+    int json_tags_depth;         // ... tags
+    int json_tags_array;         // depth of an open "tags": [...] array, -1 if none
+    
+    // CSV: header-mapped columns
+    int csv_column;
+    int csv_title_column;
+    int csv_url_column;
+    int csv_category_column;
+    int csv_header_done;
+} BookmarkImporter;
+
+BookmarkImporter *bookmark_importer_create(BookmarkStore *store, BookmarkImportFormat format);
+void bookmark_importer_feed(BookmarkImporter *importer, const char *data, size_t len);
+void bookmark_importer_finish(BookmarkImporter *importer, BookmarkImportStats *stats_out);
+int bookmark_import_file(BookmarkStore *store, const char *path, BookmarkImportFormat format,
+                         BookmarkImportStats *stats_out);
+
+#endif
@@ -0,0 +1,793 @@
+/**
+ * Bookmark Snapshot Implementation in C
+ * Persists a BookmarkStore as one versioned binary file that can be
+ * mmap'ed and queried read-only with no parsing
+ * 
+ * Layout: a fixed header at offset 0 followed by 8-byte aligned
+ * sections, located by (offset, length) pairs in the header:
+ *   RECORDS         fixed-size records; strings are relative offsets
+ *   STRINGS         title\0url\0category\0 of each live record
+ *   FREE_IDS        ids waiting to be reused
+ *   URL_INDEX       the store's (hash, id) slots, as in memory
+ *   TRIE_CLASSES    node arena size class metadata
+ *   TRIE_SLOTS      the title trie's node arena as a flat image
+ *   HEAP_ENTRIES    least-used (frecency) heap entries in heap order
+ *   HEAP_POSITIONS  heap id -> index map
+ *   TAG_NAMES       tag names in tag id order
+ *   TAG_LINKS       (bookmark id, tag id) pairs, bookmark by bookmark
+ * Nothing in the file is a pointer. Trie links are arena handles, which
+ * resolve against the flat image once the slab table points into it, and
+ * the heap and URL index hold plain ids, so opening a snapshot is mmap,
+ * a header check and O(slabs) setup, independent of bookmark count.
+ * 
+ * The file is native-endian; the header records the byte order, version
+ * and record size, and open rejects anything it cannot map as-is.
+ * Section bounds are checked on open, record string offsets on access;
+ * the trie and heap contents are trusted (files come from
+ * bookmark_snapshot_save, not from untrusted sources).
+ * 
+ * Saving writes path.tmp, fsyncs it, renames it over path and fsyncs the
+ * directory, so readers see either the old snapshot or the new one. A
+ * snapshot already mapped keeps the old file alive until it is closed.
+ * 
+ * bookmark_snapshot_load copies a snapshot into an ordinary mutable store
+ * (memcpy of the arrays plus one string block per record), for callers
+ * that want to keep adding and visiting after startup. The full-text
+ * index, category bitmaps and sorted views are not part of the file:
+ * mapped snapshots have no text search, category filter or paged views,
+ * and load rebuilds them from the records. Tags are saved only as the
+ * links between bookmarks and tag names, so mapped snapshots have no tag
+ * queries either; load re-interns the names and rebuilds the postings.
+ * 
+ * Compile: gcc -O2 -DBOOKMARK_STORE_NO_MAIN -DTRIE_NO_MAIN -DMIN_HEAP_NO_MAIN -DHASH_TABLE_NO_MAIN -DBOOKMARK_TEXT_NO_MAIN -DROARING_BITMAP_NO_MAIN -DBPLUS_TREE_NO_MAIN -DBOOKMARK_TAGS_NO_MAIN -o bookmark_snapshot bookmark_snapshot.c bookmark_store.c bookmark_text.c roaring_bitmap.c bookmark_tags.c bplus_tree.c trie.c min_heap.c hash_table.c node_arena.c -lm
+ * Run: ./bookmark_snapshot [bookmarks] [path]
+ * Define BOOKMARK_SNAPSHOT_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bookmark_snapshot.h"
+
+#define SNAPSHOT_ALIGN 8
+#define SNAPSHOT_WRITE_BUFFER (1 << 20)
+
+/**
+ * Sequential writer that tracks the file offset for the section table
+ */
+typedef struct {
+    FILE *file;
+    uint64_t offset;
+    BookmarkSnapshotHeader *header;
+    int failed;
+} BookmarkSnapshotWriter;
+
+/**
+ * Append bytes to the snapshot
+ */
+void bookmark_snapshot_write(BookmarkSnapshotWriter *writer, const void *data, size_t bytes) {
+    if (bytes == 0 || writer->failed) return;
+    if (fwrite(data, 1, bytes, writer->file) != bytes) writer->failed = 1;
+    writer->offset += bytes;
+}
+
+/**
+ * Pad to SNAPSHOT_ALIGN and start a section at the current offset
+ */
+void bookmark_snapshot_begin(BookmarkSnapshotWriter *writer, int section) {
+    static const char zeros[SNAPSHOT_ALIGN] = { 0 };
+    bookmark_snapshot_write(writer, zeros, (SNAPSHOT_ALIGN - writer->offset % SNAPSHOT_ALIGN) % SNAPSHOT_ALIGN);
+    writer->header->sections[section].offset = writer->offset;
+}
+
+/**
+ * Close a section: its length is everything written since it began
+ */
+void bookmark_snapshot_end(BookmarkSnapshotWriter *writer, int section) {
+    BookmarkSnapshotSection *s = &writer->header->sections[section];
+    s->length = writer->offset - s->offset;
+}
+
+/**
+ * fsync the directory holding path so a rename into it is durable
+ */
+int bookmark_snapshot_sync_dir(const char *path) {
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else if (slash == path) {
+        strcpy(dir, "/");
+    } else {
+        size_t len = slash - path;
+        if (len >= sizeof(dir)) return 0;
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+/**
+ * Write every section of the store (header last, once offsets are known)
+ * Time Complexity: O(n + trie bytes)
+ */
+int bookmark_snapshot_write_store(BookmarkStore *store, BookmarkSnapshotWriter *writer) {
+    BookmarkSnapshotHeader *header = writer->header;
+    Trie *titles = store->titles;
+    MinHeap *heap = store->least_visited;
+    
+    memset(header, 0, sizeof(*header));
+    bookmark_snapshot_write(writer, header, sizeof(*header));  // placeholder
+    
+    // Records, with string offsets assigned in order
+    bookmark_snapshot_begin(writer, SNAPSHOT_RECORDS);
+    uint64_t text_offset = 0;
+    for (int id = 0; id < store->record_count; id++) {
+        BookmarkRecord *record = &store->records[id];
+        BookmarkSnapshotRecord out;
+        memset(&out, 0, sizeof(out));
+        out.created_at = record->created_at;
+        out.last_visited = record->last_visited;
+        out.visit_count = record->visit_count;
+        out.frecency = record->frecency;
+        out.url_hash = record->url_hash;
+        out.recent_prev = record->recent_prev;
+        out.recent_next = record->recent_next;
+        out.live = record->live;
+        out.in_recent = record->in_recent;
+        if (record->live) {
+            out.text_offset = text_offset;
+            out.url_offset = record->url - record->title;
+            out.category_offset = record->category - record->title;
+            out.text_length = out.category_offset + strlen(record->category) + 1;
+            text_offset += out.text_length;
+        }
+        bookmark_snapshot_write(writer, &out, sizeof(out));
+    }
+    bookmark_snapshot_end(writer, SNAPSHOT_RECORDS);
+    
+    // Strings: title, url and category are one block per record
+    bookmark_snapshot_begin(writer, SNAPSHOT_STRINGS);
+    for (int id = 0; id < store->record_count; id++) {
+        BookmarkRecord *record = &store->records[id];
+        if (!record->live) continue;
+        size_t length = (record->category - record->title) + strlen(record->category) + 1;
+        bookmark_snapshot_write(writer, record->title, length);
+    }
+    bookmark_snapshot_end(writer, SNAPSHOT_STRINGS);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_FREE_IDS);
+    bookmark_snapshot_write(writer, store->free_ids, store->free_count * sizeof(BookmarkId));
+    bookmark_snapshot_end(writer, SNAPSHOT_FREE_IDS);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_URL_INDEX);
+    bookmark_snapshot_write(writer, store->url_index, store->url_index_size * sizeof(BookmarkUrlSlot));
+    bookmark_snapshot_end(writer, SNAPSHOT_URL_INDEX);
+    
+    // Trie: class metadata, then the arena image
+    bookmark_snapshot_begin(writer, SNAPSHOT_TRIE_CLASSES);
+    for (int i = 0; i < titles->arena.class_count; i++) {
+        NodeSizeClass *size_class = &titles->arena.classes[i];
+        BookmarkSnapshotArenaClass out = {
+            size_class->slot_size, size_class->slab_shift, size_class->next_unused,
+            size_class->free_list, size_class->live, 0
+        };
+        bookmark_snapshot_write(writer, &out, sizeof(out));
+    }
+    bookmark_snapshot_end(writer, SNAPSHOT_TRIE_CLASSES);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_TRIE_SLOTS);
+    if (!writer->failed && !node_arena_write(&titles->arena, writer->file)) writer->failed = 1;
+    for (int i = 0; i < titles->arena.class_count; i++) {
+        writer->offset += node_arena_class_bytes(&titles->arena.classes[i]);
+    }
+    bookmark_snapshot_end(writer, SNAPSHOT_TRIE_SLOTS);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_HEAP_ENTRIES);
+    bookmark_snapshot_write(writer, heap->entries, heap->size * sizeof(HeapEntry));
+    bookmark_snapshot_end(writer, SNAPSHOT_HEAP_ENTRIES);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_HEAP_POSITIONS);
+    bookmark_snapshot_write(writer, heap->positions, heap->id_capacity * sizeof(int));
+    bookmark_snapshot_end(writer, SNAPSHOT_HEAP_POSITIONS);
+    
+    // Tags: names by id, then each live bookmark's links
+    BookmarkTagIndex *tags = store->tags;
+    bookmark_snapshot_begin(writer, SNAPSHOT_TAG_NAMES);
+    bookmark_snapshot_write(writer, tags->strings, tags->strings_used);
+    bookmark_snapshot_end(writer, SNAPSHOT_TAG_NAMES);
+    
+    bookmark_snapshot_begin(writer, SNAPSHOT_TAG_LINKS);
+    uint32_t tag_links = 0;
+    for (int id = 0; id < store->record_count; id++) {
+        const uint32_t *of;
+        int count = store->records[id].live ? bookmark_tags_of(tags, id, &of) : 0;
+        for (int i = 0; i < count; i++) {
+            uint32_t link[2] = { (uint32_t)id, of[i] };
+            bookmark_snapshot_write(writer, link, sizeof(link));
+        }
+        tag_links += count;
+    }
+    bookmark_snapshot_end(writer, SNAPSHOT_TAG_LINKS);
+    
+    // Real header
+    memcpy(header->magic, BOOKMARK_SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = BOOKMARK_SNAPSHOT_VERSION;
+    header->byte_order = BOOKMARK_SNAPSHOT_BYTE_ORDER;
+    header->header_size = sizeof(BookmarkSnapshotHeader);
+    header->record_size = sizeof(BookmarkSnapshotRecord);
+    header->file_size = writer->offset;
+    header->record_count = store->record_count;
+    header->live_count = store->live_count;
+    header->free_count = store->free_count;
+    header->max_recent = store->max_recent;
+    header->recent_head = store->recent_head;
+    header->recent_tail = store->recent_tail;
+    header->recent_count = store->recent_count;
+    header->url_index_size = store->url_index_size;
+    header->trie_root = titles->root;
+    header->trie_word_count = titles->word_count;
+    header->trie_flags = titles->flags;
+    header->trie_class_count = titles->arena.class_count;
+    header->heap_size = heap->size;
+    header->heap_id_capacity = heap->id_capacity;
+    header->heap_arity_shift = heap->arity_shift;
+    header->mutations = store->mutations;
+    header->tag_count = tags->tag_count;
+    header->tag_link_count = tag_links;
+    header->frecency_epoch = store->frecency_epoch;
+    header->frecency_half_life = store->frecency_half_life;
+    
+    if (writer->failed || fseek(writer->file, 0, SEEK_SET) != 0) return 0;
+    return fwrite(header, sizeof(*header), 1, writer->file) == 1;
+}
+
+/**
+ * Save the store to path atomically (temp file, fsync, rename)
+ * Returns 1 on success; on failure path is left untouched
+ * Time Complexity: O(n + trie bytes)
+ */
+int bookmark_snapshot_save(BookmarkStore *store, const char *path) {
+    bookmark_store_end_bulk(store);  // the trie and heap must be complete
+    
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return 0;
+    
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    FILE *file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(tmp_path);
+        return 0;
+    }
+    setvbuf(file, NULL, _IOFBF, SNAPSHOT_WRITE_BUFFER);
+    
+    BookmarkSnapshotHeader header;
+    BookmarkSnapshotWriter writer = { file, 0, &header, 0 };
+    int ok = bookmark_snapshot_write_store(store, &writer);
+    
+    ok = ok && fflush(file) == 0 && fsync(fd) == 0;
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok) {
+        unlink(tmp_path);
+        return 0;
+    }
+    
+    bookmark_snapshot_sync_dir(path);
+    return 1;
+}
+
+/**
+ * Check a mapped header: identity, layout and section bounds
+ * Returns 1 if the file can be used as-is
+ * Time Complexity: O(1)
+ */
+int bookmark_snapshot_check(const BookmarkSnapshotHeader *header, size_t size) {
+    if (size < sizeof(BookmarkSnapshotHeader)) return 0;
+    if (memcmp(header->magic, BOOKMARK_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) return 0;
+    if (header->version != BOOKMARK_SNAPSHOT_VERSION) return 0;
+    if (header->byte_order != BOOKMARK_SNAPSHOT_BYTE_ORDER) return 0;
+    if (header->header_size != sizeof(BookmarkSnapshotHeader)) return 0;
+    if (header->record_size != sizeof(BookmarkSnapshotRecord)) return 0;
+    if (header->file_size != size) return 0;
+    
+    for (int i = 0; i < SNAPSHOT_SECTION_COUNT; i++) {
+        const BookmarkSnapshotSection *s = &header->sections[i];
+        if (s->offset % SNAPSHOT_ALIGN != 0 || s->offset > size || s->length > size - s->offset) return 0;
+    }
+    
+    const BookmarkSnapshotSection *sections = header->sections;
+    if (header->url_index_size == 0 || (header->url_index_size & (header->url_index_size - 1))) return 0;
+    if (header->heap_size > header->heap_id_capacity) return 0;
+    if (header->frecency_half_life <= 0) return 0;
+    return sections[SNAPSHOT_RECORDS].length == (uint64_t)header->record_count * sizeof(BookmarkSnapshotRecord) &&
+           sections[SNAPSHOT_FREE_IDS].length == (uint64_t)header->free_count * sizeof(BookmarkId) &&
+           sections[SNAPSHOT_URL_INDEX].length == (uint64_t)header->url_index_size * sizeof(BookmarkUrlSlot) &&
+           sections[SNAPSHOT_TRIE_CLASSES].length ==
+               (uint64_t)header->trie_class_count * sizeof(BookmarkSnapshotArenaClass) &&
+           sections[SNAPSHOT_HEAP_ENTRIES].length == (uint64_t)header->heap_size * sizeof(HeapEntry) &&
+           sections[SNAPSHOT_HEAP_POSITIONS].length == (uint64_t)header->heap_id_capacity * sizeof(int) &&
+           sections[SNAPSHOT_TAG_LINKS].length == (uint64_t)header->tag_link_count * 2 * sizeof(uint32_t);
+}
+
+/**
+ * Restore saved size class metadata into an arena built from the same
+ * slot sizes, checking the image covers every class
+ * Returns 0 if the saved classes do not match the arena
+ */
+int bookmark_snapshot_restore_classes(NodeArena *arena, const BookmarkSnapshotArenaClass *saved,
+                                      int class_count, uint64_t image_length) {
+    if (arena->class_count != class_count) return 0;
+    
+    uint64_t bytes = 0;
+    for (int i = 0; i < class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        if (size_class->slot_size != saved[i].slot_size || size_class->slab_shift != saved[i].slab_shift ||
+            saved[i].next_unused == 0 || saved[i].next_unused > NODE_INDEX_MASK + 1) {
+            return 0;
+        }
+        size_class->next_unused = saved[i].next_unused;
+        size_class->free_list = saved[i].free_list;
+        size_class->live = saved[i].live;
+        bytes += node_arena_class_bytes(size_class);
+    }
+    return bytes == image_length;
+}
+
+/**
+ * Map a snapshot read-only
+ * Only the header is read; records, strings and index pages are faulted
+ * in by the queries that touch them.
+ * Returns NULL if the file is missing, truncated or of another version
+ * Time Complexity: O(s) where s = number of trie slabs
+ */
+BookmarkSnapshot *bookmark_snapshot_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(BookmarkSnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+    
+    size_t size = st.st_size;
+    char *base = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file open
+    if (base == MAP_FAILED) return NULL;
+    
+    const BookmarkSnapshotHeader *header = (const BookmarkSnapshotHeader *)base;
+    if (!bookmark_snapshot_check(header, size)) {
+        munmap(base, size);
+        return NULL;
+    }
+    const BookmarkSnapshotSection *sections = header->sections;
+    
+    BookmarkSnapshot *snapshot = (BookmarkSnapshot *)calloc(1, sizeof(BookmarkSnapshot));
+    snapshot->base = base;
+    snapshot->size = size;
+    snapshot->header = header;
+    snapshot->records = (const BookmarkSnapshotRecord *)(base + sections[SNAPSHOT_RECORDS].offset);
+    snapshot->strings = base + sections[SNAPSHOT_STRINGS].offset;
+    snapshot->url_index = (const BookmarkUrlSlot *)(base + sections[SNAPSHOT_URL_INDEX].offset);
+    
+    // Trie: an arena with the saved classes whose slabs are the mapped image
+    const BookmarkSnapshotArenaClass *classes =
+        (const BookmarkSnapshotArenaClass *)(base + sections[SNAPSHOT_TRIE_CLASSES].offset);
+    unsigned int *slot_sizes = (unsigned int *)malloc((header->trie_class_count + 1) * sizeof(unsigned int));
+    for (uint32_t i = 0; i < header->trie_class_count; i++) slot_sizes[i] = classes[i].slot_size;
+    node_arena_init(&snapshot->titles.arena, slot_sizes, header->trie_class_count);
+    free(slot_sizes);
+    
+    if (!bookmark_snapshot_restore_classes(&snapshot->titles.arena, classes, header->trie_class_count,
+                                           sections[SNAPSHOT_TRIE_SLOTS].length)) {
+        node_arena_destroy(&snapshot->titles.arena);
+        munmap(base, size);
+        free(snapshot);
+        return NULL;
+    }
+    node_arena_map(&snapshot->titles.arena, base + sections[SNAPSHOT_TRIE_SLOTS].offset);
+    snapshot->titles.root = header->trie_root;
+    snapshot->titles.word_count = header->trie_word_count;
+    snapshot->titles.flags = header->trie_flags;
+    
+    // Heap: entries and positions straight from the file; no labels
+    MinHeap *heap = &snapshot->least_visited;
+    heap->entries = (HeapEntry *)(base + sections[SNAPSHOT_HEAP_ENTRIES].offset);
+    heap->size = heap->capacity = header->heap_size;
+    heap->arity_shift = header->heap_arity_shift;
+    heap->positions = (int *)(base + sections[SNAPSHOT_HEAP_POSITIONS].offset);
+    heap->id_capacity = header->heap_id_capacity;
+    heap->labels = (NodeHandle *)calloc(heap->id_capacity + 1, sizeof(NodeHandle));
+    
+    return snapshot;
+}
+
+/**
+ * Read a live record; string fields point into the mapping
+ * Returns 0 if id is not a live bookmark or its strings are out of bounds
+ * Time Complexity: O(1)
+ */
+int bookmark_snapshot_get(BookmarkSnapshot *snapshot, BookmarkId id, BookmarkRecord *out) {
+    if (id >= snapshot->header->record_count || !snapshot->records[id].live) return 0;
+    
+    const BookmarkSnapshotRecord *record = &snapshot->records[id];
+    uint64_t strings_length = snapshot->header->sections[SNAPSHOT_STRINGS].length;
+    if (record->text_length == 0 || record->text_offset > strings_length ||
+        record->text_length > strings_length - record->text_offset ||
+        record->url_offset >= record->text_length || record->category_offset >= record->text_length) {
+        return 0;
+    }
+    
+    char *text = (char *)snapshot->strings + record->text_offset;
+    if (text[record->text_length - 1] != '\0') return 0;
+    
+    out->title = text;
+    out->url = text + record->url_offset;
+    out->category = text + record->category_offset;
+    out->visit_count = record->visit_count;
+    out->frecency = record->frecency;
+    out->created_at = record->created_at;
+    out->last_visited = record->last_visited;
+    out->url_hash = record->url_hash;
+    out->recent_prev = record->recent_prev;
+    out->recent_next = record->recent_next;
+    out->live = 1;
+    out->in_recent = record->in_recent;
+    return 1;
+}
+
+/**
+ * Find a bookmark by url in the mapped URL index
+ * Returns its id, or BOOKMARK_NONE
+ * Time Complexity: O(1) average
+ */
+BookmarkId bookmark_snapshot_find_url(BookmarkSnapshot *snapshot, const char *url) {
+    if (!url) return BOOKMARK_NONE;
+    
+    uint32_t hash = bookmark_url_hash(url);
+    int mask = snapshot->header->url_index_size - 1;
+    for (int i = bookmark_url_home(snapshot->header->url_index_size, hash); ; i = (i + 1) & mask) {
+        const BookmarkUrlSlot *slot = &snapshot->url_index[i];
+        if (slot->id == BOOKMARK_NONE) return BOOKMARK_NONE;
+        
+        BookmarkRecord record;
+        if (slot->hash == hash && bookmark_snapshot_get(snapshot, slot->id, &record) &&
+            strcmp(record.url, url) == 0) {
+            return slot->id;
+        }
+    }
+}
+
+/**
+ * Titles starting with prefix, highest frecency first
+ * Time Complexity: O(m + k log k) for m = prefix length
+ */
+int bookmark_snapshot_search(BookmarkSnapshot *snapshot, const char *prefix, int k, BookmarkId *ids_out) {
+    return bookmark_titles_top_k(&snapshot->titles, prefix, k, ids_out);
+}
+
+/**
+ * Titles starting within max_distance typos of prefix, closest first
+ * Time Complexity: O(m * v + k log k) (see trie_search_fuzzy)
+ */
+int bookmark_snapshot_search_fuzzy(BookmarkSnapshot *snapshot, const char *prefix, int max_distance, int k,
+                                   BookmarkId *ids_out, int *distances_out) {
+    return bookmark_titles_fuzzy(&snapshot->titles, prefix, max_distance, k, ids_out, distances_out);
+}
+
+/**
+ * Most recently visited bookmarks at save time, newest first
+ * Time Complexity: O(k)
+ */
+int bookmark_snapshot_recent(BookmarkSnapshot *snapshot, int k, BookmarkId *ids_out) {
+    int count = 0;
+    for (BookmarkId id = snapshot->header->recent_head;
+         id < snapshot->header->record_count && count < k; id = snapshot->records[id].recent_next) {
+        ids_out[count++] = id;
+    }
+    return count;
+}
+
+/**
+ * Least used bookmarks, lowest frecency first
+ * Time Complexity: O(k d log(k d)) (see min_heap_extract_k)
+ */
+int bookmark_snapshot_least_visited(BookmarkSnapshot *snapshot, int k, BookmarkId *ids_out) {
+    return bookmark_heap_lowest(&snapshot->least_visited, k, ids_out);
+}
+
+/**
+ * Number of live bookmarks in the snapshot
+ */
+int bookmark_snapshot_count(BookmarkSnapshot *snapshot) {
+    return snapshot->header->live_count;
+}
+
+/**
+ * Unmap a snapshot
+ * Time Complexity: O(s) where s = number of trie slabs
+ */
+void bookmark_snapshot_close(BookmarkSnapshot *snapshot) {
+    node_arena_destroy(&snapshot->titles.arena);   // slab table only; slabs are the mapping
+    free(snapshot->least_visited.labels);
+    munmap(snapshot->base, snapshot->size);
+    free(snapshot);
+}
+
+/**
+ * Rebuild the tag index from the TAG_NAMES and TAG_LINKS sections
+ * Names are interned in saved order, so they get their saved ids back;
+ * links come bookmark by bookmark in id order, so every posting insert
+ * is an append.
+ * Returns 0 if the sections do not match the header
+ * Time Complexity: O(t + l) for t = tags, l = links
+ */
+int bookmark_snapshot_load_tags(BookmarkStore *store, BookmarkSnapshot *snapshot) {
+    const BookmarkSnapshotHeader *header = snapshot->header;
+    const char *names = snapshot->base + header->sections[SNAPSHOT_TAG_NAMES].offset;
+    uint64_t names_length = header->sections[SNAPSHOT_TAG_NAMES].length;
+    if (names_length > 0 && names[names_length - 1] != '\0') return 0;
+    
+    uint64_t at = 0;
+    for (uint32_t tag = 0; tag < header->tag_count; tag++) {
+        if (at >= names_length || bookmark_tags_intern(store->tags, names + at) != (int)tag) return 0;
+        at += strlen(names + at) + 1;
+    }
+    
+    const uint32_t *links = (const uint32_t *)(snapshot->base + header->sections[SNAPSHOT_TAG_LINKS].offset);
+    for (uint32_t i = 0; i < header->tag_link_count; i++) {
+        uint32_t id = links[2 * i], tag = links[2 * i + 1];
+        if (id >= header->record_count || !store->records[id].live || tag >= header->tag_count) return 0;
+        bookmark_tags_add(store->tags, id, (int)tag);
+    }
+    return 1;
+}
+
+/**
+ * Load a snapshot into a new mutable store
+ * Arrays are copied wholesale and the trie arena image is copied slab by
+ * slab; nothing is re-inserted. The full-text index, category bitmaps
+ * and sorted views are not saved: they are rebuilt from the records in id
+ * order (every text and category insert is an append; views are sorted
+ * and bulk-loaded). Tags are re-linked from the saved pairs.
+ * Returns NULL if the snapshot cannot be opened
+ * Time Complexity: O(n log n + trie bytes + text tokens + tag links)
+ */
+BookmarkStore *bookmark_snapshot_load(const char *path) {
+    BookmarkSnapshot *snapshot = bookmark_snapshot_open(path);
+    if (!snapshot) return NULL;
+    const BookmarkSnapshotHeader *header = snapshot->header;
+    const BookmarkSnapshotSection *sections = header->sections;
+    
+    BookmarkStore *store = bookmark_store_create(header->max_recent);
+    
+    // Trie: must use the same size classes as a trie built here
+    Trie *titles = trie_create_with(header->trie_flags);
+    const BookmarkSnapshotArenaClass *classes =
+        (const BookmarkSnapshotArenaClass *)(snapshot->base + sections[SNAPSHOT_TRIE_CLASSES].offset);
+    if (!bookmark_snapshot_restore_classes(&titles->arena, classes, header->trie_class_count,
+                                           sections[SNAPSHOT_TRIE_SLOTS].length)) {
+        trie_free(titles);
+        bookmark_store_free(store);
+        bookmark_snapshot_close(snapshot);
+        return NULL;
+    }
+    node_arena_load(&titles->arena, snapshot->base + sections[SNAPSHOT_TRIE_SLOTS].offset);
+    titles->root = header->trie_root;
+    titles->word_count = header->trie_word_count;
+    trie_free(store->titles);
+    store->titles = titles;
+    
+    // Records: one string block each, so delete can free them individually
+    int capacity = header->record_count > (uint32_t)store->record_capacity ? (int)header->record_count
+                                                                           : store->record_capacity;
+    store->records = (BookmarkRecord *)realloc(store->records, capacity * sizeof(BookmarkRecord));
+    store->record_capacity = capacity;
+    for (uint32_t id = 0; id < header->record_count; id++) {
+        BookmarkRecord *record = &store->records[id];
+        if (bookmark_snapshot_get(snapshot, id, record)) {
+            char *text = (char *)malloc(snapshot->records[id].text_length);
+            memcpy(text, record->title, snapshot->records[id].text_length);
+            record->url = text + (record->url - record->title);
+            record->category = text + (record->category - record->title);
+            record->title = text;
+            bookmark_derived_add(store, id);
+        } else {
+            memset(record, 0, sizeof(*record));
+            record->recent_prev = record->recent_next = BOOKMARK_NONE;
+        }
+    }
+    store->record_count = header->record_count;
+    store->live_count = header->live_count;
+    
+    BookmarkId *live = (BookmarkId *)malloc((header->live_count + 1) * sizeof(BookmarkId));
+    int live_count = 0;
+    for (uint32_t id = 0; id < header->record_count; id++) {
+        if (store->records[id].live) live[live_count++] = id;
+    }
+    bookmark_views_add(store, live, live_count);
+    free(live);
+    
+    store->free_capacity = header->free_count > 0 ? header->free_count : 1;
+    store->free_ids = (BookmarkId *)realloc(store->free_ids, store->free_capacity * sizeof(BookmarkId));
+    memcpy(store->free_ids, snapshot->base + sections[SNAPSHOT_FREE_IDS].offset,
+           header->free_count * sizeof(BookmarkId));
+    store->free_count = header->free_count;
+    
+    free(store->url_index);
+    store->url_index_size = header->url_index_size;
+    store->url_index = (BookmarkUrlSlot *)malloc(header->url_index_size * sizeof(BookmarkUrlSlot));
+    memcpy(store->url_index, snapshot->url_index, header->url_index_size * sizeof(BookmarkUrlSlot));
+    
+    // Heap: same arity, entries and positions copied as-is
+    min_heap_free(store->least_visited);
+    MinHeap *heap = min_heap_create_with(header->heap_id_capacity, 1 << header->heap_arity_shift);
+    memcpy(heap->entries, snapshot->least_visited.entries, header->heap_size * sizeof(HeapEntry));
+    memcpy(heap->positions, snapshot->least_visited.positions, header->heap_id_capacity * sizeof(int));
+    heap->size = header->heap_size;
+    store->least_visited = heap;
+    
+    store->recent_head = header->recent_head;
+    store->recent_tail = header->recent_tail;
+    store->recent_count = header->recent_count;
+    store->mutations = header->mutations;
+    store->frecency_epoch = header->frecency_epoch;
+    store->frecency_half_life = header->frecency_half_life;
+    
+    int tags_ok = bookmark_snapshot_load_tags(store, snapshot);
+    bookmark_snapshot_close(snapshot);
+    if (!tags_ok) {
+        bookmark_store_free(store);
+        return NULL;
+    }
+    return store;
+}
+
+#ifndef BOOKMARK_SNAPSHOT_NO_MAIN
+
+#define DEMO_DEFAULT_BOOKMARKS 200000
+#define DEMO_QUERIES 10000
+
+/**
+ * Monotonic seconds
+ */
+double snapshot_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Same top results from the live store and a snapshot?
+ */
+int snapshot_matches(BookmarkStore *store, BookmarkSnapshot *snapshot, const char *prefix) {
+    BookmarkId a[10], b[10];
+    int found_a = bookmark_store_search(store, prefix, 10, a);
+    int found_b = bookmark_snapshot_search(snapshot, prefix, 10, b);
+    return found_a == found_b && memcmp(a, b, found_a * sizeof(BookmarkId)) == 0;
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_BOOKMARKS;
+    const char *path = argc > 2 ? argv[2] : "bookmarks.snapshot";
+    if (n < 1) n = DEMO_DEFAULT_BOOKMARKS;
+    
+    printf("=== Bookmark Snapshot (mmap) in C ===\n");
+    printf("Data Structure: Versioned flat image of the record table and its indexes\n\n");
+    
+    static const char *topics[] = { "rust", "linux", "recipes", "news", "music", "travel", "python", "design" };
+    char title[128], url[128];
+    
+    printf("1. Building store by inserts: %d bookmarks\n", n);
+    double start = snapshot_now();
+    BookmarkStore *store = bookmark_store_create(20);
+    unsigned int state = 2463534242u;
+    for (int i = 0; i < n; i++) {
+        snprintf(title, sizeof(title), "%s guide %d", topics[i % 8], i);
+        snprintf(url, sizeof(url), "https://example%d.org/%s/%d", i % 997, topics[i % 8], i);
+        BookmarkId id = bookmark_store_add(store, title, url, topics[i % 8]);
+        if (i % 5 == 0) bookmark_store_tag(store, id, "to read");
+        
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        for (unsigned int v = state % 4; v > 0; v--) bookmark_store_visit(store, id);
+    }
+    for (int i = 0; i < n; i += 3) bookmark_store_delete(store, (BookmarkId)i);  // leave free ids
+    double build_time = snapshot_now() - start;
+    printf("   %d live, %.3f s\n\n", bookmark_store_count(store), build_time);
+    
+    printf("2. Saving snapshot to %s (temp file + rename)\n", path);
+    start = snapshot_now();
+    if (!bookmark_snapshot_save(store, path)) {
+        printf("   Save failed\n");
+        bookmark_store_free(store);
+        return 1;
+    }
+    double save_time = snapshot_now() - start;
+    struct stat st;
+    stat(path, &st);
+    printf("   %.1f MB, %.3f s\n\n", st.st_size / 1048576.0, save_time);
+    
+    printf("3. Opening snapshot (mmap, no parsing)\n");
+    start = snapshot_now();
+    BookmarkSnapshot *snapshot = bookmark_snapshot_open(path);
+    double open_time = snapshot_now() - start;
+    if (!snapshot) {
+        printf("   Open failed\n");
+        bookmark_store_free(store);
+        return 1;
+    }
+    printf("   %d live, open in %.3f ms (vs %.3f s rebuilding)\n", bookmark_snapshot_count(snapshot),
+           open_time * 1000, build_time);
+    
+    BookmarkId ids[5];
+    BookmarkRecord record;
+    int found = bookmark_snapshot_search(snapshot, "linux", 5, ids);
+    printf("   Search \"linux\" (highest frecency first):\n");
+    for (int i = 0; i < found; i++) {
+        bookmark_snapshot_get(snapshot, ids[i], &record);
+        printf("     [%u] %-20s visits: %u\n", ids[i], record.title, record.visit_count);
+    }
+    
+    start = snapshot_now();
+    int hits = 0;
+    for (int q = 0; q < DEMO_QUERIES; q++) {
+        int i = (int)(((unsigned int)q * 2654435761u) % n);
+        snprintf(url, sizeof(url), "https://example%d.org/%s/%d", i % 997, topics[i % 8], i);
+        hits += bookmark_snapshot_find_url(snapshot, url) != BOOKMARK_NONE;
+    }
+    printf("   %d find_url lookups: %d hits, %.0f ns/lookup\n", DEMO_QUERIES, hits,
+           (snapshot_now() - start) * 1e9 / DEMO_QUERIES);
+    
+    found = bookmark_snapshot_least_visited(snapshot, 3, ids);
+    printf("   Least used: ");
+    for (int i = 0; i < found; i++) printf("%u ", ids[i]);
+    printf("\n   Matches live store: %s\n\n",
+           snapshot_matches(store, snapshot, "linux") && snapshot_matches(store, snapshot, "") ? "yes" : "no");
+    
+    printf("4. Loading snapshot into a mutable store (copy, no re-inserts)\n");
+    start = snapshot_now();
+    BookmarkStore *loaded = bookmark_snapshot_load(path);
+    double load_time = snapshot_now() - start;
+    printf("   %d live, %.3f s\n", bookmark_store_count(loaded), load_time);
+    printf("   Tagged \"to read\": %d (saved store: %d)\n", bookmark_store_tag_count(loaded, "to read"),
+           bookmark_store_tag_count(store, "to read"));
+    BookmarkId added = bookmark_store_add(loaded, "linux kernel newbies", "https://kernelnewbies.org", "linux");
+    for (int v = 0; v < 10; v++) bookmark_store_visit(loaded, added);
+    found = bookmark_store_search(loaded, "linux", 1, ids);
+    printf("   Added and visited after load; top \"linux\": %s\n\n",
+           found && ids[0] == added ? "kernelnewbies" : "unexpected");
+    
+    printf("5. Re-saving while the old snapshot is still mapped\n");
+    bookmark_snapshot_save(loaded, path);
+    printf("   Old mapping still answers: %d live\n", bookmark_snapshot_count(snapshot));
+    BookmarkSnapshot *fresh = bookmark_snapshot_open(path);
+    printf("   New snapshot: %d live\n", fresh ? bookmark_snapshot_count(fresh) : -1);
+    
+    if (fresh) bookmark_snapshot_close(fresh);
+    bookmark_snapshot_close(snapshot);
+    bookmark_store_free(loaded);
+    bookmark_store_free(store);
+    unlink(path);
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
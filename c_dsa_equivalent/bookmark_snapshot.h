@@ -0,0 +1,137 @@
+/**
+ * Bookmark Snapshot Interface
+ * Versioned on-disk image of a BookmarkStore that can be mmap'ed and
+ * queried in place (see bookmark_snapshot.c for the file layout)
+ */
+
+#ifndef BOOKMARK_SNAPSHOT_H
+#define BOOKMARK_SNAPSHOT_H
+
+#include "bookmark_store.h"
+
+#define BOOKMARK_SNAPSHOT_MAGIC "BMSNAP\r\n"   // 8 bytes, catches text-mode mangling
+#define BOOKMARK_SNAPSHOT_VERSION 4     // 2: adds mutations, 3: adds tags, 4: adds frecency
+#define BOOKMARK_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/**
+ * Sections of the file, each 8-byte aligned
+ */
+enum {
+    SNAPSHOT_RECORDS,          // BookmarkSnapshotRecord[record_count]
+    SNAPSHOT_STRINGS,          // title\0url\0category\0 per live record
+    SNAPSHOT_FREE_IDS,         // BookmarkId[free_count]
+    SNAPSHOT_URL_INDEX,        // BookmarkUrlSlot[url_index_size]
+    SNAPSHOT_TRIE_CLASSES,     // BookmarkSnapshotArenaClass[trie_class_count]
+    SNAPSHOT_TRIE_SLOTS,       // node arena flat image
+    SNAPSHOT_HEAP_ENTRIES,     // HeapEntry[heap_size]
+    SNAPSHOT_HEAP_POSITIONS,   // int[heap_id_capacity]
+    SNAPSHOT_TAG_NAMES,        // name\0 per tag, in tag id order
+    SNAPSHOT_TAG_LINKS,        // uint32_t (id, tag) pairs[tag_link_count]
+    SNAPSHOT_SECTION_COUNT
+};
+
+typedef struct {
+    uint64_t offset;           // from the start of the file
+    uint64_t length;
+} BookmarkSnapshotSection;
+
+/**
+ * File header (offset 0)
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;       // BOOKMARK_SNAPSHOT_BYTE_ORDER as written
+    uint32_t header_size;
+    uint32_t record_size;
+    uint64_t file_size;
+    
+    uint32_t record_count;
+    uint32_t live_count;
+    uint32_t free_count;
+    uint32_t max_recent;
+    uint32_t recent_head;
+    uint32_t recent_tail;
+    uint32_t recent_count;
+    uint32_t url_index_size;
+    
+    uint32_t trie_root;
+    uint32_t trie_word_count;
+    uint32_t trie_flags;
+    uint32_t trie_class_count;
+    uint32_t heap_size;
+    uint32_t heap_id_capacity;
+    uint32_t heap_arity_shift;
+    uint32_t reserved;
+    uint64_t mutations;        // store->mutations at save time (WAL sequence)
+    uint32_t tag_count;
+    uint32_t tag_link_count;
+    int64_t frecency_epoch;    // ms; record frecency scores are relative to it
+    int64_t frecency_half_life; // ms
+    
+    BookmarkSnapshotSection sections[SNAPSHOT_SECTION_COUNT];
+} BookmarkSnapshotHeader;
+
+/**
+ * One record; strings are offsets into the STRINGS section
+ */
+typedef struct {
+    int64_t created_at;
+    int64_t last_visited;
+    uint64_t text_offset;
+    uint32_t text_length;      // title, url and category with terminators
+    uint32_t url_offset;       // from text_offset
+    uint32_t category_offset;  // from text_offset
+    uint32_t visit_count;
+    uint32_t frecency;
+    uint32_t url_hash;
+    BookmarkId recent_prev;
+    BookmarkId recent_next;
+    uint8_t live;
+    uint8_t in_recent;
+    uint8_t reserved[6];
+} BookmarkSnapshotRecord;
+
+/**
+ * Saved metadata of one node arena size class
+ */
+typedef struct {
+    uint32_t slot_size;
+    uint32_t slab_shift;
+    uint32_t next_unused;
+    uint32_t free_list;
+    uint32_t live;
+    uint32_t reserved;
+} BookmarkSnapshotArenaClass;
+
+/**
+ * Read-only view of a mapped snapshot
+ * titles and least_visited are ordinary Trie / MinHeap structs whose
+ * storage points into the mapping, so the usual query code runs on them.
+ */
+typedef struct {
+    char *base;
+    size_t size;
+    const BookmarkSnapshotHeader *header;
+    const BookmarkSnapshotRecord *records;
+    const char *strings;
+    const BookmarkUrlSlot *url_index;
+    Trie titles;
+    MinHeap least_visited;
+} BookmarkSnapshot;
+
+int bookmark_snapshot_save(BookmarkStore *store, const char *path);
+BookmarkSnapshot *bookmark_snapshot_open(const char *path);
+int bookmark_snapshot_get(BookmarkSnapshot *snapshot, BookmarkId id, BookmarkRecord *out);
+BookmarkId bookmark_snapshot_find_url(BookmarkSnapshot *snapshot, const char *url);
+int bookmark_snapshot_search(BookmarkSnapshot *snapshot, const char *prefix, int k, BookmarkId *ids_out);
+int bookmark_snapshot_search_fuzzy(BookmarkSnapshot *snapshot, const char *prefix, int max_distance, int k,
+                                   BookmarkId *ids_out, int *distances_out);
+int bookmark_snapshot_recent(BookmarkSnapshot *snapshot, int k, BookmarkId *ids_out);
+int bookmark_snapshot_least_visited(BookmarkSnapshot *snapshot, int k, BookmarkId *ids_out);
+int bookmark_snapshot_count(BookmarkSnapshot *snapshot);
+void bookmark_snapshot_close(BookmarkSnapshot *snapshot);
+BookmarkStore *bookmark_snapshot_load(const char *path);
+int bookmark_snapshot_sync_dir(const char *path);
+
+#endif
@@ -0,0 +1,1283 @@
+/**
+ * Bookmark Store (libbookmarkstore) in C
+ * One bookmark record table with the other structures as indexes over it
+ * 
+ * Every bookmark lives once, in a record table addressed by a 32-bit id.
+ * Deleted ids go on a free list and are handed out again, so the table
+ * stays dense. The structures the app keeps in sync by hand become
+ * secondary indexes that only hold ids:
+ *   URL index     - open addressing over (hash, id); the url is compared
+ *                   in the record, so no second copy of the key is kept
+ *   Title trie    - key is the folded title followed by the encoded id,
+ *                   scored by frecency for ranked autocomplete
+ *   Least visited - min heap (min_heap.c) keyed by id, value = frecency
+ *   Recent        - intrusive doubly linked list through the records,
+ *                   capped at max_recent, O(1) move-to-front on visit
+ *   Full text     - inverted index of title, url and category words
+ *                   (bookmark_text.c), BM25-ranked AND queries
+ *   Categories    - one roaring bitmap of ids per category
+ *                   (roaring_bitmap.c); filters are bitmap unions
+ *   Tags          - any number per bookmark, interned to tag ids with a
+ *                   sorted id array per tag (bookmark_tags.c); "A AND B
+ *                   NOT C" filters merge the arrays
+ *   Sorted views  - counted B+ trees (bplus_tree.c) by recency, title
+ *                   and visits; a visit moves one entry in two of them
+ *                   instead of the list being re-sorted for each page
+ * add, delete and visit update every index in one call, so they can no
+ * longer drift apart. Tags are data, not derived: tag and untag change
+ * them (and count as mutations), and snapshots save them.
+ * 
+ * Bulk loads (imports) can defer the trie, heap and views: between
+ * bookmark_store_begin_bulk and bookmark_store_end_bulk, add only fills
+ * the record table, URL index (so duplicates are still caught), text
+ * index and category bitmaps (fresh ids just append to both), and end_bulk
+ * heapifies once, inserts titles in sorted order, which keeps trie
+ * paths hot in cache, and bulk-loads empty views from sorted entries.
+ * Any other call ends bulk mode first.
+ * bookmark_build_indexes (bookmark_build.c) can replace end_bulk to
+ * rebuild every index on all cores.
+ * 
+ * Title keys: up to BOOKMARK_TITLE_MAX bytes of title, a 0x01 separator
+ * and six bytes of 0x80 | (6 id bits). Control bytes in titles become
+ * spaces, so the separator is unambiguous, and the id bytes are UTF-8
+ * continuation bytes, which case folding leaves alone. Titles that are
+ * the same text still get distinct keys.
+ * 
+ * Frecency: each visit is worth 1 when it happens and half as much every
+ * frecency_half_life after. Rather than decaying every score as time
+ * passes, a record stores SCALE * log2 of its visits' weights measured at
+ * a fixed store epoch (plus OFFSET, so 0 can mean "never visited"). Time
+ * moving on scales every score by the same factor, which is a constant
+ * shift in the log domain, so stored scores keep their order forever:
+ * the trie and heap rank on them directly, a visit rewrites one score,
+ * and the decay is only applied when a value is read. Scores are
+ * relative to the epoch, so there is nothing to rescore or rebase; a
+ * 31-bit score covers 2^18 half-lives either side of it.
+ * 
+ * View keys are 64 bits: the time or count (inverted for newest / most
+ * first), or the first 8 bytes of the folded title with the rest of the
+ * title compared only when those are equal.
+ * 
+ * Compile: gcc -O2 -DTRIE_NO_MAIN -DMIN_HEAP_NO_MAIN -DHASH_TABLE_NO_MAIN -DBOOKMARK_TEXT_NO_MAIN -DROARING_BITMAP_NO_MAIN -DBPLUS_TREE_NO_MAIN -DBOOKMARK_TAGS_NO_MAIN -o bookmark_store bookmark_store.c bookmark_text.c roaring_bitmap.c bookmark_tags.c bplus_tree.c trie.c min_heap.c hash_table.c node_arena.c -lm
+ * Run: ./bookmark_store
+ * Library: compile the same sources plus bookmark_snapshot.c,
+ * bookmark_wal.c, bookmark_import.c and bookmark_build.c with -c and
+ * each module's NO_MAIN define, then
+ * ar rcs libbookmarkstore.a *.o (see PROJECT_REPORT.md)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include <math.h>
+#include <limits.h>
+
+#include "bookmark_store.h"
+#include "hash_table.h"
+
+#define INITIAL_RECORD_CAPACITY 16
+#define INITIAL_URL_INDEX_SIZE 32
+#define INITIAL_CATEGORY_CAPACITY 8
+#define TITLE_ID_BYTES 6
+#define TITLE_SEPARATOR 0x01
+#define VIEW_SORT_RATIO 8            // filters matching under 1/8 of the store are sorted, not walked
+#define VIEW_WALK_CHUNK 256
+
+/**
+ * Wall-clock time in milliseconds
+ */
+long long bookmark_store_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Fold a visit at time (ms) into a frecency score
+ * The visit's own score is OFFSET + SCALE * (time - epoch) / half_life;
+ * two scores combine as max + SCALE * log2(1 + 2^(-gap / SCALE)), the
+ * log of the sum of their weights. Visits may arrive in any order.
+ * Time Complexity: O(1)
+ */
+uint32_t bookmark_frecency_add(uint32_t frecency, long long time, long long epoch, long long half_life) {
+    double score = BOOKMARK_FRECENCY_OFFSET + (double)BOOKMARK_FRECENCY_SCALE * (time - epoch) / half_life;
+    if (frecency > 0) {
+        double high = score > frecency ? score : frecency;
+        double low = score > frecency ? frecency : score;
+        score = high + BOOKMARK_FRECENCY_SCALE * log2(1.0 + exp2((low - high) / BOOKMARK_FRECENCY_SCALE));
+    }
+    
+    // 0 is kept for "never visited"; the heap takes ints
+    score = round(score);
+    if (score < 1) return 1;
+    if (score > INT_MAX) return INT_MAX;
+    return (uint32_t)score;
+}
+
+/**
+ * Decayed frecency at time now: the sum of the visits' weights, each
+ * halved once per half_life since it happened (0 if never visited)
+ * Time Complexity: O(1)
+ */
+double bookmark_frecency_value(uint32_t frecency, long long now, long long epoch, long long half_life) {
+    if (frecency == 0) return 0.0;
+    return exp2(((double)frecency - BOOKMARK_FRECENCY_OFFSET) / BOOKMARK_FRECENCY_SCALE -
+                (double)(now - epoch) / half_life);
+}
+
+/**
+ * Hash a url for the URL index
+ */
+uint32_t bookmark_url_hash(const char *url) {
+    return (uint32_t)hash_wy(url, strlen(url));
+}
+
+/**
+ * Home slot of a hash (Fibonacci hashing on the top bits)
+ */
+int bookmark_url_home(int index_size, uint32_t hash) {
+    int bits = __builtin_ctz(index_size);
+    return (int)((hash * 2654435769u) >> (32 - bits));
+}
+
+/**
+ * Find the slot holding url, or -1
+ * Time Complexity: O(1) average
+ */
+int bookmark_url_find(BookmarkStore *store, const char *url, uint32_t hash) {
+    int mask = store->url_index_size - 1;
+    for (int i = bookmark_url_home(store->url_index_size, hash); ; i = (i + 1) & mask) {
+        BookmarkUrlSlot *slot = &store->url_index[i];
+        if (slot->id == BOOKMARK_NONE) return -1;
+        if (slot->hash == hash && strcmp(store->records[slot->id].url, url) == 0) return i;
+    }
+}
+
+/**
+ * Place (hash, id) in the first free slot of its probe sequence
+ */
+void bookmark_url_place(BookmarkStore *store, uint32_t hash, BookmarkId id) {
+    int mask = store->url_index_size - 1;
+    int i = bookmark_url_home(store->url_index_size, hash);
+    while (store->url_index[i].id != BOOKMARK_NONE) i = (i + 1) & mask;
+    store->url_index[i].hash = hash;
+    store->url_index[i].id = id;
+}
+
+/**
+ * Allocate an index of size slots, all empty
+ */
+BookmarkUrlSlot *bookmark_url_alloc(int size) {
+    BookmarkUrlSlot *slots = (BookmarkUrlSlot *)malloc(size * sizeof(BookmarkUrlSlot));
+    for (int i = 0; i < size; i++) slots[i].id = BOOKMARK_NONE;
+    return slots;
+}
+
+/**
+ * Double the URL index once it passes 3/4 load
+ * Time Complexity: O(n) per resize, O(1) amortized
+ */
+void bookmark_url_reserve(BookmarkStore *store) {
+    if ((store->live_count + 1) * 4 <= store->url_index_size * 3) return;
+    
+    BookmarkUrlSlot *old = store->url_index;
+    int old_size = store->url_index_size;
+    store->url_index_size *= 2;
+    store->url_index = bookmark_url_alloc(store->url_index_size);
+    for (int i = 0; i < old_size; i++) {
+        if (old[i].id != BOOKMARK_NONE) bookmark_url_place(store, old[i].hash, old[i].id);
+    }
+    free(old);
+}
+
+/**
+ * Empty slot i and shift later entries of the cluster back (no tombstones)
+ * Time Complexity: O(1) average
+ */
+void bookmark_url_remove_slot(BookmarkStore *store, int i) {
+    int mask = store->url_index_size - 1;
+    int hole = i;
+    for (int j = (i + 1) & mask; store->url_index[j].id != BOOKMARK_NONE; j = (j + 1) & mask) {
+        int home = bookmark_url_home(store->url_index_size, store->url_index[j].hash);
+        // Move j into the hole unless its home lies cyclically in (hole, j]
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            store->url_index[hole] = store->url_index[j];
+            hole = j;
+        }
+    }
+    store->url_index[hole].id = BOOKMARK_NONE;
+}
+
+/**
+ * Build the trie key for a record: title, separator, encoded id
+ * Returns the key length
+ */
+int bookmark_title_key(const char *title, BookmarkId id, char *key) {
+    int length = strlen(title);
+    if (length > BOOKMARK_TITLE_MAX) {
+        length = BOOKMARK_TITLE_MAX;
+        // Do not cut a UTF-8 sequence in half
+        while (length > 0 && ((unsigned char)title[length] & 0xC0) == 0x80) length--;
+    }
+    
+    for (int i = 0; i < length; i++) {
+        unsigned char c = title[i];
+        key[i] = c < 0x20 ? ' ' : c;
+    }
+    key[length++] = TITLE_SEPARATOR;
+    for (int shift = 6 * (TITLE_ID_BYTES - 1); shift >= 0; shift -= 6) {
+        key[length++] = (char)(0x80 | ((id >> shift) & 0x3F));
+    }
+    key[length] = '\0';
+    return length;
+}
+
+/**
+ * Recover the id from the last bytes of a trie key
+ */
+BookmarkId bookmark_title_key_id(const char *key) {
+    int length = strlen(key);
+    if (length < TITLE_ID_BYTES + 1) return BOOKMARK_NONE;
+    
+    BookmarkId id = 0;
+    for (int i = length - TITLE_ID_BYTES; i < length; i++) {
+        id = (id << 6) | ((unsigned char)key[i] & 0x3F);
+    }
+    return id;
+}
+
+/**
+ * Unlink a record from the recent list
+ * Time Complexity: O(1)
+ */
+void bookmark_recent_unlink(BookmarkStore *store, BookmarkId id) {
+    BookmarkRecord *record = &store->records[id];
+    if (!record->in_recent) return;
+    
+    if (record->recent_prev != BOOKMARK_NONE) {
+        store->records[record->recent_prev].recent_next = record->recent_next;
+    } else {
+        store->recent_head = record->recent_next;
+    }
+    if (record->recent_next != BOOKMARK_NONE) {
+        store->records[record->recent_next].recent_prev = record->recent_prev;
+    } else {
+        store->recent_tail = record->recent_prev;
+    }
+    
+    record->recent_prev = record->recent_next = BOOKMARK_NONE;
+    record->in_recent = 0;
+    store->recent_count--;
+}
+
+/**
+ * Put a record at the front of the recent list, dropping the oldest
+ * entry once the list is over max_recent
+ * Time Complexity: O(1)
+ */
+void bookmark_recent_touch(BookmarkStore *store, BookmarkId id) {
+    bookmark_recent_unlink(store, id);
+    
+    BookmarkRecord *record = &store->records[id];
+    record->recent_prev = BOOKMARK_NONE;
+    record->recent_next = store->recent_head;
+    if (store->recent_head != BOOKMARK_NONE) {
+        store->records[store->recent_head].recent_prev = id;
+    } else {
+        store->recent_tail = id;
+    }
+    store->recent_head = id;
+    record->in_recent = 1;
+    store->recent_count++;
+    
+    if (store->recent_count > store->max_recent) {
+        bookmark_recent_unlink(store, store->recent_tail);
+    }
+}
+
+/**
+ * Index of a category, or -1
+ * Categories are few, so a scan comparing cached hashes first is enough.
+ * Time Complexity: O(c) for c = categories
+ */
+int bookmark_category_find(BookmarkStore *store, const char *name, uint32_t hash) {
+    for (int i = 0; i < store->category_count; i++) {
+        if (store->categories[i].hash == hash && strcmp(store->categories[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+ * Index of a category, created empty if it is new
+ * Time Complexity: O(c)
+ */
+int bookmark_category_intern(BookmarkStore *store, const char *name) {
+    uint32_t hash = (uint32_t)hash_wy(name, (int)strlen(name));
+    int found = bookmark_category_find(store, name, hash);
+    if (found >= 0) return found;
+    
+    if (store->category_count == store->category_capacity) {
+        store->category_capacity *= 2;
+        store->categories = (BookmarkCategory *)realloc(store->categories,
+                                                        store->category_capacity * sizeof(BookmarkCategory));
+    }
+    BookmarkCategory *category = &store->categories[store->category_count];
+    category->name = strdup(name);
+    category->hash = hash;
+    category->ids = roaring_bitmap_create();
+    return store->category_count++;
+}
+
+/**
+ * Index a record in the derived indexes (full text, categories)
+ * These are not saved in snapshots; bookmark_snapshot_load rebuilds them
+ * through here.
+ * Time Complexity: O(t log t + c) for t = tokens
+ */
+void bookmark_derived_add(BookmarkStore *store, BookmarkId id) {
+    BookmarkRecord *record = &store->records[id];
+    bookmark_text_add(store->text, id, record->title, record->url, record->category);
+    int category = bookmark_category_intern(store, record->category);  // may grow the table
+    roaring_bitmap_add(store->categories[category].ids, id);
+}
+
+/**
+ * Drop a record from the derived indexes
+ * Time Complexity: O(t log t + c + ROARING_ARRAY_MAX)
+ */
+void bookmark_derived_remove(BookmarkStore *store, BookmarkId id) {
+    BookmarkRecord *record = &store->records[id];
+    bookmark_text_remove(store->text, id, record->title, record->url, record->category);
+    int category = bookmark_category_find(store, record->category,
+                                          (uint32_t)hash_wy(record->category, (int)strlen(record->category)));
+    if (category >= 0) roaring_bitmap_remove(store->categories[category].ids, id);
+}
+
+/**
+ * Sort key of a record in a view
+ * Title keys are the first 8 folded bytes, big-endian, so they order like
+ * the folded strings; bookmark_view_title_tie settles equal prefixes.
+ * Time Complexity: O(1)
+ */
+uint64_t bookmark_view_key(const BookmarkRecord *record, int view) {
+    if (view == BOOKMARK_VIEW_RECENT) {
+        return UINT64_MAX - (uint64_t)(record->last_visited ? record->last_visited : record->created_at);
+    }
+    if (view == BOOKMARK_VIEW_VISITS) return UINT64_MAX - record->visit_count;
+    
+    // Fold a little past 8 bytes so a character straddling byte 8 folds whole
+    unsigned char folded[16] = {0};
+    int length = (int)strnlen(record->title, sizeof(folded));
+    memcpy(folded, record->title, length);
+    trie_fold_bytes(folded, length);
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) key = (key << 8) | folded[i];
+    return key;
+}
+
+/**
+ * Order two ids by their whole folded titles (title view tie-break)
+ * ASCII is folded in place while comparing; the rest of both titles is
+ * copied and folded only from the first non-ASCII byte. Titles are
+ * compared up to BOOKMARK_TITLE_MAX bytes; the tree falls back to the id
+ * after that.
+ */
+int bookmark_view_title_tie(uint32_t a, uint32_t b, void *context) {
+    BookmarkStore *store = (BookmarkStore *)context;
+    const unsigned char *x = (const unsigned char *)store->records[a].title;
+    const unsigned char *y = (const unsigned char *)store->records[b].title;
+    
+    int i = 0;
+    for (; i < BOOKMARK_TITLE_MAX && x[i] < 0x80 && y[i] < 0x80; i++) {
+        int cx = x[i] >= 'A' && x[i] <= 'Z' ? x[i] + 32 : x[i];
+        int cy = y[i] >= 'A' && y[i] <= 'Z' ? y[i] + 32 : y[i];
+        if (cx != cy) return cx - cy;
+        if (cx == 0) return 0;
+    }
+    if (i == BOOKMARK_TITLE_MAX) return 0;
+    
+    // Both are at a character boundary: fold the remainders
+    unsigned char first[BOOKMARK_TITLE_MAX + 1];
+    unsigned char second[BOOKMARK_TITLE_MAX + 1];
+    int first_length = (int)strnlen((const char *)x + i, BOOKMARK_TITLE_MAX - i);
+    int second_length = (int)strnlen((const char *)y + i, BOOKMARK_TITLE_MAX - i);
+    memcpy(first, x + i, first_length);
+    memcpy(second, y + i, second_length);
+    first[first_length] = second[second_length] = 0;
+    trie_fold_bytes(first, first_length);
+    trie_fold_bytes(second, second_length);
+    return strcmp((const char *)first, (const char *)second);
+}
+
+/**
+ * Put ids into every view
+ * Empty views are bulk-loaded from sorted entries in O(n); others take
+ * one insert per id.
+ * Time Complexity: O(b log b) for b = ids
+ */
+void bookmark_views_add(BookmarkStore *store, const BookmarkId *ids, int count) {
+    if (count == 0) return;
+    
+    BPlusEntry *entries = NULL;
+    for (int view = 0; view < BOOKMARK_VIEW_COUNT; view++) {
+        BPlusTree *tree = store->views[view];
+        if (bplus_tree_size(tree) > 0) {
+            for (int i = 0; i < count; i++) {
+                bplus_tree_insert(tree, bookmark_view_key(&store->records[ids[i]], view), ids[i]);
+            }
+            continue;
+        }
+        
+        if (!entries) entries = (BPlusEntry *)malloc(count * sizeof(BPlusEntry));
+        for (int i = 0; i < count; i++) {
+            entries[i].key = bookmark_view_key(&store->records[ids[i]], view);
+            entries[i].id = ids[i];
+        }
+        bplus_tree_sort(tree, entries, count);
+        bplus_tree_build(tree, entries, count);
+    }
+    free(entries);
+}
+
+/**
+ * Create an empty store
+ * max_recent caps the recent list (BOOKMARK_DEFAULT_RECENT if <= 0)
+ * Time Complexity: O(1)
+ */
+BookmarkStore *bookmark_store_create(int max_recent) {
+    BookmarkStore *store = (BookmarkStore *)malloc(sizeof(BookmarkStore));
+    
+    store->record_capacity = INITIAL_RECORD_CAPACITY;
+    store->records = (BookmarkRecord *)malloc(store->record_capacity * sizeof(BookmarkRecord));
+    store->record_count = 0;
+    store->live_count = 0;
+    store->free_capacity = INITIAL_RECORD_CAPACITY;
+    store->free_ids = (BookmarkId *)malloc(store->free_capacity * sizeof(BookmarkId));
+    store->free_count = 0;
+    
+    store->url_index_size = INITIAL_URL_INDEX_SIZE;
+    store->url_index = bookmark_url_alloc(store->url_index_size);
+    
+    store->titles = trie_create();
+    store->least_visited = min_heap_create(INITIAL_RECORD_CAPACITY);
+    store->text = bookmark_text_create();
+    store->category_capacity = INITIAL_CATEGORY_CAPACITY;
+    store->categories = (BookmarkCategory *)malloc(store->category_capacity * sizeof(BookmarkCategory));
+    store->category_count = 0;
+    store->tags = bookmark_tags_create();
+    for (int view = 0; view < BOOKMARK_VIEW_COUNT; view++) {
+        store->views[view] = bplus_tree_create(view == BOOKMARK_VIEW_TITLE ? bookmark_view_title_tie : NULL, store);
+    }
+    
+    store->recent_head = store->recent_tail = BOOKMARK_NONE;
+    store->recent_count = 0;
+    store->max_recent = max_recent > 0 ? max_recent : BOOKMARK_DEFAULT_RECENT;
+    store->frecency_epoch = bookmark_store_now_ms();
+    store->frecency_half_life = BOOKMARK_FRECENCY_HALF_LIFE_MS;
+    store->mutations = 0;
+    
+    store->bulk_ids = NULL;
+    store->bulk_count = 0;
+    store->bulk_capacity = 0;
+    
+    return store;
+}
+
+/**
+ * Take an id from the free list, or the next fresh one
+ */
+BookmarkId bookmark_store_next_id(BookmarkStore *store) {
+    if (store->free_count > 0) return store->free_ids[--store->free_count];
+    
+    if (store->record_count == store->record_capacity) {
+        store->record_capacity *= 2;
+        store->records = (BookmarkRecord *)realloc(store->records,
+                                                   store->record_capacity * sizeof(BookmarkRecord));
+    }
+    return (BookmarkId)store->record_count++;
+}
+
+/**
+ * Add a bookmark created now (see bookmark_store_add_at)
+ * category may be NULL. Returns the new id, or BOOKMARK_NONE if the url
+ * is already stored
+ * Time Complexity: O(m + log n) for m = title length
+ */
+BookmarkId bookmark_store_add(BookmarkStore *store, const char *title, const char *url,
+                              const char *category) {
+    return bookmark_store_add_at(store, title, url, category, bookmark_store_now_ms());
+}
+
+/**
+ * Add a bookmark created at created_at (ms) and index it everywhere
+ * The recency view is keyed on the creation time until the first visit,
+ * so log replay passes the logged time here rather than patching
+ * created_at afterwards.
+ * Returns the new id, or BOOKMARK_NONE if the url is already stored
+ * Time Complexity: O(m + log n) for m = title length
+ */
+BookmarkId bookmark_store_add_at(BookmarkStore *store, const char *title, const char *url,
+                                 const char *category, long long created_at) {
+    if (!title || !url) return BOOKMARK_NONE;
+    if (!category) category = "";
+    
+    uint32_t hash = bookmark_url_hash(url);
+    if (bookmark_url_find(store, url, hash) >= 0) return BOOKMARK_NONE;
+    
+    bookmark_url_reserve(store);
+    BookmarkId id = bookmark_store_next_id(store);
+    
+    // title, url and category in one block
+    size_t title_len = strlen(title) + 1;
+    size_t url_len = strlen(url) + 1;
+    size_t category_len = strlen(category) + 1;
+    char *text = (char *)malloc(title_len + url_len + category_len);
+    
+    BookmarkRecord *record = &store->records[id];
+    record->title = text;
+    record->url = text + title_len;
+    record->category = text + title_len + url_len;
+    memcpy(record->title, title, title_len);
+    memcpy(record->url, url, url_len);
+    memcpy(record->category, category, category_len);
+    record->visit_count = 0;
+    record->frecency = 0;
+    record->created_at = created_at;
+    record->last_visited = 0;
+    record->url_hash = hash;
+    record->recent_prev = record->recent_next = BOOKMARK_NONE;
+    record->live = 1;
+    record->in_recent = 0;
+    store->live_count++;
+    store->mutations++;
+    
+    bookmark_url_place(store, hash, id);
+    bookmark_derived_add(store, id);
+    
+    if (store->bulk_capacity > 0) {
+        // Bulk mode: trie, heap and views are built in end_bulk
+        if (store->bulk_count == store->bulk_capacity) {
+            store->bulk_capacity *= 2;
+            store->bulk_ids = (BookmarkId *)realloc(store->bulk_ids, store->bulk_capacity * sizeof(BookmarkId));
+        }
+        store->bulk_ids[store->bulk_count++] = id;
+        return id;
+    }
+    
+    char key[MAX_WORD_LENGTH];
+    bookmark_title_key(title, id, key);
+    trie_insert_scored(store->titles, key, 0);
+    
+    min_heap_insert(store->least_visited, (int)id, 0, NULL);
+    for (int view = 0; view < BOOKMARK_VIEW_COUNT; view++) {
+        bplus_tree_insert(store->views[view], bookmark_view_key(record, view), id);
+    }
+    
+    return id;
+}
+
+/**
+ * Defer trie, heap and view updates for the adds that follow
+ * Time Complexity: O(1)
+ */
+void bookmark_store_begin_bulk(BookmarkStore *store) {
+    if (store->bulk_capacity > 0) return;
+    store->bulk_capacity = INITIAL_RECORD_CAPACITY;
+    store->bulk_ids = (BookmarkId *)malloc(store->bulk_capacity * sizeof(BookmarkId));
+    store->bulk_count = 0;
+}
+
+/**
+ * Order title refs by title (bulk trie inserts)
+ */
+int bookmark_title_ref_compare(const void *a, const void *b) {
+    return strcmp(((const BookmarkTitleRef *)a)->title, ((const BookmarkTitleRef *)b)->title);
+}
+
+/**
+ * Index everything added in bulk mode and leave it
+ * The heap gets all new ids appended and one bottom-up heapify; titles
+ * are sorted and inserted in order, so consecutive inserts share their
+ * trie path; views are loaded as in bookmark_views_add.
+ * Time Complexity: O(n + b log b) for b = bulk adds
+ */
+void bookmark_store_end_bulk(BookmarkStore *store) {
+    if (store->bulk_capacity == 0) return;
+    
+    BookmarkTitleRef *refs = (BookmarkTitleRef *)malloc((store->bulk_count + 1) * sizeof(BookmarkTitleRef));
+    for (int i = 0; i < store->bulk_count; i++) {
+        BookmarkId id = store->bulk_ids[i];
+        refs[i].title = store->records[id].title;
+        refs[i].id = id;
+        min_heap_append(store->least_visited, (int)id, (int)store->records[id].frecency, NULL);
+    }
+    min_heap_heapify(store->least_visited);
+    
+    qsort(refs, store->bulk_count, sizeof(BookmarkTitleRef), bookmark_title_ref_compare);
+    char key[MAX_WORD_LENGTH];
+    for (int i = 0; i < store->bulk_count; i++) {
+        bookmark_title_key(refs[i].title, refs[i].id, key);
+        trie_insert_scored(store->titles, key, store->records[refs[i].id].frecency);
+    }
+    
+    free(refs);
+    bookmark_views_add(store, store->bulk_ids, store->bulk_count);
+    free(store->bulk_ids);
+    store->bulk_ids = NULL;
+    store->bulk_count = 0;
+    store->bulk_capacity = 0;
+}
+
+/**
+ * Look up a live record
+ * Returns NULL if id is not a live bookmark
+ * Time Complexity: O(1)
+ */
+const BookmarkRecord *bookmark_store_get(BookmarkStore *store, BookmarkId id) {
+    if (id >= (BookmarkId)store->record_count || !store->records[id].live) return NULL;
+    return &store->records[id];
+}
+
+/**
+ * Find a bookmark by url
+ * Returns its id, or BOOKMARK_NONE
+ * Time Complexity: O(1) average
+ */
+BookmarkId bookmark_store_find_url(BookmarkStore *store, const char *url) {
+    if (!url) return BOOKMARK_NONE;
+    int slot = bookmark_url_find(store, url, bookmark_url_hash(url));
+    return slot >= 0 ? store->url_index[slot].id : BOOKMARK_NONE;
+}
+
+/**
+ * Delete a bookmark from the table and every index; its id is reused
+ * Returns 0 if id is not a live bookmark
+ * Time Complexity: O(m + log n) for m = title length
+ */
+int bookmark_store_delete(BookmarkStore *store, BookmarkId id) {
+    if (!bookmark_store_get(store, id)) return 0;
+    bookmark_store_end_bulk(store);
+    BookmarkRecord *record = &store->records[id];
+    
+    bookmark_url_remove_slot(store, bookmark_url_find(store, record->url, record->url_hash));
+    
+    char key[MAX_WORD_LENGTH];
+    bookmark_title_key(record->title, id, key);
+    trie_delete(store->titles, key);
+    
+    min_heap_remove(store->least_visited, (int)id);
+    for (int view = 0; view < BOOKMARK_VIEW_COUNT; view++) {
+        bplus_tree_remove(store->views[view], bookmark_view_key(record, view), id);
+    }
+    bookmark_derived_remove(store, id);
+    bookmark_tags_clear(store->tags, id);
+    bookmark_recent_unlink(store, id);
+    
+    free(record->title);
+    record->title = record->url = record->category = NULL;
+    record->live = 0;
+    store->live_count--;
+    store->mutations++;
+    
+    if (store->free_count == store->free_capacity) {
+        store->free_capacity *= 2;
+        store->free_ids = (BookmarkId *)realloc(store->free_ids, store->free_capacity * sizeof(BookmarkId));
+    }
+    store->free_ids[store->free_count++] = id;
+    return 1;
+}
+
+/**
+ * Record a visit now (see bookmark_store_visit_at)
+ * Returns 0 if id is not a live bookmark
+ * Time Complexity: O(m + log n) for m = title length
+ */
+int bookmark_store_visit(BookmarkStore *store, BookmarkId id) {
+    return bookmark_store_visit_at(store, id, bookmark_store_now_ms());
+}
+
+/**
+ * Record a visit made at time (ms): bump the count, fold the visit into
+ * the frecency score the trie and heap rank on, move to the front of the
+ * recent list and re-place it in the recency and visit views
+ * Older times (log replay, imported history) weigh less, as if the
+ * visit had been recorded then.
+ * Returns 0 if id is not a live bookmark
+ * Time Complexity: O(m + log n) for m = title length
+ */
+int bookmark_store_visit_at(BookmarkStore *store, BookmarkId id, long long time) {
+    if (!bookmark_store_get(store, id)) return 0;
+    bookmark_store_end_bulk(store);
+    BookmarkRecord *record = &store->records[id];
+    
+    bplus_tree_remove(store->views[BOOKMARK_VIEW_RECENT], bookmark_view_key(record, BOOKMARK_VIEW_RECENT), id);
+    bplus_tree_remove(store->views[BOOKMARK_VIEW_VISITS], bookmark_view_key(record, BOOKMARK_VIEW_VISITS), id);
+    record->visit_count++;
+    record->last_visited = time;
+    record->frecency = bookmark_frecency_add(record->frecency, time, store->frecency_epoch,
+                                             store->frecency_half_life);
+    bplus_tree_insert(store->views[BOOKMARK_VIEW_RECENT], bookmark_view_key(record, BOOKMARK_VIEW_RECENT), id);
+    bplus_tree_insert(store->views[BOOKMARK_VIEW_VISITS], bookmark_view_key(record, BOOKMARK_VIEW_VISITS), id);
+    
+    char key[MAX_WORD_LENGTH];
+    bookmark_title_key(record->title, id, key);
+    trie_set_score(store->titles, key, record->frecency);
+    
+    min_heap_update_key(store->least_visited, (int)id, (int)record->frecency);
+    bookmark_recent_touch(store, id);
+    store->mutations++;
+    return 1;
+}
+
+/**
+ * Current frecency of a bookmark: its visits, each worth 1 when made and
+ * half as much every half-life since (0 if never visited or not live)
+ * Time Complexity: O(1)
+ */
+double bookmark_store_frecency(BookmarkStore *store, BookmarkId id) {
+    const BookmarkRecord *record = bookmark_store_get(store, id);
+    if (!record) return 0.0;
+    return bookmark_frecency_value(record->frecency, bookmark_store_now_ms(), store->frecency_epoch,
+                                   store->frecency_half_life);
+}
+
+/**
+ * Tag a bookmark (the name is trimmed; new names become new tags)
+ * Returns 0 if id is not live, the name is empty, or it already has the tag
+ * Time Complexity: O(m + k) for m = name length, k = the bookmark's
+ * tags, plus O(n) for n = bookmarks with the tag unless id is the
+ * newest of them
+ */
+int bookmark_store_tag(BookmarkStore *store, BookmarkId id, const char *tag) {
+    if (!bookmark_store_get(store, id) || !tag) return 0;
+    if (!bookmark_tags_add(store->tags, id, bookmark_tags_intern(store->tags, tag))) return 0;
+    store->mutations++;
+    return 1;
+}
+
+/**
+ * Take a tag off a bookmark
+ * Returns 0 if id is not live or does not have the tag
+ * Time Complexity: O(m + k + n)
+ */
+int bookmark_store_untag(BookmarkStore *store, BookmarkId id, const char *tag) {
+    if (!bookmark_store_get(store, id) || !tag) return 0;
+    int found = bookmark_tags_find(store->tags, tag);
+    if (found < 0 || !bookmark_tags_remove(store->tags, id, found)) return 0;
+    store->mutations++;
+    return 1;
+}
+
+/**
+ * Tag names of a bookmark, in the order they were added
+ * Writes up to max names and returns how many were written
+ * Time Complexity: O(k)
+ */
+int bookmark_store_tags_of(BookmarkStore *store, BookmarkId id, const char **names_out, int max) {
+    if (!bookmark_store_get(store, id)) return 0;
+    const uint32_t *tags;
+    int count = bookmark_tags_of(store->tags, id, &tags);
+    int written = 0;
+    for (; written < count && written < max; written++) {
+        names_out[written] = bookmark_tags_name(store->tags, (int)tags[written]);
+    }
+    return written;
+}
+
+/**
+ * Ranked prefix search over a title trie, decoding ids from the keys
+ * Shared by the store and read-only snapshots.
+ * Time Complexity: O(m + k log k) for m = prefix length
+ */
+int bookmark_titles_top_k(Trie *titles, const char *prefix, int k, BookmarkId *ids_out) {
+    if (!prefix || k <= 0) return 0;
+    
+    char (*keys)[256] = malloc(k * sizeof(*keys));
+    int found = trie_search_top_k(titles, prefix, k, keys, NULL);
+    for (int i = 0; i < found; i++) {
+        ids_out[i] = bookmark_title_key_id(keys[i]);
+    }
+    free(keys);
+    return found;
+}
+
+/**
+ * Typo-tolerant ranked search over a title trie (see trie_search_fuzzy)
+ * Shared by the store and read-only snapshots. distances_out may be NULL.
+ * Time Complexity: O(m * v + k log k) for v = nodes in the edit neighborhood
+ */
+int bookmark_titles_fuzzy(Trie *titles, const char *prefix, int max_distance, int k,
+                          BookmarkId *ids_out, int *distances_out) {
+    if (!prefix || k <= 0) return 0;
+    
+    char (*keys)[256] = malloc(k * sizeof(*keys));
+    int found = trie_search_fuzzy(titles, prefix, max_distance, k, keys, NULL, distances_out);
+    for (int i = 0; i < found; i++) {
+        ids_out[i] = bookmark_title_key_id(keys[i]);
+    }
+    free(keys);
+    return found;
+}
+
+/**
+ * Titles starting with prefix, highest frecency first
+ * Writes up to k ids to ids_out and returns how many were written
+ * Time Complexity: O(m + k log k) for m = prefix length
+ */
+int bookmark_store_search(BookmarkStore *store, const char *prefix, int k, BookmarkId *ids_out) {
+    bookmark_store_end_bulk(store);
+    return bookmark_titles_top_k(store->titles, prefix, k, ids_out);
+}
+
+/**
+ * Titles starting within max_distance typos (1 or 2) of prefix: closest
+ * first, then highest frecency
+ * Writes up to k ids (and their distances, if distances_out is not NULL)
+ * and returns how many were written
+ * Time Complexity: O(m * v + k log k) for v = nodes in the edit neighborhood
+ */
+int bookmark_store_search_fuzzy(BookmarkStore *store, const char *prefix, int max_distance, int k,
+                                BookmarkId *ids_out, int *distances_out) {
+    bookmark_store_end_bulk(store);
+    return bookmark_titles_fuzzy(store->titles, prefix, max_distance, k, ids_out, distances_out);
+}
+
+/**
+ * Bookmarks containing every word of query (in title, url or category),
+ * best BM25 match first
+ * Writes up to k ids (and scores, if scores_out is not NULL) and returns
+ * how many were written
+ * Time Complexity: O(q r (log g + B / w) + m log k) (see bookmark_text_search)
+ */
+int bookmark_store_search_text(BookmarkStore *store, const char *query, int k, BookmarkId *ids_out,
+                               double *scores_out) {
+    return bookmark_text_search(store->text, query, k, ids_out, scores_out);
+}
+
+/**
+ * Ids filed under any of the given categories (unknown names match
+ * nothing), as a bitmap the caller frees with roaring_bitmap_free
+ * Combine it with other bitmaps, count it, or page through it with
+ * roaring_bitmap_to_array.
+ * Time Complexity: O(f c) lookups plus the bitmap union, for f = filters
+ */
+RoaringBitmap *bookmark_store_filter(BookmarkStore *store, const char *const *categories, int count) {
+    const RoaringBitmap **selected = (const RoaringBitmap **)malloc((count + 1) * sizeof(RoaringBitmap *));
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        int category = bookmark_category_find(store, categories[i],
+                                              (uint32_t)hash_wy(categories[i], (int)strlen(categories[i])));
+        if (category >= 0) selected[found++] = store->categories[category].ids;
+    }
+    RoaringBitmap *result = roaring_bitmap_or_many(selected, found);
+    free(selected);
+    return result;
+}
+
+/**
+ * Bookmarks in one category
+ * Time Complexity: O(c)
+ */
+int bookmark_store_category_count(BookmarkStore *store, const char *category) {
+    int found = bookmark_category_find(store, category, (uint32_t)hash_wy(category, (int)strlen(category)));
+    return found >= 0 ? (int)roaring_bitmap_cardinality(store->categories[found].ids) : 0;
+}
+
+/**
+ * Every category with its bookmark count, in first-use order
+ * Writes up to max names (and counts, if counts_out is not NULL) and
+ * returns how many were written
+ * Time Complexity: O(c)
+ */
+int bookmark_store_categories(BookmarkStore *store, const char **names_out, int *counts_out, int max) {
+    int written = 0;
+    for (; written < store->category_count && written < max; written++) {
+        names_out[written] = store->categories[written].name;
+        if (counts_out) counts_out[written] = (int)roaring_bitmap_cardinality(store->categories[written].ids);
+    }
+    return written;
+}
+
+/**
+ * Ids tagged with every name in all and none of the names in none, as a
+ * bitmap the caller frees with roaring_bitmap_free (so it pages through
+ * bookmark_store_page and combines with category filters)
+ * An unknown name in all matches nothing; unknown names in none are
+ * ignored. With no names in all, the query starts from every live id.
+ * Time Complexity: O(a + e) lookups plus the merges (see
+ * bookmark_tags_query) for a, e = names in all and none; O(n) more
+ * when all is empty
+ */
+RoaringBitmap *bookmark_store_tag_filter(BookmarkStore *store, const char *const *all, int all_count,
+                                         const char *const *none, int none_count) {
+    RoaringBitmap *result = roaring_bitmap_create();
+    int *all_tags = (int *)malloc((all_count + 1) * sizeof(int));
+    int *none_tags = (int *)malloc((none_count + 1) * sizeof(int));
+    int known = 1;
+    for (int i = 0; i < all_count && known; i++) {
+        all_tags[i] = bookmark_tags_find(store->tags, all[i]);
+        known = all_tags[i] >= 0;
+    }
+    for (int i = 0; i < none_count; i++) none_tags[i] = bookmark_tags_find(store->tags, none[i]);
+    
+    uint32_t *ids = NULL;
+    int count = 0;
+    if (known && all_count > 0) {
+        count = bookmark_tags_query(store->tags, all_tags, all_count, none_tags, none_count, &ids);
+    } else if (known) {
+        // Nothing required: every live id, minus the excluded tags
+        ids = (uint32_t *)malloc((store->live_count + 1) * sizeof(uint32_t));
+        for (int id = 0; id < store->record_count; id++) {
+            if (store->records[id].live) ids[count++] = (uint32_t)id;
+        }
+        for (int i = 0; i < none_count && count > 0; i++) {
+            if (none_tags[i] < 0) continue;
+            const BookmarkTag *tag = &store->tags->tags[none_tags[i]];
+            count = bookmark_tags_merge(ids, count, tag->ids, tag->count, ids, 1);
+        }
+    }
+    for (int i = 0; i < count; i++) roaring_bitmap_add(result, ids[i]);  // increasing: appends
+    
+    free(ids);
+    free(all_tags);
+    free(none_tags);
+    return result;
+}
+
+/**
+ * Bookmarks with one tag
+ * Time Complexity: O(m) for m = name length
+ */
+int bookmark_store_tag_count(BookmarkStore *store, const char *tag) {
+    return bookmark_tags_count(store->tags, bookmark_tags_find(store->tags, tag));
+}
+
+/**
+ * Every tag with its bookmark count, in first-use order (tags whose
+ * bookmarks are all gone are listed with 0)
+ * Writes up to max names (and counts, if counts_out is not NULL) and
+ * returns how many were written
+ * Time Complexity: O(t) for t = tags
+ */
+int bookmark_store_tags(BookmarkStore *store, const char **names_out, int *counts_out, int max) {
+    int written = 0;
+    for (; written < store->tags->tag_count && written < max; written++) {
+        names_out[written] = bookmark_tags_name(store->tags, written);
+        if (counts_out) counts_out[written] = bookmark_tags_count(store->tags, written);
+    }
+    return written;
+}
+
+/**
+ * One page of a sorted view: the ids at positions offset .. offset +
+ * limit - 1 in view order, counting only ids in filter if it is not NULL
+ * (e.g. from bookmark_store_filter)
+ * Unfiltered pages and filters matching a good share of the store walk
+ * the view; sparse filters are sorted instead, which beats walking past
+ * the many ids they skip.
+ * Writes up to limit ids to ids_out and returns how many were written
+ * Time Complexity: O(log n + limit) unfiltered; O(m log m) for a sparse
+ * filter of m ids; O(log n + (offset + limit) n / m) walking a dense one
+ */
+int bookmark_store_page(BookmarkStore *store, int view, const RoaringBitmap *filter, int offset, int limit,
+                        BookmarkId *ids_out) {
+    if (view < 0 || view >= BOOKMARK_VIEW_COUNT || limit <= 0) return 0;
+    if (offset < 0) offset = 0;
+    bookmark_store_end_bulk(store);
+    BPlusTree *tree = store->views[view];
+    if (!filter) return bplus_tree_range(tree, offset, limit, ids_out);
+    
+    int matches = (int)roaring_bitmap_cardinality(filter);
+    if (offset >= matches) return 0;
+    int written = 0;
+    
+    if ((uint64_t)matches * VIEW_SORT_RATIO < (uint64_t)store->live_count) {
+        BookmarkId *ids = (BookmarkId *)malloc(matches * sizeof(BookmarkId));
+        BPlusEntry *entries = (BPlusEntry *)malloc(matches * sizeof(BPlusEntry));
+        int live = 0;
+        roaring_bitmap_to_array(filter, 0, matches, ids);
+        for (int i = 0; i < matches; i++) {
+            const BookmarkRecord *record = bookmark_store_get(store, ids[i]);
+            if (!record) continue;
+            entries[live].key = bookmark_view_key(record, view);
+            entries[live++].id = ids[i];
+        }
+        bplus_tree_sort(tree, entries, live);
+        for (int i = offset; i < live && written < limit; i++) ids_out[written++] = entries[i].id;
+        free(entries);
+        free(ids);
+        return written;
+    }
+    
+    BookmarkId chunk[VIEW_WALK_CHUNK];
+    int position = 0;
+    int skip = offset;
+    while (written < limit) {
+        int count = bplus_tree_range(tree, position, VIEW_WALK_CHUNK, chunk);
+        if (count == 0) break;
+        position += count;
+        for (int i = 0; i < count && written < limit; i++) {
+            if (!roaring_bitmap_contains(filter, chunk[i])) continue;
+            if (skip > 0) skip--;
+            else ids_out[written++] = chunk[i];
+        }
+    }
+    return written;
+}
+
+/**
+ * Most recently visited bookmarks, newest first
+ * Writes up to k ids to ids_out and returns how many were written
+ * Time Complexity: O(k)
+ */
+int bookmark_store_recent(BookmarkStore *store, int k, BookmarkId *ids_out) {
+    int count = 0;
+    for (BookmarkId id = store->recent_head; id != BOOKMARK_NONE && count < k;
+         id = store->records[id].recent_next) {
+        ids_out[count++] = id;
+    }
+    return count;
+}
+
+/**
+ * The k lowest-valued ids of a frecency heap, in order
+ * Shared by the store and read-only snapshots.
+ * Time Complexity: O(k d log(k d)) (see min_heap_extract_k)
+ */
+int bookmark_heap_lowest(MinHeap *heap, int k, BookmarkId *ids_out) {
+    if (k <= 0) return 0;
+    
+    HeapItem *items = (HeapItem *)malloc(k * sizeof(HeapItem));
+    int found = min_heap_extract_k(heap, k, items);
+    for (int i = 0; i < found; i++) {
+        ids_out[i] = (BookmarkId)items[i].id;
+    }
+    free(items);
+    return found;
+}
+
+/**
+ * Least used bookmarks, lowest frecency first (never visited before
+ * any visit; old visits sink below a few recent ones)
+ * Writes up to k ids to ids_out and returns how many were written
+ * Time Complexity: O(k d log(k d)) (see min_heap_extract_k)
+ */
+int bookmark_store_least_visited(BookmarkStore *store, int k, BookmarkId *ids_out) {
+    bookmark_store_end_bulk(store);
+    return bookmark_heap_lowest(store->least_visited, k, ids_out);
+}
+
+/**
+ * Number of live bookmarks
+ */
+int bookmark_store_count(BookmarkStore *store) {
+    return store->live_count;
+}
+
+/**
+ * Free the store, its records and every index
+ * Time Complexity: O(n)
+ */
+void bookmark_store_free(BookmarkStore *store) {
+    for (int i = 0; i < store->record_count; i++) {
+        if (store->records[i].live) free(store->records[i].title);
+    }
+    free(store->records);
+    free(store->free_ids);
+    free(store->url_index);
+    trie_free(store->titles);
+    min_heap_free(store->least_visited);
+    bookmark_text_free(store->text);
+    for (int i = 0; i < store->category_count; i++) {
+        free(store->categories[i].name);
+        roaring_bitmap_free(store->categories[i].ids);
+    }
+    free(store->categories);
+    bookmark_tags_free(store->tags);
+    for (int view = 0; view < BOOKMARK_VIEW_COUNT; view++) bplus_tree_free(store->views[view]);
+    free(store->bulk_ids);
+    free(store);
+}
+
+#ifndef BOOKMARK_STORE_NO_MAIN
+/**
+ * Print the records behind a list of ids
+ */
+void bookmark_store_print_ids(BookmarkStore *store, const BookmarkId *ids, int count) {
+    for (int i = 0; i < count; i++) {
+        const BookmarkRecord *record = bookmark_store_get(store, ids[i]);
+        printf("  [%u] %-28s %-32s visits: %u  frecency: %.2f\n", ids[i], record->title, record->url,
+               record->visit_count, bookmark_store_frecency(store, ids[i]));
+    }
+}
+
+/**
+ * Demonstration program
+ */
+int main() {
+    printf("=== Bookmark Store (libbookmarkstore) in C ===\n");
+    printf("Data Structure: Record table with hash, trie, heap, recent-list, tag and B+ tree indexes\n\n");
+    
+    BookmarkStore *store = bookmark_store_create(5);
+    
+    const char *sample[][3] = {
+        {"GitHub", "https://github.com", "Development"},
+        {"Stack Overflow", "https://stackoverflow.com", "Development"},
+        {"Google", "https://google.com", "Search"},
+        {"Gmail", "https://mail.google.com", "Email"},
+        {"Google Maps", "https://maps.google.com", "Maps"},
+        {"MDN Web Docs", "https://developer.mozilla.org", "Documentation"},
+        {"YouTube", "https://youtube.com", "Entertainment"},
+    };
+    int sample_count = sizeof(sample) / sizeof(sample[0]);
+    
+    printf("1. Adding bookmarks:\n");
+    for (int i = 0; i < sample_count; i++) {
+        BookmarkId id = bookmark_store_add(store, sample[i][0], sample[i][1], sample[i][2]);
+        printf("   id %u: %s\n", id, sample[i][0]);
+    }
+    printf("   Duplicate url rejected: %s\n",
+           bookmark_store_add(store, "GitHub again", "https://github.com", NULL) == BOOKMARK_NONE ? "yes" : "no");
+    printf("   Count: %d\n\n", bookmark_store_count(store));
+    
+    printf("2. Visiting bookmarks:\n");
+    const char *visits[] = {
+        "https://google.com", "https://github.com", "https://google.com",
+        "https://maps.google.com", "https://google.com", "https://github.com",
+    };
+    for (int i = 0; i < (int)(sizeof(visits) / sizeof(visits[0])); i++) {
+        bookmark_store_visit(store, bookmark_store_find_url(store, visits[i]));
+    }
+    printf("   6 visits recorded\n\n");
+    
+    BookmarkId ids[16];
+    int found;
+    
+    printf("3. Search \"g\" (highest frecency first):\n");
+    found = bookmark_store_search(store, "g", 16, ids);
+    bookmark_store_print_ids(store, ids, found);
+    
+    printf("\n4. Fuzzy search (typos, closest first):\n");
+    const char *typos[] = {"githbu", "gogle", "stak overflow"};
+    int distances[16];
+    for (int i = 0; i < 3; i++) {
+        found = bookmark_store_search_fuzzy(store, typos[i], 2, 16, ids, distances);
+        printf("   \"%s\": %d found, best distance %d\n", typos[i], found, found > 0 ? distances[0] : -1);
+        bookmark_store_print_ids(store, ids, found < 3 ? found : 3);
+    }
+    
+    printf("\n5. Full-text search (words of title, url or category):\n");
+    const char *queries[] = {"overflow", "google maps", "development"};
+    for (int i = 0; i < 3; i++) {
+        found = bookmark_store_search_text(store, queries[i], 16, ids, NULL);
+        printf("   \"%s\":\n", queries[i]);
+        bookmark_store_print_ids(store, ids, found);
+    }
+    
+    printf("\n6. Category filter (Development or Maps):\n");
+    const char *filters[] = {"Development", "Maps"};
+    RoaringBitmap *filtered = bookmark_store_filter(store, filters, 2);
+    found = roaring_bitmap_to_array(filtered, 0, 16, ids);
+    bookmark_store_print_ids(store, ids, found);
+    roaring_bitmap_free(filtered);
+    const char *names[16];
+    int counts[16];
+    int category_count = bookmark_store_categories(store, names, counts, 16);
+    printf("   Counts:");
+    for (int i = 0; i < category_count; i++) {
+        printf(" %s %d%s", names[i], counts[i], i + 1 < category_count ? "," : "\n");
+    }
+    
+    printf("\n7. Recently visited:\n");
+    found = bookmark_store_recent(store, 16, ids);
+    bookmark_store_print_ids(store, ids, found);
+    
+    printf("\n8. Least used (3):\n");
+    found = bookmark_store_least_visited(store, 3, ids);
+    bookmark_store_print_ids(store, ids, found);
+    
+    printf("\n9. Sorted views (kept in order, paged):\n");
+    printf("   By title, items 2-4:\n");
+    found = bookmark_store_page(store, BOOKMARK_VIEW_TITLE, NULL, 2, 3, ids);
+    bookmark_store_print_ids(store, ids, found);
+    printf("   Most visited, top 3:\n");
+    found = bookmark_store_page(store, BOOKMARK_VIEW_VISITS, NULL, 0, 3, ids);
+    bookmark_store_print_ids(store, ids, found);
+    printf("   Most recent in Development or Maps:\n");
+    filtered = bookmark_store_filter(store, filters, 2);
+    found = bookmark_store_page(store, BOOKMARK_VIEW_RECENT, filtered, 0, 16, ids);
+    bookmark_store_print_ids(store, ids, found);
+    roaring_bitmap_free(filtered);
+    
+    printf("\n10. Tags (a bookmark can have several):\n");
+    const char *tagging[][3] = {
+        {"https://github.com", "work", "code"},
+        {"https://stackoverflow.com", "code", "reference"},
+        {"https://developer.mozilla.org", "reference", "work"},
+        {"https://mail.google.com", "work", NULL},
+        {"https://google.com", "reference", NULL},
+    };
+    for (int i = 0; i < (int)(sizeof(tagging) / sizeof(tagging[0])); i++) {
+        BookmarkId tagged = bookmark_store_find_url(store, tagging[i][0]);
+        for (int t = 1; t < 3 && tagging[i][t]; t++) bookmark_store_tag(store, tagged, tagging[i][t]);
+    }
+    found = bookmark_store_tags_of(store, bookmark_store_find_url(store, "https://github.com"), names, 16);
+    printf("   GitHub:");
+    for (int i = 0; i < found; i++) printf(" #%s", names[i]);
+    printf("\n");
+    const char *with[] = {"work"}, *without[] = {"code"};
+    filtered = bookmark_store_tag_filter(store, with, 1, without, 1);
+    printf("   #work NOT #code, by title:\n");
+    found = bookmark_store_page(store, BOOKMARK_VIEW_TITLE, filtered, 0, 16, ids);
+    bookmark_store_print_ids(store, ids, found);
+    roaring_bitmap_free(filtered);
+    int tag_count = bookmark_store_tags(store, names, counts, 16);
+    printf("   Counts:");
+    for (int i = 0; i < tag_count; i++) {
+        printf(" %s %d%s", names[i], counts[i], i + 1 < tag_count ? "," : "\n");
+    }
+    
+    printf("\n11. Deleting Google:\n");
+    bookmark_store_delete(store, bookmark_store_find_url(store, "https://google.com"));
+    printf("   find_url: %s\n",
+           bookmark_store_find_url(store, "https://google.com") == BOOKMARK_NONE ? "not found" : "found");
+    found = bookmark_store_search(store, "g", 16, ids);
+    printf("   Search \"g\":\n");
+    bookmark_store_print_ids(store, ids, found);
+    found = bookmark_store_search_text(store, "google", 16, ids, NULL);
+    printf("   Full-text \"google\":\n");
+    bookmark_store_print_ids(store, ids, found);
+    found = bookmark_store_recent(store, 16, ids);
+    printf("   Recently visited:\n");
+    bookmark_store_print_ids(store, ids, found);
+    found = bookmark_store_page(store, BOOKMARK_VIEW_VISITS, NULL, 0, 3, ids);
+    printf("   Most visited, top 3:\n");
+    bookmark_store_print_ids(store, ids, found);
+    printf("   #reference now %d\n", bookmark_store_tag_count(store, "reference"));
+    
+    printf("\n12. Id reuse:\n");
+    BookmarkId id = bookmark_store_add(store, "Wikipedia", "https://wikipedia.org", "Reference");
+    printf("   Wikipedia got id %u (freed by Google), tags: %d\n", id, bookmark_store_tags_of(store, id, names, 16));
+    printf("   Count: %d\n", bookmark_store_count(store));
+    
+    printf("\n13. Frecency (frequent AND recent):\n");
+    BookmarkId forum = bookmark_store_add(store, "Rust Forum", "https://users.rust-lang.org", "Development");
+    BookmarkId blog = bookmark_store_add(store, "Rust Blog", "https://blog.rust-lang.org", "Development");
+    long long now = bookmark_store_now_ms();
+    long long day = 24LL * 60 * 60 * 1000;
+    for (int i = 0; i < 40; i++) bookmark_store_visit_at(store, forum, now - (180 + i) * day);
+    for (int i = 0; i < 3; i++) bookmark_store_visit_at(store, blog, now - i * day);
+    printf("   Forum: 40 visits six months ago, Blog: 3 visits this week\n");
+    found = bookmark_store_search(store, "rust", 16, ids);
+    printf("   Search \"rust\":\n");
+    bookmark_store_print_ids(store, ids, found);
+    found = bookmark_store_least_visited(store, 3, ids);
+    printf("   Least used (3):\n");
+    bookmark_store_print_ids(store, ids, found);
+    
+    bookmark_store_free(store);
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
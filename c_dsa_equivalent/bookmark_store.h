@@ -0,0 +1,173 @@
+/**
+ * Bookmark Store Interface (libbookmarkstore)
+ * One record table addressed by 32-bit ids, with the hash, trie, heap,
+ * recency list, tags and sorted views kept as secondary indexes over
+ * those ids
+ * (see bookmark_store.c for implementation notes)
+ */
+
+#ifndef BOOKMARK_STORE_H
+#define BOOKMARK_STORE_H
+
+#include <stdint.h>
+
+#include "trie.h"
+#include "min_heap.h"
+#include "bookmark_text.h"
+#include "roaring_bitmap.h"
+#include "bookmark_tags.h"
+#include "bplus_tree.h"
+
+#define BOOKMARK_NONE UINT32_MAX
+#define BOOKMARK_TITLE_MAX 248       // title bytes indexed by the trie
+#define BOOKMARK_DEFAULT_RECENT 20
+#define BOOKMARK_FRECENCY_HALF_LIFE_MS (30LL * 24 * 60 * 60 * 1000) // a visit's weight halves every 30 days
+#define BOOKMARK_FRECENCY_SCALE 4096     // frecency units per doubling (one half-life)
+#define BOOKMARK_FRECENCY_OFFSET (1u << 30) // frecency of a single visit at the epoch
+
+// Sorted views (bookmark_store_page)
+#define BOOKMARK_VIEW_RECENT 0       // last visit (creation if never visited), newest first
+#define BOOKMARK_VIEW_TITLE 1        // case-folded title, A to Z
+#define BOOKMARK_VIEW_VISITS 2       // visit count, most first
+#define BOOKMARK_VIEW_COUNT 3
+
+typedef uint32_t BookmarkId;
+
+/**
+ * One bookmark
+ * title, url and category share a single allocation (title first).
+ */
+typedef struct {
+    char *title;
+    char *url;
+    char *category;
+    unsigned int visit_count;
+    uint32_t frecency;           // log-domain decayed visit score, 0 if never visited
+    long long created_at;        // ms since the epoch
+    long long last_visited;      // ms since the epoch, 0 if never
+    uint32_t url_hash;
+    BookmarkId recent_prev;      // recency list links (ids)
+    BookmarkId recent_next;
+    unsigned char live;
+    unsigned char in_recent;
+} BookmarkRecord;
+
+/**
+ * URL index slot: full hash plus id, empty when id is BOOKMARK_NONE
+ */
+typedef struct {
+    uint32_t hash;
+    BookmarkId id;
+} BookmarkUrlSlot;
+
+/**
+ * Category index entry: a category name and the ids filed under it
+ * Entries stay once created, with an empty set when the last bookmark
+ * goes, so category lists do not reshuffle.
+ */
+typedef struct {
+    char *name;
+    uint32_t hash;
+    RoaringBitmap *ids;
+} BookmarkCategory;
+
+/**
+ * Bookmark Store structure
+ */
+typedef struct {
+    BookmarkRecord *records;     // indexed by id
+    int record_capacity;
+    int record_count;            // ids handed out so far (live or free)
+    int live_count;
+    BookmarkId *free_ids;        // deleted ids, reused first
+    int free_count;
+    int free_capacity;
+    
+    BookmarkUrlSlot *url_index;  // url -> id
+    int url_index_size;          // power of two
+    
+    Trie *titles;                // title + id -> frecency
+    MinHeap *least_visited;      // id -> frecency
+    BookmarkTextIndex *text;     // title/url/category words -> ids
+    BookmarkCategory *categories; // category -> ids
+    int category_count;
+    int category_capacity;
+    BookmarkTagIndex *tags;      // tag -> ids, id -> tags
+    BPlusTree *views[BOOKMARK_VIEW_COUNT]; // ids in each sort order
+    
+    BookmarkId recent_head;      // most recent first
+    BookmarkId recent_tail;
+    int recent_count;
+    int max_recent;
+    
+    long long frecency_epoch;    // ms since the epoch that frecency scores are relative to
+    long long frecency_half_life; // ms
+    
+    uint64_t mutations;          // successful add/delete/visit/tag/untag calls (WAL sequence)
+    
+    BookmarkId *bulk_ids;        // added since bulk mode began, not yet in trie/heap/views
+    int bulk_count;
+    int bulk_capacity;           // 0 when not in bulk mode
+} BookmarkStore;
+
+long long bookmark_store_now_ms(void);
+BookmarkStore *bookmark_store_create(int max_recent);
+BookmarkId bookmark_store_add(BookmarkStore *store, const char *title, const char *url,
+                              const char *category);
+BookmarkId bookmark_store_add_at(BookmarkStore *store, const char *title, const char *url,
+                                 const char *category, long long created_at);
+int bookmark_store_delete(BookmarkStore *store, BookmarkId id);
+int bookmark_store_visit(BookmarkStore *store, BookmarkId id);
+int bookmark_store_visit_at(BookmarkStore *store, BookmarkId id, long long time);
+double bookmark_store_frecency(BookmarkStore *store, BookmarkId id);
+int bookmark_store_tag(BookmarkStore *store, BookmarkId id, const char *tag);
+int bookmark_store_untag(BookmarkStore *store, BookmarkId id, const char *tag);
+int bookmark_store_tags_of(BookmarkStore *store, BookmarkId id, const char **names_out, int max);
+const BookmarkRecord *bookmark_store_get(BookmarkStore *store, BookmarkId id);
+BookmarkId bookmark_store_find_url(BookmarkStore *store, const char *url);
+int bookmark_store_search(BookmarkStore *store, const char *prefix, int k, BookmarkId *ids_out);
+int bookmark_store_search_fuzzy(BookmarkStore *store, const char *prefix, int max_distance, int k,
+                                BookmarkId *ids_out, int *distances_out);
+int bookmark_store_search_text(BookmarkStore *store, const char *query, int k, BookmarkId *ids_out,
+                               double *scores_out);
+RoaringBitmap *bookmark_store_filter(BookmarkStore *store, const char *const *categories, int count);
+int bookmark_store_category_count(BookmarkStore *store, const char *category);
+int bookmark_store_categories(BookmarkStore *store, const char **names_out, int *counts_out, int max);
+RoaringBitmap *bookmark_store_tag_filter(BookmarkStore *store, const char *const *all, int all_count,
+                                         const char *const *none, int none_count);
+int bookmark_store_tag_count(BookmarkStore *store, const char *tag);
+int bookmark_store_tags(BookmarkStore *store, const char **names_out, int *counts_out, int max);
+int bookmark_store_page(BookmarkStore *store, int view, const RoaringBitmap *filter, int offset, int limit,
+                        BookmarkId *ids_out);
+int bookmark_store_recent(BookmarkStore *store, int k, BookmarkId *ids_out);
+int bookmark_store_least_visited(BookmarkStore *store, int k, BookmarkId *ids_out);
+int bookmark_store_count(BookmarkStore *store);
+void bookmark_store_begin_bulk(BookmarkStore *store);
+void bookmark_store_end_bulk(BookmarkStore *store);
+void bookmark_store_free(BookmarkStore *store);
+
+/**
+ * Title + id pair sorted to order bulk trie inserts
+ */
+typedef struct {
+    const char *title;
+    BookmarkId id;
+} BookmarkTitleRef;
+
+// Index helpers shared with snapshots and parallel builds
+// (bookmark_snapshot.c, bookmark_build.c)
+uint32_t bookmark_frecency_add(uint32_t frecency, long long time, long long epoch, long long half_life);
+double bookmark_frecency_value(uint32_t frecency, long long now, long long epoch, long long half_life);
+uint32_t bookmark_url_hash(const char *url);
+int bookmark_url_home(int index_size, uint32_t hash);
+int bookmark_title_key(const char *title, BookmarkId id, char *key);
+int bookmark_title_ref_compare(const void *a, const void *b);
+int bookmark_titles_top_k(Trie *titles, const char *prefix, int k, BookmarkId *ids_out);
+int bookmark_titles_fuzzy(Trie *titles, const char *prefix, int max_distance, int k,
+                          BookmarkId *ids_out, int *distances_out);
+int bookmark_heap_lowest(MinHeap *heap, int k, BookmarkId *ids_out);
+void bookmark_derived_add(BookmarkStore *store, BookmarkId id);
+uint64_t bookmark_view_key(const BookmarkRecord *record, int view);
+void bookmark_views_add(BookmarkStore *store, const BookmarkId *ids, int count);
+
+#endif
@@ -0,0 +1,704 @@
+/**
+ * Bookmark Tag Index in C
+ * Many-to-many tags on bookmarks with "A AND B NOT C" queries
+ * 
+ * A category is one string per bookmark; tags let a bookmark sit under
+ * any number of labels without a second record (which would double the
+ * memory and defeat the URL index's duplicate check). Tag names are
+ * interned once:
+ *   Dictionary - open addressing over (hash, tag id) slots, names in one
+ *                string buffer, so a bookmark's tags are small integers
+ *   Postings   - per tag, a sorted array of the bookmark ids carrying it;
+ *                its length is the tag's count, read in O(1)
+ *   Tag lists  - per bookmark id, the tag ids it carries, so untagging
+ *                and deleting a bookmark touch only its own postings
+ * Fresh ids are the largest yet, so tagging a new bookmark appends to
+ * each posting array; other changes shift one array (memmove).
+ * 
+ * Queries start from the rarest required tag and narrow it with each
+ * other required tag (AND), then drop each excluded tag (NOT). Lists of
+ * similar size are merged a block at a time: a block of a is compared
+ * against every rotation of a block of b (AVX2 8x8 / SSE2 4x4, scalar
+ * fallback), and whichever block ends lower moves on. When one list is
+ * TAG_GALLOP_RATIO times shorter, its ids gallop through the other
+ * instead, so a rare tag costs O(r log(n / r)), not O(n). Results are
+ * written in place over the running result, which never grows.
+ * 
+ * Compile: gcc -O2 -DHASH_TABLE_NO_MAIN -o bookmark_tags bookmark_tags.c hash_table.c -lm   (add -mavx2 for 8-wide merges)
+ * Run: ./bookmark_tags
+ *      ./bookmark_tags --bench [n]   (tag queries on n bookmarks vs a scan)
+ * Define BOOKMARK_TAGS_NO_MAIN to link it into libbookmarkstore.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <time.h>
+
+#include "bookmark_tags.h"
+#include "hash_table.h"
+
+#define TAGS_INITIAL_SLOTS 64
+#define TAGS_INITIAL_POSTINGS 4
+
+/**
+ * Home slot of a hash (Fibonacci hashing on the top bits)
+ */
+int tags_slot_home(int slot_count, uint32_t hash) {
+    int bits = __builtin_ctz(slot_count);
+    return (int)((hash * 2654435769u) >> (32 - bits));
+}
+
+/**
+ * Trim surrounding whitespace and cut to TAG_MAX_NAME bytes without
+ * splitting a UTF-8 sequence
+ * Writes the name to out (TAG_MAX_NAME + 1 bytes) and returns its length
+ */
+int tags_normalize(const char *name, char *out) {
+    while (isspace((unsigned char)*name)) name++;
+    int length = (int)strlen(name);
+    while (length > 0 && isspace((unsigned char)name[length - 1])) length--;
+    if (length > TAG_MAX_NAME) {
+        length = TAG_MAX_NAME;
+        while (length > 0 && ((unsigned char)name[length] & 0xC0) == 0x80) length--;
+    }
+    memcpy(out, name, length);
+    out[length] = '\0';
+    return length;
+}
+
+/**
+ * Find a normalized name's tag id, or -1
+ * Time Complexity: O(1) average
+ */
+int tags_lookup(const BookmarkTagIndex *index, const char *name, uint32_t hash) {
+    int mask = index->slot_count - 1;
+    for (int i = tags_slot_home(index->slot_count, hash); index->slots[i].tag >= 0; i = (i + 1) & mask) {
+        const BookmarkTagSlot *slot = &index->slots[i];
+        if (slot->hash == hash && strcmp(index->strings + index->tags[slot->tag].name, name) == 0) return slot->tag;
+    }
+    return -1;
+}
+
+/**
+ * Put a slot in the first free place of its probe sequence
+ */
+void tags_slot_place(BookmarkTagIndex *index, BookmarkTagSlot slot) {
+    int mask = index->slot_count - 1;
+    int i = tags_slot_home(index->slot_count, slot.hash);
+    while (index->slots[i].tag >= 0) i = (i + 1) & mask;
+    index->slots[i] = slot;
+}
+
+/**
+ * Empty slot array
+ */
+BookmarkTagSlot *tags_slots_alloc(int slot_count) {
+    BookmarkTagSlot *slots = (BookmarkTagSlot *)malloc(slot_count * sizeof(BookmarkTagSlot));
+    for (int i = 0; i < slot_count; i++) slots[i].tag = -1;
+    return slots;
+}
+
+/**
+ * Double the dictionary once it passes 3/4 load
+ * Time Complexity: O(t) per resize, O(1) amortized
+ */
+void tags_slots_reserve(BookmarkTagIndex *index) {
+    if ((index->tag_count + 1) * 4 <= index->slot_count * 3) return;
+    
+    BookmarkTagSlot *old = index->slots;
+    int old_count = index->slot_count;
+    index->slot_count *= 2;
+    index->slots = tags_slots_alloc(index->slot_count);
+    for (int i = 0; i < old_count; i++) {
+        if (old[i].tag >= 0) tags_slot_place(index, old[i]);
+    }
+    free(old);
+}
+
+/**
+ * Create empty index
+ * Time Complexity: O(1)
+ */
+BookmarkTagIndex *bookmark_tags_create(void) {
+    BookmarkTagIndex *index = (BookmarkTagIndex *)calloc(1, sizeof(BookmarkTagIndex));
+    index->tag_capacity = 16;
+    index->tags = (BookmarkTag *)malloc(index->tag_capacity * sizeof(BookmarkTag));
+    index->slot_count = TAGS_INITIAL_SLOTS;
+    index->slots = tags_slots_alloc(index->slot_count);
+    index->strings_capacity = 256;
+    index->strings = (char *)malloc(index->strings_capacity);
+    return index;
+}
+
+/**
+ * Tag id of a name (trimmed), or -1 if no bookmark was ever tagged so
+ * Time Complexity: O(m) average for m = name length
+ */
+int bookmark_tags_find(const BookmarkTagIndex *index, const char *name) {
+    char normalized[TAG_MAX_NAME + 1];
+    int length = tags_normalize(name, normalized);
+    if (length == 0) return -1;
+    return tags_lookup(index, normalized, (uint32_t)hash_wy(normalized, length));
+}
+
+/**
+ * Tag id of a name (trimmed), adding the tag if it is new
+ * Returns -1 for a name that is empty after trimming
+ * Time Complexity: O(m) average
+ */
+int bookmark_tags_intern(BookmarkTagIndex *index, const char *name) {
+    char normalized[TAG_MAX_NAME + 1];
+    int length = tags_normalize(name, normalized);
+    if (length == 0) return -1;
+    uint32_t hash = (uint32_t)hash_wy(normalized, length);
+    int found = tags_lookup(index, normalized, hash);
+    if (found >= 0) return found;
+    
+    tags_slots_reserve(index);
+    if (index->tag_count == index->tag_capacity) {
+        index->tag_capacity *= 2;
+        index->tags = (BookmarkTag *)realloc(index->tags, index->tag_capacity * sizeof(BookmarkTag));
+    }
+    while (index->strings_used + length + 1 > index->strings_capacity) {
+        index->strings_capacity *= 2;
+        index->strings = (char *)realloc(index->strings, index->strings_capacity);
+    }
+    
+    BookmarkTag *tag = &index->tags[index->tag_count];
+    memset(tag, 0, sizeof(BookmarkTag));
+    tag->hash = hash;
+    tag->name = (uint32_t)index->strings_used;
+    memcpy(index->strings + index->strings_used, normalized, length + 1);
+    index->strings_used += length + 1;
+    
+    tags_slot_place(index, (BookmarkTagSlot){ hash, index->tag_count });
+    return index->tag_count++;
+}
+
+/**
+ * Name of a tag id, or NULL
+ */
+const char *bookmark_tags_name(const BookmarkTagIndex *index, int tag) {
+    return tag >= 0 && tag < index->tag_count ? index->strings + index->tags[tag].name : NULL;
+}
+
+/**
+ * Tag list of a bookmark id, grown to cover it
+ */
+BookmarkTagList *tags_doc(BookmarkTagIndex *index, uint32_t id) {
+    if (id >= (uint32_t)index->doc_capacity) {
+        int capacity = index->doc_capacity > 0 ? index->doc_capacity : 16;
+        while ((uint32_t)capacity <= id) capacity *= 2;
+        index->docs = (BookmarkTagList *)realloc(index->docs, capacity * sizeof(BookmarkTagList));
+        memset(index->docs + index->doc_capacity, 0, (capacity - index->doc_capacity) * sizeof(BookmarkTagList));
+        index->doc_capacity = capacity;
+    }
+    return &index->docs[id];
+}
+
+/**
+ * First position from from on holding an id >= target (count if none)
+ * Steps 1, 2, 4, ... ahead, then binary searches the last step, so the
+ * cost grows with the distance moved rather than the array length.
+ * Time Complexity: O(log d) for d = positions skipped
+ */
+int tags_gallop(const uint32_t *ids, int from, int count, uint32_t target) {
+    if (from >= count || ids[from] >= target) return from;
+    int low = from, step = 1;
+    while (low + step < count && ids[low + step] < target) {
+        low += step;
+        step *= 2;
+    }
+    int high = low + step < count ? low + step : count;
+    // ids[low] < target; ids[high] >= target or high == count
+    while (high - low > 1) {
+        int mid = low + (high - low) / 2;
+        if (ids[mid] < target) low = mid; else high = mid;
+    }
+    return high;
+}
+
+/**
+ * Insert an id into a tag's postings
+ * Returns 0 if it was already there
+ * Time Complexity: O(1) for a new largest id, else O(n)
+ */
+int tags_posting_insert(BookmarkTag *tag, uint32_t id) {
+    int at = tag->count;
+    if (at > 0 && tag->ids[at - 1] >= id) {
+        at = tags_gallop(tag->ids, 0, tag->count, id);
+        if (tag->ids[at] == id) return 0;
+    }
+    if (tag->count == tag->capacity) {
+        tag->capacity = tag->capacity > 0 ? tag->capacity * 2 : TAGS_INITIAL_POSTINGS;
+        tag->ids = (uint32_t *)realloc(tag->ids, tag->capacity * sizeof(uint32_t));
+    }
+    memmove(&tag->ids[at + 1], &tag->ids[at], (tag->count - at) * sizeof(uint32_t));
+    tag->ids[at] = id;
+    tag->count++;
+    return 1;
+}
+
+/**
+ * Remove an id from a tag's postings
+ * Time Complexity: O(n)
+ */
+void tags_posting_remove(BookmarkTag *tag, uint32_t id) {
+    int at = tags_gallop(tag->ids, 0, tag->count, id);
+    if (at == tag->count || tag->ids[at] != id) return;
+    memmove(&tag->ids[at], &tag->ids[at + 1], (tag->count - at - 1) * sizeof(uint32_t));
+    tag->count--;
+}
+
+/**
+ * Tag bookmark id with a tag id
+ * Returns 1 if added, 0 if it already had the tag, the tag id is
+ * unknown or the bookmark has TAG_MAX_PER_BOOKMARK tags
+ * Time Complexity: O(k) for k = the bookmark's tags, plus the insert
+ */
+int bookmark_tags_add(BookmarkTagIndex *index, uint32_t id, int tag) {
+    if (tag < 0 || tag >= index->tag_count) return 0;
+    BookmarkTagList *doc = tags_doc(index, id);
+    for (int i = 0; i < doc->count; i++) {
+        if (doc->tags[i] == (uint32_t)tag) return 0;
+    }
+    if (doc->count == TAG_MAX_PER_BOOKMARK) return 0;
+    
+    if (doc->count == doc->capacity) {
+        int capacity = doc->capacity > 0 ? doc->capacity * 2 : 2;
+        doc->capacity = (uint8_t)(capacity < TAG_MAX_PER_BOOKMARK ? capacity : TAG_MAX_PER_BOOKMARK);
+        doc->tags = (uint32_t *)realloc(doc->tags, doc->capacity * sizeof(uint32_t));
+    }
+    doc->tags[doc->count++] = (uint32_t)tag;
+    tags_posting_insert(&index->tags[tag], id);
+    index->links++;
+    return 1;
+}
+
+/**
+ * Take a tag off bookmark id
+ * Returns 0 if it did not have the tag
+ * Time Complexity: O(k + n) for n = bookmarks with the tag
+ */
+int bookmark_tags_remove(BookmarkTagIndex *index, uint32_t id, int tag) {
+    if (id >= (uint32_t)index->doc_capacity) return 0;
+    BookmarkTagList *doc = &index->docs[id];
+    for (int i = 0; i < doc->count; i++) {
+        if (doc->tags[i] != (uint32_t)tag) continue;
+        memmove(&doc->tags[i], &doc->tags[i + 1], (doc->count - i - 1) * sizeof(uint32_t));
+        doc->count--;
+        tags_posting_remove(&index->tags[tag], id);
+        index->links--;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Take every tag off bookmark id (when it is deleted)
+ * Time Complexity: O(sum of its tags' bookmark counts)
+ */
+void bookmark_tags_clear(BookmarkTagIndex *index, uint32_t id) {
+    if (id >= (uint32_t)index->doc_capacity) return;
+    BookmarkTagList *doc = &index->docs[id];
+    for (int i = 0; i < doc->count; i++) {
+        tags_posting_remove(&index->tags[doc->tags[i]], id);
+    }
+    index->links -= doc->count;
+    free(doc->tags);
+    memset(doc, 0, sizeof(BookmarkTagList));
+}
+
+/**
+ * Tag ids of bookmark id, in the order they were added
+ * Points *tags_out at them and returns how many there are
+ * Time Complexity: O(1)
+ */
+int bookmark_tags_of(const BookmarkTagIndex *index, uint32_t id, const uint32_t **tags_out) {
+    if (id >= (uint32_t)index->doc_capacity || index->docs[id].count == 0) {
+        *tags_out = NULL;
+        return 0;
+    }
+    *tags_out = index->docs[id].tags;
+    return index->docs[id].count;
+}
+
+/**
+ * Bookmarks carrying a tag
+ * Time Complexity: O(1)
+ */
+int bookmark_tags_count(const BookmarkTagIndex *index, int tag) {
+    return tag >= 0 && tag < index->tag_count ? index->tags[tag].count : 0;
+}
+
+/**
+ * Copy the lanes of block set in keep to out; returns how many
+ */
+int tags_emit(uint32_t *out, const uint32_t *block, int lanes, unsigned int keep) {
+    int written = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        if ((keep >> lane) & 1) out[written++] = block[lane];
+    }
+    return written;
+}
+
+/**
+ * a AND b, or a NOT b when exclude is set, of two sorted id arrays
+ * out may be a (results never run ahead of the ids read). Returns the
+ * number of ids written.
+ * Time Complexity: O(r log(n / r)) when one side (r ids) is much
+ * shorter, else O((n + m) / w) vector steps for w lanes
+ */
+int bookmark_tags_merge(const uint32_t *a, int a_count, const uint32_t *b, int b_count, uint32_t *out,
+                        int exclude) {
+    int i = 0, j = 0, written = 0;
+    if (b_count == 0 || a_count == 0) {
+        if (!exclude) return 0;
+        memmove(out, a, a_count * sizeof(uint32_t));
+        return a_count;
+    }
+    
+    // a much shorter: look each of its ids up in b
+    if ((long)a_count * TAG_GALLOP_RATIO < b_count) {
+        for (; i < a_count; i++) {
+            j = tags_gallop(b, j, b_count, a[i]);
+            int found = j < b_count && b[j] == a[i];
+            if (found != exclude) out[written++] = a[i];
+        }
+        return written;
+    }
+    
+    // b much shorter: find each of its ids in a
+    if ((long)b_count * TAG_GALLOP_RATIO < a_count) {
+        for (; j < b_count && i < a_count; j++) {
+            int at = tags_gallop(a, i, a_count, b[j]);
+            int found = at < a_count && a[at] == b[j];
+            if (exclude) {
+                memmove(out + written, a + i, (at - i) * sizeof(uint32_t));
+                written += at - i;
+                i = found ? at + 1 : at;
+            } else {
+                if (found) out[written++] = b[j];
+                i = at;
+            }
+        }
+        if (exclude) {
+            memmove(out + written, a + i, (a_count - i) * sizeof(uint32_t));
+            written += a_count - i;
+        }
+        return written;
+    }
+    
+    // Similar sizes: all-pairs compare of one block of each per step.
+    // matched collects the lanes of a's current block seen in b; the block
+    // is emitted when it moves on, since b's later blocks are all larger.
+    unsigned int matched = 0;
+#if defined(__AVX2__)
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= a_count && j + 8 <= b_count) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+        __m256i equal = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(va, vb));
+        }
+        matched |= (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(equal));
+        
+        uint32_t a_last = a[i + 7], b_last = b[j + 7];
+        if (a_last <= b_last) {
+            written += tags_emit(out + written, a + i, 8, exclude ? ~matched & 0xFF : matched);
+            matched = 0;
+            i += 8;
+        }
+        if (b_last <= a_last) j += 8;
+    }
+#elif defined(__SSE2__)
+    while (i + 4 <= a_count && j + 4 <= b_count) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i equal = _mm_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 4; r++) {
+            vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, vb));
+        }
+        matched |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(equal));
+        
+        uint32_t a_last = a[i + 3], b_last = b[j + 3];
+        if (a_last <= b_last) {
+            written += tags_emit(out + written, a + i, 4, exclude ? ~matched & 0xF : matched);
+            matched = 0;
+            i += 4;
+        }
+        if (b_last <= a_last) j += 4;
+    }
+#endif
+    
+    // Scalar tail; the first lanes may already be matched by earlier blocks of b
+    for (int lane = 0; i < a_count; i++, lane++) {
+        while (j < b_count && b[j] < a[i]) j++;
+        int found = (lane < 32 && ((matched >> lane) & 1)) || (j < b_count && b[j] == a[i]);
+        if (found != exclude) out[written++] = a[i];
+    }
+    return written;
+}
+
+/**
+ * Bookmarks carrying every tag in all and none of the tags in none
+ * all must name at least one tag. Points *ids_out at a sorted array the
+ * caller frees and returns its length; unknown tags in all match
+ * nothing, unknown tags in none are ignored.
+ * Time Complexity: O(a log a) to order the lists, then one merge per
+ * tag, each bounded by the running result (see bookmark_tags_merge)
+ */
+int bookmark_tags_query(const BookmarkTagIndex *index, const int *all, int all_count, const int *none,
+                        int none_count, uint32_t **ids_out) {
+    *ids_out = NULL;
+    if (all_count <= 0) return 0;
+    for (int t = 0; t < all_count; t++) {
+        if (all[t] < 0 || all[t] >= index->tag_count) return 0;
+    }
+    
+    // Rarest first: the running result only shrinks from there
+    int *order = (int *)malloc(all_count * sizeof(int));
+    memcpy(order, all, all_count * sizeof(int));
+    for (int t = 1; t < all_count; t++) {
+        int tag = order[t], at = t;
+        while (at > 0 && index->tags[order[at - 1]].count > index->tags[tag].count) {
+            order[at] = order[at - 1];
+            at--;
+        }
+        order[at] = tag;
+    }
+    
+    const BookmarkTag *rarest = &index->tags[order[0]];
+    uint32_t *result = (uint32_t *)malloc((rarest->count + 1) * sizeof(uint32_t));
+    int count = rarest->count;
+    if (count > 0) memcpy(result, rarest->ids, count * sizeof(uint32_t));
+    for (int t = 1; t < all_count && count > 0; t++) {
+        const BookmarkTag *tag = &index->tags[order[t]];
+        count = bookmark_tags_merge(result, count, tag->ids, tag->count, result, 0);
+    }
+    for (int t = 0; t < none_count && count > 0; t++) {
+        if (none[t] < 0 || none[t] >= index->tag_count) continue;
+        const BookmarkTag *tag = &index->tags[none[t]];
+        count = bookmark_tags_merge(result, count, tag->ids, tag->count, result, 1);
+    }
+    
+    free(order);
+    *ids_out = result;
+    return count;
+}
+
+/**
+ * Bytes held by the index
+ * Time Complexity: O(t + d) for t = tags, d = bookmark ids covered
+ */
+size_t bookmark_tags_memory_usage(const BookmarkTagIndex *index) {
+    size_t bytes = sizeof(BookmarkTagIndex) + index->tag_capacity * sizeof(BookmarkTag);
+    bytes += index->slot_count * sizeof(BookmarkTagSlot) + index->strings_capacity;
+    bytes += index->doc_capacity * sizeof(BookmarkTagList);
+    for (int t = 0; t < index->tag_count; t++) bytes += index->tags[t].capacity * sizeof(uint32_t);
+    for (int d = 0; d < index->doc_capacity; d++) bytes += index->docs[d].capacity * sizeof(uint32_t);
+    return bytes;
+}
+
+/**
+ * Free index
+ * Time Complexity: O(t + d)
+ */
+void bookmark_tags_free(BookmarkTagIndex *index) {
+    for (int t = 0; t < index->tag_count; t++) free(index->tags[t].ids);
+    for (int d = 0; d < index->doc_capacity; d++) free(index->docs[d].tags);
+    free(index->tags);
+    free(index->slots);
+    free(index->strings);
+    free(index->docs);
+    free(index);
+}
+
+#ifndef BOOKMARK_TAGS_NO_MAIN
+#define BENCH_TAGS 200
+#define BENCH_QUERIES 2000
+
+double tags_bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int tags_bench_compare_latency(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Baseline: does a bookmark's tag list satisfy the query? (linear scan)
+ */
+int tags_bench_scan_match(const uint32_t *tags, int count, const int *all, int all_count, const int *none,
+                          int none_count) {
+    for (int t = 0; t < all_count; t++) {
+        int found = 0;
+        for (int i = 0; i < count && !found; i++) found = tags[i] == (uint32_t)all[t];
+        if (!found) return 0;
+    }
+    for (int t = 0; t < none_count; t++) {
+        for (int i = 0; i < count; i++) {
+            if (tags[i] == (uint32_t)none[t]) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Tag n bookmarks with 1-5 skewed tags each, then time "A AND B NOT C"
+ * style queries against scanning every bookmark's tag list
+ */
+void tags_bench(int n) {
+    printf("Tag index benchmark: %d bookmarks, %d tags\n", n, BENCH_TAGS);
+    BookmarkTagIndex *index = bookmark_tags_create();
+    for (int t = 0; t < BENCH_TAGS; t++) {
+        char name[16];
+        snprintf(name, sizeof(name), "tag%d", t);
+        bookmark_tags_intern(index, name);
+    }
+    
+    // Tag t is drawn about 1 / (t + 1) as often as tag 0 (Zipf-like)
+    double *weights = (double *)malloc(BENCH_TAGS * sizeof(double));
+    double total = 0;
+    for (int t = 0; t < BENCH_TAGS; t++) total += 1.0 / (t + 1);
+    for (int t = 0; t < BENCH_TAGS; t++) weights[t] = 1.0 / (t + 1) / total;
+    
+    srand(5);
+    double start = tags_bench_seconds();
+    for (int id = 0; id < n; id++) {
+        for (int k = 1 + rand() % 5; k > 0; k--) {
+            double pick = (double)rand() / RAND_MAX;
+            int t = 0;
+            while (t < BENCH_TAGS - 1 && pick > weights[t]) pick -= weights[t++];
+            bookmark_tags_add(index, (uint32_t)id, t);
+        }
+    }
+    double build = tags_bench_seconds() - start;
+    printf("  Tagged in %.1f ms, %ld links, %.2f MB\n", build * 1e3, index->links,
+           bookmark_tags_memory_usage(index) / 1048576.0);
+    
+    struct { const char *label; int all[3]; int all_count; int none[2]; int none_count; } shapes[] = {
+        { "A AND B (common)", {0, 1}, 2, {0}, 0 },
+        { "A AND B NOT C", {0, 2}, 2, {1}, 1 },
+        { "rare AND common", {150, 0}, 2, {0}, 0 },
+        { "A AND B AND C", {0, 1, 3}, 3, {0}, 0 },
+        { "A NOT B NOT C", {4}, 1, {0, 1}, 2 },
+    };
+    double *latency = (double *)malloc(BENCH_QUERIES * sizeof(double));
+    printf("  %-18s %9s %10s %10s %10s\n", "query", "matches", "p50 (us)", "p99 (us)", "scan (us)");
+    for (int s = 0; s < (int)(sizeof(shapes) / sizeof(shapes[0])); s++) {
+        int matches = 0;
+        for (int q = 0; q < BENCH_QUERIES; q++) {
+            uint32_t *ids;
+            double t = tags_bench_seconds();
+            matches = bookmark_tags_query(index, shapes[s].all, shapes[s].all_count, shapes[s].none,
+                                          shapes[s].none_count, &ids);
+            latency[q] = tags_bench_seconds() - t;
+            free(ids);
+        }
+        qsort(latency, BENCH_QUERIES, sizeof(double), tags_bench_compare_latency);
+        
+        start = tags_bench_seconds();
+        int scanned = 0;
+        for (int id = 0; id < n; id++) {
+            const uint32_t *tags;
+            int count = bookmark_tags_of(index, (uint32_t)id, &tags);
+            scanned += tags_bench_scan_match(tags, count, shapes[s].all, shapes[s].all_count, shapes[s].none,
+                                             shapes[s].none_count);
+        }
+        double scan = tags_bench_seconds() - start;
+        printf("  %-18s %9d %10.1f %10.1f %10.1f%s\n", shapes[s].label, matches,
+               latency[BENCH_QUERIES / 2] * 1e6, latency[BENCH_QUERIES * 99 / 100] * 1e6, scan * 1e6,
+               scanned == matches ? "" : "  MISMATCH");
+    }
+    
+    free(latency);
+    free(weights);
+    bookmark_tags_free(index);
+}
+
+/**
+ * Print the bookmarks matching a query
+ */
+void tags_print_query(BookmarkTagIndex *index, const char *const *titles, const char *label, const int *all,
+                      int all_count, const int *none, int none_count) {
+    uint32_t *ids;
+    int count = bookmark_tags_query(index, all, all_count, none, none_count, &ids);
+    printf("   %-32s", label);
+    for (int i = 0; i < count; i++) printf(" %s%s", titles[ids[i]], i + 1 < count ? "," : "");
+    printf("%s\n", count == 0 ? " (none)" : "");
+    free(ids);
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        tags_bench(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    
+    printf("=== Bookmark Tag Index in C ===\n");
+    printf("Data Structure: Interned tag ids, sorted posting arrays, SIMD block merge\n\n");
+    
+    const char *titles[] = { "GitHub", "Stack Overflow", "MDN Web Docs", "YouTube", "Figma", "Hacker News" };
+    const char *tagging[][4] = {
+        { "work", "code", NULL },
+        { "work", "code", "reference" },
+        { "reference", "reading", "code" },
+        { "video", NULL },
+        { "work", "design", NULL },
+        { "reading", "news", "  work  " },
+    };
+    int bookmark_count = sizeof(titles) / sizeof(titles[0]);
+    
+    BookmarkTagIndex *index = bookmark_tags_create();
+    printf("1. Tagging %d bookmarks:\n", bookmark_count);
+    for (int id = 0; id < bookmark_count; id++) {
+        for (int t = 0; t < 4 && tagging[id][t]; t++) {
+            bookmark_tags_add(index, (uint32_t)id, bookmark_tags_intern(index, tagging[id][t]));
+        }
+        const uint32_t *tags;
+        int count = bookmark_tags_of(index, (uint32_t)id, &tags);
+        printf("   %-14s", titles[id]);
+        for (int t = 0; t < count; t++) printf(" #%s", bookmark_tags_name(index, (int)tags[t]));
+        printf("\n");
+    }
+    
+    printf("\n2. Tag counts:\n  ");
+    for (int t = 0; t < index->tag_count; t++) {
+        printf(" %s %d%s", bookmark_tags_name(index, t), bookmark_tags_count(index, t),
+               t + 1 < index->tag_count ? "," : "\n");
+    }
+    
+    int work = bookmark_tags_find(index, "work");
+    int code = bookmark_tags_find(index, "code");
+    int reading = bookmark_tags_find(index, "reading");
+    int reference = bookmark_tags_find(index, "reference");
+    printf("\n3. Queries:\n");
+    tags_print_query(index, titles, "work AND code", (int[]){ work, code }, 2, NULL, 0);
+    tags_print_query(index, titles, "code NOT work", (int[]){ code }, 1, (int[]){ work }, 1);
+    tags_print_query(index, titles, "reading AND reference", (int[]){ reading, reference }, 2, NULL, 0);
+    tags_print_query(index, titles, "work NOT code NOT design", (int[]){ work }, 1,
+                     (int[]){ code, bookmark_tags_find(index, "design") }, 2);
+    
+    printf("\n4. Untagging Stack Overflow #work, deleting GitHub:\n");
+    bookmark_tags_remove(index, 1, work);
+    bookmark_tags_clear(index, 0);
+    tags_print_query(index, titles, "work AND code", (int[]){ work, code }, 2, NULL, 0);
+    tags_print_query(index, titles, "code NOT work", (int[]){ code }, 1, (int[]){ work }, 1);
+    printf("   #work now %d, #code now %d\n", bookmark_tags_count(index, work), bookmark_tags_count(index, code));
+    
+    bookmark_tags_free(index);
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
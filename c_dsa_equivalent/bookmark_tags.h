@@ -0,0 +1,91 @@
+/**
+ * Bookmark Tag Index Interface
+ * Many-to-many tags: interned tag ids, a sorted posting array of
+ * bookmark ids per tag and the tag list of each bookmark
+ * (see bookmark_tags.c for implementation notes)
+ */
+
+#ifndef BOOKMARK_TAGS_H
+#define BOOKMARK_TAGS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define TAG_MAX_NAME 64              // longer tag names are cut to this many bytes
+#define TAG_MAX_PER_BOOKMARK 255
+#define TAG_GALLOP_RATIO 32          // size ratio above which merges gallop
+
+/**
+ * One tag: its name and the ids carrying it
+ * count is the tag's bookmark count, kept as the array changes, so
+ * counts never walk the postings.
+ */
+typedef struct {
+    uint32_t *ids;               // sorted, no duplicates
+    int count;
+    int capacity;
+    uint32_t hash;
+    uint32_t name;               // offset of the name in the string buffer
+} BookmarkTag;
+
+/**
+ * Dictionary slot: hash copied from the tag, empty when tag < 0
+ */
+typedef struct {
+    uint32_t hash;
+    int tag;
+} BookmarkTagSlot;
+
+/**
+ * Tags of one bookmark, in the order they were added
+ */
+typedef struct {
+    uint32_t *tags;
+    uint8_t count;
+    uint8_t capacity;
+} BookmarkTagList;
+
+/**
+ * Tag index structure
+ * Tag ids are dense and never reused; a tag whose last bookmark goes
+ * keeps its id with a count of 0.
+ */
+typedef struct {
+    BookmarkTag *tags;
+    int tag_count;
+    int tag_capacity;
+    BookmarkTagSlot *slots;      // name -> tag id, open addressing
+    int slot_count;              // power of two
+    char *strings;               // NUL-terminated tag names
+    size_t strings_used;
+    size_t strings_capacity;
+    BookmarkTagList *docs;       // indexed by bookmark id
+    int doc_capacity;
+    long links;                  // (bookmark, tag) pairs
+} BookmarkTagIndex;
+
+BookmarkTagIndex *bookmark_tags_create(void);
+int bookmark_tags_find(const BookmarkTagIndex *index, const char *name);
+int bookmark_tags_intern(BookmarkTagIndex *index, const char *name);
+const char *bookmark_tags_name(const BookmarkTagIndex *index, int tag);
+int bookmark_tags_add(BookmarkTagIndex *index, uint32_t id, int tag);
+int bookmark_tags_remove(BookmarkTagIndex *index, uint32_t id, int tag);
+void bookmark_tags_clear(BookmarkTagIndex *index, uint32_t id);
+int bookmark_tags_of(const BookmarkTagIndex *index, uint32_t id, const uint32_t **tags_out);
+int bookmark_tags_count(const BookmarkTagIndex *index, int tag);
+int bookmark_tags_query(const BookmarkTagIndex *index, const int *all, int all_count, const int *none,
+                        int none_count, uint32_t **ids_out);
+int bookmark_tags_merge(const uint32_t *a, int a_count, const uint32_t *b, int b_count, uint32_t *out,
+                        int exclude);
+size_t bookmark_tags_memory_usage(const BookmarkTagIndex *index);
+void bookmark_tags_free(BookmarkTagIndex *index);
+
+#endif
@@ -0,0 +1,975 @@
+/**
+ * Bookmark Full-Text Index in C
+ * Finds bookmarks by any word of their title, URL host and path, or
+ * category, ranked with BM25
+ * 
+ * The title trie only answers prefixes of whole titles, so "Overflow"
+ * never reaches "Stack Overflow". This index splits every field into
+ * tokens (runs of letters and digits, UTF-8 kept whole, case-folded like
+ * the trie) and keeps one posting list of bookmark ids per token:
+ *   Dictionary - open addressing over (hash, text offset, term index)
+ *                slots, so a probe reads one string only on a hash match
+ *   Postings   - per term, sorted (id delta, tf) varint pairs in blocks
+ *                of up to TEXT_BLOCK_POSTINGS; block bytes live in a
+ *                NodeArena (node_arena.c), and the blocks' last ids form
+ *                a skip list over the posting list
+ * Adding a bookmark with a fresh id only appends to the last block of
+ * each of its terms. Removing one, or reusing its id, re-encodes the one
+ * block the id falls in, so every update stays O(block).
+ * 
+ * AND queries intersect the lists rarest first, leapfrogging: each list
+ * jumps to the current candidate by galloping over block last ids, then
+ * decodes one block and finds the id with a vector compare (AVX2 / SSE2,
+ * scalar fallback), so long lists are mostly skipped, not decoded.
+ * Matches are scored with BM25; title and category tokens count
+ * TEXT_TITLE_WEIGHT / TEXT_CATEGORY_WEIGHT times (a simple BM25F), and a
+ * size-k min heap keeps the best.
+ * 
+ * Compile: gcc -O2 -DTRIE_NO_MAIN -DHASH_TABLE_NO_MAIN -o bookmark_text bookmark_text.c trie.c hash_table.c node_arena.c -lm   (add -mavx2 for 8-wide seeks)
+ * Run: ./bookmark_text [benchmark_bookmarks]
+ * Define BOOKMARK_TEXT_NO_MAIN to link it into libbookmarkstore.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <strings.h>
+#include <time.h>
+
+#include "bookmark_text.h"
+#include "trie.h"
+#include "hash_table.h"
+
+#define TEXT_INITIAL_SLOTS 64
+#define TEXT_MAX_VARINT 5
+
+/**
+ * Arena size classes for block bytes, up to a full block of
+ * worst-case postings (5-byte delta + 5-byte tf)
+ */
+static const unsigned int TEXT_SIZE_CLASSES[] = {
+    8, 16, 32, 64, 128, 256, 512, 1024, 1536
+};
+
+/**
+ * Append value as a little-endian base-128 varint
+ * Returns bytes written (1-5)
+ */
+int text_varint_put(unsigned char *out, uint32_t value) {
+    int length = 0;
+    while (value >= 0x80) {
+        out[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char)value;
+    return length;
+}
+
+/**
+ * Read one varint and advance *in past it
+ */
+uint32_t text_varint_get(const unsigned char **in) {
+    const unsigned char *p = *in;
+    uint32_t value = *p & 0x7F;
+    for (int shift = 7; *p++ & 0x80; shift += 7) {
+        value |= (uint32_t)(*p & 0x7F) << shift;
+    }
+    *in = p;
+    return value;
+}
+
+/**
+ * Token bytes: ASCII letters and digits, and any non-ASCII byte
+ */
+int text_is_word_byte(unsigned char c) {
+    return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/**
+ * Next token of text: a run of word bytes, case-folded and cut to
+ * TEXT_MAX_TERM bytes without splitting a UTF-8 sequence
+ * Writes the token (NUL-terminated, TEXT_MAX_TERM + 1 bytes of room) and
+ * its length; returns the position after it, or NULL when text has no
+ * more tokens.
+ * Time Complexity: O(t) where t = bytes scanned
+ */
+const char *bookmark_text_next_token(const char *text, char *token, int *length_out) {
+    const unsigned char *p = (const unsigned char *)text;
+    while (*p && !text_is_word_byte(*p)) p++;
+    if (!*p) return NULL;
+    
+    const unsigned char *start = p;
+    while (text_is_word_byte(*p)) p++;
+    int length = (int)(p - start);
+    if (length > TEXT_MAX_TERM) {
+        length = TEXT_MAX_TERM;
+        while (length > 0 && (start[length] & 0xC0) == 0x80) length--;
+    }
+    memcpy(token, start, length);
+    token[length] = '\0';
+    trie_fold_bytes((unsigned char *)token, length);
+    
+    *length_out = length;
+    return (const char *)p;
+}
+
+/**
+ * Where URL tokens start: after the scheme and a leading "www."
+ * so every bookmark does not share "https" and "www"
+ */
+const char *text_url_start(const char *url) {
+    const char *scheme = strstr(url, "://");
+    if (scheme) url = scheme + 3;
+    if (strncasecmp(url, "www.", 4) == 0) url += 4;
+    return url;
+}
+
+/**
+ * Home slot of a term hash (Fibonacci hashing on the top bits)
+ */
+int text_slot_home(int slot_count, uint32_t hash) {
+    int bits = __builtin_ctz(slot_count);
+    return (int)((hash * 2654435769u) >> (32 - bits));
+}
+
+/**
+ * Find a term's index, or -1
+ * Time Complexity: O(1) average
+ */
+int text_term_find(BookmarkTextIndex *index, const char *term, uint32_t hash) {
+    int mask = index->slot_count - 1;
+    for (int i = text_slot_home(index->slot_count, hash); index->slots[i].term >= 0; i = (i + 1) & mask) {
+        TextSlot *slot = &index->slots[i];
+        if (slot->hash == hash && strcmp(index->strings + slot->text, term) == 0) return slot->term;
+    }
+    return -1;
+}
+
+/**
+ * Put a slot in the first free place of its probe sequence
+ */
+void text_slot_place(BookmarkTextIndex *index, TextSlot slot) {
+    int mask = index->slot_count - 1;
+    int i = text_slot_home(index->slot_count, slot.hash);
+    while (index->slots[i].term >= 0) i = (i + 1) & mask;
+    index->slots[i] = slot;
+}
+
+/**
+ * Empty slot array of the index's size
+ */
+TextSlot *text_slots_alloc(int slot_count) {
+    TextSlot *slots = (TextSlot *)malloc(slot_count * sizeof(TextSlot));
+    for (int i = 0; i < slot_count; i++) slots[i].term = -1;
+    return slots;
+}
+
+/**
+ * Double the dictionary once it passes 3/4 load
+ * Time Complexity: O(n) per resize, O(1) amortized
+ */
+void text_slots_reserve(BookmarkTextIndex *index) {
+    if ((index->term_count + 1) * 4 <= index->slot_count * 3) return;
+    
+    TextSlot *old = index->slots;
+    int old_count = index->slot_count;
+    index->slot_count *= 2;
+    index->slots = text_slots_alloc(index->slot_count);
+    for (int i = 0; i < old_count; i++) {
+        if (old[i].term >= 0) text_slot_place(index, old[i]);
+    }
+    free(old);
+}
+
+/**
+ * Find a term's index, adding an empty term if it is new
+ * Time Complexity: O(t) average for t = term length
+ */
+int text_term_intern(BookmarkTextIndex *index, const char *term, int length) {
+    uint32_t hash = (uint32_t)hash_wy(term, length);
+    int found = text_term_find(index, term, hash);
+    if (found >= 0) return found;
+    
+    text_slots_reserve(index);
+    if (index->term_count == index->term_capacity) {
+        index->term_capacity *= 2;
+        index->terms = (TextTerm *)realloc(index->terms, index->term_capacity * sizeof(TextTerm));
+    }
+    while (index->strings_used + length + 1 > index->strings_capacity) {
+        index->strings_capacity *= 2;
+        index->strings = (char *)realloc(index->strings, index->strings_capacity);
+    }
+    
+    TextTerm *entry = &index->terms[index->term_count];
+    memset(entry, 0, sizeof(TextTerm));
+    entry->block_capacity = 1;
+    entry->text = (uint32_t)index->strings_used;
+    memcpy(index->strings + index->strings_used, term, length + 1);
+    index->strings_used += length + 1;
+    
+    text_slot_place(index, (TextSlot){ hash, entry->text, index->term_count });
+    return index->term_count++;
+}
+
+/**
+ * Create empty index
+ * Time Complexity: O(1)
+ */
+BookmarkTextIndex *bookmark_text_create(void) {
+    BookmarkTextIndex *index = (BookmarkTextIndex *)calloc(1, sizeof(BookmarkTextIndex));
+    index->term_capacity = 64;
+    index->terms = (TextTerm *)malloc(index->term_capacity * sizeof(TextTerm));
+    index->slot_count = TEXT_INITIAL_SLOTS;
+    index->slots = text_slots_alloc(index->slot_count);
+    index->strings_capacity = 1024;
+    index->strings = (char *)malloc(index->strings_capacity);
+    node_arena_init(&index->arena, TEXT_SIZE_CLASSES, sizeof(TEXT_SIZE_CLASSES) / sizeof(TEXT_SIZE_CLASSES[0]));
+    return index;
+}
+
+/**
+ * Blocks of a term's posting list
+ */
+TextBlock *text_term_blocks(TextTerm *term) {
+    return term->block_capacity > 1 ? term->blocks : &term->single;
+}
+
+/**
+ * Open a gap for a new block at position at
+ * Time Complexity: O(b) for b = blocks in the list
+ */
+TextBlock *text_term_insert_block(TextTerm *term, int at) {
+    if (term->block_count == term->block_capacity) {
+        if (term->block_capacity == 1) {
+            term->blocks = (TextBlock *)malloc(4 * sizeof(TextBlock));
+            if (term->block_count == 1) term->blocks[0] = term->single;
+            term->block_capacity = 4;
+        } else {
+            term->block_capacity *= 2;
+            term->blocks = (TextBlock *)realloc(term->blocks, term->block_capacity * sizeof(TextBlock));
+        }
+    }
+    
+    TextBlock *blocks = text_term_blocks(term);
+    memmove(&blocks[at + 1], &blocks[at], (term->block_count - at) * sizeof(TextBlock));
+    term->block_count++;
+    memset(&blocks[at], 0, sizeof(TextBlock));
+    return &blocks[at];
+}
+
+/**
+ * Drop the block at position at (its bytes must already be freed)
+ */
+void text_term_remove_block(TextTerm *term, int at) {
+    TextBlock *blocks = text_term_blocks(term);
+    memmove(&blocks[at], &blocks[at + 1], (term->block_count - at - 1) * sizeof(TextBlock));
+    term->block_count--;
+}
+
+/**
+ * First block whose last id is >= id (binary search on skip keys),
+ * or block_count if id is past the end
+ * Time Complexity: O(log b)
+ */
+int text_find_block(TextTerm *term, uint32_t id) {
+    TextBlock *blocks = text_term_blocks(term);
+    int low = 0, high = term->block_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (blocks[mid].last_id < id) low = mid + 1; else high = mid;
+    }
+    return low;
+}
+
+/**
+ * Slot bytes available to a block
+ */
+unsigned int text_block_capacity(BookmarkTextIndex *index, TextBlock *block) {
+    if (block->bytes == NODE_NULL) return 0;
+    return index->arena.classes[block->bytes >> NODE_INDEX_BITS].slot_size;
+}
+
+/**
+ * Make room for size bytes, moving the block to a larger slot if needed
+ * (existing bytes are kept)
+ */
+unsigned char *text_block_reserve(BookmarkTextIndex *index, TextBlock *block, unsigned int size) {
+    if (size > text_block_capacity(index, block)) {
+        NodeHandle grown = node_arena_alloc(&index->arena, size);
+        if (block->bytes != NODE_NULL) {
+            memcpy(node_arena_get(&index->arena, grown), node_arena_get(&index->arena, block->bytes), block->size);
+            node_arena_free(&index->arena, block->bytes);
+        }
+        block->bytes = grown;
+    }
+    return (unsigned char *)node_arena_get(&index->arena, block->bytes);
+}
+
+/**
+ * Decode a block into ids and tfs; returns the posting count
+ * Time Complexity: O(n) for n = postings in the block
+ */
+int text_block_decode(BookmarkTextIndex *index, TextBlock *block, uint32_t *ids, uint32_t *tfs) {
+    const unsigned char *p = (const unsigned char *)node_arena_get(&index->arena, block->bytes);
+    uint32_t id = 0;
+    for (int i = 0; i < block->count; i++) {
+        id += text_varint_get(&p);
+        ids[i] = id;
+        tfs[i] = text_varint_get(&p);
+    }
+    return block->count;
+}
+
+/**
+ * Encode postings into a block, resizing its slot to fit
+ * Time Complexity: O(n)
+ */
+void text_block_encode(BookmarkTextIndex *index, TextBlock *block, const uint32_t *ids, const uint32_t *tfs,
+                       int count) {
+    unsigned char buffer[TEXT_BLOCK_POSTINGS * 2 * TEXT_MAX_VARINT];
+    int size = 0;
+    uint32_t previous = 0;
+    for (int i = 0; i < count; i++) {
+        size += text_varint_put(buffer + size, ids[i] - previous);
+        size += text_varint_put(buffer + size, tfs[i]);
+        previous = ids[i];
+    }
+    
+    // Shrink too: re-encodes happen on removals
+    if (block->bytes != NODE_NULL && (unsigned int)size * 2 < text_block_capacity(index, block)) {
+        node_arena_free(&index->arena, block->bytes);
+        block->bytes = NODE_NULL;
+    }
+    block->size = 0;
+    memcpy(text_block_reserve(index, block, size), buffer, size);
+    block->size = size;
+    block->count = count;
+    block->last_id = ids[count - 1];
+}
+
+/**
+ * Add (id, tf) to a term's posting list
+ * Ids past the end of the list (fresh bookmarks) are appended in place;
+ * anything else re-encodes the block the id falls in, splitting it when
+ * it overflows.
+ * Time Complexity: O(1) amortized for appends, O(log b + B) otherwise
+ * for B = TEXT_BLOCK_POSTINGS
+ */
+void text_posting_add(BookmarkTextIndex *index, TextTerm *term, uint32_t id, uint32_t tf) {
+    term->doc_count++;
+    TextBlock *blocks = text_term_blocks(term);
+    TextBlock *last = term->block_count > 0 ? &blocks[term->block_count - 1] : NULL;
+    
+    if (last == NULL || id > last->last_id) {
+        if (last == NULL || last->count == TEXT_BLOCK_POSTINGS) {
+            last = text_term_insert_block(term, term->block_count);
+        }
+        
+        unsigned char encoded[2 * TEXT_MAX_VARINT];
+        int size = text_varint_put(encoded, id - (last->count > 0 ? last->last_id : 0));
+        size += text_varint_put(encoded + size, tf);
+        unsigned char *bytes = text_block_reserve(index, last, last->size + size);
+        memcpy(bytes + last->size, encoded, size);
+        last->size += size;
+        last->count++;
+        last->last_id = id;
+        return;
+    }
+    
+    uint32_t ids[TEXT_BLOCK_POSTINGS + 1], tfs[TEXT_BLOCK_POSTINGS + 1];
+    int at = text_find_block(term, id);
+    int count = text_block_decode(index, &blocks[at], ids, tfs);
+    int position = 0;
+    while (ids[position] < id) position++;
+    memmove(&ids[position + 1], &ids[position], (count - position) * sizeof(uint32_t));
+    memmove(&tfs[position + 1], &tfs[position], (count - position) * sizeof(uint32_t));
+    ids[position] = id;
+    tfs[position] = tf;
+    count++;
+    
+    if (count <= TEXT_BLOCK_POSTINGS) {
+        text_block_encode(index, &blocks[at], ids, tfs, count);
+        return;
+    }
+    
+    // Split the overflowing block in two halves
+    int half = count / 2;
+    text_block_encode(index, &blocks[at], ids, tfs, half);
+    TextBlock *second = text_term_insert_block(term, at + 1);
+    text_block_encode(index, second, ids + half, tfs + half, count - half);
+}
+
+/**
+ * Remove id from a term's posting list, if present
+ * Time Complexity: O(log b + B)
+ */
+void text_posting_remove(BookmarkTextIndex *index, TextTerm *term, uint32_t id) {
+    int at = text_find_block(term, id);
+    if (at == term->block_count) return;
+    
+    TextBlock *block = &text_term_blocks(term)[at];
+    uint32_t ids[TEXT_BLOCK_POSTINGS], tfs[TEXT_BLOCK_POSTINGS];
+    int count = text_block_decode(index, block, ids, tfs);
+    int position = 0;
+    while (position < count && ids[position] < id) position++;
+    if (position == count || ids[position] != id) return;
+    
+    term->doc_count--;
+    count--;
+    if (count == 0) {
+        node_arena_free(&index->arena, block->bytes);
+        text_term_remove_block(term, at);
+        return;
+    }
+    memmove(&ids[position], &ids[position + 1], (count - position) * sizeof(uint32_t));
+    memmove(&tfs[position], &tfs[position + 1], (count - position) * sizeof(uint32_t));
+    text_block_encode(index, block, ids, tfs, count);
+}
+
+/**
+ * Term and weighted frequency of one document
+ */
+typedef struct {
+    int term;
+    uint32_t tf;
+} TextTermCount;
+
+typedef struct {
+    TextTermCount *counts;
+    int count;
+    int capacity;
+    uint32_t length;             // weighted tokens
+} TextDocTerms;
+
+/**
+ * Tokenize one field into doc, adding each token weight times
+ * With create == 0, tokens missing from the dictionary are skipped.
+ */
+void text_collect_field(BookmarkTextIndex *index, TextDocTerms *doc, const char *text, int weight, int create) {
+    char token[TEXT_MAX_TERM + 1];
+    int length;
+    while (text && (text = bookmark_text_next_token(text, token, &length)) != NULL) {
+        doc->length += weight;
+        int term = create ? text_term_intern(index, token, length)
+                          : text_term_find(index, token, (uint32_t)hash_wy(token, length));
+        if (term < 0) continue;
+        
+        if (doc->count == doc->capacity) {
+            doc->capacity = doc->capacity ? doc->capacity * 2 : 32;
+            doc->counts = (TextTermCount *)realloc(doc->counts, doc->capacity * sizeof(TextTermCount));
+        }
+        doc->counts[doc->count++] = (TextTermCount){ term, (uint32_t)weight };
+    }
+}
+
+int text_term_count_compare(const void *a, const void *b) {
+    return ((const TextTermCount *)a)->term - ((const TextTermCount *)b)->term;
+}
+
+/**
+ * Distinct terms of a bookmark with summed field weights
+ * Time Complexity: O(t log t) for t = tokens
+ */
+void text_collect(BookmarkTextIndex *index, TextDocTerms *doc, const char *title, const char *url,
+                  const char *category, int create) {
+    memset(doc, 0, sizeof(TextDocTerms));
+    text_collect_field(index, doc, title, TEXT_TITLE_WEIGHT, create);
+    text_collect_field(index, doc, url ? text_url_start(url) : NULL, TEXT_URL_WEIGHT, create);
+    text_collect_field(index, doc, category, TEXT_CATEGORY_WEIGHT, create);
+    
+    if (doc->count > 1) qsort(doc->counts, doc->count, sizeof(TextTermCount), text_term_count_compare);
+    int distinct = 0;
+    for (int i = 0; i < doc->count; i++) {
+        if (distinct > 0 && doc->counts[distinct - 1].term == doc->counts[i].term) {
+            doc->counts[distinct - 1].tf += doc->counts[i].tf;
+        } else {
+            doc->counts[distinct++] = doc->counts[i];
+        }
+    }
+    doc->count = distinct;
+}
+
+/**
+ * Index a bookmark under every token of its fields
+ * id must not be indexed already (remove it first when reusing it).
+ * Time Complexity: O(t log t) for t = tokens, plus O(B) per term whose
+ * list id does not extend
+ */
+void bookmark_text_add(BookmarkTextIndex *index, uint32_t id, const char *title, const char *url,
+                       const char *category) {
+    TextDocTerms doc;
+    text_collect(index, &doc, title, url, category, 1);
+    for (int i = 0; i < doc.count; i++) {
+        text_posting_add(index, &index->terms[doc.counts[i].term], id, doc.counts[i].tf);
+    }
+    
+    if ((int)id >= index->doc_capacity) {
+        int capacity = index->doc_capacity ? index->doc_capacity : 64;
+        while (capacity <= (int)id) capacity *= 2;
+        index->doc_lengths = (uint32_t *)realloc(index->doc_lengths, capacity * sizeof(uint32_t));
+        memset(index->doc_lengths + index->doc_capacity, 0, (capacity - index->doc_capacity) * sizeof(uint32_t));
+        index->doc_capacity = capacity;
+    }
+    index->doc_lengths[id] = doc.length;
+    index->doc_count++;
+    index->total_length += doc.length;
+    free(doc.counts);
+}
+
+/**
+ * Remove a bookmark; the fields must be the ones it was added with
+ * Time Complexity: O(t log t + d (log b + B)) for d = distinct terms
+ */
+void bookmark_text_remove(BookmarkTextIndex *index, uint32_t id, const char *title, const char *url,
+                          const char *category) {
+    if ((int)id >= index->doc_capacity) return;
+    
+    TextDocTerms doc;
+    text_collect(index, &doc, title, url, category, 0);
+    for (int i = 0; i < doc.count; i++) {
+        text_posting_remove(index, &index->terms[doc.counts[i].term], id);
+    }
+    
+    index->doc_count--;
+    index->total_length -= index->doc_lengths[id];
+    index->doc_lengths[id] = 0;
+    free(doc.counts);
+}
+
+/**
+ * Position of the first id >= target in a sorted block, from position
+ * from on; count if there is none
+ * Compares a vector of ids per step (unsigned compare via a sign flip).
+ * Time Complexity: O(n / w) for w = vector lanes
+ */
+int text_lower_bound(const uint32_t *ids, int from, int count, uint32_t target) {
+    int i = from;
+#if defined(__AVX2__)
+    __m256i flip = _mm256_set1_epi32((int)0x80000000u);
+    __m256i bound = _mm256_xor_si256(_mm256_set1_epi32((int)target), flip);
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(ids + i)), flip);
+        unsigned int below = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(bound, v)));
+        if (below != 0xFF) return i + __builtin_ctz(~below);
+    }
+#elif defined(__SSE2__)
+    __m128i flip = _mm_set1_epi32((int)0x80000000u);
+    __m128i bound = _mm_xor_si128(_mm_set1_epi32((int)target), flip);
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(ids + i)), flip);
+        unsigned int below = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(bound, v)));
+        if (below != 0xF) return i + __builtin_ctz(~below);
+    }
+#endif
+    while (i < count && ids[i] < target) i++;
+    return i;
+}
+
+/**
+ * Decode block b of the cursor's list (or mark the cursor done)
+ */
+void text_cursor_load(BookmarkTextIndex *index, TextCursor *cursor, int block) {
+    cursor->block = block;
+    cursor->position = 0;
+    cursor->count = 0;
+    if (block < cursor->term->block_count) {
+        cursor->count = text_block_decode(index, &text_term_blocks(cursor->term)[block], cursor->ids, cursor->tfs);
+    }
+}
+
+uint32_t text_cursor_current(TextCursor *cursor) {
+    return cursor->position < cursor->count ? cursor->ids[cursor->position] : TEXT_NO_DOC;
+}
+
+/**
+ * Step to the next posting
+ */
+uint32_t text_cursor_next(BookmarkTextIndex *index, TextCursor *cursor) {
+    if (++cursor->position == cursor->count) text_cursor_load(index, cursor, cursor->block + 1);
+    return text_cursor_current(cursor);
+}
+
+/**
+ * Move to the first posting >= target and return its id
+ * Gallops over block last ids (1, 2, 4, ... blocks ahead), binary
+ * searches the last stride, and decodes only the block it lands in.
+ * Time Complexity: O(log g + B) for g = blocks skipped
+ */
+uint32_t text_cursor_seek(BookmarkTextIndex *index, TextCursor *cursor, uint32_t target) {
+    if (cursor->position == cursor->count) return TEXT_NO_DOC;
+    
+    TextBlock *blocks = text_term_blocks(cursor->term);
+    int block_count = cursor->term->block_count;
+    if (blocks[cursor->block].last_id < target) {
+        int behind = cursor->block, step = 1;
+        while (behind + step < block_count && blocks[behind + step].last_id < target) {
+            behind += step;
+            step *= 2;
+        }
+        
+        int low = behind + 1;
+        int high = behind + step < block_count ? behind + step : block_count - 1;
+        if (low > high || blocks[high].last_id < target) {
+            text_cursor_load(index, cursor, block_count);
+            return TEXT_NO_DOC;
+        }
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (blocks[mid].last_id < target) low = mid + 1; else high = mid;
+        }
+        text_cursor_load(index, cursor, low);
+    }
+    
+    cursor->position = text_lower_bound(cursor->ids, cursor->position, cursor->count, target);
+    return cursor->ids[cursor->position];
+}
+
+/**
+ * Scored match for the top-k heap
+ */
+typedef struct {
+    double score;
+    uint32_t id;
+} TextHit;
+
+/**
+ * Ranking order: higher score first, then lower id
+ */
+int text_hit_before(const TextHit *a, const TextHit *b) {
+    if (a->score != b->score) return a->score > b->score;
+    return a->id < b->id;
+}
+
+/**
+ * Offer a hit to a size-k min heap (worst hit on top)
+ * Time Complexity: O(log k)
+ */
+void text_hits_offer(TextHit *heap, int *size, int k, TextHit hit) {
+    int i;
+    if (*size < k) {
+        i = (*size)++;
+        while (i > 0 && text_hit_before(&heap[(i - 1) / 2], &hit)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = hit;
+        return;
+    }
+    if (!text_hit_before(&hit, &heap[0])) return;
+    
+    i = 0;
+    while (2 * i + 1 < *size) {
+        int child = 2 * i + 1;
+        if (child + 1 < *size && text_hit_before(&heap[child], &heap[child + 1])) child++;
+        if (!text_hit_before(&hit, &heap[child])) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = hit;
+}
+
+int text_hit_compare(const void *a, const void *b) {
+    return text_hit_before((const TextHit *)a, (const TextHit *)b) ? -1 : 1;
+}
+
+int text_cursor_rarest_first(const void *a, const void *b) {
+    return (*(TextCursor *const *)a)->term->doc_count - (*(TextCursor *const *)b)->term->doc_count;
+}
+
+/**
+ * Bookmarks containing every word of query, best BM25 score first
+ * Writes up to k ids (and scores, if scores_out is not NULL) and returns
+ * how many were written. Query words go through the same tokenizer as
+ * the fields; a word no bookmark contains matches nothing.
+ * Time Complexity: O(q r (log g + B / w)) for q = query terms and
+ * r = postings of the rarest term, plus O(m log k) for m = matches
+ */
+int bookmark_text_search(BookmarkTextIndex *index, const char *query, int k, uint32_t *ids_out,
+                         double *scores_out) {
+    if (!query || k <= 0 || index->doc_count == 0) return 0;
+    
+    // Look up each distinct query term
+    TextTerm *terms[TEXT_MAX_QUERY_TERMS];
+    int term_count = 0;
+    char token[TEXT_MAX_TERM + 1];
+    int length;
+    while (term_count < TEXT_MAX_QUERY_TERMS && (query = bookmark_text_next_token(query, token, &length)) != NULL) {
+        int found = text_term_find(index, token, (uint32_t)hash_wy(token, length));
+        if (found < 0 || index->terms[found].doc_count == 0) return 0;
+        
+        int duplicate = 0;
+        for (int i = 0; i < term_count; i++) {
+            if (terms[i] == &index->terms[found]) duplicate = 1;
+        }
+        if (!duplicate) terms[term_count++] = &index->terms[found];
+    }
+    if (term_count == 0) return 0;
+    
+    TextCursor *cursors = (TextCursor *)malloc(term_count * sizeof(TextCursor));
+    TextCursor *order[TEXT_MAX_QUERY_TERMS];
+    for (int i = 0; i < term_count; i++) {
+        cursors[i].term = terms[i];
+        text_cursor_load(index, &cursors[i], 0);
+        order[i] = &cursors[i];
+    }
+    qsort(order, term_count, sizeof(TextCursor *), text_cursor_rarest_first);
+    
+    double idf[TEXT_MAX_QUERY_TERMS];
+    for (int i = 0; i < term_count; i++) {
+        double df = order[i]->term->doc_count;
+        idf[i] = log(1.0 + (index->doc_count - df + 0.5) / (df + 0.5));
+    }
+    double average_length = (double)index->total_length / index->doc_count;
+    
+    // Leapfrog: every list seeks to the candidate; a miss moves the
+    // candidate to where that list landed
+    TextHit *heap = (TextHit *)malloc(k * sizeof(TextHit));
+    int heap_size = 0;
+    uint32_t candidate = text_cursor_current(order[0]);
+    while (candidate != TEXT_NO_DOC) {
+        uint32_t landed = candidate;
+        int agreeing = 1;
+        while (agreeing < term_count && (landed = text_cursor_seek(index, order[agreeing], candidate)) == candidate) {
+            agreeing++;
+        }
+        
+        if (agreeing < term_count) {
+            if (landed == TEXT_NO_DOC) break;
+            candidate = text_cursor_seek(index, order[0], landed);
+            continue;
+        }
+        
+        double norm = TEXT_BM25_K1 * (1.0 - TEXT_BM25_B + TEXT_BM25_B * index->doc_lengths[candidate] / average_length);
+        double score = 0;
+        for (int i = 0; i < term_count; i++) {
+            double tf = order[i]->tfs[order[i]->position];
+            score += idf[i] * tf * (TEXT_BM25_K1 + 1.0) / (tf + norm);
+        }
+        text_hits_offer(heap, &heap_size, k, (TextHit){ score, candidate });
+        candidate = text_cursor_next(index, order[0]);
+    }
+    
+    qsort(heap, heap_size, sizeof(TextHit), text_hit_compare);
+    for (int i = 0; i < heap_size; i++) {
+        ids_out[i] = heap[i].id;
+        if (scores_out) scores_out[i] = heap[i].score;
+    }
+    
+    free(heap);
+    free(cursors);
+    return heap_size;
+}
+
+/**
+ * Bytes held by the index
+ * Time Complexity: O(n) for n = terms
+ */
+size_t bookmark_text_memory_usage(BookmarkTextIndex *index) {
+    size_t bytes = sizeof(BookmarkTextIndex) + node_arena_bytes(&index->arena);
+    bytes += index->term_capacity * sizeof(TextTerm) + index->slot_count * sizeof(TextSlot);
+    bytes += index->strings_capacity + index->doc_capacity * sizeof(uint32_t);
+    for (int i = 0; i < index->term_count; i++) {
+        if (index->terms[i].block_capacity > 1) bytes += index->terms[i].block_capacity * sizeof(TextBlock);
+    }
+    return bytes;
+}
+
+/**
+ * Free index
+ * Time Complexity: O(n) for n = terms
+ */
+void bookmark_text_free(BookmarkTextIndex *index) {
+    for (int i = 0; i < index->term_count; i++) {
+        if (index->terms[i].block_capacity > 1) free(index->terms[i].blocks);
+    }
+    node_arena_destroy(&index->arena);
+    free(index->terms);
+    free(index->slots);
+    free(index->strings);
+    free(index->doc_lengths);
+    free(index);
+}
+
+#ifndef BOOKMARK_TEXT_NO_MAIN
+static const char *DEMO_SYLLABLES[] = {
+    "ka", "to", "ri", "mu", "sen", "lo", "git", "hub", "news", "docs", "map", "tar", "vel", "qui", "ze",
+    "an", "pro", "ex", "dev", "ops", "ma", "li", "ber", "for", "cal", "in", "tu", "ne", "wa", "shi",
+};
+
+static const char *DEMO_CATEGORIES[] = {
+    "Development", "News", "Reference", "Shopping", "Travel", "Music", "Research", "Finance",
+};
+
+void text_demo_word(char *out) {
+    int syllables = sizeof(DEMO_SYLLABLES) / sizeof(DEMO_SYLLABLES[0]);
+    out[0] = '\0';
+    for (int i = 1 + rand() % 3; i > 0; i--) {
+        strcat(out, DEMO_SYLLABLES[rand() % syllables]);
+    }
+}
+
+double text_demo_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int text_demo_compare_latency(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Baseline: does a bookmark contain every query token? (linear scan)
+ */
+int text_demo_scan_match(const char *fields[3], char tokens[][TEXT_MAX_TERM + 1], int token_count) {
+    for (int t = 0; t < token_count; t++) {
+        int found = 0;
+        for (int f = 0; f < 3 && !found; f++) {
+            char token[TEXT_MAX_TERM + 1];
+            int length;
+            const char *p = f == 1 ? text_url_start(fields[f]) : fields[f];
+            while (!found && (p = bookmark_text_next_token(p, token, &length)) != NULL) {
+                found = strcmp(token, tokens[t]) == 0;
+            }
+        }
+        if (!found) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Index n random bookmarks, then time AND queries of 1-3 words against
+ * a linear scan of the same bookmarks
+ */
+void text_demo_benchmark(int n) {
+    printf("--- Benchmark: %d bookmarks ---\n", n);
+    char (*titles)[96] = malloc(n * sizeof(*titles));
+    char (*urls)[96] = malloc(n * sizeof(*urls));
+    int categories = sizeof(DEMO_CATEGORIES) / sizeof(DEMO_CATEGORIES[0]);
+    
+    srand(11);
+    for (int i = 0; i < n; i++) {
+        char a[32], b[32], c[32], d[32];
+        text_demo_word(a); text_demo_word(b); text_demo_word(c); text_demo_word(d);
+        snprintf(titles[i], sizeof(titles[i]), "%s %s %s", a, b, c);
+        snprintf(urls[i], sizeof(urls[i]), "https://www.%s.com/%s/%d", b, d, i);
+    }
+    
+    BookmarkTextIndex *index = bookmark_text_create();
+    double start = text_demo_seconds();
+    for (int i = 0; i < n; i++) {
+        bookmark_text_add(index, i, titles[i], urls[i], DEMO_CATEGORIES[i % categories]);
+    }
+    double build = text_demo_seconds() - start;
+    printf("Indexed in %.2f s (%.0f bookmarks/s), %d terms, %.1f MB\n", build, n / build,
+           index->term_count, bookmark_text_memory_usage(index) / 1048576.0);
+    
+    int queries = 2000;
+    double *latency = malloc(queries * sizeof(double));
+    uint32_t ids[10];
+    for (int words = 1; words <= 3; words++) {
+        long found = 0;
+        for (int q = 0; q < queries; q++) {
+            // Words of one bookmark, so the AND has at least one match
+            int doc = rand() % n;
+            char query[128] = "", word[TEXT_MAX_TERM + 1];
+            int length;
+            const char *p = titles[doc];
+            for (int w = 0; w < words && (p = bookmark_text_next_token(p, word, &length)) != NULL; w++) {
+                strcat(query, word);
+                strcat(query, " ");
+            }
+            
+            double t = text_demo_seconds();
+            found += bookmark_text_search(index, query, 10, ids, NULL);
+            latency[q] = text_demo_seconds() - t;
+        }
+        qsort(latency, queries, sizeof(double), text_demo_compare_latency);
+        printf("%d-word AND: p50 %.0f us, p99 %.0f us, %.1f results\n", words,
+               latency[queries / 2] * 1e6, latency[queries * 99 / 100] * 1e6, (double)found / queries);
+    }
+    
+    // The same question answered by scanning every bookmark
+    char tokens[2][TEXT_MAX_TERM + 1];
+    int length;
+    bookmark_text_next_token(bookmark_text_next_token(titles[0], tokens[0], &length), tokens[1], &length);
+    start = text_demo_seconds();
+    int scanned = 0;
+    for (int i = 0; i < n; i++) {
+        const char *fields[3] = { titles[i], urls[i], DEMO_CATEGORIES[i % categories] };
+        scanned += text_demo_scan_match(fields, tokens, 2);
+    }
+    double scan = text_demo_seconds() - start;
+    start = text_demo_seconds();
+    char query[2 * TEXT_MAX_TERM + 2];
+    snprintf(query, sizeof(query), "%s %s", tokens[0], tokens[1]);
+    uint32_t *all = malloc(n * sizeof(uint32_t));
+    int indexed = bookmark_text_search(index, query, n, all, NULL);
+    double lookup = text_demo_seconds() - start;
+    printf("\"%s\" all matches: scan %d in %.1f ms, index %d in %.2f ms\n", query, scanned, scan * 1e3,
+           indexed, lookup * 1e3);
+    
+    free(all);
+    free(latency);
+    free(titles);
+    free(urls);
+    bookmark_text_free(index);
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        text_demo_benchmark(atoi(argv[1]));
+        return 0;
+    }
+    
+    printf("=== Bookmark Full-Text Index in C ===\n");
+    printf("Data Structure: Inverted index, varint posting blocks with skip keys, BM25\n\n");
+    
+    const char *sample[][3] = {
+        {"GitHub", "https://github.com", "Development"},
+        {"Stack Overflow", "https://stackoverflow.com/questions/tagged/c", "Development"},
+        {"Google", "https://www.google.com", "Search"},
+        {"Google Maps", "https://maps.google.com/?q=overflow+parking", "Maps"},
+        {"MDN Web Docs", "https://developer.mozilla.org/en-US/docs/Web", "Documentation"},
+        {"Stack Exchange Network", "https://stackexchange.com/sites", "Development"},
+        {"C Reference", "https://en.cppreference.com/w/c", "Documentation"},
+        {"Москва Новости", "https://news.example.ru/moscow", "News"},
+    };
+    int sample_count = sizeof(sample) / sizeof(sample[0]);
+    
+    BookmarkTextIndex *index = bookmark_text_create();
+    printf("1. Indexing %d bookmarks (title, url host/path, category)\n", sample_count);
+    for (int i = 0; i < sample_count; i++) {
+        bookmark_text_add(index, i, sample[i][0], sample[i][1], sample[i][2]);
+    }
+    printf("   %d terms\n\n", index->term_count);
+    
+    const char *queries[] = {"overflow", "stack", "docs", "google maps", "development c", "МОСКВА", "missing"};
+    printf("2. Queries (all words must match, BM25 order):\n");
+    for (int q = 0; q < (int)(sizeof(queries) / sizeof(queries[0])); q++) {
+        uint32_t ids[8];
+        double scores[8];
+        int found = bookmark_text_search(index, queries[q], 8, ids, scores);
+        printf("   \"%s\": %d\n", queries[q], found);
+        for (int i = 0; i < found; i++) {
+            printf("     %.3f  %s  (%s)\n", scores[i], sample[ids[i]][0], sample[ids[i]][1]);
+        }
+    }
+    
+    printf("\n3. Removing Stack Overflow, then \"stack\":\n");
+    bookmark_text_remove(index, 1, sample[1][0], sample[1][1], sample[1][2]);
+    uint32_t ids[8];
+    int found = bookmark_text_search(index, "stack", 8, ids, NULL);
+    for (int i = 0; i < found; i++) {
+        printf("   %s\n", sample[ids[i]][0]);
+    }
+    
+    bookmark_text_free(index);
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
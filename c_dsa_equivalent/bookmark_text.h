@@ -0,0 +1,115 @@
+/**
+ * Bookmark Full-Text Index Interface
+ * Inverted index over bookmark titles, URLs and categories with BM25
+ * ranking (see bookmark_text.c for implementation notes)
+ */
+
+#ifndef BOOKMARK_TEXT_H
+#define BOOKMARK_TEXT_H
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "node_arena.h"
+
+#define TEXT_BLOCK_POSTINGS 128      // postings per block before it splits
+#define TEXT_MAX_TERM 64             // longer tokens are cut to this many bytes
+#define TEXT_MAX_QUERY_TERMS 16
+#define TEXT_NO_DOC UINT32_MAX
+
+// Field weights: a term counts this many times towards tf and length
+#define TEXT_TITLE_WEIGHT 3
+#define TEXT_CATEGORY_WEIGHT 2
+#define TEXT_URL_WEIGHT 1
+
+#define TEXT_BM25_K1 1.2
+#define TEXT_BM25_B 0.75
+
+/**
+ * One block of a posting list
+ * Postings are (doc id delta, tf) varint pairs in id order; the first
+ * delta is from 0, so every block decodes on its own. last_id is the
+ * skip key that lets intersections jump over whole blocks.
+ */
+typedef struct {
+    uint32_t last_id;
+    NodeHandle bytes;            // encoded postings in the index arena
+    unsigned short count;
+    unsigned short size;         // encoded bytes
+} TextBlock;
+
+/**
+ * Dictionary entry and posting list of one term
+ * Most terms occur in a single block, kept inline in single.
+ */
+typedef struct {
+    TextBlock *blocks;           // block array once there is more than one
+    TextBlock single;
+    int block_count;
+    int block_capacity;          // 1 while the list lives in single
+    int doc_count;               // documents containing the term
+    uint32_t text;               // offset of the term in the string buffer
+} TextTerm;
+
+/**
+ * Dictionary slot: hash and text offset copied from the term, so probes
+ * only touch the slot array and the matching string; empty when term < 0
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t text;
+    int term;
+} TextSlot;
+
+/**
+ * Full-text index structure
+ * Documents are identified by caller ids (bookmark ids); ids may be
+ * reused after a document is removed.
+ */
+typedef struct {
+    TextTerm *terms;
+    int term_count;
+    int term_capacity;
+    TextSlot *slots;             // term dictionary, open addressing
+    int slot_count;              // power of two
+    char *strings;               // NUL-terminated term text
+    size_t strings_used;
+    size_t strings_capacity;
+    NodeArena arena;             // block bytes, in size classes up to one full block
+    uint32_t *doc_lengths;       // weighted token count per id
+    int doc_capacity;
+    int doc_count;               // indexed documents
+    long long total_length;
+} BookmarkTextIndex;
+
+/**
+ * Cursor over one posting list with its current block decoded
+ */
+typedef struct {
+    TextTerm *term;
+    int block;
+    int position;
+    int count;
+    uint32_t ids[TEXT_BLOCK_POSTINGS];
+    uint32_t tfs[TEXT_BLOCK_POSTINGS];
+} TextCursor;
+
+BookmarkTextIndex *bookmark_text_create(void);
+void bookmark_text_add(BookmarkTextIndex *index, uint32_t id, const char *title, const char *url,
+                       const char *category);
+void bookmark_text_remove(BookmarkTextIndex *index, uint32_t id, const char *title, const char *url,
+                          const char *category);
+int bookmark_text_search(BookmarkTextIndex *index, const char *query, int k, uint32_t *ids_out,
+                         double *scores_out);
+size_t bookmark_text_memory_usage(BookmarkTextIndex *index);
+void bookmark_text_free(BookmarkTextIndex *index);
+
+// Tokenizer, shared with callers that scan text themselves
+const char *bookmark_text_next_token(const char *text, char *token, int *length_out);
+
+#endif
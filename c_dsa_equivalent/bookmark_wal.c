@@ -0,0 +1,826 @@
+/**
+ * Bookmark Write-Ahead Log Implementation in C
+ * Makes add/delete/visit/tag/untag on a BookmarkStore durable without one fsync
+ * per operation
+ * 
+ * Every successful store mutation bumps store->mutations, which doubles
+ * as the log sequence number. The log file is a small header holding the
+ * sequence of its first record, followed by one frame per mutation:
+ *   varint payload length | payload | CRC-32 of payload (4 bytes, LE)
+ * Payload:
+ *   op (1 byte) | varint id | op data
+ *   ADD    zigzag varint time delta, then title, url, category as
+ *          varint length + bytes
+ *   DELETE nothing
+ *   VISIT  zigzag varint time delta
+ *   TAG    tag name as varint length + bytes
+ *   UNTAG  tag name as varint length + bytes
+ * Times are milliseconds, delta-coded against the previous record in
+ * the file, so a visit usually takes 7-10 bytes on disk.
+ * 
+ * Group commit: the logged mutators encode their record into an
+ * in-memory batch and return. A flusher thread waits up to window_ms for
+ * more records to join the batch, writes it and fdatasyncs once for all
+ * of them. bookmark_wal_commit blocks until everything appended so far
+ * is durable, so callers that must acknowledge a write (add, delete) can
+ * wait while visits simply ride the next batch: a visit is durable at
+ * most window_ms plus one sync after it happened.
+ * 
+ * Startup layers the log over a snapshot: load the snapshot (its header
+ * records store->mutations), then bookmark_wal_open replays only records
+ * whose sequence is at or past that point. A torn or corrupt tail (crash
+ * mid-write) ends replay and is truncated away before appending resumes.
+ * bookmark_wal_checkpoint saves a snapshot and starts a fresh log; a
+ * crash between the two steps is harmless because replay skips records
+ * the snapshot already contains.
+ * 
+ * The store itself is single-threaded: call the logged mutators from one
+ * thread. The flusher only does I/O.
+ * 
+ * Compile: gcc -O2 -pthread -DBOOKMARK_STORE_NO_MAIN -DBOOKMARK_SNAPSHOT_NO_MAIN -DTRIE_NO_MAIN -DMIN_HEAP_NO_MAIN -DHASH_TABLE_NO_MAIN -DBOOKMARK_TEXT_NO_MAIN -DROARING_BITMAP_NO_MAIN -DBPLUS_TREE_NO_MAIN -DBOOKMARK_TAGS_NO_MAIN -o bookmark_wal bookmark_wal.c bookmark_snapshot.c bookmark_store.c bookmark_text.c roaring_bitmap.c bookmark_tags.c bplus_tree.c trie.c min_heap.c hash_table.c node_arena.c -lm
+ * Run: ./bookmark_wal [visits] [window_ms]
+ * Define BOOKMARK_WAL_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bookmark_wal.h"
+#include "bookmark_snapshot.h"
+
+#define WAL_INITIAL_BATCH 4096
+#define WAL_MAX_VARINT 10
+#define WAL_CRC_BYTES 4
+
+static uint32_t WAL_CRC_TABLE[256];
+static pthread_once_t WAL_CRC_ONCE = PTHREAD_ONCE_INIT;
+
+/**
+ * Build the CRC-32 (IEEE, reflected) lookup table
+ */
+void bookmark_wal_crc_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; bit++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        WAL_CRC_TABLE[i] = c;
+    }
+}
+
+/**
+ * CRC-32 of a payload
+ * Time Complexity: O(n)
+ */
+uint32_t bookmark_wal_crc32(const unsigned char *data, size_t len) {
+    pthread_once(&WAL_CRC_ONCE, bookmark_wal_crc_init);
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        c = WAL_CRC_TABLE[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+/**
+ * Bytes a LEB128 varint of value takes
+ */
+int bookmark_wal_varint_size(uint64_t value) {
+    int size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * Write a LEB128 varint; returns bytes written
+ */
+int bookmark_wal_put_varint(unsigned char *out, uint64_t value) {
+    int size = 0;
+    while (value >= 0x80) {
+        out[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = (unsigned char)value;
+    return size;
+}
+
+/**
+ * Read a LEB128 varint from [p, end); returns bytes read, 0 if truncated
+ */
+int bookmark_wal_get_varint(const unsigned char *p, const unsigned char *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (int i = 0; i < WAL_MAX_VARINT && p + i < end; i++) {
+        result |= (uint64_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Map signed deltas to unsigned so small negatives stay short varints
+ */
+uint64_t bookmark_wal_zigzag(long long value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+long long bookmark_wal_unzigzag(uint64_t value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+/**
+ * Write all of buf, retrying short writes
+ */
+int bookmark_wal_write_all(int fd, const unsigned char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, buf, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        buf += written;
+        len -= written;
+    }
+    return 1;
+}
+
+/**
+ * Create an empty log whose first record will have sequence base
+ * Written to path.tmp and renamed into place, like snapshots.
+ * Returns an append-mode descriptor, or -1
+ */
+int bookmark_wal_create_file(const char *path, uint64_t base) {
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return -1;
+    
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    
+    BookmarkWalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BOOKMARK_WAL_MAGIC, sizeof(header.magic));
+    header.version = BOOKMARK_WAL_VERSION;
+    header.base_sequence = base;
+    
+    int ok = bookmark_wal_write_all(fd, (const unsigned char *)&header, sizeof(header)) && fsync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    bookmark_snapshot_sync_dir(path);
+    return open(path, O_WRONLY | O_APPEND);
+}
+
+/**
+ * Read a whole file into memory
+ * Returns NULL if it cannot be opened (errno says why)
+ */
+unsigned char *bookmark_wal_read_file(const char *path, size_t *size_out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    
+    size_t size = st.st_size, done = 0;
+    unsigned char *data = (unsigned char *)malloc(size ? size : 1);
+    while (done < size) {
+        ssize_t got = read(fd, data + done, size - done);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += got;
+    }
+    close(fd);
+    *size_out = done;
+    return data;
+}
+
+/**
+ * Where replay ended up
+ */
+typedef struct {
+    uint64_t valid_bytes;        // end of the last intact frame
+    uint64_t end_sequence;       // sequence after the last intact frame
+    long long last_time;         // timestamp base for the next record
+    long applied;                // records applied to the store
+} BookmarkWalScan;
+
+/**
+ * Does the op carry a time delta?
+ */
+int bookmark_wal_op_timed(int op) {
+    return op == WAL_OP_ADD || op == WAL_OP_VISIT;
+}
+
+/**
+ * Length-prefixed strings at the end of the op's payload
+ */
+int bookmark_wal_op_strings(int op) {
+    if (op == WAL_OP_ADD) return 3;
+    return op == WAL_OP_TAG || op == WAL_OP_UNTAG ? 1 : 0;
+}
+
+/**
+ * Apply one decoded payload whose sequence is store->mutations
+ * Returns 0 if the store disagrees with the log (wrong id, dead id)
+ */
+int bookmark_wal_apply(BookmarkStore *store, int op, BookmarkId id, long long time,
+                       const unsigned char *p, const unsigned char *end) {
+    if (op == WAL_OP_DELETE) return bookmark_store_delete(store, id);
+    
+    // Replayed at its logged time, so frecency and the recency view match the original
+    if (op == WAL_OP_VISIT) return bookmark_store_visit_at(store, id, time);
+    
+    // ADD: title, url, category; TAG / UNTAG: the tag name
+    char *fields[3] = { NULL, NULL, NULL };
+    int field_count = bookmark_wal_op_strings(op);
+    int ok = 1;
+    for (int f = 0; f < field_count && ok; f++) {
+        uint64_t len;
+        int used = bookmark_wal_get_varint(p, end, &len);
+        if (!used || len > (uint64_t)(end - p - used)) {
+            ok = 0;
+            break;
+        }
+        p += used;
+        fields[f] = (char *)malloc(len + 1);
+        memcpy(fields[f], p, len);
+        fields[f][len] = '\0';
+        p += len;
+    }
+    
+    if (ok && op == WAL_OP_ADD) {
+        ok = bookmark_store_add_at(store, fields[0], fields[1], fields[2], time) == id;
+    } else if (ok) {
+        ok = op == WAL_OP_TAG ? bookmark_store_tag(store, id, fields[0]) : bookmark_store_untag(store, id, fields[0]);
+    }
+    for (int f = 0; f < 3; f++) free(fields[f]);
+    return ok;
+}
+
+/**
+ * Replay a log image into store, skipping records the store already has
+ * Returns 0 if the log and store are inconsistent
+ * Time Complexity: O(log bytes)
+ */
+int bookmark_wal_scan(const unsigned char *data, size_t size, BookmarkStore *store, BookmarkWalScan *scan) {
+    const BookmarkWalHeader *header = (const BookmarkWalHeader *)data;
+    uint64_t sequence = header->base_sequence;
+    if (sequence > store->mutations) return 0;  // records between store and log are missing
+    
+    const unsigned char *p = data + sizeof(BookmarkWalHeader);
+    const unsigned char *end = data + size;
+    scan->last_time = 0;
+    scan->applied = 0;
+    
+    while (p < end) {
+        // Frame: stop at the first torn or corrupt one
+        uint64_t payload_len;
+        int used = bookmark_wal_get_varint(p, end, &payload_len);
+        if (!used || payload_len == 0 || payload_len + WAL_CRC_BYTES > (uint64_t)(end - p - used)) break;
+        
+        const unsigned char *payload = p + used;
+        const unsigned char *payload_end = payload + payload_len;
+        uint32_t crc = payload_end[0] | (payload_end[1] << 8) | (payload_end[2] << 16) |
+                       ((uint32_t)payload_end[3] << 24);
+        if (crc != bookmark_wal_crc32(payload, payload_len)) break;
+        
+        int op = payload[0];
+        const unsigned char *q = payload + 1;
+        uint64_t id, delta = 0;
+        used = bookmark_wal_get_varint(q, payload_end, &id);
+        if (!used || id >= BOOKMARK_NONE) break;
+        q += used;
+        if (op < WAL_OP_ADD || op > WAL_OP_UNTAG) break;
+        if (bookmark_wal_op_timed(op)) {
+            used = bookmark_wal_get_varint(q, payload_end, &delta);
+            if (!used) break;
+            q += used;
+        }
+        long long time = scan->last_time + bookmark_wal_unzigzag(delta);
+        
+        if (sequence >= store->mutations) {
+            if (!bookmark_wal_apply(store, op, (BookmarkId)id, time, q, payload_end)) return 0;
+            scan->applied++;
+        }
+        if (bookmark_wal_op_timed(op)) scan->last_time = time;
+        
+        sequence++;
+        p = payload_end + WAL_CRC_BYTES;
+    }
+    
+    scan->valid_bytes = p - data;
+    scan->end_sequence = sequence;
+    return 1;
+}
+
+/**
+ * Check a log header
+ */
+int bookmark_wal_header_ok(const unsigned char *data, size_t size) {
+    const BookmarkWalHeader *header = (const BookmarkWalHeader *)data;
+    return size >= sizeof(BookmarkWalHeader) &&
+           memcmp(header->magic, BOOKMARK_WAL_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == BOOKMARK_WAL_VERSION;
+}
+
+/**
+ * Replay the log at path into store without opening it for writing
+ * Returns records applied (0 if there is no log), or -1 if the log is
+ * unreadable or does not line up with the store
+ * Time Complexity: O(log bytes)
+ */
+long bookmark_wal_replay(const char *path, BookmarkStore *store, uint64_t *valid_bytes_out) {
+    size_t size;
+    unsigned char *data = bookmark_wal_read_file(path, &size);
+    if (!data) return errno == ENOENT ? 0 : -1;
+    
+    BookmarkWalScan scan;
+    long result = -1;
+    if (bookmark_wal_header_ok(data, size) && bookmark_wal_scan(data, size, store, &scan)) {
+        result = scan.applied;
+        if (valid_bytes_out) *valid_bytes_out = scan.valid_bytes;
+    }
+    free(data);
+    return result;
+}
+
+/**
+ * Background flusher: batch, write, one fdatasync per batch
+ */
+void *bookmark_wal_flusher(void *arg) {
+    BookmarkWal *wal = (BookmarkWal *)arg;
+    pthread_mutex_lock(&wal->lock);
+    
+    while (1) {
+        while (wal->pending_len == 0 && !wal->closing) {
+            pthread_cond_wait(&wal->work, &wal->lock);
+        }
+        if (wal->pending_len == 0) break;  // closing and drained
+        
+        // Give the batch window_ms to collect more records
+        if (wal->window_ms > 0 && !wal->closing) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)wal->window_ms * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            while (!wal->closing &&
+                   pthread_cond_timedwait(&wal->work, &wal->lock, &deadline) != ETIMEDOUT) {
+            }
+        }
+        
+        // Swap buffers so mutators keep appending during the sync
+        unsigned char *batch = wal->pending;
+        size_t batch_len = wal->pending_len;
+        size_t batch_capacity = wal->pending_capacity;
+        wal->pending = wal->writing;
+        wal->pending_capacity = wal->writing_capacity;
+        wal->pending_len = 0;
+        wal->writing = batch;
+        wal->writing_capacity = batch_capacity;
+        uint64_t batch_end = wal->appended_lsn;
+        int fd = wal->fd;
+        pthread_mutex_unlock(&wal->lock);
+        
+        int ok = !wal->failed && bookmark_wal_write_all(fd, batch, batch_len) && fdatasync(fd) == 0;
+        
+        pthread_mutex_lock(&wal->lock);
+        if (ok) {
+            wal->durable_lsn = batch_end;
+            wal->syncs++;
+        } else {
+            wal->failed = 1;
+        }
+        pthread_cond_broadcast(&wal->durable);
+    }
+    
+    pthread_mutex_unlock(&wal->lock);
+    return NULL;
+}
+
+/**
+ * Open (or create) the log for store, replaying what the store lacks
+ * store should come from the matching snapshot, or be empty if there is
+ * none. window_ms bounds how long a record waits for its batch
+ * (BOOKMARK_WAL_DEFAULT_WINDOW_MS if negative, 0 = sync as soon as the
+ * flusher is free).
+ * Returns NULL if the log is unreadable or does not line up with store
+ * Time Complexity: O(log bytes)
+ */
+BookmarkWal *bookmark_wal_open(const char *path, BookmarkStore *store, int window_ms) {
+    size_t size = 0;
+    unsigned char *data = bookmark_wal_read_file(path, &size);
+    if (!data && errno != ENOENT) return NULL;
+    
+    BookmarkWalScan scan = { 0, store->mutations, 0, 0 };
+    int fd;
+    if (data && bookmark_wal_header_ok(data, size)) {
+        if (!bookmark_wal_scan(data, size, store, &scan)) {
+            free(data);
+            return NULL;
+        }
+    } else if (data && size >= sizeof(BookmarkWalHeader)) {
+        free(data);  // not a log (or another version): do not overwrite it
+        return NULL;
+    }
+    free(data);
+    
+    if (scan.valid_bytes > 0 && scan.end_sequence == store->mutations) {
+        // Continue the existing log after its last intact record
+        if (truncate(path, scan.valid_bytes) != 0) return NULL;
+        fd = open(path, O_WRONLY | O_APPEND);
+    } else {
+        // No log, a torn header, or a log the snapshot has overtaken
+        fd = bookmark_wal_create_file(path, store->mutations);
+        scan.last_time = 0;
+    }
+    if (fd < 0) return NULL;
+    
+    BookmarkWal *wal = (BookmarkWal *)calloc(1, sizeof(BookmarkWal));
+    wal->path = strdup(path);
+    wal->fd = fd;
+    wal->window_ms = window_ms >= 0 ? window_ms : BOOKMARK_WAL_DEFAULT_WINDOW_MS;
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->work, NULL);
+    pthread_cond_init(&wal->durable, NULL);
+    wal->pending_capacity = wal->writing_capacity = WAL_INITIAL_BATCH;
+    wal->pending = (unsigned char *)malloc(wal->pending_capacity);
+    wal->writing = (unsigned char *)malloc(wal->writing_capacity);
+    wal->next_sequence = store->mutations;
+    wal->last_time = scan.last_time;
+    
+    pthread_create(&wal->flusher, NULL, bookmark_wal_flusher, wal);
+    return wal;
+}
+
+/**
+ * Encode one record into the pending batch (lock held)
+ * strings holds ADD's title, url, category or TAG / UNTAG's name, and is
+ * NULL otherwise; time is ignored by ops without one
+ * Time Complexity: O(record size) amortized
+ */
+void bookmark_wal_append(BookmarkWal *wal, int op, BookmarkId id, long long time, const char *strings[3]) {
+    uint64_t delta = bookmark_wal_zigzag(time - wal->last_time);
+    size_t lengths[3] = { 0, 0, 0 };
+    int string_count = bookmark_wal_op_strings(op);
+    
+    size_t payload_len = 1 + bookmark_wal_varint_size(id);
+    if (bookmark_wal_op_timed(op)) payload_len += bookmark_wal_varint_size(delta);
+    for (int f = 0; f < string_count; f++) {
+        lengths[f] = strlen(strings[f]);
+        payload_len += bookmark_wal_varint_size(lengths[f]) + lengths[f];
+    }
+    size_t frame_len = bookmark_wal_varint_size(payload_len) + payload_len + WAL_CRC_BYTES;
+    
+    if (wal->pending_len + frame_len > wal->pending_capacity) {
+        while (wal->pending_len + frame_len > wal->pending_capacity) wal->pending_capacity *= 2;
+        wal->pending = (unsigned char *)realloc(wal->pending, wal->pending_capacity);
+    }
+    
+    unsigned char *out = wal->pending + wal->pending_len;
+    out += bookmark_wal_put_varint(out, payload_len);
+    unsigned char *payload = out;
+    *out++ = (unsigned char)op;
+    out += bookmark_wal_put_varint(out, id);
+    if (bookmark_wal_op_timed(op)) {
+        out += bookmark_wal_put_varint(out, delta);
+        wal->last_time = time;
+    }
+    for (int f = 0; f < string_count; f++) {
+        out += bookmark_wal_put_varint(out, lengths[f]);
+        memcpy(out, strings[f], lengths[f]);
+        out += lengths[f];
+    }
+    uint32_t crc = bookmark_wal_crc32(payload, payload_len);
+    for (int b = 0; b < WAL_CRC_BYTES; b++) *out++ = (unsigned char)(crc >> (8 * b));
+    
+    if (wal->pending_len == 0) pthread_cond_signal(&wal->work);
+    wal->pending_len += frame_len;
+    wal->appended_lsn += frame_len;
+    wal->next_sequence++;
+    wal->records++;
+}
+
+/**
+ * Add a bookmark and log it
+ * Returns the id, or BOOKMARK_NONE if the store refused it or the log
+ * has failed. Durable after the next group commit (see bookmark_wal_commit).
+ * Time Complexity: O(m + log n) for m = title length
+ */
+BookmarkId bookmark_wal_add(BookmarkWal *wal, BookmarkStore *store, const char *title,
+                            const char *url, const char *category) {
+    pthread_mutex_lock(&wal->lock);
+    BookmarkId id = BOOKMARK_NONE;
+    if (!wal->failed && wal->next_sequence == store->mutations) {
+        id = bookmark_store_add(store, title, url, category);
+        if (id != BOOKMARK_NONE) {
+            const BookmarkRecord *record = bookmark_store_get(store, id);
+            const char *strings[3] = { record->title, record->url, record->category };
+            bookmark_wal_append(wal, WAL_OP_ADD, id, record->created_at, strings);
+        }
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return id;
+}
+
+/**
+ * Delete a bookmark and log it
+ * Returns 0 if id is not live or the log has failed
+ * Time Complexity: O(m + log n) for m = title length
+ */
+int bookmark_wal_delete(BookmarkWal *wal, BookmarkStore *store, BookmarkId id) {
+    pthread_mutex_lock(&wal->lock);
+    int ok = !wal->failed && wal->next_sequence == store->mutations && bookmark_store_delete(store, id);
+    if (ok) bookmark_wal_append(wal, WAL_OP_DELETE, id, 0, NULL);
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+/**
+ * Record a visit and log it; does not wait for the disk
+ * Returns 0 if id is not live or the log has failed
+ * Time Complexity: O(m + log n) for m = title length
+ */
+int bookmark_wal_visit(BookmarkWal *wal, BookmarkStore *store, BookmarkId id) {
+    pthread_mutex_lock(&wal->lock);
+    int ok = !wal->failed && wal->next_sequence == store->mutations && bookmark_store_visit(store, id);
+    if (ok) bookmark_wal_append(wal, WAL_OP_VISIT, id, bookmark_store_get(store, id)->last_visited, NULL);
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+/**
+ * Tag a bookmark and log it (the name as stored, trimmed)
+ * Returns 0 if the store refused the tag or the log has failed
+ * Time Complexity: O(m + k + n) (see bookmark_store_tag)
+ */
+int bookmark_wal_tag(BookmarkWal *wal, BookmarkStore *store, BookmarkId id, const char *tag) {
+    pthread_mutex_lock(&wal->lock);
+    int ok = !wal->failed && wal->next_sequence == store->mutations && bookmark_store_tag(store, id, tag);
+    if (ok) {
+        const char *strings[3] = { bookmark_tags_name(store->tags, bookmark_tags_find(store->tags, tag)), NULL, NULL };
+        bookmark_wal_append(wal, WAL_OP_TAG, id, 0, strings);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+/**
+ * Take a tag off a bookmark and log it
+ * Returns 0 if the bookmark did not have the tag or the log has failed
+ * Time Complexity: O(m + k + n)
+ */
+int bookmark_wal_untag(BookmarkWal *wal, BookmarkStore *store, BookmarkId id, const char *tag) {
+    pthread_mutex_lock(&wal->lock);
+    int ok = !wal->failed && wal->next_sequence == store->mutations && bookmark_store_untag(store, id, tag);
+    if (ok) {
+        const char *strings[3] = { bookmark_tags_name(store->tags, bookmark_tags_find(store->tags, tag)), NULL, NULL };
+        bookmark_wal_append(wal, WAL_OP_UNTAG, id, 0, strings);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+/**
+ * Wait until every record appended so far is on disk
+ * Joins the current batch rather than forcing a sync of its own.
+ * Returns 0 if the log has failed
+ */
+int bookmark_wal_commit(BookmarkWal *wal) {
+    pthread_mutex_lock(&wal->lock);
+    uint64_t target = wal->appended_lsn;
+    while (wal->durable_lsn < target && !wal->failed) {
+        pthread_cond_wait(&wal->durable, &wal->lock);
+    }
+    int ok = !wal->failed;
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+/**
+ * Save a snapshot of store and start a fresh, empty log after it
+ * Returns 0 on failure (the old snapshot and log remain valid)
+ * Time Complexity: O(n + trie bytes)
+ */
+int bookmark_wal_checkpoint(BookmarkWal *wal, BookmarkStore *store, const char *snapshot_path) {
+    if (!bookmark_wal_commit(wal)) return 0;
+    if (!bookmark_snapshot_save(store, snapshot_path)) return 0;
+    
+    int fd = bookmark_wal_create_file(wal->path, store->mutations);
+    if (fd < 0) return 0;
+    
+    // Nothing is pending (commit above, single mutator), so the flusher is idle
+    pthread_mutex_lock(&wal->lock);
+    close(wal->fd);
+    wal->fd = fd;
+    wal->next_sequence = store->mutations;
+    wal->last_time = 0;
+    pthread_mutex_unlock(&wal->lock);
+    return 1;
+}
+
+/**
+ * Flush what is pending, stop the flusher and close the log
+ */
+void bookmark_wal_close(BookmarkWal *wal) {
+    pthread_mutex_lock(&wal->lock);
+    wal->closing = 1;
+    pthread_cond_signal(&wal->work);
+    pthread_mutex_unlock(&wal->lock);
+    pthread_join(wal->flusher, NULL);
+    
+    close(wal->fd);
+    pthread_mutex_destroy(&wal->lock);
+    pthread_cond_destroy(&wal->work);
+    pthread_cond_destroy(&wal->durable);
+    free(wal->pending);
+    free(wal->writing);
+    free(wal->path);
+    free(wal);
+}
+
+#ifndef BOOKMARK_WAL_NO_MAIN
+
+#define DEMO_BOOKMARKS 1000
+#define DEMO_DEFAULT_VISITS 200000
+#define DEMO_SYNC_EACH 500           // visits measured with a commit after each
+
+/**
+ * Monotonic seconds
+ */
+double wal_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Bytes in a file (0 if missing)
+ */
+long wal_file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : 0;
+}
+
+/**
+ * Sum of visit counts: a cheap fingerprint for comparing stores
+ */
+unsigned long wal_total_visits(BookmarkStore *store) {
+    unsigned long total = 0;
+    for (int id = 0; id < store->record_count; id++) {
+        if (store->records[id].live) total += store->records[id].visit_count;
+    }
+    return total;
+}
+
+/**
+ * Does the recency view hold exactly the live bookmarks?
+ * Replayed adds and visits must re-key it by their logged times, or
+ * deletes leave stale entries behind.
+ */
+int wal_recent_view_ok(BookmarkStore *store) {
+    int live = bookmark_store_count(store);
+    BookmarkId *ids = (BookmarkId *)malloc((live + 2) * sizeof(BookmarkId));
+    int found = bookmark_store_page(store, BOOKMARK_VIEW_RECENT, NULL, 0, live + 1, ids);
+    int ok = found == live;
+    for (int i = 0; i < found && ok; i++) ok = bookmark_store_get(store, ids[i]) != NULL;
+    free(ids);
+    return ok;
+}
+
+/**
+ * Recover the way startup does: snapshot (if any), then the log
+ */
+BookmarkStore *wal_recover(const char *snapshot_path, const char *wal_path, long *replayed) {
+    BookmarkStore *store = bookmark_snapshot_load(snapshot_path);
+    if (!store) store = bookmark_store_create(20);
+    *replayed = bookmark_wal_replay(wal_path, store, NULL);
+    return store;
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    int visits = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_VISITS;
+    int window_ms = argc > 2 ? atoi(argv[2]) : BOOKMARK_WAL_DEFAULT_WINDOW_MS;
+    if (visits < 1) visits = DEMO_DEFAULT_VISITS;
+    const char *wal_path = "bookmarks.wal";
+    const char *snapshot_path = "bookmarks.snapshot";
+    unlink(wal_path);
+    unlink(snapshot_path);
+    
+    printf("=== Bookmark Write-Ahead Log in C ===\n");
+    printf("Data Structure: Append-only log with group commit, replayed over a snapshot\n\n");
+    
+    BookmarkStore *store = bookmark_store_create(20);
+    BookmarkWal *wal = bookmark_wal_open(wal_path, store, window_ms);
+    if (!wal) {
+        printf("Cannot open %s\n", wal_path);
+        return 1;
+    }
+    
+    printf("1. Adding %d bookmarks, one commit at the end\n", DEMO_BOOKMARKS);
+    char title[64], url[64];
+    for (int i = 0; i < DEMO_BOOKMARKS; i++) {
+        snprintf(title, sizeof(title), "Bookmark %d", i);
+        snprintf(url, sizeof(url), "https://example.org/%d", i);
+        bookmark_wal_add(wal, store, title, url, "Demo");
+    }
+    bookmark_wal_commit(wal);
+    printf("   Log: %ld bytes, %lu syncs\n\n", wal_file_size(wal_path), wal->syncs);
+    
+    printf("2. Visits: commit after every visit vs group commit (window %d ms)\n", window_ms);
+    unsigned long syncs_before = wal->syncs;
+    wal->window_ms = 0;  // one sync per click, no batching delay
+    double start = wal_now();
+    for (int i = 0; i < DEMO_SYNC_EACH; i++) {
+        bookmark_wal_visit(wal, store, (BookmarkId)(i % DEMO_BOOKMARKS));
+        bookmark_wal_commit(wal);
+    }
+    double each_time = wal_now() - start;
+    wal->window_ms = window_ms;
+    printf("   Commit each:  %6d visits, %6lu syncs, %10.0f visits/s\n", DEMO_SYNC_EACH,
+           wal->syncs - syncs_before, DEMO_SYNC_EACH / each_time);
+    
+    syncs_before = wal->syncs;
+    long bytes_before = wal_file_size(wal_path);
+    start = wal_now();
+    unsigned int state = 2463534242u;
+    for (int i = 0; i < visits; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        bookmark_wal_visit(wal, store, state % DEMO_BOOKMARKS);
+    }
+    double append_time = wal_now() - start;
+    bookmark_wal_commit(wal);
+    double group_time = wal_now() - start;
+    printf("   Group commit: %6d visits, %6lu syncs, %10.0f visits/s (%.0f ns to log a visit)\n", visits,
+           wal->syncs - syncs_before, visits / group_time, append_time * 1e9 / visits);
+    printf("   %.1f bytes per visit record\n\n",
+           (double)(wal_file_size(wal_path) - bytes_before) / visits);
+    
+    printf("3. Crash without checkpoint: recover from the log alone\n");
+    unsigned long expected = wal_total_visits(store);
+    bookmark_wal_close(wal);
+    long replayed;
+    BookmarkStore *recovered = wal_recover(snapshot_path, wal_path, &replayed);
+    printf("   Replayed %ld records: %d bookmarks, visits %lu (expected %lu)\n", replayed,
+           bookmark_store_count(recovered), wal_total_visits(recovered), expected);
+    for (int i = 0; i < DEMO_BOOKMARKS; i += 4) bookmark_store_delete(recovered, (BookmarkId)i);
+    printf("   Deleted every 4th after replay: %d left, recency view matches: %s\n\n",
+           bookmark_store_count(recovered), wal_recent_view_ok(recovered) ? "yes" : "NO");
+    bookmark_store_free(recovered);
+    
+    printf("4. Torn tail: appending half a record, then reopening for writes\n");
+    long intact = wal_file_size(wal_path);
+    FILE *file = fopen(wal_path, "ab");
+    fputc(0x40, file);
+    fputc(WAL_OP_VISIT, file);
+    fclose(file);
+    bookmark_store_free(store);
+    store = bookmark_store_create(20);
+    wal = bookmark_wal_open(wal_path, store, window_ms);
+    printf("   Recovered visits %lu; log truncated to the last intact record: %s\n\n",
+           wal_total_visits(store), wal_file_size(wal_path) == intact ? "yes" : "no");
+    
+    printf("5. Checkpoint, more visits, recover from snapshot + log\n");
+    bookmark_wal_checkpoint(wal, store, snapshot_path);
+    printf("   Snapshot: %ld bytes, log after checkpoint: %ld bytes\n", wal_file_size(snapshot_path),
+           wal_file_size(wal_path));
+    for (int i = 0; i < 1000; i++) bookmark_wal_visit(wal, store, (BookmarkId)(i % 10));
+    bookmark_wal_delete(wal, store, 999);
+    for (int i = 0; i < 10; i++) bookmark_wal_tag(wal, store, (BookmarkId)i, i % 2 ? "odd" : "even");
+    bookmark_wal_untag(wal, store, 0, "even");
+    expected = wal_total_visits(store);
+    bookmark_wal_close(wal);
+    recovered = wal_recover(snapshot_path, wal_path, &replayed);
+    printf("   Replayed %ld records over the snapshot: %d bookmarks, visits %lu (expected %lu)\n", replayed,
+           bookmark_store_count(recovered), wal_total_visits(recovered), expected);
+    printf("   Tags replayed: odd %d, even %d (expected 5, 4)\n", bookmark_store_tag_count(recovered, "odd"),
+           bookmark_store_tag_count(recovered, "even"));
+    
+    bookmark_store_free(recovered);
+    bookmark_store_free(store);
+    unlink(wal_path);
+    unlink(snapshot_path);
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,79 @@
+/**
+ * Bookmark Write-Ahead Log Interface
+ * Durable add/delete/visit/tag/untag for a BookmarkStore with group commit and
+ * replay over a snapshot (see bookmark_wal.c for the record format)
+ */
+
+#ifndef BOOKMARK_WAL_H
+#define BOOKMARK_WAL_H
+
+#include <pthread.h>
+
+#include "bookmark_store.h"
+
+#define BOOKMARK_WAL_MAGIC "BMWAL\r\n"          // 8 bytes with the terminator
+#define BOOKMARK_WAL_VERSION 2               // 2: adds TAG and UNTAG
+#define BOOKMARK_WAL_DEFAULT_WINDOW_MS 10
+
+#define WAL_OP_ADD 1
+#define WAL_OP_DELETE 2
+#define WAL_OP_VISIT 3
+#define WAL_OP_TAG 4
+#define WAL_OP_UNTAG 5
+
+/**
+ * File header: records that follow are sequence numbers
+ * base_sequence, base_sequence + 1, ...
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t base_sequence;
+} BookmarkWalHeader;
+
+/**
+ * Open log with a background flusher
+ * Mutators append encoded records to `pending` under `lock`; the flusher
+ * swaps it out, writes it and fdatasyncs once for the whole batch.
+ */
+typedef struct {
+    char *path;
+    int fd;
+    int window_ms;               // how long a batch may wait for company
+    
+    pthread_mutex_t lock;
+    pthread_cond_t work;         // records pending or closing
+    pthread_cond_t durable;      // durable_lsn advanced
+    pthread_t flusher;
+    
+    unsigned char *pending;      // encoded records not yet written
+    size_t pending_len;
+    size_t pending_capacity;
+    unsigned char *writing;      // batch being written by the flusher
+    size_t writing_capacity;
+    
+    uint64_t appended_lsn;       // log bytes appended (including pending)
+    uint64_t durable_lsn;        // log bytes known to be on disk
+    uint64_t next_sequence;      // sequence of the next record
+    long long last_time;         // timestamps are delta-coded against this
+    int closing;
+    int failed;                  // a write or sync failed; log is read-only
+    
+    unsigned long syncs;         // fdatasync calls (stats)
+    unsigned long records;       // records appended (stats)
+} BookmarkWal;
+
+BookmarkWal *bookmark_wal_open(const char *path, BookmarkStore *store, int window_ms);
+long bookmark_wal_replay(const char *path, BookmarkStore *store, uint64_t *valid_bytes_out);
+BookmarkId bookmark_wal_add(BookmarkWal *wal, BookmarkStore *store, const char *title,
+                            const char *url, const char *category);
+int bookmark_wal_delete(BookmarkWal *wal, BookmarkStore *store, BookmarkId id);
+int bookmark_wal_visit(BookmarkWal *wal, BookmarkStore *store, BookmarkId id);
+int bookmark_wal_tag(BookmarkWal *wal, BookmarkStore *store, BookmarkId id, const char *tag);
+int bookmark_wal_untag(BookmarkWal *wal, BookmarkStore *store, BookmarkId id, const char *tag);
+int bookmark_wal_commit(BookmarkWal *wal);
+int bookmark_wal_checkpoint(BookmarkWal *wal, BookmarkStore *store, const char *snapshot_path);
+void bookmark_wal_close(BookmarkWal *wal);
+
+#endif
@@ -0,0 +1,774 @@
+/**
+ * B+ Tree Implementation in C
+ * Ordered index of (key, id) entries with O(log n) updates and
+ * positional access, for sorted views that are kept instead of re-sorted
+ * 
+ * Entries live in leaves of up to BPLUS_LEAF_MAX, chained left to right,
+ * so a page of results is a walk along one or two leaves. Inner nodes
+ * keep, per child, the smallest entry below it and how many entries
+ * are below it. The counts make the tree an order-statistic tree:
+ *   bplus_tree_range - descend by counts to position offset, then walk
+ *                      the leaf chain ("items 200-250 by visits")
+ *   bplus_tree_rank  - position of an entry, summing counts on the way
+ * Both are O(log n) to find the start; neither visits skipped leaves.
+ * 
+ * Entries order by a 64-bit key, then an optional tie-break callback,
+ * then id, so every entry is distinct and deleting one needs only the
+ * key it was inserted with. A key can be a number (visit count, time)
+ * or the first bytes of a string with the tie-break comparing the rest.
+ * Separators are kept exact (removing a subtree's smallest entry updates
+ * the separator naming it), so the tie-break is only ever called on ids
+ * that are in the tree and whose data the caller still has.
+ * 
+ * Nodes split in half when full and borrow from or merge with a sibling
+ * when they drop under half, so every node but the root is at least half
+ * full and the height stays O(log n). Nodes are slots in a NodeArena
+ * (node_arena.c) linked by 32-bit handles. bplus_tree_build bulk-loads
+ * sorted entries bottom-up in O(n).
+ * 
+ * Compile: gcc -O2 -o bplus_tree bplus_tree.c node_arena.c
+ * Run: ./bplus_tree
+ *      ./bplus_tree --bench [n]   (visit + page vs re-sorting n bookmarks)
+ * Define BPLUS_TREE_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#include "bplus_tree.h"
+
+#define BPLUS_LEAF_MIN (BPLUS_LEAF_MAX / 2)
+#define BPLUS_BRANCH_MIN (BPLUS_BRANCH_MAX / 2)
+
+/**
+ * Resolve a leaf handle
+ */
+BPlusLeaf *bplus_leaf(BPlusTree *tree, NodeHandle handle) {
+    return (BPlusLeaf *)node_arena_get(&tree->arena, handle);
+}
+
+/**
+ * Resolve an inner node handle
+ */
+BPlusBranch *bplus_branch(BPlusTree *tree, NodeHandle handle) {
+    return (BPlusBranch *)node_arena_get(&tree->arena, handle);
+}
+
+/**
+ * Allocate an empty leaf
+ */
+NodeHandle bplus_alloc_leaf(BPlusTree *tree) {
+    NodeHandle handle = node_arena_alloc(&tree->arena, sizeof(BPlusLeaf));
+    BPlusLeaf *leaf = bplus_leaf(tree, handle);
+    leaf->count = 0;
+    leaf->prev = leaf->next = NODE_NULL;
+    return handle;
+}
+
+/**
+ * Allocate an empty inner node
+ */
+NodeHandle bplus_alloc_branch(BPlusTree *tree) {
+    NodeHandle handle = node_arena_alloc(&tree->arena, sizeof(BPlusBranch));
+    bplus_branch(tree, handle)->count = 0;
+    return handle;
+}
+
+/**
+ * Create empty tree
+ * tie_break orders entries with equal keys before the id does; NULL to
+ * order them by id alone.
+ * Time Complexity: O(1)
+ */
+BPlusTree *bplus_tree_create(BPlusTieBreak tie_break, void *context) {
+    BPlusTree *tree = (BPlusTree *)malloc(sizeof(BPlusTree));
+    size_t slot = sizeof(BPlusLeaf) > sizeof(BPlusBranch) ? sizeof(BPlusLeaf) : sizeof(BPlusBranch);
+    node_arena_init_fixed(&tree->arena, (unsigned int)slot);
+    tree->root = bplus_alloc_leaf(tree);
+    tree->height = 0;
+    tree->size = 0;
+    tree->tie_break = tie_break;
+    tree->context = context;
+    return tree;
+}
+
+/**
+ * Order two entries: key, then tie-break, then id
+ * Time Complexity: O(1) plus the tie-break
+ */
+int bplus_tree_compare(const BPlusTree *tree, const BPlusEntry *a, const BPlusEntry *b) {
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    if (a->id == b->id) return 0;
+    if (tree->tie_break) {
+        int order = tree->tie_break(a->id, b->id, tree->context);
+        if (order != 0) return order;
+    }
+    return a->id < b->id ? -1 : 1;
+}
+
+/**
+ * First position in a leaf whose entry is >= entry
+ * Time Complexity: O(log BPLUS_LEAF_MAX)
+ */
+int bplus_leaf_lower_bound(BPlusTree *tree, const BPlusLeaf *leaf, const BPlusEntry *entry) {
+    int low = 0;
+    int high = leaf->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        BPlusEntry probe = { leaf->keys[mid], leaf->ids[mid] };
+        if (bplus_tree_compare(tree, &probe, entry) < 0) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+/**
+ * Child of an inner node whose range holds entry
+ * Time Complexity: O(log BPLUS_BRANCH_MAX)
+ */
+int bplus_branch_child(BPlusTree *tree, const BPlusBranch *branch, const BPlusEntry *entry) {
+    int low = 1;
+    int high = branch->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (bplus_tree_compare(tree, &branch->low[mid], entry) <= 0) low = mid + 1;
+        else high = mid;
+    }
+    return low - 1;
+}
+
+/**
+ * Walk from the root to the leaf that holds entry, recording the inner
+ * nodes and child slots taken
+ * Returns the leaf's handle
+ */
+NodeHandle bplus_descend(BPlusTree *tree, const BPlusEntry *entry, NodeHandle *path, int *slots) {
+    NodeHandle node = tree->root;
+    for (int level = 0; level < tree->height; level++) {
+        BPlusBranch *branch = bplus_branch(tree, node);
+        path[level] = node;
+        slots[level] = bplus_branch_child(tree, branch, entry);
+        node = branch->children[slots[level]];
+    }
+    return node;
+}
+
+/**
+ * Put (low, child, size) at position at of an inner node with room
+ */
+void bplus_branch_put(BPlusBranch *branch, int at, const BPlusEntry *low, NodeHandle child, uint32_t size) {
+    int tail = branch->count - at;
+    memmove(&branch->low[at + 1], &branch->low[at], tail * sizeof(BPlusEntry));
+    memmove(&branch->children[at + 1], &branch->children[at], tail * sizeof(NodeHandle));
+    memmove(&branch->sizes[at + 1], &branch->sizes[at], tail * sizeof(uint32_t));
+    branch->low[at] = *low;
+    branch->children[at] = child;
+    branch->sizes[at] = size;
+    branch->count++;
+}
+
+/**
+ * Drop position at of an inner node
+ */
+void bplus_branch_drop(BPlusBranch *branch, int at) {
+    int tail = branch->count - at - 1;
+    memmove(&branch->low[at], &branch->low[at + 1], tail * sizeof(BPlusEntry));
+    memmove(&branch->children[at], &branch->children[at + 1], tail * sizeof(NodeHandle));
+    memmove(&branch->sizes[at], &branch->sizes[at + 1], tail * sizeof(uint32_t));
+    branch->count--;
+}
+
+/**
+ * Entries below an inner node
+ */
+uint32_t bplus_branch_total(const BPlusBranch *branch) {
+    uint32_t total = 0;
+    for (int i = 0; i < branch->count; i++) total += branch->sizes[i];
+    return total;
+}
+
+/**
+ * Put (key, id) at position at of a leaf with room
+ */
+void bplus_leaf_put(BPlusLeaf *leaf, int at, uint64_t key, uint32_t id) {
+    int tail = leaf->count - at;
+    memmove(&leaf->keys[at + 1], &leaf->keys[at], tail * sizeof(uint64_t));
+    memmove(&leaf->ids[at + 1], &leaf->ids[at], tail * sizeof(uint32_t));
+    leaf->keys[at] = key;
+    leaf->ids[at] = id;
+    leaf->count++;
+}
+
+/**
+ * Drop position at of a leaf
+ */
+void bplus_leaf_drop(BPlusLeaf *leaf, int at) {
+    int tail = leaf->count - at - 1;
+    memmove(&leaf->keys[at], &leaf->keys[at + 1], tail * sizeof(uint64_t));
+    memmove(&leaf->ids[at], &leaf->ids[at + 1], tail * sizeof(uint32_t));
+    leaf->count--;
+}
+
+/**
+ * Insert an entry
+ * Returns 1 if inserted, 0 if (key, id) is already in the tree
+ * Time Complexity: O(log n)
+ */
+int bplus_tree_insert(BPlusTree *tree, uint64_t key, uint32_t id) {
+    BPlusEntry entry = { key, id };
+    NodeHandle path[BPLUS_MAX_HEIGHT];
+    int slots[BPLUS_MAX_HEIGHT];
+    NodeHandle node = bplus_descend(tree, &entry, path, slots);
+    BPlusLeaf *leaf = bplus_leaf(tree, node);
+    int at = bplus_leaf_lower_bound(tree, leaf, &entry);
+    if (at < leaf->count && leaf->keys[at] == key && leaf->ids[at] == id) return 0;
+    
+    for (int level = 0; level < tree->height; level++) {
+        bplus_branch(tree, path[level])->sizes[slots[level]]++;
+    }
+    tree->size++;
+    
+    if (leaf->count < BPLUS_LEAF_MAX) {
+        bplus_leaf_put(leaf, at, key, id);
+        return 1;
+    }
+    
+    // Full leaf: move the upper half to a new right sibling, then insert
+    NodeHandle right_handle = bplus_alloc_leaf(tree);
+    BPlusLeaf *right = bplus_leaf(tree, right_handle);
+    int half = BPLUS_LEAF_MAX / 2;
+    right->count = BPLUS_LEAF_MAX - half;
+    memcpy(right->keys, &leaf->keys[half], right->count * sizeof(uint64_t));
+    memcpy(right->ids, &leaf->ids[half], right->count * sizeof(uint32_t));
+    leaf->count = half;
+    if (at <= half) bplus_leaf_put(leaf, at, key, id);
+    else bplus_leaf_put(right, at - half, key, id);
+    
+    right->prev = node;
+    right->next = leaf->next;
+    if (leaf->next != NODE_NULL) bplus_leaf(tree, leaf->next)->prev = right_handle;
+    leaf->next = right_handle;
+    
+    // Hand the new sibling up; split inner nodes while they are full
+    BPlusEntry low = { right->keys[0], right->ids[0] };
+    NodeHandle sibling = right_handle;
+    uint32_t sibling_size = (uint32_t)right->count;
+    uint32_t left_size = (uint32_t)leaf->count;
+    for (int level = tree->height - 1; level >= 0; level--) {
+        BPlusBranch *branch = bplus_branch(tree, path[level]);
+        int slot = slots[level];
+        branch->sizes[slot] = left_size;
+        if (branch->count < BPLUS_BRANCH_MAX) {
+            bplus_branch_put(branch, slot + 1, &low, sibling, sibling_size);
+            return 1;
+        }
+        
+        NodeHandle split_handle = bplus_alloc_branch(tree);
+        BPlusBranch *split = bplus_branch(tree, split_handle);
+        int branch_half = BPLUS_BRANCH_MAX / 2;
+        split->count = BPLUS_BRANCH_MAX - branch_half;
+        memcpy(split->low, &branch->low[branch_half], split->count * sizeof(BPlusEntry));
+        memcpy(split->children, &branch->children[branch_half], split->count * sizeof(NodeHandle));
+        memcpy(split->sizes, &branch->sizes[branch_half], split->count * sizeof(uint32_t));
+        branch->count = branch_half;
+        if (slot + 1 <= branch_half) bplus_branch_put(branch, slot + 1, &low, sibling, sibling_size);
+        else bplus_branch_put(split, slot + 1 - branch_half, &low, sibling, sibling_size);
+        
+        low = split->low[0];
+        sibling = split_handle;
+        sibling_size = bplus_branch_total(split);
+        left_size = bplus_branch_total(branch);
+    }
+    
+    // The root split: grow a level
+    NodeHandle root_handle = bplus_alloc_branch(tree);
+    BPlusBranch *root = bplus_branch(tree, root_handle);
+    root->children[0] = tree->root;
+    root->sizes[0] = left_size;
+    root->count = 1;
+    bplus_branch_put(root, 1, &low, sibling, sibling_size);
+    tree->root = root_handle;
+    tree->height++;
+    return 1;
+}
+
+/**
+ * Merge leaf at slot + 1 of parent into the leaf at slot
+ */
+void bplus_leaf_merge(BPlusTree *tree, BPlusBranch *parent, int slot) {
+    BPlusLeaf *left = bplus_leaf(tree, parent->children[slot]);
+    NodeHandle right_handle = parent->children[slot + 1];
+    BPlusLeaf *right = bplus_leaf(tree, right_handle);
+    
+    memcpy(&left->keys[left->count], right->keys, right->count * sizeof(uint64_t));
+    memcpy(&left->ids[left->count], right->ids, right->count * sizeof(uint32_t));
+    left->count += right->count;
+    left->next = right->next;
+    if (right->next != NODE_NULL) bplus_leaf(tree, right->next)->prev = parent->children[slot];
+    
+    parent->sizes[slot] += parent->sizes[slot + 1];
+    bplus_branch_drop(parent, slot + 1);
+    node_arena_free(&tree->arena, right_handle);
+}
+
+/**
+ * Refill the leaf at slot of parent if it is under half full: borrow
+ * an entry from a sibling that can spare one, else merge with it
+ * Returns 1 if parent lost a child
+ */
+int bplus_leaf_rebalance(BPlusTree *tree, BPlusBranch *parent, int slot) {
+    BPlusLeaf *leaf = bplus_leaf(tree, parent->children[slot]);
+    if (leaf->count >= BPLUS_LEAF_MIN) return 0;
+    
+    if (slot > 0) {
+        BPlusLeaf *left = bplus_leaf(tree, parent->children[slot - 1]);
+        if (left->count > BPLUS_LEAF_MIN) {
+            left->count--;
+            bplus_leaf_put(leaf, 0, left->keys[left->count], left->ids[left->count]);
+            parent->sizes[slot - 1]--;
+            parent->sizes[slot]++;
+            parent->low[slot] = (BPlusEntry){ leaf->keys[0], leaf->ids[0] };
+            return 0;
+        }
+        bplus_leaf_merge(tree, parent, slot - 1);
+        return 1;
+    }
+    
+    BPlusLeaf *right = bplus_leaf(tree, parent->children[slot + 1]);
+    if (right->count > BPLUS_LEAF_MIN) {
+        bplus_leaf_put(leaf, leaf->count, right->keys[0], right->ids[0]);
+        bplus_leaf_drop(right, 0);
+        parent->sizes[slot]++;
+        parent->sizes[slot + 1]--;
+        parent->low[slot + 1] = (BPlusEntry){ right->keys[0], right->ids[0] };
+        return 0;
+    }
+    bplus_leaf_merge(tree, parent, slot);
+    return 1;
+}
+
+/**
+ * Merge inner node at slot + 1 of parent into the one at slot
+ * The right node's first child takes the parent's separator as its low.
+ */
+void bplus_branch_merge(BPlusTree *tree, BPlusBranch *parent, int slot) {
+    BPlusBranch *left = bplus_branch(tree, parent->children[slot]);
+    NodeHandle right_handle = parent->children[slot + 1];
+    BPlusBranch *right = bplus_branch(tree, right_handle);
+    
+    right->low[0] = parent->low[slot + 1];
+    memcpy(&left->low[left->count], right->low, right->count * sizeof(BPlusEntry));
+    memcpy(&left->children[left->count], right->children, right->count * sizeof(NodeHandle));
+    memcpy(&left->sizes[left->count], right->sizes, right->count * sizeof(uint32_t));
+    left->count += right->count;
+    
+    parent->sizes[slot] += parent->sizes[slot + 1];
+    bplus_branch_drop(parent, slot + 1);
+    node_arena_free(&tree->arena, right_handle);
+}
+
+/**
+ * Refill the inner node at slot of parent if it is under half full
+ * (see bplus_leaf_rebalance); a borrowed child moves with its subtree
+ * Returns 1 if parent lost a child
+ */
+int bplus_branch_rebalance(BPlusTree *tree, BPlusBranch *parent, int slot) {
+    BPlusBranch *node = bplus_branch(tree, parent->children[slot]);
+    if (node->count >= BPLUS_BRANCH_MIN) return 0;
+    
+    if (slot > 0) {
+        BPlusBranch *left = bplus_branch(tree, parent->children[slot - 1]);
+        if (left->count > BPLUS_BRANCH_MIN) {
+            int last = left->count - 1;
+            uint32_t moved = left->sizes[last];
+            node->low[0] = parent->low[slot];
+            bplus_branch_put(node, 0, &left->low[last], left->children[last], moved);
+            parent->low[slot] = left->low[last];
+            left->count--;
+            parent->sizes[slot - 1] -= moved;
+            parent->sizes[slot] += moved;
+            return 0;
+        }
+        bplus_branch_merge(tree, parent, slot - 1);
+        return 1;
+    }
+    
+    BPlusBranch *right = bplus_branch(tree, parent->children[slot + 1]);
+    if (right->count > BPLUS_BRANCH_MIN) {
+        uint32_t moved = right->sizes[0];
+        bplus_branch_put(node, node->count, &parent->low[slot + 1], right->children[0], moved);
+        parent->low[slot + 1] = right->low[1];
+        bplus_branch_drop(right, 0);
+        parent->sizes[slot] += moved;
+        parent->sizes[slot + 1] -= moved;
+        return 0;
+    }
+    bplus_branch_merge(tree, parent, slot);
+    return 1;
+}
+
+/**
+ * Remove an entry (key must be the one it was inserted with)
+ * Returns 1 if removed, 0 if it was not in the tree
+ * Time Complexity: O(log n)
+ */
+int bplus_tree_remove(BPlusTree *tree, uint64_t key, uint32_t id) {
+    BPlusEntry entry = { key, id };
+    NodeHandle path[BPLUS_MAX_HEIGHT];
+    int slots[BPLUS_MAX_HEIGHT];
+    BPlusLeaf *leaf = bplus_leaf(tree, bplus_descend(tree, &entry, path, slots));
+    int at = bplus_leaf_lower_bound(tree, leaf, &entry);
+    if (at == leaf->count || leaf->keys[at] != key || leaf->ids[at] != id) return 0;
+    
+    bplus_leaf_drop(leaf, at);
+    for (int level = 0; level < tree->height; level++) {
+        bplus_branch(tree, path[level])->sizes[slots[level]]--;
+    }
+    tree->size--;
+    
+    // The smallest entry of a subtree is named by the deepest ancestor
+    // reached through a child other than its first
+    if (at == 0 && leaf->count > 0) {
+        for (int level = tree->height - 1; level >= 0; level--) {
+            if (slots[level] == 0) continue;
+            bplus_branch(tree, path[level])->low[slots[level]] = (BPlusEntry){ leaf->keys[0], leaf->ids[0] };
+            break;
+        }
+    }
+    
+    // Fix underfull nodes bottom-up; stop at the first level that is fine
+    for (int level = tree->height - 1; level >= 0; level--) {
+        BPlusBranch *parent = bplus_branch(tree, path[level]);
+        int shrunk = level == tree->height - 1 ? bplus_leaf_rebalance(tree, parent, slots[level])
+                                                : bplus_branch_rebalance(tree, parent, slots[level]);
+        if (!shrunk) break;
+    }
+    
+    if (tree->height > 0) {
+        BPlusBranch *root = bplus_branch(tree, tree->root);
+        if (root->count == 1) {
+            NodeHandle only = root->children[0];
+            node_arena_free(&tree->arena, tree->root);
+            tree->root = only;
+            tree->height--;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Number of entries that order before (key, id)
+ * The position (key, id) has, or would have, in the sorted order.
+ * Time Complexity: O(log n)
+ */
+int bplus_tree_rank(BPlusTree *tree, uint64_t key, uint32_t id) {
+    BPlusEntry entry = { key, id };
+    NodeHandle node = tree->root;
+    int rank = 0;
+    for (int level = 0; level < tree->height; level++) {
+        BPlusBranch *branch = bplus_branch(tree, node);
+        int slot = bplus_branch_child(tree, branch, &entry);
+        for (int i = 0; i < slot; i++) rank += (int)branch->sizes[i];
+        node = branch->children[slot];
+    }
+    return rank + bplus_leaf_lower_bound(tree, bplus_leaf(tree, node), &entry);
+}
+
+/**
+ * Ids in sorted order, skipping the first offset, at most limit
+ * Writes to ids_out and returns how many were written
+ * Time Complexity: O(log n + limit)
+ */
+int bplus_tree_range(BPlusTree *tree, int offset, int limit, uint32_t *ids_out) {
+    if (offset < 0) offset = 0;
+    if (limit <= 0 || offset >= tree->size) return 0;
+    
+    NodeHandle node = tree->root;
+    for (int level = 0; level < tree->height; level++) {
+        BPlusBranch *branch = bplus_branch(tree, node);
+        int slot = 0;
+        while ((uint32_t)offset >= branch->sizes[slot]) offset -= (int)branch->sizes[slot++];
+        node = branch->children[slot];
+    }
+    
+    int written = 0;
+    while (node != NODE_NULL && written < limit) {
+        BPlusLeaf *leaf = bplus_leaf(tree, node);
+        int take = leaf->count - offset;
+        if (take > limit - written) take = limit - written;
+        memcpy(&ids_out[written], &leaf->ids[offset], take * sizeof(uint32_t));
+        written += take;
+        offset = 0;
+        node = leaf->next;
+    }
+    return written;
+}
+
+/**
+ * Number of entries
+ * Time Complexity: O(1)
+ */
+int bplus_tree_size(const BPlusTree *tree) {
+    return tree->size;
+}
+
+/**
+ * Sort entries into the tree's order (for bplus_tree_build)
+ * Bottom-up merge sort, so the tie-break needs no global state.
+ * Time Complexity: O(n log n)
+ */
+void bplus_tree_sort(const BPlusTree *tree, BPlusEntry *entries, int count) {
+    BPlusEntry *buffer = (BPlusEntry *)malloc((count + 1) * sizeof(BPlusEntry));
+    BPlusEntry *from = entries;
+    BPlusEntry *to = buffer;
+    
+    for (int width = 1; width < count; width *= 2) {
+        for (int start = 0; start < count; start += 2 * width) {
+            int mid = start + width < count ? start + width : count;
+            int end = start + 2 * width < count ? start + 2 * width : count;
+            int i = start, j = mid, k = start;
+            while (i < mid && j < end) {
+                to[k++] = bplus_tree_compare(tree, &from[j], &from[i]) < 0 ? from[j++] : from[i++];
+            }
+            while (i < mid) to[k++] = from[i++];
+            while (j < end) to[k++] = from[j++];
+        }
+        BPlusEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+    
+    if (from != entries) memcpy(entries, from, count * sizeof(BPlusEntry));
+    free(buffer);
+}
+
+/**
+ * Fill an empty tree from entries already in its order
+ * Leaves and inner nodes are packed level by level, the entries spread
+ * evenly so every node is at least half full.
+ * Time Complexity: O(n)
+ */
+void bplus_tree_build(BPlusTree *tree, const BPlusEntry *sorted, int count) {
+    if (tree->size > 0 || count == 0) return;
+    node_arena_free(&tree->arena, tree->root);
+    
+    int nodes = (count + BPLUS_LEAF_MAX - 1) / BPLUS_LEAF_MAX;
+    NodeHandle *handles = (NodeHandle *)malloc(nodes * sizeof(NodeHandle));
+    BPlusEntry *lows = (BPlusEntry *)malloc(nodes * sizeof(BPlusEntry));
+    uint32_t *sizes = (uint32_t *)malloc(nodes * sizeof(uint32_t));
+    
+    NodeHandle prev = NODE_NULL;
+    for (int n = 0, at = 0; n < nodes; n++) {
+        int take = count / nodes + (n < count % nodes);
+        handles[n] = bplus_alloc_leaf(tree);
+        BPlusLeaf *leaf = bplus_leaf(tree, handles[n]);
+        for (int i = 0; i < take; i++) {
+            leaf->keys[i] = sorted[at + i].key;
+            leaf->ids[i] = sorted[at + i].id;
+        }
+        leaf->count = take;
+        leaf->prev = prev;
+        if (prev != NODE_NULL) bplus_leaf(tree, prev)->next = handles[n];
+        prev = handles[n];
+        lows[n] = sorted[at];
+        sizes[n] = (uint32_t)take;
+        at += take;
+    }
+    
+    // Group each level's nodes under parents until one is left
+    int height = 0;
+    while (nodes > 1) {
+        int parents = (nodes + BPLUS_BRANCH_MAX - 1) / BPLUS_BRANCH_MAX;
+        for (int p = 0, at = 0; p < parents; p++) {
+            int take = nodes / parents + (p < nodes % parents);
+            NodeHandle handle = bplus_alloc_branch(tree);
+            BPlusBranch *branch = bplus_branch(tree, handle);
+            memcpy(branch->low, &lows[at], take * sizeof(BPlusEntry));
+            memcpy(branch->children, &handles[at], take * sizeof(NodeHandle));
+            memcpy(branch->sizes, &sizes[at], take * sizeof(uint32_t));
+            branch->count = take;
+            handles[p] = handle;
+            lows[p] = lows[at];
+            sizes[p] = bplus_branch_total(branch);
+            at += take;
+        }
+        nodes = parents;
+        height++;
+    }
+    
+    tree->root = handles[0];
+    tree->height = height;
+    tree->size = count;
+    free(handles);
+    free(lows);
+    free(sizes);
+}
+
+/**
+ * Bytes held by the tree
+ * Time Complexity: O(1) per size class
+ */
+size_t bplus_tree_memory_usage(BPlusTree *tree) {
+    return sizeof(BPlusTree) + node_arena_bytes(&tree->arena);
+}
+
+/**
+ * Free tree
+ * Time Complexity: O(slabs)
+ */
+void bplus_tree_free(BPlusTree *tree) {
+    node_arena_destroy(&tree->arena);
+    free(tree);
+}
+
+#ifndef BPLUS_TREE_NO_MAIN
+#define BENCH_PAGE 50
+
+double bplus_bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Order (key, id) pairs for the re-sort baseline
+ */
+int bplus_bench_compare(const void *a, const void *b) {
+    const BPlusEntry *x = (const BPlusEntry *)a;
+    const BPlusEntry *y = (const BPlusEntry *)b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/**
+ * A visit on n bookmarks ordered by visit count (most first): update
+ * the one entry and read a page, against re-sorting every entry
+ */
+void bplus_bench(int n) {
+    printf("B+ tree benchmark: %d bookmarks by visit count\n", n);
+    
+    unsigned int *visits = (unsigned int *)malloc(n * sizeof(unsigned int));
+    BPlusEntry *entries = (BPlusEntry *)malloc(n * sizeof(BPlusEntry));
+    srand(11);
+    for (int id = 0; id < n; id++) {
+        visits[id] = (unsigned int)(rand() % 1000);
+        entries[id] = (BPlusEntry){ UINT64_MAX - visits[id], (uint32_t)id };
+    }
+    
+    BPlusTree *tree = bplus_tree_create(NULL, NULL);
+    double start = bplus_bench_seconds();
+    bplus_tree_sort(tree, entries, n);
+    bplus_tree_build(tree, entries, n);
+    printf("  Bulk build: %.1f ms, %.2f MB\n", (bplus_bench_seconds() - start) * 1e3,
+           bplus_tree_memory_usage(tree) / 1048576.0);
+    
+    uint32_t page[BENCH_PAGE];
+    int rounds = 100000;
+    start = bplus_bench_seconds();
+    for (int r = 0; r < rounds; r++) {
+        int id = rand() % n;
+        bplus_tree_remove(tree, UINT64_MAX - visits[id], (uint32_t)id);
+        visits[id]++;
+        bplus_tree_insert(tree, UINT64_MAX - visits[id], (uint32_t)id);
+    }
+    double update_us = (bplus_bench_seconds() - start) / rounds * 1e6;
+    
+    start = bplus_bench_seconds();
+    for (int r = 0; r < rounds; r++) {
+        bplus_tree_range(tree, rand() % n, BENCH_PAGE, page);
+    }
+    double page_us = (bplus_bench_seconds() - start) / rounds * 1e6;
+    
+    int sorts = 5;
+    start = bplus_bench_seconds();
+    for (int r = 0; r < sorts; r++) {
+        for (int id = 0; id < n; id++) entries[id] = (BPlusEntry){ UINT64_MAX - visits[id], (uint32_t)id };
+        qsort(entries, n, sizeof(BPlusEntry), bplus_bench_compare);
+    }
+    double sort_us = (bplus_bench_seconds() - start) / sorts * 1e6;
+    
+    int top = bplus_tree_range(tree, 0, BENCH_PAGE, page);
+    int same = top == BENCH_PAGE || top == n;
+    for (int i = 0; i < top; i++) same = same && page[i] == entries[i].id;
+    
+    printf("  Visit (remove + insert): %8.2f us\n", update_us);
+    printf("  Page of %d at a random offset: %8.2f us\n", BENCH_PAGE, page_us);
+    printf("  Re-sort per render: %8.0f us (%.0fx a visit + page)%s\n", sort_us,
+           sort_us / (update_us + page_us), same ? "" : "  MISMATCH");
+    
+    bplus_tree_free(tree);
+    free(entries);
+    free(visits);
+}
+
+/**
+ * Print a page of ids with their keys
+ */
+void bplus_print_page(BPlusTree *tree, const char *label, int offset, int limit, const unsigned int *visits) {
+    uint32_t ids[16];
+    int count = bplus_tree_range(tree, offset, limit, ids);
+    printf("   %-18s", label);
+    for (int i = 0; i < count; i++) printf(" %u(%u)", ids[i], visits[ids[i]]);
+    printf("\n");
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        bplus_bench(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    
+    printf("=== B+ Tree in C ===\n");
+    printf("Data Structure: Counted B+ tree, leaves of %d, inner nodes of %d\n\n",
+           BPLUS_LEAF_MAX, BPLUS_BRANCH_MAX);
+    
+    // Most visited first: key = UINT64_MAX - visits
+    unsigned int visits[1000];
+    BPlusTree *tree = bplus_tree_create(NULL, NULL);
+    
+    printf("1. Inserting 1000 bookmarks by visit count:\n");
+    for (uint32_t id = 0; id < 1000; id++) {
+        visits[id] = (id * 37) % 101;
+        bplus_tree_insert(tree, UINT64_MAX - visits[id], id);
+    }
+    printf("   Size %d, height %d, %zu bytes\n", bplus_tree_size(tree), tree->height,
+           bplus_tree_memory_usage(tree));
+    bplus_print_page(tree, "Top 5:", 0, 5, visits);
+    bplus_print_page(tree, "Items 200-204:", 200, 5, visits);
+    
+    printf("\n2. Visiting bookmark 42 fifty times (remove + insert each):\n");
+    for (int i = 0; i < 50; i++) {
+        bplus_tree_remove(tree, UINT64_MAX - visits[42], 42);
+        visits[42]++;
+        bplus_tree_insert(tree, UINT64_MAX - visits[42], 42);
+    }
+    printf("   Bookmark 42 now at position %d\n", bplus_tree_rank(tree, UINT64_MAX - visits[42], 42));
+    bplus_print_page(tree, "Top 5:", 0, 5, visits);
+    
+    printf("\n3. Deleting 900 bookmarks:\n");
+    for (uint32_t id = 100; id < 1000; id++) {
+        bplus_tree_remove(tree, UINT64_MAX - visits[id], id);
+    }
+    printf("   Size %d, height %d\n", bplus_tree_size(tree), tree->height);
+    bplus_print_page(tree, "Last 5:", bplus_tree_size(tree) - 5, 5, visits);
+    
+    printf("\n4. Bulk build from sorted entries:\n");
+    BPlusEntry entries[1000];
+    for (uint32_t id = 0; id < 1000; id++) entries[id] = (BPlusEntry){ UINT64_MAX - visits[id], id };
+    BPlusTree *built = bplus_tree_create(NULL, NULL);
+    bplus_tree_sort(built, entries, 1000);
+    bplus_tree_build(built, entries, 1000);
+    printf("   Size %d, height %d\n", bplus_tree_size(built), built->height);
+    bplus_print_page(built, "Top 5:", 0, 5, visits);
+    
+    bplus_tree_free(tree);
+    bplus_tree_free(built);
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
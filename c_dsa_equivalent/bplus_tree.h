@@ -0,0 +1,84 @@
+/**
+ * B+ Tree Interface
+ * Ordered index of (key, id) entries with subtree counts, shared by
+ * bplus_tree.c and the modules built on it
+ * (see bplus_tree.c for implementation notes)
+ */
+
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "node_arena.h"
+
+#define BPLUS_LEAF_MAX 64            // entries per leaf
+#define BPLUS_BRANCH_MAX 32          // children per inner node
+#define BPLUS_MAX_HEIGHT 16
+
+/**
+ * One indexed entry; entries order by key, then the tie-break, then id
+ */
+typedef struct {
+    uint64_t key;
+    uint32_t id;
+} BPlusEntry;
+
+/**
+ * Orders two ids whose keys are equal (<0, 0, >0)
+ * Lets a fixed-width key stand for a longer one, e.g. the first bytes of
+ * a title, with the full comparison only on ties.
+ */
+typedef int (*BPlusTieBreak)(uint32_t a, uint32_t b, void *context);
+
+/**
+ * Leaf: sorted entries, chained left to right for range scans
+ */
+typedef struct {
+    uint64_t keys[BPLUS_LEAF_MAX];
+    uint32_t ids[BPLUS_LEAF_MAX];
+    int count;
+    NodeHandle prev;
+    NodeHandle next;
+} BPlusLeaf;
+
+/**
+ * Inner node: low[i] is the smallest entry under child i (low[0] is not
+ * used) and sizes[i] how many there are, so positions can be found
+ * without visiting leaves
+ */
+typedef struct {
+    BPlusEntry low[BPLUS_BRANCH_MAX];
+    NodeHandle children[BPLUS_BRANCH_MAX];
+    uint32_t sizes[BPLUS_BRANCH_MAX];
+    int count;
+} BPlusBranch;
+
+/**
+ * B+ Tree structure
+ */
+typedef struct {
+    NodeArena arena;             // leaves and inner nodes
+    NodeHandle root;
+    int height;                  // inner levels above the leaves
+    int size;                    // entries
+    BPlusTieBreak tie_break;     // NULL: equal keys order by id
+    void *context;               // passed to tie_break
+} BPlusTree;
+
+BPlusTree *bplus_tree_create(BPlusTieBreak tie_break, void *context);
+int bplus_tree_compare(const BPlusTree *tree, const BPlusEntry *a, const BPlusEntry *b);
+int bplus_tree_insert(BPlusTree *tree, uint64_t key, uint32_t id);
+int bplus_tree_remove(BPlusTree *tree, uint64_t key, uint32_t id);
+int bplus_tree_rank(BPlusTree *tree, uint64_t key, uint32_t id);
+int bplus_tree_range(BPlusTree *tree, int offset, int limit, uint32_t *ids_out);
+int bplus_tree_size(const BPlusTree *tree);
+void bplus_tree_sort(const BPlusTree *tree, BPlusEntry *entries, int count);
+void bplus_tree_build(BPlusTree *tree, const BPlusEntry *sorted, int count);
+size_t bplus_tree_memory_usage(BPlusTree *tree);
+void bplus_tree_free(BPlusTree *tree);
+
+#endif
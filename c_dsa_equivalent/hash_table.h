@@ -0,0 +1,139 @@
+/**
+ * Hash Table Interface
+ * Types and functions shared by hash_table.c and the modules built on it
+ * (see hash_table.c for implementation notes)
+ */
+
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GROUP_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GROUP_WIDTH 16
+#else
+#define GROUP_WIDTH 16
+#endif
+
+#define KEY_SIZE 256
+#define VALUE_SIZE 256
+
+#define MAX_LOAD_FACTOR 0.75      // (live + tombstones) / size before rehash
+#define MAX_TOMBSTONE_RATIO 0.25  // tombstones / size before compaction
+#define REHASH_STEP 4             // old slots migrated per operation
+
+#define CTRL_EMPTY 0x80           // never-used slot (high bit set)
+#define CTRL_DELETED 0xFE         // tombstone (high bit set)
+#define ARENA_BYTES_PER_SLOT 32   // initial arena capacity per table slot
+#define ARENA_NO_OFFSET SIZE_MAX  // string_arena_append could not grow the arena
+
+/**
+ * String arena owning all key and value bytes
+ * Strings are appended NUL-terminated; deleted strings are only counted
+ * as garbage and reclaimed when the table is rebuilt.
+ */
+typedef struct {
+    char *bytes;
+    size_t used;
+    size_t capacity;
+    size_t garbage;  // bytes no longer referenced by any entry
+} StringArena;
+
+/**
+ * Entry structure for hash table
+ * Only read once the slot's control tag matches
+ */
+typedef struct {
+    size_t key_offset;  // arenas may pass 2 GiB (10M urls)
+    size_t value_offset;
+    unsigned int hash;  // kept so rehashing never touches key bytes
+    int key_len;
+    int value_len;
+} HashEntry;
+
+/**
+ * One generation of slots with its own string arena
+ * size is always a multiple of GROUP_WIDTH.
+ */
+typedef struct {
+    unsigned char *ctrl;   // control tags: 7 hash bits, CTRL_EMPTY or CTRL_DELETED
+    HashEntry *entries;    // parallel to ctrl
+    int size;
+    StringArena arena;
+} HashBuckets;
+
+/**
+ * Hash function over key bytes, returning 64 bits
+ */
+typedef unsigned long long (*HashFunction)(const char *key, int len);
+
+/**
+ * Releases memory a table drops (drained generations, outgrown arenas).
+ * NULL means free; concurrent wrappers pass their own to defer frees
+ * until no reader can still be looking at the memory.
+ */
+typedef void (*HashRelease)(void *ptr, void *context);
+
+/**
+ * Hash Table structure
+ *
+ * While a rehash is in progress, entries live in both old_table and
+ * table. Lookups check table first, then the not yet migrated part of
+ * old_table.
+ */
+typedef struct {
+    HashBuckets table;
+    HashBuckets old_table;  // being drained, ctrl == NULL when not rehashing
+    int count;          // live entries across both tables
+    int tombstones;     // deleted slots in table
+    int old_count;      // live entries still in old_table
+    int rehash_index;   // next old_table slot to migrate
+    HashFunction hash_fn;
+    HashRelease release;    // NULL: free
+    void *release_context;
+} HashTable;
+
+/**
+ * Selectable hash family
+ */
+typedef struct {
+    const char *name;
+    HashFunction fn;
+} HashFunctionInfo;
+
+// Hash family
+unsigned long long hash_sum31(const char *key, int len);
+unsigned long long hash_fnv1a(const char *key, int len);
+unsigned long long hash_murmur64(const char *key, int len);
+unsigned long long hash_wy(const char *key, int len);
+HashFunction hash_function_by_name(const char *name);
+unsigned int hash_table_hash(HashTable *ht, const char *key, int len);
+
+// Group probing helpers
+unsigned char hash_tag(unsigned int hash);
+int hash_home_group(unsigned int hash, int size);
+unsigned int group_match(const unsigned char *group, unsigned char tag);
+unsigned int group_match_free(const unsigned char *group);
+
+// Table operations
+HashTable *hash_table_create(int initial_size);
+HashTable *hash_table_create_with(int initial_size, HashFunction hash_fn, HashRelease release,
+                                  void *release_context);
+void hash_table_insert(HashTable *ht, const char *key, const char *value);
+char *hash_table_get(HashTable *ht, const char *key);
+int hash_table_delete(HashTable *ht, const char *key);
+int hash_table_find_slot(HashBuckets *buckets, const char *key, int key_len, unsigned int hash);
+void hash_table_rehash_finish(HashTable *ht);
+void hash_table_compact(HashTable *ht);
+void hash_table_print(HashTable *ht);
+long hash_table_memory_usage(HashTable *ht);
+void hash_table_free(HashTable *ht);
+
+#endif
@@ -1,14 +1,29 @@
 /**
- * BookmarkHub - Singly Linked List Implementation in C
- * Sequential data structure with dynamic allocation for bookmarks
+ * BookmarkHub - Doubly Linked List Implementation in C
+ * Recency (LRU) list with dynamic allocation for bookmarks
  * 
- * Compile: gcc -o linked_list linked_list.c
+ * Nodes are slots in a NodeArena (node_arena.c) linked both ways by
+ * 32-bit handles; clearing the list drops every node at once instead of
+ * freeing each.
+ * 
+ * Each value is unique in the list and indexed by an open-addressing
+ * hash map (value -> node handle). With prev links and the index,
+ * search, delete, move-to-front and evicting the oldest entry are all
+ * O(1) instead of a walk.
+ * 
+ * Compile: gcc -o linked_list linked_list.c node_arena.c
  * Run: ./linked_list
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+
+#include "node_arena.h"
+
+#define LIST_INDEX_INITIAL_SIZE 16   // slots; always a power of two
+#define LIST_INDEX_MAX_LOAD 0.75
 
 /**
  * Node structure for linked list
@@ -17,25 +32,132 @@ typedef struct Node {
     int value;
     char website_name[256];
     char data[256];
-    struct Node *next;
+    NodeHandle prev;
+    NodeHandle next;
 } Node;
 
+/**
+ * Index slot: value -> node, empty when handle is NODE_NULL
+ */
+typedef struct {
+    int value;
+    NodeHandle handle;
+} ListIndexSlot;
+
 /**
  * Linked List structure
  */
 typedef struct {
-    Node *head;
-    Node *tail;
+    NodeArena arena;
+    NodeHandle head;
+    NodeHandle tail;
     int size;
     int max_size;
+    ListIndexSlot *index;   // linear probing, no tombstones
+    int index_size;
 } LinkedList;
 
+#define LIST_NODE(list, handle) ((Node *)node_arena_get(&(list)->arena, (handle)))
+
+int linked_list_remove_end(LinkedList *list);
+
+/**
+ * Home slot of value (Fibonacci hashing)
+ * Time Complexity: O(1)
+ */
+int list_index_home(LinkedList *list, int value) {
+    return (int)(((uint32_t)value * 2654435769u) & (uint32_t)(list->index_size - 1));
+}
+
+/**
+ * Allocate an empty index with size slots
+ */
+void list_index_init(LinkedList *list, int size) {
+    list->index = (ListIndexSlot *)calloc(size, sizeof(ListIndexSlot));
+    list->index_size = size;
+}
+
+/**
+ * Slot holding value, or the empty slot where it would go
+ * Time Complexity: O(1) average
+ */
+int list_index_find(LinkedList *list, int value) {
+    int mask = list->index_size - 1;
+    int slot = list_index_home(list, value);
+    
+    while (list->index[slot].handle != NODE_NULL && list->index[slot].value != value) {
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+/**
+ * Node holding value, or NODE_NULL
+ * Time Complexity: O(1) average
+ */
+NodeHandle list_index_get(LinkedList *list, int value) {
+    return list->index[list_index_find(list, value)].handle;
+}
+
+/**
+ * Map value to handle (value must not be present)
+ * Doubles the index when it passes the load limit.
+ * Time Complexity: O(1) amortized
+ */
+void list_index_put(LinkedList *list, int value, NodeHandle handle) {
+    if (list->size + 1 > list->index_size * LIST_INDEX_MAX_LOAD) {
+        ListIndexSlot *old = list->index;
+        int old_size = list->index_size;
+        
+        list_index_init(list, old_size * 2);
+        for (int i = 0; i < old_size; i++) {
+            if (old[i].handle != NODE_NULL) {
+                list->index[list_index_find(list, old[i].value)] = old[i];
+            }
+        }
+        free(old);
+    }
+    
+    int slot = list_index_find(list, value);
+    list->index[slot].value = value;
+    list->index[slot].handle = handle;
+}
+
+/**
+ * Unmap value
+ * Later entries of the probe run are shifted back into the gap, so no
+ * tombstones are left behind.
+ * Time Complexity: O(1) average
+ */
+void list_index_remove(LinkedList *list, int value) {
+    int mask = list->index_size - 1;
+    int hole = list_index_find(list, value);
+    if (list->index[hole].handle == NODE_NULL) return;
+    
+    int slot = hole;
+    while (1) {
+        slot = (slot + 1) & mask;
+        if (list->index[slot].handle == NODE_NULL) break;
+        
+        // Move the entry back unless its home lies in (hole, slot]
+        int home = list_index_home(list, list->index[slot].value);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            list->index[hole] = list->index[slot];
+            hole = slot;
+        }
+    }
+    
+    list->index[hole].handle = NODE_NULL;
+}
+
 /**
  * Create new node
  * Time Complexity: O(1)
  */
-Node *node_create(int value, const char *website_name, const char *data) {
-    Node *node = (Node *)malloc(sizeof(Node));
+NodeHandle node_create(LinkedList *list, int value, const char *website_name, const char *data) {
+    NodeHandle handle = node_arena_alloc(&list->arena, sizeof(Node));
+    Node *node = LIST_NODE(list, handle);
     node->value = value;
     
     if (website_name) {
@@ -50,8 +172,9 @@ Node *node_create(int value, const char *website_name, const char *data) {
         node->data[0] = '\0';
     }
     
-    node->next = NULL;
-    return node;
+    node->prev = NODE_NULL;
+    node->next = NODE_NULL;
+    return handle;
 }
 
 /**
@@ -60,28 +183,82 @@ Node *node_create(int value, const char *website_name, const char *data) {
  */
 LinkedList *linked_list_create(int max_size) {
     LinkedList *list = (LinkedList *)malloc(sizeof(LinkedList));
-    list->head = NULL;
-    list->tail = NULL;
+    node_arena_init_fixed(&list->arena, sizeof(Node));
+    list->head = NODE_NULL;
+    list->tail = NODE_NULL;
     list->size = 0;
     list->max_size = max_size;
+    list_index_init(list, LIST_INDEX_INITIAL_SIZE);
     return list;
 }
 
 /**
- * Insert node at beginning (front)
+ * Detach node from its neighbours (stays allocated and indexed)
  * Time Complexity: O(1)
  */
-void linked_list_insert_front(LinkedList *list, int value, const char *website_name, const char *data) {
-    Node *new_node = node_create(value, website_name, data);
+void linked_list_unlink(LinkedList *list, NodeHandle handle) {
+    Node *node = LIST_NODE(list, handle);
     
-    if (list->head == NULL) {
-        list->head = new_node;
-        list->tail = new_node;
+    if (node->prev != NODE_NULL) {
+        LIST_NODE(list, node->prev)->next = node->next;
     } else {
-        new_node->next = list->head;
-        list->head = new_node;
+        list->head = node->next;
+    }
+    
+    if (node->next != NODE_NULL) {
+        LIST_NODE(list, node->next)->prev = node->prev;
+    } else {
+        list->tail = node->prev;
     }
     
+    node->prev = NODE_NULL;
+    node->next = NODE_NULL;
+}
+
+/**
+ * Attach a detached node before the head
+ * Time Complexity: O(1)
+ */
+void linked_list_link_front(LinkedList *list, NodeHandle handle) {
+    LIST_NODE(list, handle)->next = list->head;
+    
+    if (list->head == NODE_NULL) {
+        list->tail = handle;
+    } else {
+        LIST_NODE(list, list->head)->prev = handle;
+    }
+    
+    list->head = handle;
+}
+
+/**
+ * Unlink, unindex and free a node, returning its value
+ * Time Complexity: O(1)
+ */
+int linked_list_remove_node(LinkedList *list, NodeHandle handle) {
+    int value = LIST_NODE(list, handle)->value;
+    
+    linked_list_unlink(list, handle);
+    list_index_remove(list, value);
+    node_arena_free(&list->arena, handle);
+    list->size--;
+    
+    return value;
+}
+
+int linked_list_delete(LinkedList *list, int value);
+
+/**
+ * Insert node at beginning (front)
+ * A value already in the list is replaced, so it is only ever listed once.
+ * Time Complexity: O(1)
+ */
+void linked_list_insert_front(LinkedList *list, int value, const char *website_name, const char *data) {
+    linked_list_delete(list, value);
+    
+    NodeHandle new_node = node_create(list, value, website_name, data);
+    linked_list_link_front(list, new_node);
+    list_index_put(list, value, new_node);
     list->size++;
     
     // Remove oldest if exceeds max size
@@ -92,51 +269,52 @@ void linked_list_insert_front(LinkedList *list, int value, const char *website_n
 
 /**
  * Insert node at end
+ * A value already in the list is replaced, so it is only ever listed once.
  * Time Complexity: O(1)
  */
 void linked_list_insert_end(LinkedList *list, int value, const char *website_name, const char *data) {
-    Node *new_node = node_create(value, website_name, data);
+    linked_list_delete(list, value);
     
-    if (list->head == NULL) {
+    NodeHandle new_node = node_create(list, value, website_name, data);
+    
+    if (list->head == NODE_NULL) {
         list->head = new_node;
         list->tail = new_node;
     } else {
-        list->tail->next = new_node;
+        LIST_NODE(list, new_node)->prev = list->tail;
+        LIST_NODE(list, list->tail)->next = new_node;
         list->tail = new_node;
     }
     
+    list_index_put(list, value, new_node);
     list->size++;
 }
 
 /**
- * Remove node from end
- * Time Complexity: O(n) for singly linked list
+ * Move value to the front (mark as most recently used)
+ * Returns 0 if value is not in the list
+ * Time Complexity: O(1)
  */
-int linked_list_remove_end(LinkedList *list) {
-    if (list->head == NULL) return 0;
-    
-    if (list->head == list->tail) {
-        int value = list->head->value;
-        free(list->head);
-        list->head = NULL;
-        list->tail = NULL;
-        list->size--;
-        return value;
-    }
+int linked_list_move_to_front(LinkedList *list, int value) {
+    NodeHandle handle = list_index_get(list, value);
+    if (handle == NODE_NULL) return 0;
     
-    // Find second-to-last node
-    Node *current = list->head;
-    while (current->next != list->tail) {
-        current = current->next;
+    if (handle != list->head) {
+        linked_list_unlink(list, handle);
+        linked_list_link_front(list, handle);
     }
     
-    int value = list->tail->value;
-    free(list->tail);
-    current->next = NULL;
-    list->tail = current;
-    list->size--;
+    return 1;
+}
+
+/**
+ * Remove node from end (least recently used)
+ * Time Complexity: O(1)
+ */
+int linked_list_remove_end(LinkedList *list) {
+    if (list->tail == NODE_NULL) return 0;
     
-    return value;
+    return linked_list_remove_node(list, list->tail);
 }
 
 /**
@@ -144,72 +322,29 @@ int linked_list_remove_end(LinkedList *list) {
  * Time Complexity: O(1)
  */
 int linked_list_remove_front(LinkedList *list) {
-    if (list->head == NULL) return -1;
-    
-    Node *temp = list->head;
-    int value = temp->value;
-    list->head = temp->next;
-    
-    if (list->head == NULL) {
-        list->tail = NULL;
-    }
+    if (list->head == NODE_NULL) return -1;
     
-    free(temp);
-    list->size--;
-    
-    return value;
+    return linked_list_remove_node(list, list->head);
 }
 
 /**
  * Search for value in list
- * Time Complexity: O(n)
+ * Time Complexity: O(1) average
  */
 int linked_list_search(LinkedList *list, int value) {
-    Node *current = list->head;
-    
-    while (current != NULL) {
-        if (current->value == value) {
-            return 1;  // Found
-        }
-        current = current->next;
-    }
-    
-    return 0;  // Not found
+    return list_index_get(list, value) != NODE_NULL;
 }
 
 /**
  * Delete specific value from list
- * Time Complexity: O(n)
+ * Time Complexity: O(1) average
  */
 int linked_list_delete(LinkedList *list, int value) {
-    if (list->head == NULL) return 0;
-    
-    // If head needs to be deleted
-    if (list->head->value == value) {
-        return linked_list_remove_front(list) != -1;
-    }
-    
-    Node *current = list->head;
-    Node *prev = NULL;
+    NodeHandle handle = list_index_get(list, value);
+    if (handle == NODE_NULL) return 0;
     
-    while (current != NULL) {
-        if (current->value == value) {
-            prev->next = current->next;
-            
-            if (current == list->tail) {
-                list->tail = prev;
-            }
-            
-            free(current);
-            list->size--;
-            return 1;
-        }
-        
-        prev = current;
-        current = current->next;
-    }
-    
-    return 0;
+    linked_list_remove_node(list, handle);
+    return 1;
 }
 
 /**
@@ -219,9 +354,9 @@ int linked_list_delete(LinkedList *list, int value) {
 int linked_list_get_at(LinkedList *list, int position, char *data_out) {
     if (position < 0 || position >= list->size) return -1;
     
-    Node *current = list->head;
+    Node *current = LIST_NODE(list, list->head);
     for (int i = 0; i < position; i++) {
-        current = current->next;
+        current = LIST_NODE(list, current->next);
     }
     
     if (data_out && current->data[0] != '\0') {
@@ -233,19 +368,17 @@ int linked_list_get_at(LinkedList *list, int position, char *data_out) {
 
 /**
  * Clear entire list
- * Time Complexity: O(n)
+ * Drops all nodes at once; their slabs are kept for reuse. The index
+ * goes back to its initial size.
+ * Time Complexity: O(1)
  */
 void linked_list_clear(LinkedList *list) {
-    Node *current = list->head;
+    node_arena_reset(&list->arena);
+    free(list->index);
+    list_index_init(list, LIST_INDEX_INITIAL_SIZE);
     
-    while (current != NULL) {
-        Node *temp = current;
-        current = current->next;
-        free(temp);
-    }
-    
-    list->head = NULL;
-    list->tail = NULL;
+    list->head = NODE_NULL;
+    list->tail = NODE_NULL;
     list->size = 0;
 }
 
@@ -256,15 +389,16 @@ void linked_list_clear(LinkedList *list) {
 void linked_list_print(LinkedList *list) {
     printf("\n=== BookmarkHub - Linked List Contents ===\n");
     
-    if (list->head == NULL) {
+    if (list->head == NODE_NULL) {
         printf("List is empty\n\n");
         return;
     }
     
-    Node *current = list->head;
+    NodeHandle handle = list->head;
     int position = 0;
     
-    while (current != NULL) {
+    while (handle != NODE_NULL) {
+        Node *current = LIST_NODE(list, handle);
         printf("[%d] Value: %d", position, current->value);
         if (current->website_name[0] != '\0') {
             printf(" | Website: %s", current->website_name);
@@ -272,9 +406,9 @@ void linked_list_print(LinkedList *list) {
         if (current->data[0] != '\0') {
             printf(" | Data: %s", current->data);
         }
-        printf(" %s\n", (current == list->head) ? " ← HEAD" : (current == list->tail) ? " ← TAIL" : "");
+        printf(" %s\n", (handle == list->head) ? " ← HEAD" : (handle == list->tail) ? " ← TAIL" : "");
         
-        current = current->next;
+        handle = current->next;
         position++;
     }
     
@@ -284,10 +418,11 @@ void linked_list_print(LinkedList *list) {
 
 /**
  * Free linked list memory
- * Time Complexity: O(n)
+ * Time Complexity: O(s) where s = number of arena slabs
  */
 void linked_list_free(LinkedList *list) {
-    linked_list_clear(list);
+    node_arena_destroy(&list->arena);
+    free(list->index);
     free(list);
 }
 
@@ -295,9 +430,9 @@ void linked_list_free(LinkedList *list) {
  * Demonstration program
  */
 int main() {
-    printf("=== BookmarkHub - Singly Linked List Implementation in C ===\n");
-    printf("Data Structure: Linked List for bookmark storage\n");
-    printf("Operations: Insert O(1), Search O(n), Delete O(n)\n\n");
+    printf("=== BookmarkHub - Doubly Linked List Implementation in C ===\n");
+    printf("Data Structure: Linked List + hash index for recent bookmarks\n");
+    printf("Operations: Insert O(1), Search O(1), Delete O(1), Move to Front O(1)\n\n");
     
     LinkedList *list = linked_list_create(20);
     
@@ -342,8 +477,16 @@ int main() {
     value = linked_list_get_at(list, 2, data_buffer);
     printf("Position 2: Value=%d, Data=%s\n", value, data_buffer);
     
+    // Revisit an existing bookmark
+    printf("\n--- Moving bookmark 30 to front (visited again) ---\n");
+    if (linked_list_move_to_front(list, 30)) {
+        printf("✓ Moved value 30 to front\n");
+    }
+    
+    linked_list_print(list);
+    
     // Delete
-    printf("\n--- Deleting bookmark ---\n");
+    printf("--- Deleting bookmark ---\n");
     if (linked_list_delete(list, 20)) {
         printf("✓ Deleted bookmark with value 20\n");
     }
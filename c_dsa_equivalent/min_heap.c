@@ -1,195 +1,398 @@
 /**
  * Min Heap Implementation in C
- * Complete binary tree where parent <= children
+ * Complete d-ary tree where parent <= children
  * 
- * Compile: gcc -o min_heap min_heap.c -lm
+ * Hot/cold split: the heap array holds only 8-byte (value, id) entries,
+ * so sifting compares and moves keys without touching item records.
+ * Labels are cold data, stored per id in a NodeArena (node_arena.c)
+ * and only read when an item is handed out.
+ * 
+ * Each node has 2^k children (4 by default). The children of a node are
+ * adjacent in the array and fit in one cache line, and the tree is half
+ * as tall as a binary heap.
+ * 
+ * Indexed (addressable) heap: every item carries a caller-chosen id and
+ * a position map tracks which slot each id occupies, so an item's key
+ * can be changed or the item removed by id in O(log n).
+ * 
+ * Compile: gcc -O2 -o min_heap min_heap.c node_arena.c -lm
  * Run: ./min_heap
+ *      ./min_heap --bench [n]   (compare layouts on n items)
+ * Define MIN_HEAP_NO_MAIN to link into another program.
  */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 #include <math.h>
+#include <time.h>
 
-#define MAX_HEAP_SIZE 100
+#include "min_heap.h"
 
-/**
- * Item in heap (with value and label)
- */
-typedef struct {
-    int value;
-    char label[256];
-} HeapItem;
+#define INITIAL_HEAP_CAPACITY 8
 
 /**
- * Min Heap structure
+ * Label slot sizes (bytes including the terminator)
  */
-typedef struct {
-    HeapItem *items;
-    int size;
-    int capacity;
-} MinHeap;
+static const unsigned int HEAP_LABEL_CLASSES[] = { 16, 32, 64, 128, HEAP_LABEL_SIZE };
 
 /**
  * Helper function: get parent index
  */
-int get_parent(int index) {
-    return (index - 1) / 2;
+int get_parent(MinHeap *heap, int index) {
+    return (index - 1) >> heap->arity_shift;
 }
 
 /**
- * Helper function: get left child index
+ * Helper function: get first child index (siblings follow it)
  */
-int get_left_child(int index) {
-    return 2 * index + 1;
+int get_first_child(MinHeap *heap, int index) {
+    return (index << heap->arity_shift) + 1;
 }
 
 /**
- * Helper function: get right child index
+ * Store entry at index and record its position
  */
-int get_right_child(int index) {
-    return 2 * index + 2;
+void place_entry(MinHeap *heap, int index, HeapEntry entry) {
+    heap->entries[index] = entry;
+    heap->positions[entry.id] = index;
 }
 
 /**
- * Swap two elements in heap
+ * Slot currently holding id, or -1 if id is not in the heap
+ * Time Complexity: O(1)
  */
-void swap_items(HeapItem *a, HeapItem *b) {
-    HeapItem temp = *a;
-    *a = *b;
-    *b = temp;
+int min_heap_position(MinHeap *heap, int id) {
+    if (id < 0 || id >= heap->id_capacity) return -1;
+    return heap->positions[id];
 }
 
 /**
- * Create new min heap
- * Time Complexity: O(1)
+ * Create new min heap with the given number of children per node
+ * capacity is only the initial size; the heap doubles when full.
+ * arity is rounded up to a power of two (at least 2)
+ * Time Complexity: O(capacity)
  */
-MinHeap *min_heap_create(int capacity) {
+MinHeap *min_heap_create_with(int capacity, int arity) {
+    if (capacity < 1) capacity = 1;
+    
     MinHeap *heap = (MinHeap *)malloc(sizeof(MinHeap));
-    heap->items = (HeapItem *)malloc(capacity * sizeof(HeapItem));
+    heap->entries = (HeapEntry *)malloc(capacity * sizeof(HeapEntry));
     heap->size = 0;
     heap->capacity = capacity;
+    
+    heap->arity_shift = 1;
+    while ((1 << heap->arity_shift) < arity) {
+        heap->arity_shift++;
+    }
+    
+    heap->id_capacity = capacity;
+    heap->positions = (int *)malloc(capacity * sizeof(int));
+    memset(heap->positions, -1, capacity * sizeof(int));
+    heap->labels = (NodeHandle *)calloc(capacity, sizeof(NodeHandle));
+    node_arena_init(&heap->label_arena, HEAP_LABEL_CLASSES,
+                    sizeof(HEAP_LABEL_CLASSES) / sizeof(HEAP_LABEL_CLASSES[0]));
     return heap;
 }
 
+/**
+ * Create new min heap (grows past capacity as needed)
+ * Time Complexity: O(capacity)
+ */
+MinHeap *min_heap_create(int capacity) {
+    return min_heap_create_with(capacity, HEAP_DEFAULT_ARITY);
+}
+
 /**
  * Move element up to maintain min heap property
- * Time Complexity: O(log n)
+ * Parents slide down into the hole; the entry is written once at the end.
+ * Time Complexity: O(log_d n)
  */
 void heapify_up(MinHeap *heap, int index) {
+    HeapEntry entry = heap->entries[index];
+    
     while (index > 0) {
-        int parent_index = get_parent(index);
+        int parent_index = get_parent(heap, index);
         
-        if (heap->items[parent_index].value > heap->items[index].value) {
-            swap_items(&heap->items[parent_index], &heap->items[index]);
-            index = parent_index;
-        } else {
-            break;
-        }
+        if (heap->entries[parent_index].value <= entry.value) break;
+        
+        place_entry(heap, index, heap->entries[parent_index]);
+        index = parent_index;
     }
+    
+    place_entry(heap, index, entry);
 }
 
 /**
  * Move element down to maintain min heap property
- * Time Complexity: O(log n)
+ * Time Complexity: O(d log_d n)
  */
 void heapify_down(MinHeap *heap, int index) {
+    HeapEntry entry = heap->entries[index];
+    int arity = 1 << heap->arity_shift;
+    
     while (1) {
-        int min_index = index;
-        int left_child = get_left_child(index);
-        int right_child = get_right_child(index);
+        int first_child = get_first_child(heap, index);
+        if (first_child >= heap->size) break;
         
-        // Check left child
-        if (left_child < heap->size && 
-            heap->items[left_child].value < heap->items[min_index].value) {
-            min_index = left_child;
-        }
+        // Smallest of the (up to d) adjacent children
+        int last_child = first_child + arity;
+        if (last_child > heap->size) last_child = heap->size;
         
-        // Check right child
-        if (right_child < heap->size && 
-            heap->items[right_child].value < heap->items[min_index].value) {
-            min_index = right_child;
+        int min_index = first_child;
+        for (int child = first_child + 1; child < last_child; child++) {
+            if (heap->entries[child].value < heap->entries[min_index].value) {
+                min_index = child;
+            }
         }
         
-        // If min is not current, swap and continue
-        if (min_index != index) {
-            swap_items(&heap->items[index], &heap->items[min_index]);
-            index = min_index;
-        } else {
-            break;
-        }
+        if (heap->entries[min_index].value >= entry.value) break;
+        
+        place_entry(heap, index, heap->entries[min_index]);
+        index = min_index;
     }
+    
+    place_entry(heap, index, entry);
 }
 
 /**
- * Insert element into min heap
- * Time Complexity: O(log n)
+ * Append an entry without restoring heap order
+ * Grows the entry array and id maps as needed and stores the label.
+ * Returns 0 if id is negative or already in the heap
+ * Time Complexity: O(1) amortized
  */
-int min_heap_insert(MinHeap *heap, int value, const char *label) {
+int min_heap_append(MinHeap *heap, int id, int value, const char *label) {
+    if (id < 0 || min_heap_position(heap, id) != -1) return 0;
+    
+    // Double the entry array when full
     if (heap->size >= heap->capacity) {
-        printf("Heap is full!\n");
-        return 0;
+        heap->capacity *= 2;
+        heap->entries = (HeapEntry *)realloc(heap->entries, heap->capacity * sizeof(HeapEntry));
     }
     
-    // Add new element at end
-    heap->items[heap->size].value = value;
+    // Grow the id maps to cover id
+    if (id >= heap->id_capacity) {
+        int new_capacity = heap->id_capacity * 2;
+        if (new_capacity <= id) new_capacity = id + 1;
+        heap->positions = (int *)realloc(heap->positions, new_capacity * sizeof(int));
+        heap->labels = (NodeHandle *)realloc(heap->labels, new_capacity * sizeof(NodeHandle));
+        memset(heap->positions + heap->id_capacity, -1,
+               (new_capacity - heap->id_capacity) * sizeof(int));
+        memset(heap->labels + heap->id_capacity, 0,
+               (new_capacity - heap->id_capacity) * sizeof(NodeHandle));
+        heap->id_capacity = new_capacity;
+    }
+    
+    // Cold part: label in the smallest slot that holds it (none if NULL)
+    heap->labels[id] = NODE_NULL;
     if (label) {
-        strncpy(heap->items[heap->size].label, label, 255);
+        size_t label_len = strlen(label);
+        if (label_len > HEAP_LABEL_SIZE - 1) label_len = HEAP_LABEL_SIZE - 1;
+        heap->labels[id] = node_arena_alloc(&heap->label_arena, label_len + 1);
+        memcpy(node_arena_get(&heap->label_arena, heap->labels[id]), label, label_len);
     }
     
-    // Move up to maintain heap property
-    heapify_up(heap, heap->size);
+    // Hot part: add at end
+    place_entry(heap, heap->size, (HeapEntry){ value, id });
     heap->size++;
     
     return 1;
 }
 
+/**
+ * Insert element into min heap
+ * id must be non-negative and not already in the heap
+ * Time Complexity: O(log_d n) (amortized when the heap grows)
+ */
+int min_heap_insert(MinHeap *heap, int id, int value, const char *label) {
+    if (!min_heap_append(heap, id, value, label)) return 0;
+    
+    // Move new element up to maintain heap property
+    heapify_up(heap, heap->size - 1);
+    return 1;
+}
+
+/**
+ * Build heap from n items at once (bottom-up heapify)
+ * Items with a negative or repeated id are skipped.
+ * Sifting down from the last parent back to the root costs O(n) in
+ * total, against O(n log n) for n separate inserts.
+ * Time Complexity: O(n)
+ */
+MinHeap *min_heap_build(const HeapItem *items, int n) {
+    MinHeap *heap = min_heap_create(n);
+    
+    for (int i = 0; i < n; i++) {
+        min_heap_append(heap, items[i].id, items[i].value, items[i].label);
+    }
+    
+    min_heap_heapify(heap);
+    return heap;
+}
+
+/**
+ * Restore heap order over the whole array (bottom-up)
+ * Pairs with min_heap_append for bulk loads into an existing heap.
+ * Time Complexity: O(n)
+ */
+void min_heap_heapify(MinHeap *heap) {
+    int last_parent = heap->size > 1 ? get_parent(heap, heap->size - 1) : -1;
+    for (int i = last_parent; i >= 0; i--) {
+        heapify_down(heap, i);
+    }
+}
+
+/**
+ * Heapify the subtree rooted at root (bottom-up, level by level)
+ * Subtrees with different roots on one level share no entries, so
+ * separate threads may heapify them at once; min_heap_heapify_above
+ * then finishes the levels over them.
+ * Time Complexity: O(s) where s = subtree size
+ */
+void min_heap_heapify_subtree(MinHeap *heap, int root) {
+    int first[32], last[32];
+    int levels = 0;
+    
+    // Index range of the subtree on each level
+    for (long lo = root, hi = root; lo < heap->size && levels < 32; levels++) {
+        first[levels] = (int)lo;
+        last[levels] = hi < heap->size ? (int)hi : heap->size - 1;
+        lo = ((long)lo << heap->arity_shift) + 1;
+        hi = ((long)hi << heap->arity_shift) + (1 << heap->arity_shift);
+    }
+    
+    for (int level = levels - 2; level >= 0; level--) {
+        for (int i = last[level]; i >= first[level]; i--) {
+            heapify_down(heap, i);
+        }
+    }
+}
+
+/**
+ * Sift down every entry before index, last first
+ * Completes a heapify once every subtree rooted at or after index is a heap.
+ * Time Complexity: O(index + log n)
+ */
+void min_heap_heapify_above(MinHeap *heap, int index) {
+    if (index > heap->size) index = heap->size;
+    for (int i = index - 1; i >= 0; i--) {
+        heapify_down(heap, i);
+    }
+}
+
+/**
+ * Label of item id (read from the cold store), "" if it has none
+ * Time Complexity: O(1)
+ */
+const char *min_heap_label(MinHeap *heap, int id) {
+    if (heap->labels[id] == NODE_NULL) return "";
+    return (const char *)node_arena_get(&heap->label_arena, heap->labels[id]);
+}
+
+/**
+ * Copy the item at index, joining its hot and cold parts
+ */
+void min_heap_item_at(MinHeap *heap, int index, HeapItem *out) {
+    out->id = heap->entries[index].id;
+    out->value = heap->entries[index].value;
+    strcpy(out->label, min_heap_label(heap, out->id));
+}
+
+
 /**
  * Get minimum element without removing
  * Time Complexity: O(1)
  */
 int min_heap_peek(MinHeap *heap, HeapItem *out) {
     if (heap->size == 0) return 0;
-    *out = heap->items[0];
+    min_heap_item_at(heap, 0, out);
     return 1;
 }
 
 /**
  * Extract and remove minimum element
- * Time Complexity: O(log n)
+ * Time Complexity: O(d log_d n)
  */
 int min_heap_extract_min(MinHeap *heap, HeapItem *out) {
     if (heap->size == 0) return 0;
     
-    *out = heap->items[0];
-    
-    // Move last element to root
-    heap->items[0] = heap->items[heap->size - 1];
-    heap->size--;
+    min_heap_item_at(heap, 0, out);
+    min_heap_delete(heap, 0);
     
-    // Restore heap property if not empty
-    if (heap->size > 0) {
-        heapify_down(heap, 0);
+    return 1;
+}
+
+/**
+ * Copy the k smallest items to out in ascending order, leaving the heap intact
+ * Walks the heap best-first: a small frontier heap of indexes starts at
+ * the root, and each index taken from it adds its children.
+ * Returns the number of items written (min of k and size)
+ * Time Complexity: O(k d log(k d))
+ */
+int min_heap_extract_k(MinHeap *heap, int k, HeapItem *out) {
+    if (k > heap->size) k = heap->size;
+    if (k <= 0) return 0;
+    
+    int arity = 1 << heap->arity_shift;
+    int *frontier = (int *)malloc(((size_t)k * arity + 1) * sizeof(int));
+    int frontier_size = 0;
+    int count = 0;
+    
+    frontier[frontier_size++] = 0;
+    
+    while (count < k) {
+        // Pop the frontier index with the smallest value
+        int index = frontier[0];
+        int last = frontier[--frontier_size];
+        int hole = 0;
+        while (1) {
+            int child = 2 * hole + 1;
+            if (child >= frontier_size) break;
+            if (child + 1 < frontier_size &&
+                heap->entries[frontier[child + 1]].value < heap->entries[frontier[child]].value) {
+                child++;
+            }
+            if (heap->entries[frontier[child]].value >= heap->entries[last].value) break;
+            frontier[hole] = frontier[child];
+            hole = child;
+        }
+        if (frontier_size > 0) frontier[hole] = last;
+        
+        min_heap_item_at(heap, index, &out[count++]);
+        
+        // Its children are the next candidates
+        int first_child = get_first_child(heap, index);
+        for (int child = first_child; child < first_child + arity && child < heap->size; child++) {
+            int slot = frontier_size++;
+            while (slot > 0 && heap->entries[frontier[(slot - 1) / 2]].value > heap->entries[child].value) {
+                frontier[slot] = frontier[(slot - 1) / 2];
+                slot = (slot - 1) / 2;
+            }
+            frontier[slot] = child;
+        }
     }
     
-    return 1;
+    free(frontier);
+    return count;
 }
 
 /**
  * Delete element at specific index
- * Time Complexity: O(log n)
+ * Time Complexity: O(d log_d n)
  */
 int min_heap_delete(MinHeap *heap, int index) {
     if (index < 0 || index >= heap->size) return 0;
     
+    int id = heap->entries[index].id;
+    heap->positions[id] = -1;
+    node_arena_free(&heap->label_arena, heap->labels[id]);
+    heap->labels[id] = NODE_NULL;
+    
     // Move last element to deleted position
-    heap->items[index] = heap->items[heap->size - 1];
     heap->size--;
     
     // Restore heap property if not last element
     if (index < heap->size) {
-        if (index > 0 && heap->items[index].value < 
-            heap->items[get_parent(index)].value) {
+        place_entry(heap, index, heap->entries[heap->size]);
+        if (index > 0 && heap->entries[index].value <
+            heap->entries[get_parent(heap, index)].value) {
             heapify_up(heap, index);
         } else {
             heapify_down(heap, index);
@@ -199,6 +402,39 @@ int min_heap_delete(MinHeap *heap, int index) {
     return 1;
 }
 
+/**
+ * Change the value of item id and restore heap order
+ * Returns 0 if id is not in the heap
+ * Time Complexity: O(d log_d n)
+ */
+int min_heap_update_key(MinHeap *heap, int id, int value) {
+    int index = min_heap_position(heap, id);
+    if (index == -1) return 0;
+    
+    int old_value = heap->entries[index].value;
+    heap->entries[index].value = value;
+    
+    if (value < old_value) {
+        heapify_up(heap, index);
+    } else if (value > old_value) {
+        heapify_down(heap, index);
+    }
+    
+    return 1;
+}
+
+/**
+ * Remove item id from the heap
+ * Returns 0 if id is not in the heap
+ * Time Complexity: O(d log_d n)
+ */
+int min_heap_remove(MinHeap *heap, int id) {
+    int index = min_heap_position(heap, id);
+    if (index == -1) return 0;
+    
+    return min_heap_delete(heap, index);
+}
+
 /**
  * Print heap as tree structure
  * Time Complexity: O(n)
@@ -213,28 +449,28 @@ void min_heap_print(MinHeap *heap) {
     
     printf("Heap array (level-order):\n");
     for (int i = 0; i < heap->size; i++) {
-        printf("[%d] Value: %d", i, heap->items[i].value);
-        if (heap->items[i].label[0] != '\0') {
-            printf(" (Label: %s)", heap->items[i].label);
+        HeapEntry *entry = &heap->entries[i];
+        const char *label = min_heap_label(heap, entry->id);
+        printf("[%d] Value: %d (id %d)", i, entry->value, entry->id);
+        if (strlen(label) > 0) {
+            printf(" (Label: %s)", label);
         }
         if (i == 0) printf(" ← MIN (Root)");
         printf("\n");
     }
     
     // Print as tree with levels
-    printf("\nHeap tree structure:\n");
+    printf("\nHeap tree structure (%d children per node):\n", 1 << heap->arity_shift);
     int level_size = 1;
-    int level_count = 0;
     int index = 0;
     
     while (index < heap->size) {
         for (int i = 0; i < level_size && index < heap->size; i++) {
-            printf("%d ", heap->items[index].value);
+            printf("%d ", heap->entries[index].value);
             index++;
         }
         printf("\n");
-        level_size *= 2;
-        level_count++;
+        level_size <<= heap->arity_shift;
     }
     
     printf("Size: %d / Capacity: %d\n\n", heap->size, heap->capacity);
@@ -252,42 +488,245 @@ void min_heap_print_sorted(MinHeap *heap) {
         return;
     }
     
-    // Create temporary copy
-    MinHeap *temp = min_heap_create(heap->capacity);
-    for (int i = 0; i < heap->size; i++) {
-        temp->items[i] = heap->items[i];
-    }
-    temp->size = heap->size;
+    // Temporary view over copies of the entries and positions (labels unused)
+    MinHeap temp = *heap;
+    temp.entries = (HeapEntry *)malloc(heap->size * sizeof(HeapEntry));
+    memcpy(temp.entries, heap->entries, heap->size * sizeof(HeapEntry));
+    temp.positions = (int *)malloc(heap->id_capacity * sizeof(int));
+    memcpy(temp.positions, heap->positions, heap->id_capacity * sizeof(int));
     
     printf("[ ");
-    while (temp->size > 0) {
-        HeapItem min;
-        min_heap_extract_min(temp, &min);
-        printf("%d ", min.value);
+    while (temp.size > 0) {
+        printf("%d ", temp.entries[0].value);
+        temp.size--;
+        if (temp.size > 0) {
+            place_entry(&temp, 0, temp.entries[temp.size]);
+            heapify_down(&temp, 0);
+        }
     }
     printf("]\n\n");
     
-    free(temp->items);
-    free(temp);
+    free(temp.entries);
+    free(temp.positions);
 }
 
 /**
  * Free heap memory
  */
 void min_heap_free(MinHeap *heap) {
-    free(heap->items);
+    node_arena_destroy(&heap->label_arena);
+    free(heap->entries);
+    free(heap->positions);
+    free(heap->labels);
     free(heap);
 }
 
+#ifndef MIN_HEAP_NO_MAIN
+
+/**
+ * Benchmark baselines: binary heaps over whole 260-byte items
+ * "inline" keeps the items in the heap array (the original layout);
+ * "handles" keeps them in a NodeArena and sifts 4-byte handles, so
+ * every comparison dereferences a record.
+ */
+typedef struct {
+    int value;
+    char label[HEAP_LABEL_SIZE];
+} BenchItem;
+
+void bench_inline_push(BenchItem *items, int *size, int value, const char *label) {
+    int index = (*size)++;
+    items[index].value = value;
+    strncpy(items[index].label, label, HEAP_LABEL_SIZE - 1);
+    items[index].label[HEAP_LABEL_SIZE - 1] = '\0';
+    
+    while (index > 0 && items[(index - 1) / 2].value > items[index].value) {
+        BenchItem temp = items[index];
+        items[index] = items[(index - 1) / 2];
+        items[(index - 1) / 2] = temp;
+        index = (index - 1) / 2;
+    }
+}
+
+void bench_inline_pop(BenchItem *items, int *size, BenchItem *out) {
+    *out = items[0];
+    items[0] = items[--(*size)];
+    
+    int index = 0;
+    while (1) {
+        int min_index = index;
+        int left = 2 * index + 1;
+        int right = 2 * index + 2;
+        
+        if (left < *size && items[left].value < items[min_index].value) min_index = left;
+        if (right < *size && items[right].value < items[min_index].value) min_index = right;
+        if (min_index == index) break;
+        
+        BenchItem temp = items[index];
+        items[index] = items[min_index];
+        items[min_index] = temp;
+        index = min_index;
+    }
+}
+
+#define BENCH_ITEM(arena, handle) ((BenchItem *)node_arena_get((arena), (handle)))
+
+void bench_handle_push(NodeArena *arena, NodeHandle *items, int *size, int value, const char *label) {
+    NodeHandle handle = node_arena_alloc(arena, sizeof(BenchItem));
+    BENCH_ITEM(arena, handle)->value = value;
+    strncpy(BENCH_ITEM(arena, handle)->label, label, HEAP_LABEL_SIZE - 1);
+    
+    int index = (*size)++;
+    items[index] = handle;
+    
+    while (index > 0 && BENCH_ITEM(arena, items[(index - 1) / 2])->value >
+           BENCH_ITEM(arena, items[index])->value) {
+        NodeHandle temp = items[index];
+        items[index] = items[(index - 1) / 2];
+        items[(index - 1) / 2] = temp;
+        index = (index - 1) / 2;
+    }
+}
+
+void bench_handle_pop(NodeArena *arena, NodeHandle *items, int *size, BenchItem *out) {
+    *out = *BENCH_ITEM(arena, items[0]);
+    node_arena_free(arena, items[0]);
+    items[0] = items[--(*size)];
+    
+    int index = 0;
+    while (1) {
+        int min_index = index;
+        int left = 2 * index + 1;
+        int right = 2 * index + 2;
+        
+        if (left < *size && BENCH_ITEM(arena, items[left])->value <
+            BENCH_ITEM(arena, items[min_index])->value) min_index = left;
+        if (right < *size && BENCH_ITEM(arena, items[right])->value <
+            BENCH_ITEM(arena, items[min_index])->value) min_index = right;
+        if (min_index == index) break;
+        
+        NodeHandle temp = items[index];
+        items[index] = items[min_index];
+        items[min_index] = temp;
+        index = min_index;
+    }
+}
+
+double heap_bench_ns_per_op(clock_t start, int ops) {
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / ops;
+}
+
+/**
+ * Eviction-style workload: insert n labelled items, bump n random
+ * keys (indexed heaps only), then extract everything in order
+ */
+void heap_bench(int n) {
+    int *values = (int *)malloc(n * sizeof(int));
+    int *bumps = (int *)malloc(n * sizeof(int));
+    char label[64];
+    
+    srand(42);
+    for (int i = 0; i < n; i++) {
+        values[i] = rand() % (n + 1);
+        bumps[i] = rand() % n;
+    }
+    
+    printf("Min heap benchmark: %d items\n", n);
+    printf("%-24s %12s %12s %12s\n", "layout", "insert ns", "update ns", "extract ns");
+    
+    // Baseline 1: items inline in the array
+    BenchItem *inline_items = (BenchItem *)malloc((size_t)n * sizeof(BenchItem));
+    BenchItem popped;
+    int size = 0;
+    
+    clock_t start = clock();
+    for (int i = 0; i < n; i++) {
+        snprintf(label, sizeof(label), "https://example.com/bookmark/%d", i);
+        bench_inline_push(inline_items, &size, values[i], label);
+    }
+    double insert_ns = heap_bench_ns_per_op(start, n);
+    
+    start = clock();
+    while (size > 0) {
+        bench_inline_pop(inline_items, &size, &popped);
+    }
+    printf("%-24s %12.1f %12s %12.1f\n", "binary, inline items", insert_ns, "-",
+           heap_bench_ns_per_op(start, n));
+    free(inline_items);
+    
+    // Baseline 2: item handles into an arena
+    NodeArena arena;
+    node_arena_init_fixed(&arena, sizeof(BenchItem));
+    NodeHandle *handles = (NodeHandle *)malloc(n * sizeof(NodeHandle));
+    
+    start = clock();
+    for (int i = 0; i < n; i++) {
+        snprintf(label, sizeof(label), "https://example.com/bookmark/%d", i);
+        bench_handle_push(&arena, handles, &size, values[i], label);
+    }
+    insert_ns = heap_bench_ns_per_op(start, n);
+    
+    start = clock();
+    while (size > 0) {
+        bench_handle_pop(&arena, handles, &size, &popped);
+    }
+    printf("%-24s %12.1f %12s %12.1f\n", "binary, item handles", insert_ns, "-",
+           heap_bench_ns_per_op(start, n));
+    free(handles);
+    node_arena_destroy(&arena);
+    
+    // Hot/cold split at several arities
+    int arities[] = { 2, 4, 8 };
+    for (int a = 0; a < 3; a++) {
+        MinHeap *heap = min_heap_create_with(n, arities[a]);
+        HeapItem item;
+        
+        start = clock();
+        for (int i = 0; i < n; i++) {
+            snprintf(label, sizeof(label), "https://example.com/bookmark/%d", i);
+            min_heap_insert(heap, i, values[i], label);
+        }
+        insert_ns = heap_bench_ns_per_op(start, n);
+        
+        start = clock();
+        for (int i = 0; i < n; i++) {
+            int id = bumps[i];
+            min_heap_update_key(heap, id, heap->entries[heap->positions[id]].value + 1);
+        }
+        double update_ns = heap_bench_ns_per_op(start, n);
+        
+        start = clock();
+        while (min_heap_extract_min(heap, &item)) {
+        }
+        
+        char name[32];
+        snprintf(name, sizeof(name), "%d-ary, hot/cold", arities[a]);
+        printf("%-24s %12.1f %12.1f %12.1f\n", name, insert_ns, update_ns,
+               heap_bench_ns_per_op(start, n));
+        
+        min_heap_free(heap);
+    }
+    
+    free(values);
+    free(bumps);
+}
+
 /**
  * Demonstration program
+ * With --bench [n], compares heap layouts instead
  */
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        heap_bench(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    
     printf("=== Min Heap Implementation in C ===\n");
-    printf("Data Structure: Min Heap (Complete Binary Tree)\n");
-    printf("Operations: Insert O(log n), Extract Min O(log n), Peek O(1)\n\n");
+    printf("Data Structure: Min Heap (Complete %d-ary Tree)\n", HEAP_DEFAULT_ARITY);
+    printf("Operations: Insert O(log n), Extract Min O(log n), Peek O(1), Update/Remove by id O(log n)\n");
+    printf("            Build O(n), k smallest O(k log k)\n\n");
     
-    MinHeap *heap = min_heap_create(MAX_HEAP_SIZE);
+    MinHeap *heap = min_heap_create(INITIAL_HEAP_CAPACITY);
     
     // Insert elements
     printf("--- Inserting elements ---\n");
@@ -295,8 +734,8 @@ int main() {
     int count = sizeof(values) / sizeof(values[0]);
     
     for (int i = 0; i < count; i++) {
-        min_heap_insert(heap, values[i], "");
-        printf("Inserted: %d\n", values[i]);
+        min_heap_insert(heap, i, values[i], "");
+        printf("Inserted: %d (id %d)\n", values[i], i);
     }
     
     min_heap_print(heap);
@@ -322,8 +761,8 @@ int main() {
     printf("--- Inserting more elements ---\n");
     int new_values[] = {8, 22, 3};
     for (int i = 0; i < 3; i++) {
-        min_heap_insert(heap, new_values[i], "");
-        printf("Inserted: %d\n", new_values[i]);
+        min_heap_insert(heap, count + i, new_values[i], "");
+        printf("Inserted: %d (id %d)\n", new_values[i], count + i);
     }
     
     min_heap_print(heap);
@@ -339,9 +778,42 @@ int main() {
     
     min_heap_print(heap);
     
+    // Change keys and remove by id (e.g. a bookmark was visited / deleted)
+    printf("--- Updating id 2 (70 -> 1) and removing id 9 ---\n");
+    if (min_heap_update_key(heap, 2, 1)) {
+        printf("✓ Updated id 2 to 1\n");
+    }
+    if (min_heap_remove(heap, 9)) {
+        printf("✓ Removed id 9\n");
+    }
+    
+    min_heap_print(heap);
+    
+    // Read the k smallest without removing them
+    printf("--- 3 smallest (heap unchanged) ---\n");
+    HeapItem smallest[3];
+    int found = min_heap_extract_k(heap, 3, smallest);
+    for (int i = 0; i < found; i++) {
+        printf("%d (id %d)\n", smallest[i].value, smallest[i].id);
+    }
+    printf("Size still: %d\n\n", heap->size);
+    
+    // Rank a whole batch at once (e.g. bookmarks loaded at startup)
+    printf("--- Building heap from %d items in O(n) ---\n", count);
+    HeapItem batch[sizeof(values) / sizeof(values[0])];
+    for (int i = 0; i < count; i++) {
+        batch[i].id = i;
+        batch[i].value = values[i];
+        snprintf(batch[i].label, sizeof(batch[i].label), "bookmark-%d", i);
+    }
+    MinHeap *built = min_heap_build(batch, count);
+    min_heap_print(built);
+    min_heap_free(built);
+    
     // Cleanup
     min_heap_free(heap);
     printf("Min heap freed.\n");
     
     return 0;
 }
+#endif
@@ -0,0 +1,72 @@
+/**
+ * Min Heap Interface
+ * Types and functions shared by min_heap.c and the modules built on it
+ * (see min_heap.c for implementation notes)
+ */
+
+#ifndef MIN_HEAP_H
+#define MIN_HEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "node_arena.h"
+
+#define HEAP_DEFAULT_ARITY 4
+#define HEAP_LABEL_SIZE 256
+
+/**
+ * Item in heap (with id, value and label)
+ * The heap stores items split; this is the form handed to callers.
+ */
+typedef struct {
+    int id;              // caller's key for update/remove (e.g. bookmark id)
+    int value;
+    char label[HEAP_LABEL_SIZE];
+} HeapItem;
+
+/**
+ * Hot heap entry: the part sifting reads
+ */
+typedef struct {
+    int value;
+    int id;
+} HeapEntry;
+
+/**
+ * Min Heap structure
+ */
+typedef struct {
+    HeapEntry *entries;      // heap order
+    int size;
+    int capacity;
+    int arity_shift;         // children per node = 1 << arity_shift
+    int *positions;          // id -> index in entries, -1 if absent
+    NodeHandle *labels;      // id -> label slot in label_arena
+    int id_capacity;
+    NodeArena label_arena;   // cold label store, slots sized to the label
+} MinHeap;
+
+// Heap operations
+MinHeap *min_heap_create(int capacity);
+MinHeap *min_heap_create_with(int capacity, int arity);
+MinHeap *min_heap_build(const HeapItem *items, int n);
+int min_heap_append(MinHeap *heap, int id, int value, const char *label);
+void min_heap_heapify(MinHeap *heap);
+void min_heap_heapify_subtree(MinHeap *heap, int root);
+void min_heap_heapify_above(MinHeap *heap, int index);
+int min_heap_insert(MinHeap *heap, int id, int value, const char *label);
+int min_heap_position(MinHeap *heap, int id);
+const char *min_heap_label(MinHeap *heap, int id);
+int min_heap_peek(MinHeap *heap, HeapItem *out);
+int min_heap_extract_min(MinHeap *heap, HeapItem *out);
+int min_heap_extract_k(MinHeap *heap, int k, HeapItem *out);
+int min_heap_update_key(MinHeap *heap, int id, int value);
+int min_heap_remove(MinHeap *heap, int id);
+int min_heap_delete(MinHeap *heap, int index);
+void min_heap_print(MinHeap *heap);
+void min_heap_print_sorted(MinHeap *heap);
+void min_heap_free(MinHeap *heap);
+
+#endif
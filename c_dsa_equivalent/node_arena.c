@@ -0,0 +1,359 @@
+/**
+ * Node Arena (Slab Allocator) Implementation in C
+ * Fixed-size slots for tree and list nodes, addressed by 32-bit handles
+ * 
+ * Each size class hands out slots from 64 KB slabs. A slot is named by a
+ * handle (size class + slot index) rather than a pointer, so node links
+ * take 4 bytes instead of 8. Slabs are never moved, which keeps pointers
+ * obtained from node_arena_get valid until that slot is freed.
+ * 
+ * Freed slots go on a per-class free list and are reused first. Tearing
+ * down a whole structure does not visit its nodes: node_arena_reset
+ * forgets every slot in O(1) per class, node_arena_destroy releases the
+ * slabs in O(slabs).
+ * 
+ * An arena can also be written out as a flat image (every class's used
+ * slots back to back) and brought back either by copying it into fresh
+ * slabs or by pointing the slab table straight into the image, e.g. a
+ * read-only mmap of a snapshot file. Handles stay the same either way.
+ * 
+ * Arenas filled by separate threads can be merged afterwards: adopting
+ * one into another moves its slabs over without copying a slot, and its
+ * handles shift by a per-class offset (node_arena_rebase).
+ * 
+ * Library module (no main); link it with the structure using it, e.g.
+ * gcc -o trie trie.c node_arena.c
+ */
+
+#include "node_arena.h"
+
+/**
+ * Create arena with the given slot sizes (ascending)
+ * Time Complexity: O(c) where c = number of classes
+ */
+void node_arena_init(NodeArena *arena, const unsigned int *class_sizes, int class_count) {
+    arena->classes = (NodeSizeClass *)calloc(class_count, sizeof(NodeSizeClass));
+    arena->class_count = class_count;
+    arena->mapped = 0;
+    
+    for (int i = 0; i < class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        
+        // Slots hold structs with pointers and the free-list link
+        size_class->slot_size = (class_sizes[i] + 7) & ~7u;
+        if (size_class->slot_size < 8) size_class->slot_size = 8;
+        
+        // Largest power-of-two slot count that fits a slab (at least 16)
+        unsigned int shift = 4;
+        while ((2u << shift) * size_class->slot_size <= NODE_SLAB_BYTES) {
+            shift++;
+        }
+        size_class->slab_shift = shift;
+        size_class->next_unused = 1;
+    }
+}
+
+/**
+ * Create arena with a single slot size
+ * Time Complexity: O(1)
+ */
+void node_arena_init_fixed(NodeArena *arena, unsigned int slot_size) {
+    node_arena_init(arena, &slot_size, 1);
+}
+
+/**
+ * Create an empty arena with the same size classes as model
+ * Time Complexity: O(c) where c = number of classes
+ */
+void node_arena_init_like(NodeArena *arena, const NodeArena *model) {
+    unsigned int *sizes = (unsigned int *)malloc(model->class_count * sizeof(unsigned int));
+    for (int i = 0; i < model->class_count; i++) {
+        sizes[i] = model->classes[i].slot_size;
+    }
+    node_arena_init(arena, sizes, model->class_count);
+    free(sizes);
+}
+
+/**
+ * Allocate a zeroed slot of at least size bytes
+ * Returns NODE_NULL if no class is large enough or the class is exhausted
+ * Time Complexity: O(1) amortized
+ */
+NodeHandle node_arena_alloc(NodeArena *arena, size_t size) {
+    int class_index = 0;
+    while (class_index < arena->class_count && arena->classes[class_index].slot_size < size) {
+        class_index++;
+    }
+    
+    if (class_index == arena->class_count) {
+        printf("Node too large for arena: %zu bytes\n", size);
+        return NODE_NULL;
+    }
+    
+    NodeSizeClass *size_class = &arena->classes[class_index];
+    uint32_t index;
+    
+    if (size_class->free_list != 0) {
+        // Reuse the most recently freed slot
+        index = size_class->free_list;
+        NodeHandle handle = ((NodeHandle)class_index << NODE_INDEX_BITS) | index;
+        memcpy(&size_class->free_list, node_arena_get(arena, handle), sizeof(uint32_t));
+    } else {
+        if (size_class->next_unused > NODE_INDEX_MASK) {
+            printf("Arena size class exhausted\n");
+            return NODE_NULL;
+        }
+        
+        index = size_class->next_unused++;
+        
+        // Add a slab when the bump index runs past the last one
+        if ((int)(index >> size_class->slab_shift) == size_class->slab_count) {
+            if (size_class->slab_count == size_class->slab_capacity) {
+                size_class->slab_capacity = size_class->slab_capacity ? size_class->slab_capacity * 2 : 4;
+                size_class->slabs = (char **)realloc(size_class->slabs,
+                                                     size_class->slab_capacity * sizeof(char *));
+            }
+            size_class->slabs[size_class->slab_count++] =
+                (char *)malloc((size_t)size_class->slot_size << size_class->slab_shift);
+        }
+    }
+    
+    size_class->live++;
+    
+    NodeHandle handle = ((NodeHandle)class_index << NODE_INDEX_BITS) | index;
+    memset(node_arena_get(arena, handle), 0, size);
+    return handle;
+}
+
+/**
+ * Return a slot to its class's free list
+ * Time Complexity: O(1)
+ */
+void node_arena_free(NodeArena *arena, NodeHandle handle) {
+    if (handle == NODE_NULL) return;
+    
+    NodeSizeClass *size_class = &arena->classes[handle >> NODE_INDEX_BITS];
+    memcpy(node_arena_get(arena, handle), &size_class->free_list, sizeof(uint32_t));
+    size_class->free_list = handle & NODE_INDEX_MASK;
+    size_class->live--;
+}
+
+/**
+ * Drop every slot at once, keeping slabs for reuse
+ * Outstanding handles become invalid.
+ * Time Complexity: O(c) where c = number of classes
+ */
+void node_arena_reset(NodeArena *arena) {
+    for (int i = 0; i < arena->class_count; i++) {
+        arena->classes[i].next_unused = 1;
+        arena->classes[i].free_list = 0;
+        arena->classes[i].live = 0;
+    }
+}
+
+/**
+ * Release all slabs
+ * Time Complexity: O(s) where s = number of slabs
+ */
+void node_arena_destroy(NodeArena *arena) {
+    for (int i = 0; i < arena->class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        for (int s = 0; s < size_class->slab_count && !arena->mapped; s++) {
+            free(size_class->slabs[s]);
+        }
+        free(size_class->slabs);
+    }
+    
+    free(arena->classes);
+    arena->classes = NULL;
+    arena->class_count = 0;
+}
+
+/**
+ * Put slots [first, end) of a class on its free list
+ */
+void node_arena_free_range(NodeArena *arena, int class_index, uint32_t first, uint32_t end) {
+    NodeSizeClass *size_class = &arena->classes[class_index];
+    for (uint32_t index = end; index-- > first; ) {
+        NodeHandle handle = ((NodeHandle)class_index << NODE_INDEX_BITS) | index;
+        memcpy(node_arena_get(arena, handle), &size_class->free_list, sizeof(uint32_t));
+        size_class->free_list = index;
+    }
+}
+
+/**
+ * Move every slab of src to the end of dst's classes, leaving src empty
+ * Slot i of a src class becomes slot offsets[class] + i of dst, so a src
+ * handle h is node_arena_rebase(h, offsets) afterwards; the caller must
+ * rewrite the handles stored inside its nodes. src's free slots, the
+ * unused tail of its last slab and the unused tail of dst's last slab
+ * all go on dst's free lists, so nothing is lost but src's slot 0.
+ * Both arenas must have the same size classes (see node_arena_init_like).
+ * Returns 0, changing nothing, if a dst class would run out of handles
+ * Time Complexity: O(s + f) for s = slabs moved, f = free slots
+ */
+int node_arena_adopt(NodeArena *dst, NodeArena *src, uint32_t *offsets) {
+    for (int i = 0; i < src->class_count; i++) {
+        uint64_t slots = (uint64_t)(dst->classes[i].slab_count + src->classes[i].slab_count) << dst->classes[i].slab_shift;
+        if (slots > (uint64_t)NODE_INDEX_MASK + 1) return 0;
+    }
+    
+    for (int i = 0; i < src->class_count; i++) {
+        NodeSizeClass *to = &dst->classes[i];
+        NodeSizeClass *from = &src->classes[i];
+        offsets[i] = (uint32_t)to->slab_count << to->slab_shift;
+        if (from->slab_count == 0) continue;
+        
+        // dst's bump region ends here; its unused tail becomes free slots
+        if (to->slab_count > 0) node_arena_free_range(dst, i, to->next_unused, offsets[i]);
+        
+        if (to->slab_count + from->slab_count > to->slab_capacity) {
+            to->slab_capacity = to->slab_count + from->slab_count;
+            to->slabs = (char **)realloc(to->slabs, to->slab_capacity * sizeof(char *));
+        }
+        memcpy(to->slabs + to->slab_count, from->slabs, from->slab_count * sizeof(char *));
+        to->slab_count += from->slab_count;
+        to->next_unused = (uint32_t)to->slab_count << to->slab_shift;
+        to->live += from->live;
+        
+        // src's free list, relinked with rebased indexes
+        uint32_t index = from->free_list;
+        while (index != 0) {
+            NodeHandle handle = ((NodeHandle)i << NODE_INDEX_BITS) | (index + offsets[i]);
+            void *slot = node_arena_get(dst, handle);
+            uint32_t next;
+            memcpy(&next, slot, sizeof(uint32_t));
+            uint32_t link = next != 0 ? next + offsets[i] : to->free_list;
+            memcpy(slot, &link, sizeof(uint32_t));
+            index = next;
+        }
+        if (from->free_list != 0) to->free_list = from->free_list + offsets[i];
+        
+        node_arena_free_range(dst, i, offsets[i] + from->next_unused, to->next_unused);
+        if (offsets[i] > 0) node_arena_free_range(dst, i, offsets[i], offsets[i] + 1);
+        
+        free(from->slabs);
+        from->slabs = NULL;
+        from->slab_count = from->slab_capacity = 0;
+        from->next_unused = 1;
+        from->free_list = 0;
+        from->live = 0;
+    }
+    return 1;
+}
+
+/**
+ * Bytes reserved in slabs
+ * Time Complexity: O(c) where c = number of classes
+ */
+size_t node_arena_bytes(NodeArena *arena) {
+    size_t bytes = 0;
+    for (int i = 0; i < arena->class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        bytes += (size_t)size_class->slab_count * (size_class->slot_size << size_class->slab_shift);
+    }
+    return bytes;
+}
+
+/**
+ * Number of slots currently allocated
+ * Time Complexity: O(c) where c = number of classes
+ */
+size_t node_arena_live(NodeArena *arena) {
+    size_t live = 0;
+    for (int i = 0; i < arena->class_count; i++) {
+        live += arena->classes[i].live;
+    }
+    return live;
+}
+
+/**
+ * Bytes of one class in a flat image: every slot handed out so far
+ * (including reserved slot 0 and freed slots, so handles stay valid);
+ * nothing for a class that never allocated
+ * Time Complexity: O(1)
+ */
+size_t node_arena_class_bytes(const NodeSizeClass *size_class) {
+    if (size_class->next_unused <= 1) return 0;
+    return (size_t)size_class->next_unused * size_class->slot_size;
+}
+
+/**
+ * Write the arena's flat image: class 0's used slots, then class 1's, ...
+ * Class metadata (next_unused, free_list, live) is the caller's to save.
+ * Returns 0 on a write error
+ * Time Complexity: O(bytes used)
+ */
+int node_arena_write(NodeArena *arena, FILE *file) {
+    for (int i = 0; i < arena->class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        size_t remaining = node_arena_class_bytes(size_class);
+        size_t slab_bytes = (size_t)size_class->slot_size << size_class->slab_shift;
+        
+        for (int s = 0; remaining > 0; s++) {
+            size_t chunk = remaining < slab_bytes ? remaining : slab_bytes;
+            if (fwrite(size_class->slabs[s], 1, chunk, file) != chunk) return 0;
+            remaining -= chunk;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Number of slabs a class needs to cover its used slots
+ */
+int node_arena_slabs_needed(const NodeSizeClass *size_class) {
+    if (size_class->next_unused <= 1) return 0;
+    return (int)(((size_class->next_unused - 1) >> size_class->slab_shift) + 1);
+}
+
+/**
+ * Point the slab table into a flat image without copying
+ * The arena's classes must already carry the saved metadata. The image
+ * must outlive the arena, and the arena must not be allocated from.
+ * Time Complexity: O(s) where s = number of slabs
+ */
+void node_arena_map(NodeArena *arena, char *image) {
+    for (int i = 0; i < arena->class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        size_t slab_bytes = (size_t)size_class->slot_size << size_class->slab_shift;
+        
+        size_class->slab_count = size_class->slab_capacity = node_arena_slabs_needed(size_class);
+        size_class->slabs = (char **)malloc(size_class->slab_count * sizeof(char *));
+        for (int s = 0; s < size_class->slab_count; s++) {
+            size_class->slabs[s] = image + s * slab_bytes;
+        }
+        image += node_arena_class_bytes(size_class);
+    }
+    arena->mapped = 1;
+}
+
+/**
+ * Copy a flat image into fresh slabs, replacing any existing ones
+ * The arena's classes must already carry the saved metadata; the result
+ * is an ordinary arena that can be allocated from and freed.
+ * Time Complexity: O(bytes used)
+ */
+void node_arena_load(NodeArena *arena, const char *image) {
+    for (int i = 0; i < arena->class_count; i++) {
+        NodeSizeClass *size_class = &arena->classes[i];
+        size_t slab_bytes = (size_t)size_class->slot_size << size_class->slab_shift;
+        size_t remaining = node_arena_class_bytes(size_class);
+        
+        for (int s = 0; s < size_class->slab_count; s++) {
+            free(size_class->slabs[s]);
+        }
+        free(size_class->slabs);
+        
+        size_class->slab_count = size_class->slab_capacity = node_arena_slabs_needed(size_class);
+        size_class->slabs = (char **)malloc(size_class->slab_count * sizeof(char *));
+        for (int s = 0; s < size_class->slab_count; s++) {
+            size_t chunk = remaining < slab_bytes ? remaining : slab_bytes;
+            size_class->slabs[s] = (char *)malloc(slab_bytes);
+            memcpy(size_class->slabs[s], image, chunk);
+            image += chunk;
+            remaining -= chunk;
+        }
+    }
+    arena->mapped = 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * Node Arena Interface
+ * Slab allocator shared by the trie, linked list and heap
+ * (see node_arena.c for implementation notes)
+ */
+
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define NODE_NULL 0               // handle that never refers to a slot
+#define NODE_CLASS_BITS 5         // up to 32 size classes per arena
+#define NODE_INDEX_BITS 27        // up to 2^27 slots per size class
+#define NODE_INDEX_MASK ((1u << NODE_INDEX_BITS) - 1)
+#define NODE_SLAB_BYTES 65536     // target bytes per slab
+
+/**
+ * 32-bit node handle: size class in the top bits, slot index below
+ * Half the size of a pointer, and stays valid when slabs are added.
+ */
+typedef uint32_t NodeHandle;
+
+/**
+ * Slots of one fixed size, carved out of equally sized slabs
+ * Freed slots are chained through their first four bytes.
+ */
+typedef struct {
+    char **slabs;
+    int slab_count;
+    int slab_capacity;
+    unsigned int slot_size;
+    unsigned int slab_shift;      // log2(slots per slab)
+    uint32_t next_unused;         // bump index; slot 0 is reserved for NODE_NULL
+    uint32_t free_list;           // index of first freed slot, 0 if none
+    uint32_t live;
+} NodeSizeClass;
+
+/**
+ * Arena of one or more size classes
+ */
+typedef struct {
+    NodeSizeClass *classes;
+    int class_count;
+    int mapped;                   // slabs point into caller memory (read-only view)
+} NodeArena;
+
+void node_arena_init(NodeArena *arena, const unsigned int *class_sizes, int class_count);
+void node_arena_init_fixed(NodeArena *arena, unsigned int slot_size);
+void node_arena_init_like(NodeArena *arena, const NodeArena *model);
+NodeHandle node_arena_alloc(NodeArena *arena, size_t size);
+void node_arena_free(NodeArena *arena, NodeHandle handle);
+void node_arena_reset(NodeArena *arena);
+void node_arena_destroy(NodeArena *arena);
+size_t node_arena_bytes(NodeArena *arena);
+size_t node_arena_live(NodeArena *arena);
+int node_arena_adopt(NodeArena *dst, NodeArena *src, uint32_t *offsets);
+
+// Flat images (snapshots): each class's used slots back to back
+size_t node_arena_class_bytes(const NodeSizeClass *size_class);
+int node_arena_write(NodeArena *arena, FILE *file);
+void node_arena_map(NodeArena *arena, char *image);
+void node_arena_load(NodeArena *arena, const char *image);
+
+/**
+ * Resolve a handle to its slot
+ * Inline: every node access goes through here.
+ * Time Complexity: O(1)
+ */
+static inline void *node_arena_get(NodeArena *arena, NodeHandle handle) {
+    NodeSizeClass *size_class = &arena->classes[handle >> NODE_INDEX_BITS];
+    uint32_t index = handle & NODE_INDEX_MASK;
+    uint32_t slot = index & ((1u << size_class->slab_shift) - 1);
+    return size_class->slabs[index >> size_class->slab_shift] + (size_t)slot * size_class->slot_size;
+}
+
+/**
+ * Handle of a slot after its arena was adopted with these offsets
+ * Time Complexity: O(1)
+ */
+static inline NodeHandle node_arena_rebase(NodeHandle handle, const uint32_t *offsets) {
+    if (handle == NODE_NULL) return NODE_NULL;
+    return handle + offsets[handle >> NODE_INDEX_BITS];
+}
+
+#endif
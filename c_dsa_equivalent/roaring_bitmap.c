@@ -0,0 +1,775 @@
+/**
+ * Roaring Bitmap Implementation in C
+ * Compressed set of 32-bit ids with fast union, intersection and counts
+ * 
+ * Ids are split into a 16-bit key (high half) and a 16-bit value (low
+ * half). Each key present in the set owns one container holding the low
+ * halves, in whichever form is smaller:
+ *   Array  - sorted uint16 values, up to ROARING_ARRAY_MAX (8 KB max)
+ *   Bitmap - 65536 bits (8 KB) once the container holds more
+ * An array becomes a bitmap when it passes ROARING_ARRAY_MAX and turns
+ * back at half that, so add/remove at the boundary does not flip it
+ * each time. No container is ever bigger than 8 KB, and sparse sets
+ * (a category with a few bookmarks spread over millions of ids) cost
+ * two bytes per id while dense ones cost one bit.
+ * 
+ * Set operations walk both key lists in order and combine container
+ * pairs: array/array by merging (galloping when one side is much
+ * smaller), array/bitmap by testing bits, bitmap/bitmap 64 bits per
+ * step. Cardinalities are kept per container and per bitmap, so counts
+ * are O(1) and paging (roaring_bitmap_to_array with an offset) skips
+ * whole containers.
+ * 
+ * Ids added in increasing order (fresh bookmark ids) append to the last
+ * array container without a search.
+ * 
+ * Compile: gcc -O2 -o roaring_bitmap roaring_bitmap.c
+ * Run: ./roaring_bitmap
+ *      ./roaring_bitmap --bench [n]   (filter toggles on n bookmarks vs a scan)
+ * Define ROARING_BITMAP_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#include "roaring_bitmap.h"
+
+#define ROARING_INITIAL_CONTAINERS 4
+#define ROARING_INITIAL_ARRAY 4
+#define ROARING_GALLOP_RATIO 32      // size ratio above which intersections gallop
+
+/**
+ * Values of an array container
+ */
+uint16_t *roaring_values(const RoaringContainer *container) {
+    return (uint16_t *)container->data;
+}
+
+/**
+ * Words of a bitmap container
+ */
+uint64_t *roaring_words(const RoaringContainer *container) {
+    return (uint64_t *)container->data;
+}
+
+/**
+ * Create empty bitmap
+ * Time Complexity: O(1)
+ */
+RoaringBitmap *roaring_bitmap_create(void) {
+    RoaringBitmap *bitmap = (RoaringBitmap *)malloc(sizeof(RoaringBitmap));
+    bitmap->capacity = ROARING_INITIAL_CONTAINERS;
+    bitmap->containers = (RoaringContainer *)malloc(bitmap->capacity * sizeof(RoaringContainer));
+    bitmap->count = 0;
+    bitmap->cardinality = 0;
+    return bitmap;
+}
+
+/**
+ * Index of the container for key, or -(insertion point) - 1
+ * Time Complexity: O(log c) for c = containers
+ */
+int roaring_find(const RoaringBitmap *bitmap, uint16_t key) {
+    int low = 0, high = bitmap->count - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        uint16_t found = bitmap->containers[mid].key;
+        if (found == key) return mid;
+        if (found < key) low = mid + 1; else high = mid - 1;
+    }
+    return -low - 1;
+}
+
+/**
+ * First position in values[from, count) holding a value >= x
+ * Time Complexity: O(log n)
+ */
+int roaring_lower_bound(const uint16_t *values, int from, int count, uint16_t x) {
+    int low = from, high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (values[mid] < x) low = mid + 1; else high = mid;
+    }
+    return low;
+}
+
+/**
+ * Galloping lower bound: probe 1, 2, 4, ... ahead of from, then binary
+ * search the last stride
+ * Time Complexity: O(log d) for d = distance moved
+ */
+int roaring_gallop(const uint16_t *values, int from, int count, uint16_t x) {
+    if (from >= count || values[from] >= x) return from;
+    int behind = from, step = 1;
+    while (behind + step < count && values[behind + step] < x) {
+        behind += step;
+        step *= 2;
+    }
+    return roaring_lower_bound(values, behind + 1, behind + step < count ? behind + step + 1 : count, x);
+}
+
+/**
+ * Does a container hold low?
+ * Time Complexity: O(log n) for arrays, O(1) for bitmaps
+ */
+int roaring_container_contains(const RoaringContainer *container, uint16_t low) {
+    if (container->type == ROARING_BITMAP) return (roaring_words(container)[low >> 6] >> (low & 63)) & 1;
+    int at = roaring_lower_bound(roaring_values(container), 0, container->cardinality, low);
+    return at < container->cardinality && roaring_values(container)[at] == low;
+}
+
+/**
+ * Turn an array container into a bitmap container
+ * Time Complexity: O(n + words)
+ */
+void roaring_container_to_bitmap(RoaringContainer *container) {
+    uint64_t *words = (uint64_t *)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    uint16_t *values = roaring_values(container);
+    for (int i = 0; i < container->cardinality; i++) {
+        words[values[i] >> 6] |= 1ULL << (values[i] & 63);
+    }
+    free(container->data);
+    container->data = words;
+    container->type = ROARING_BITMAP;
+    container->capacity = 0;
+}
+
+/**
+ * Write the set bits of words as sorted values; returns how many
+ * Time Complexity: O(words + n)
+ */
+int roaring_words_extract(const uint64_t *words, uint16_t *values) {
+    int count = 0;
+    for (int w = 0; w < ROARING_BITMAP_WORDS; w++) {
+        for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+            values[count++] = (uint16_t)(w * 64 + __builtin_ctzll(bits));
+        }
+    }
+    return count;
+}
+
+/**
+ * Turn a bitmap container (at most ROARING_ARRAY_MAX values) into an
+ * array container
+ * Time Complexity: O(words + n)
+ */
+void roaring_container_to_array(RoaringContainer *container) {
+    int capacity = container->cardinality > 0 ? container->cardinality : 1;
+    uint16_t *values = (uint16_t *)malloc(capacity * sizeof(uint16_t));
+    roaring_words_extract(roaring_words(container), values);
+    free(container->data);
+    container->data = values;
+    container->type = ROARING_ARRAY;
+    container->capacity = capacity;
+}
+
+/**
+ * Add low to a container; returns 1 if it was not there
+ * Time Complexity: O(n) for arrays (shift), O(1) for bitmaps
+ */
+int roaring_container_add(RoaringContainer *container, uint16_t low) {
+    if (container->type == ROARING_BITMAP) {
+        uint64_t *word = &roaring_words(container)[low >> 6];
+        uint64_t bit = 1ULL << (low & 63);
+        if (*word & bit) return 0;
+        *word |= bit;
+        container->cardinality++;
+        return 1;
+    }
+    
+    uint16_t *values = roaring_values(container);
+    int at = roaring_lower_bound(values, 0, container->cardinality, low);
+    if (at < container->cardinality && values[at] == low) return 0;
+    
+    if (container->cardinality == ROARING_ARRAY_MAX) {
+        roaring_container_to_bitmap(container);
+        return roaring_container_add(container, low);
+    }
+    if (container->cardinality == container->capacity) {
+        container->capacity *= 2;
+        if (container->capacity > ROARING_ARRAY_MAX) container->capacity = ROARING_ARRAY_MAX;
+        container->data = realloc(container->data, container->capacity * sizeof(uint16_t));
+        values = roaring_values(container);
+    }
+    memmove(&values[at + 1], &values[at], (container->cardinality - at) * sizeof(uint16_t));
+    values[at] = low;
+    container->cardinality++;
+    return 1;
+}
+
+/**
+ * Remove low from a container; returns 1 if it was there
+ * Time Complexity: O(n) for arrays, O(1) for bitmaps (O(words) when it
+ * shrinks back to an array)
+ */
+int roaring_container_remove(RoaringContainer *container, uint16_t low) {
+    if (container->type == ROARING_BITMAP) {
+        uint64_t *word = &roaring_words(container)[low >> 6];
+        uint64_t bit = 1ULL << (low & 63);
+        if (!(*word & bit)) return 0;
+        *word &= ~bit;
+        if (--container->cardinality <= ROARING_ARRAY_MAX / 2) roaring_container_to_array(container);
+        return 1;
+    }
+    
+    uint16_t *values = roaring_values(container);
+    int at = roaring_lower_bound(values, 0, container->cardinality, low);
+    if (at == container->cardinality || values[at] != low) return 0;
+    memmove(&values[at], &values[at + 1], (container->cardinality - at - 1) * sizeof(uint16_t));
+    container->cardinality--;
+    return 1;
+}
+
+/**
+ * Open a slot for a new container at position at
+ * Time Complexity: O(c)
+ */
+RoaringContainer *roaring_insert_container(RoaringBitmap *bitmap, int at) {
+    if (bitmap->count == bitmap->capacity) {
+        bitmap->capacity *= 2;
+        bitmap->containers = (RoaringContainer *)realloc(bitmap->containers,
+                                                         bitmap->capacity * sizeof(RoaringContainer));
+    }
+    memmove(&bitmap->containers[at + 1], &bitmap->containers[at], (bitmap->count - at) * sizeof(RoaringContainer));
+    bitmap->count++;
+    return &bitmap->containers[at];
+}
+
+/**
+ * Free and drop the container at position at
+ * Time Complexity: O(c)
+ */
+void roaring_remove_container(RoaringBitmap *bitmap, int at) {
+    free(bitmap->containers[at].data);
+    memmove(&bitmap->containers[at], &bitmap->containers[at + 1], (bitmap->count - at - 1) * sizeof(RoaringContainer));
+    bitmap->count--;
+}
+
+/**
+ * Add id x; returns 1 if it was not in the set
+ * Time Complexity: O(1) when x is above every id so far, otherwise
+ * O(log c + ROARING_ARRAY_MAX)
+ */
+int roaring_bitmap_add(RoaringBitmap *bitmap, uint32_t x) {
+    uint16_t key = (uint16_t)(x >> 16), low = (uint16_t)x;
+    
+    // Appending past the end: the usual case for fresh ids
+    RoaringContainer *last = bitmap->count > 0 ? &bitmap->containers[bitmap->count - 1] : NULL;
+    if (last && last->key == key && last->type == ROARING_ARRAY && last->cardinality < last->capacity &&
+        roaring_values(last)[last->cardinality - 1] < low) {
+        roaring_values(last)[last->cardinality++] = low;
+        bitmap->cardinality++;
+        return 1;
+    }
+    
+    int at = roaring_find(bitmap, key);
+    if (at < 0) {
+        RoaringContainer *container = roaring_insert_container(bitmap, -at - 1);
+        container->key = key;
+        container->type = ROARING_ARRAY;
+        container->cardinality = 1;
+        container->capacity = ROARING_INITIAL_ARRAY;
+        container->data = malloc(ROARING_INITIAL_ARRAY * sizeof(uint16_t));
+        roaring_values(container)[0] = low;
+        bitmap->cardinality++;
+        return 1;
+    }
+    
+    if (!roaring_container_add(&bitmap->containers[at], low)) return 0;
+    bitmap->cardinality++;
+    return 1;
+}
+
+/**
+ * Remove id x; returns 1 if it was in the set
+ * Time Complexity: O(log c + ROARING_ARRAY_MAX)
+ */
+int roaring_bitmap_remove(RoaringBitmap *bitmap, uint32_t x) {
+    int at = roaring_find(bitmap, (uint16_t)(x >> 16));
+    if (at < 0 || !roaring_container_remove(&bitmap->containers[at], (uint16_t)x)) return 0;
+    
+    if (bitmap->containers[at].cardinality == 0) roaring_remove_container(bitmap, at);
+    bitmap->cardinality--;
+    return 1;
+}
+
+/**
+ * Is id x in the set?
+ * Time Complexity: O(log c + log ROARING_ARRAY_MAX)
+ */
+int roaring_bitmap_contains(const RoaringBitmap *bitmap, uint32_t x) {
+    int at = roaring_find(bitmap, (uint16_t)(x >> 16));
+    return at >= 0 && roaring_container_contains(&bitmap->containers[at], (uint16_t)x);
+}
+
+/**
+ * Number of ids in the set
+ * Time Complexity: O(1)
+ */
+uint64_t roaring_bitmap_cardinality(const RoaringBitmap *bitmap) {
+    return bitmap->cardinality;
+}
+
+/**
+ * Append a container to a result bitmap (keys arrive in order)
+ */
+void roaring_append(RoaringBitmap *bitmap, const RoaringContainer *container) {
+    *roaring_insert_container(bitmap, bitmap->count) = *container;
+    bitmap->cardinality += container->cardinality;
+}
+
+/**
+ * Deep copy of a container
+ * Time Complexity: O(n)
+ */
+RoaringContainer roaring_container_copy(const RoaringContainer *source) {
+    RoaringContainer copy = *source;
+    size_t bytes = source->type == ROARING_BITMAP ? ROARING_BITMAP_WORDS * sizeof(uint64_t)
+                                                  : source->cardinality * sizeof(uint16_t);
+    copy.capacity = source->type == ROARING_BITMAP ? 0 : source->cardinality;
+    copy.data = malloc(bytes);
+    memcpy(copy.data, source->data, bytes);
+    return copy;
+}
+
+/**
+ * Result container from count sorted values (bitmap form above
+ * ROARING_ARRAY_MAX)
+ */
+RoaringContainer roaring_container_from_values(uint16_t key, const uint16_t *values, int count) {
+    RoaringContainer container = { key, ROARING_ARRAY, count, count, malloc(count * sizeof(uint16_t)) };
+    memcpy(container.data, values, count * sizeof(uint16_t));
+    if (count > ROARING_ARRAY_MAX) roaring_container_to_bitmap(&container);
+    return container;
+}
+
+/**
+ * Merge two sorted arrays under op into out; returns the count
+ * AND gallops through the larger side when the sizes are lopsided.
+ * Time Complexity: O(n + m), or O(n log(m / n)) for a lopsided AND
+ */
+int roaring_arrays_merge(const uint16_t *a, int na, const uint16_t *b, int nb, int op, uint16_t *out) {
+    int i = 0, j = 0, count = 0;
+    
+    if (op == ROARING_AND && (na * ROARING_GALLOP_RATIO < nb || nb * ROARING_GALLOP_RATIO < na)) {
+        const uint16_t *small = na < nb ? a : b, *large = na < nb ? b : a;
+        int small_count = na < nb ? na : nb, large_count = na < nb ? nb : na;
+        for (; i < small_count; i++) {
+            j = roaring_gallop(large, j, large_count, small[i]);
+            if (j == large_count) break;
+            if (large[j] == small[i]) out[count++] = small[i];
+        }
+        return count;
+    }
+    
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            if (op != ROARING_AND) out[count++] = a[i];
+            i++;
+        } else if (a[i] > b[j]) {
+            if (op == ROARING_OR) out[count++] = b[j];
+            j++;
+        } else {
+            if (op != ROARING_ANDNOT) out[count++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    if (op != ROARING_AND) while (i < na) out[count++] = a[i++];
+    if (op == ROARING_OR) while (j < nb) out[count++] = b[j++];
+    return count;
+}
+
+/**
+ * Word-wise a op b into out; returns the number of set bits
+ * Time Complexity: O(ROARING_BITMAP_WORDS)
+ */
+int roaring_words_combine(const uint64_t *a, const uint64_t *b, int op, uint64_t *out) {
+    int count = 0;
+    for (int w = 0; w < ROARING_BITMAP_WORDS; w++) {
+        uint64_t word = op == ROARING_AND ? a[w] & b[w] : op == ROARING_OR ? a[w] | b[w] : a[w] & ~b[w];
+        out[w] = word;
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+/**
+ * Combine two containers with the same key; returns 0 if the result is
+ * empty, else fills out
+ * Time Complexity: O(n + m) for arrays, O(ROARING_BITMAP_WORDS) otherwise
+ */
+int roaring_container_combine(const RoaringContainer *a, const RoaringContainer *b, int op, RoaringContainer *out) {
+    uint16_t buffer[2 * ROARING_ARRAY_MAX];
+    int count;
+    
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY) {
+        count = roaring_arrays_merge(roaring_values(a), a->cardinality, roaring_values(b), b->cardinality, op, buffer);
+    } else if (a->type == ROARING_ARRAY && op != ROARING_OR) {
+        // Keep a's values that b has (AND) or lacks (ANDNOT)
+        count = 0;
+        for (int i = 0; i < a->cardinality; i++) {
+            uint16_t low = roaring_values(a)[i];
+            if (roaring_container_contains(b, low) == (op == ROARING_AND)) buffer[count++] = low;
+        }
+    } else if (b->type == ROARING_ARRAY && op == ROARING_AND) {
+        count = 0;
+        for (int i = 0; i < b->cardinality; i++) {
+            uint16_t low = roaring_values(b)[i];
+            if (roaring_container_contains(a, low)) buffer[count++] = low;
+        }
+    } else {
+        // Result as bits: a bitmap (or an array OR'ed into a bitmap)
+        RoaringContainer result = { a->key, ROARING_BITMAP, 0, 0, malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t)) };
+        uint64_t *words = roaring_words(&result);
+        const RoaringContainer *bits = a->type == ROARING_BITMAP ? a : b;
+        const RoaringContainer *other = bits == a ? b : a;
+        
+        if (other->type == ROARING_BITMAP) {
+            result.cardinality = roaring_words_combine(roaring_words(a), roaring_words(b), op, words);
+        } else {
+            memcpy(words, roaring_words(bits), ROARING_BITMAP_WORDS * sizeof(uint64_t));
+            result.cardinality = bits->cardinality;
+            for (int i = 0; i < other->cardinality; i++) {
+                uint16_t low = roaring_values(other)[i];
+                uint64_t bit = 1ULL << (low & 63), had = words[low >> 6] & bit;
+                if (op == ROARING_OR && !had) {
+                    words[low >> 6] |= bit;
+                    result.cardinality++;
+                } else if (op == ROARING_ANDNOT && had) {
+                    words[low >> 6] &= ~bit;
+                    result.cardinality--;
+                }
+            }
+        }
+        
+        if (result.cardinality == 0) {
+            free(result.data);
+            return 0;
+        }
+        if (result.cardinality <= ROARING_ARRAY_MAX) roaring_container_to_array(&result);
+        *out = result;
+        return 1;
+    }
+    
+    if (count == 0) return 0;
+    *out = roaring_container_from_values(a->key, buffer, count);
+    return 1;
+}
+
+/**
+ * New bitmap a op b (ROARING_AND, ROARING_OR or ROARING_ANDNOT = a \ b)
+ * Containers present on one side only are skipped (AND), or copied
+ * (OR, and ANDNOT for a's side).
+ * Time Complexity: O(c + sum of container work), each container pair at
+ * most O(ROARING_BITMAP_WORDS)
+ */
+RoaringBitmap *roaring_bitmap_combine(const RoaringBitmap *a, const RoaringBitmap *b, int op) {
+    RoaringBitmap *result = roaring_bitmap_create();
+    int i = 0, j = 0;
+    while (i < a->count || j < b->count) {
+        RoaringContainer container;
+        if (j == b->count || (i < a->count && a->containers[i].key < b->containers[j].key)) {
+            if (op != ROARING_AND) {
+                container = roaring_container_copy(&a->containers[i]);
+                roaring_append(result, &container);
+            }
+            i++;
+        } else if (i == a->count || b->containers[j].key < a->containers[i].key) {
+            if (op == ROARING_OR) {
+                container = roaring_container_copy(&b->containers[j]);
+                roaring_append(result, &container);
+            }
+            j++;
+        } else {
+            if (roaring_container_combine(&a->containers[i], &b->containers[j], op, &container)) {
+                roaring_append(result, &container);
+            }
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+/**
+ * Union of count bitmaps (an empty bitmap for count == 0)
+ * Time Complexity: O(count * union size) in the worst case
+ */
+RoaringBitmap *roaring_bitmap_or_many(const RoaringBitmap *const *bitmaps, int count) {
+    RoaringBitmap *result = roaring_bitmap_create();
+    for (int i = 0; i < count; i++) {
+        RoaringBitmap *merged = roaring_bitmap_combine(result, bitmaps[i], ROARING_OR);
+        roaring_bitmap_free(result);
+        result = merged;
+    }
+    return result;
+}
+
+/**
+ * Size of a AND b without building it
+ * Time Complexity: as roaring_bitmap_combine with ROARING_AND, no allocation
+ */
+uint64_t roaring_bitmap_and_cardinality(const RoaringBitmap *a, const RoaringBitmap *b) {
+    uint64_t total = 0;
+    int i = 0, j = 0;
+    while (i < a->count && j < b->count) {
+        const RoaringContainer *x = &a->containers[i], *y = &b->containers[j];
+        if (x->key < y->key) {
+            i++;
+            continue;
+        }
+        if (y->key < x->key) {
+            j++;
+            continue;
+        }
+        
+        if (x->type == ROARING_BITMAP && y->type == ROARING_BITMAP) {
+            for (int w = 0; w < ROARING_BITMAP_WORDS; w++) {
+                total += __builtin_popcountll(roaring_words(x)[w] & roaring_words(y)[w]);
+            }
+        } else if (x->type == ROARING_ARRAY && y->type == ROARING_ARRAY) {
+            uint16_t buffer[ROARING_ARRAY_MAX];
+            total += roaring_arrays_merge(roaring_values(x), x->cardinality, roaring_values(y), y->cardinality,
+                                          ROARING_AND, buffer);
+        } else {
+            const RoaringContainer *values = x->type == ROARING_ARRAY ? x : y, *bits = values == x ? y : x;
+            for (int v = 0; v < values->cardinality; v++) {
+                total += roaring_container_contains(bits, roaring_values(values)[v]);
+            }
+        }
+        i++;
+        j++;
+    }
+    return total;
+}
+
+/**
+ * Write ids in increasing order, skipping the first offset, at most limit
+ * Returns how many were written. Whole containers inside the offset are
+ * skipped by their cardinality, so any page costs O(c + limit).
+ * Time Complexity: O(c + ROARING_BITMAP_WORDS + limit)
+ */
+int roaring_bitmap_to_array(const RoaringBitmap *bitmap, uint32_t offset, int limit, uint32_t *ids_out) {
+    int written = 0;
+    for (int i = 0; i < bitmap->count && written < limit; i++) {
+        const RoaringContainer *container = &bitmap->containers[i];
+        if (offset >= (uint32_t)container->cardinality) {
+            offset -= container->cardinality;
+            continue;
+        }
+        
+        uint32_t high = (uint32_t)container->key << 16;
+        if (container->type == ROARING_ARRAY) {
+            for (int v = (int)offset; v < container->cardinality && written < limit; v++) {
+                ids_out[written++] = high | roaring_values(container)[v];
+            }
+        } else {
+            const uint64_t *words = roaring_words(container);
+            for (int w = 0; w < ROARING_BITMAP_WORDS && written < limit; w++) {
+                uint64_t bits = words[w];
+                int ones = __builtin_popcountll(bits);
+                if (offset >= (uint32_t)ones) {
+                    offset -= ones;
+                    continue;
+                }
+                for (; bits && written < limit; bits &= bits - 1) {
+                    if (offset > 0) {
+                        offset--;
+                        continue;
+                    }
+                    ids_out[written++] = high | (uint32_t)(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+        }
+        offset = 0;
+    }
+    return written;
+}
+
+/**
+ * Bytes held by the bitmap
+ * Time Complexity: O(c)
+ */
+size_t roaring_bitmap_memory_usage(const RoaringBitmap *bitmap) {
+    size_t bytes = sizeof(RoaringBitmap) + bitmap->capacity * sizeof(RoaringContainer);
+    for (int i = 0; i < bitmap->count; i++) {
+        const RoaringContainer *container = &bitmap->containers[i];
+        bytes += container->type == ROARING_BITMAP ? ROARING_BITMAP_WORDS * sizeof(uint64_t)
+                                                   : container->capacity * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+/**
+ * Free bitmap
+ * Time Complexity: O(c)
+ */
+void roaring_bitmap_free(RoaringBitmap *bitmap) {
+    for (int i = 0; i < bitmap->count; i++) {
+        free(bitmap->containers[i].data);
+    }
+    free(bitmap->containers);
+    free(bitmap);
+}
+
+#ifndef ROARING_BITMAP_NO_MAIN
+#define BENCH_CATEGORIES 16
+#define BENCH_PAGE 50
+
+double roaring_bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Filter toggles on n bookmarks: union of the active categories, its
+ * count and the first page of ids, against scanning a category array
+ */
+void roaring_bench(int n) {
+    printf("Roaring bitmap benchmark: %d bookmarks, %d categories\n", n, BENCH_CATEGORIES);
+    
+    // Skewed categories: category c holds about 1 / 2^(c+1) of the ids
+    unsigned char *categories = (unsigned char *)malloc(n);
+    RoaringBitmap *bitmaps[BENCH_CATEGORIES];
+    for (int c = 0; c < BENCH_CATEGORIES; c++) bitmaps[c] = roaring_bitmap_create();
+    srand(7);
+    double start = roaring_bench_seconds();
+    for (int id = 0; id < n; id++) {
+        int c = 0;
+        while (c < BENCH_CATEGORIES - 1 && (rand() & 1)) c++;
+        categories[id] = (unsigned char)c;
+        roaring_bitmap_add(bitmaps[c], (uint32_t)id);
+    }
+    double build = roaring_bench_seconds() - start;
+    
+    size_t bytes = 0;
+    for (int c = 0; c < BENCH_CATEGORIES; c++) bytes += roaring_bitmap_memory_usage(bitmaps[c]);
+    printf("  Built in %.1f ms, %.2f MB (%.2f bytes/id; scan needs %d bytes/id)\n", build * 1e3,
+           bytes / 1048576.0, (double)bytes / n, (int)sizeof(unsigned char));
+    
+    uint32_t page[BENCH_PAGE];
+    int selections[][3] = { {0, -1, -1}, {3, -1, -1}, {1, 5, -1}, {2, 9, 12}, {10, 11, 13} };
+    printf("  %-14s %10s %12s %12s\n", "filter", "matches", "bitmap (us)", "scan (us)");
+    for (int s = 0; s < 5; s++) {
+        const RoaringBitmap *active[3];
+        int active_count = 0;
+        char name[32] = "";
+        for (int k = 0; k < 3 && selections[s][k] >= 0; k++) {
+            active[active_count++] = bitmaps[selections[s][k]];
+            snprintf(name + strlen(name), sizeof(name) - strlen(name), "%s%d", k ? "|" : "", selections[s][k]);
+        }
+        
+        int rounds = 20;
+        start = roaring_bench_seconds();
+        uint64_t matches = 0;
+        for (int r = 0; r < rounds; r++) {
+            RoaringBitmap *filtered = roaring_bitmap_or_many(active, active_count);
+            matches = roaring_bitmap_cardinality(filtered);
+            roaring_bitmap_to_array(filtered, 0, BENCH_PAGE, page);
+            roaring_bitmap_free(filtered);
+        }
+        double bitmap_us = (roaring_bench_seconds() - start) / rounds * 1e6;
+        
+        start = roaring_bench_seconds();
+        uint64_t scanned = 0;
+        for (int r = 0; r < rounds; r++) {
+            scanned = 0;
+            for (int id = 0; id < n; id++) {
+                for (int k = 0; k < active_count; k++) {
+                    if (categories[id] == selections[s][k]) {
+                        if (scanned < BENCH_PAGE) page[scanned] = (uint32_t)id;
+                        scanned++;
+                        break;
+                    }
+                }
+            }
+        }
+        double scan_us = (roaring_bench_seconds() - start) / rounds * 1e6;
+        printf("  %-14s %10llu %12.1f %12.1f%s\n", name, (unsigned long long)matches, bitmap_us, scan_us,
+               scanned == matches ? "" : "  MISMATCH");
+    }
+    
+    for (int c = 0; c < BENCH_CATEGORIES; c++) roaring_bitmap_free(bitmaps[c]);
+    free(categories);
+}
+
+/**
+ * Print a bitmap's first ids
+ */
+void roaring_print(const char *label, const RoaringBitmap *bitmap) {
+    uint32_t ids[12];
+    int count = roaring_bitmap_to_array(bitmap, 0, 12, ids);
+    printf("   %-22s %6llu ids:", label, (unsigned long long)roaring_bitmap_cardinality(bitmap));
+    for (int i = 0; i < count; i++) printf(" %u", ids[i]);
+    printf("%s\n", (uint64_t)count < roaring_bitmap_cardinality(bitmap) ? " ..." : "");
+}
+
+/**
+ * Demonstration program
+ */
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        roaring_bench(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    
+    printf("=== Roaring Bitmap in C ===\n");
+    printf("Data Structure: Array / bitmap containers keyed by the high 16 bits\n\n");
+    
+    RoaringBitmap *development = roaring_bitmap_create();
+    RoaringBitmap *learning = roaring_bitmap_create();
+    RoaringBitmap *pinned = roaring_bitmap_create();
+    
+    printf("1. Filling category sets:\n");
+    for (uint32_t id = 0; id < 200000; id++) {
+        if (id % 3 == 0) roaring_bitmap_add(development, id);   // dense: bitmap containers
+        if (id % 1000 == 7) roaring_bitmap_add(learning, id);   // sparse: array containers
+    }
+    roaring_bitmap_add(pinned, 7);
+    roaring_bitmap_add(pinned, 9);
+    roaring_bitmap_add(pinned, 3000);
+    roaring_bitmap_add(pinned, 4000000000u);
+    roaring_print("Development", development);
+    roaring_print("Learning", learning);
+    roaring_print("Pinned", pinned);
+    printf("   Development: %zu bytes (%d containers), Learning: %zu bytes\n\n",
+           roaring_bitmap_memory_usage(development), development->count, roaring_bitmap_memory_usage(learning));
+    
+    printf("2. Set operations:\n");
+    RoaringBitmap *either = roaring_bitmap_combine(development, learning, ROARING_OR);
+    RoaringBitmap *both = roaring_bitmap_combine(development, learning, ROARING_AND);
+    RoaringBitmap *only = roaring_bitmap_combine(learning, development, ROARING_ANDNOT);
+    roaring_print("Development OR Learning", either);
+    roaring_print("Development AND Learning", both);
+    roaring_print("Learning NOT Development", only);
+    printf("   |Development AND Pinned| without building it: %llu\n\n",
+           (unsigned long long)roaring_bitmap_and_cardinality(development, pinned));
+    
+    printf("3. Paging Development (ranks 20000-20004):\n   ");
+    uint32_t page[5];
+    int count = roaring_bitmap_to_array(development, 20000, 5, page);
+    for (int i = 0; i < count; i++) printf(" %u", page[i]);
+    printf("\n\n");
+    
+    printf("4. Removing ids:\n");
+    for (uint32_t id = 0; id < 200000; id += 3) {
+        if (id % 2 == 0) roaring_bitmap_remove(development, id);
+    }
+    roaring_print("Development (odd only)", development);
+    printf("   contains 3: %d, contains 6: %d\n", roaring_bitmap_contains(development, 3),
+           roaring_bitmap_contains(development, 6));
+    
+    roaring_bitmap_free(either);
+    roaring_bitmap_free(both);
+    roaring_bitmap_free(only);
+    roaring_bitmap_free(development);
+    roaring_bitmap_free(learning);
+    roaring_bitmap_free(pinned);
+    
+    printf("\n=== Demo Complete ===\n");
+    return 0;
+}
+#endif
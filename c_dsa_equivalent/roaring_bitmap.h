@@ -0,0 +1,61 @@
+/**
+ * Roaring Bitmap Interface
+ * Compressed sets of 32-bit ids, shared by roaring_bitmap.c and the
+ * modules built on it (see roaring_bitmap.c for implementation notes)
+ */
+
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define ROARING_ARRAY_MAX 4096       // array containers above this become bitmaps
+#define ROARING_BITMAP_WORDS 1024    // 65536 bits
+
+#define ROARING_ARRAY 0
+#define ROARING_BITMAP 1
+
+#define ROARING_AND 0
+#define ROARING_OR 1
+#define ROARING_ANDNOT 2
+
+/**
+ * Ids sharing their high 16 bits
+ * Sorted uint16 low halves while sparse (array), 8 KB of bits when
+ * dense (bitmap); whichever is smaller for the cardinality.
+ */
+typedef struct {
+    uint16_t key;                // high 16 bits
+    uint8_t type;                // ROARING_ARRAY or ROARING_BITMAP
+    int cardinality;             // 1..65536
+    int capacity;                // array slots (array containers)
+    void *data;                  // uint16_t[capacity] or uint64_t[ROARING_BITMAP_WORDS]
+} RoaringContainer;
+
+/**
+ * Roaring Bitmap structure
+ * Containers sorted by key; empty containers are dropped.
+ */
+typedef struct {
+    RoaringContainer *containers;
+    int count;
+    int capacity;
+    uint64_t cardinality;        // ids in the set
+} RoaringBitmap;
+
+RoaringBitmap *roaring_bitmap_create(void);
+int roaring_bitmap_add(RoaringBitmap *bitmap, uint32_t x);
+int roaring_bitmap_remove(RoaringBitmap *bitmap, uint32_t x);
+int roaring_bitmap_contains(const RoaringBitmap *bitmap, uint32_t x);
+uint64_t roaring_bitmap_cardinality(const RoaringBitmap *bitmap);
+RoaringBitmap *roaring_bitmap_combine(const RoaringBitmap *a, const RoaringBitmap *b, int op);
+RoaringBitmap *roaring_bitmap_or_many(const RoaringBitmap *const *bitmaps, int count);
+uint64_t roaring_bitmap_and_cardinality(const RoaringBitmap *a, const RoaringBitmap *b);
+int roaring_bitmap_to_array(const RoaringBitmap *bitmap, uint32_t offset, int limit, uint32_t *ids_out);
+size_t roaring_bitmap_memory_usage(const RoaringBitmap *bitmap);
+void roaring_bitmap_free(RoaringBitmap *bitmap);
+
+#endif
@@ -0,0 +1,828 @@
+/**
+ * Sharded Concurrent Cache in C
+ * Bounded key -> value cache for recently visited bookmarks, shared by
+ * many worker threads, with a pluggable eviction policy
+ * 
+ * Keys are spread over a power-of-two number of shards by the top bits of
+ * their hash. Each shard owns a fixed array of entries, an open-addressing
+ * index (key -> entry) and the policy's queues, all allocated up front and
+ * never moved. Writers (put, delete, evictions) take the shard mutex and
+ * keep the shard's sequence counter odd while they change the index.
+ * 
+ * Lookups take no lock. They probe the index and read the value between
+ * two reads of the sequence counter and retry on a mismatch, as in
+ * sharded_hash_table.c. Because the arrays never move, no reclamation is
+ * needed. What a hit does next depends on the policy:
+ *   - CLOCK:   set the entry's reference bit (one relaxed store)
+ *   - S3-FIFO: bump the entry's 2-bit frequency (one relaxed store)
+ *   - LRU:     move the entry to the front of its list, which needs the
+ *              mutex; if another thread holds it the move is skipped, so
+ *              LRU order is approximate under contention
+ * 
+ * S3-FIFO (Yang et al., SOSP'23): new keys enter a small FIFO holding 10%
+ * of the shard. On eviction from it, keys hit again move to the main
+ * FIFO and the rest are dropped, leaving their key in a ghost FIFO; a key
+ * found in the ghost FIFO is inserted straight into main. Main evicts
+ * like CLOCK with a frequency counter instead of a bit.
+ * 
+ * Compile: gcc -O2 -pthread -o sharded_cache sharded_cache.c -lm
+ * Run: ./sharded_cache [max_threads]
+ * Define SHARDED_CACHE_NO_MAIN to link into another program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_SHARDS 16
+#define CACHE_LINE 64
+#define CACHE_NONE -1            // no entry / end of a queue
+#define OPTIMISTIC_RETRIES 8     // failed snapshots before taking the mutex
+#define S3FIFO_SMALL_PERCENT 10  // share of a shard given to the small FIFO
+#define S3FIFO_MAX_FREQ 3
+
+/**
+ * Index slot: key -> value + 1, empty when stored is 0
+ */
+typedef struct {
+    int key;
+    int stored;
+} CacheIndexSlot;
+
+/**
+ * Open-addressing hash index (linear probing, backward-shift delete)
+ * Sized once to at most 50% load, so it never rehashes.
+ */
+typedef struct {
+    CacheIndexSlot *slots;
+    int mask;
+} CacheIndex;
+
+/**
+ * Cached entry; prev/next link it into one of the policy's queues
+ */
+typedef struct {
+    int key;
+    int value;
+    int prev;
+    int next;
+    atomic_uchar freq;       // CLOCK reference bit / S3-FIFO counter
+    unsigned char queue;     // CACHE_QUEUE_*
+} CacheEntry;
+
+#define CACHE_QUEUE_MAIN 0
+#define CACHE_QUEUE_SMALL 1
+#define CACHE_QUEUE_FREE 2
+
+/**
+ * Doubly linked queue of entry slots: new at head, victims from tail
+ */
+typedef struct {
+    int head;
+    int tail;
+    int size;
+} CacheQueue;
+
+typedef struct CacheShard CacheShard;
+
+/**
+ * Eviction policy
+ * on_hit runs without the mutex unless hit_needs_lock is set.
+ * on_insert and evict run under the mutex; evict unlinks a victim from
+ * its queue and returns its slot.
+ */
+typedef struct {
+    const char *name;
+    int hit_needs_lock;
+    int uses_ghost;
+    void (*on_hit)(CacheShard *shard, int slot);
+    void (*on_insert)(CacheShard *shard, int slot);
+    int (*evict)(CacheShard *shard);
+} CachePolicy;
+
+/**
+ * One shard
+ * Aligned so neighbouring shards never share a cache line.
+ */
+struct CacheShard {
+    _Alignas(CACHE_LINE) atomic_uint seq;  // odd while a writer changes the index
+    pthread_mutex_t lock;
+    const CachePolicy *policy;
+    CacheEntry *entries;
+    int capacity;
+    int count;
+    int free_list;            // unused entries chained through next
+    CacheIndex index;
+    CacheQueue queues[2];     // CACHE_QUEUE_MAIN, CACHE_QUEUE_SMALL
+    int small_target;         // S3-FIFO small queue size
+    int *ghost_keys;          // S3-FIFO ghost FIFO (ring of evicted keys)
+    int ghost_capacity;
+    int ghost_count;
+    int ghost_next;
+    CacheIndex ghost_index;   // ghost key -> ring position
+};
+
+/**
+ * Sharded Cache structure
+ */
+typedef struct {
+    CacheShard *shards;
+    int shard_count;   // power of two
+    int shard_bits;
+    const CachePolicy *policy;
+} ShardedCache;
+
+/**
+ * 32-bit integer hash (murmur3 finalizer)
+ * Top bits pick the shard, low bits the index slot.
+ */
+uint32_t cache_hash(int key) {
+    uint32_t hash = (uint32_t)key;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ * Create an index for up to entries keys
+ */
+void cache_index_init(CacheIndex *index, int entries) {
+    int size = 16;
+    while (size < 2 * entries) {
+        size *= 2;
+    }
+    index->slots = (CacheIndexSlot *)calloc(size, sizeof(CacheIndexSlot));
+    index->mask = size - 1;
+}
+
+/**
+ * Position of key, or of the empty slot ending its probe run
+ * The probe is bounded so a reader racing a writer cannot spin forever;
+ * returns -1 if it gives up.
+ * Time Complexity: O(1) average
+ */
+int cache_index_find(const CacheIndex *index, int key) {
+    int pos = cache_hash(key) & index->mask;
+    
+    for (int i = 0; i <= index->mask; i++) {
+        const CacheIndexSlot *slot = &index->slots[pos];
+        if (slot->stored == 0 || slot->key == key) return pos;
+        pos = (pos + 1) & index->mask;
+    }
+    
+    return -1;
+}
+
+/**
+ * Value stored for key, or CACHE_NONE
+ * Time Complexity: O(1) average
+ */
+int cache_index_get(const CacheIndex *index, int key) {
+    int pos = cache_index_find(index, key);
+    if (pos < 0) return CACHE_NONE;
+    return index->slots[pos].stored - 1;
+}
+
+/**
+ * Map key to value, replacing any previous value
+ * Time Complexity: O(1) average
+ */
+void cache_index_set(CacheIndex *index, int key, int value) {
+    int pos = cache_index_find(index, key);
+    index->slots[pos].key = key;
+    index->slots[pos].stored = value + 1;
+}
+
+/**
+ * Unmap key, shifting later entries of the probe run back into the gap
+ * Time Complexity: O(1) average
+ */
+void cache_index_remove(CacheIndex *index, int key) {
+    int hole = cache_index_find(index, key);
+    if (hole < 0 || index->slots[hole].stored == 0) return;
+    
+    int pos = hole;
+    while (1) {
+        pos = (pos + 1) & index->mask;
+        if (index->slots[pos].stored == 0) break;
+        
+        // Move the entry back unless its home lies in (hole, pos]
+        int home = cache_hash(index->slots[pos].key) & index->mask;
+        if (((pos - home) & index->mask) >= ((pos - hole) & index->mask)) {
+            index->slots[hole] = index->slots[pos];
+            hole = pos;
+        }
+    }
+    
+    index->slots[hole].stored = 0;
+}
+
+/**
+ * Add slot at the head of a queue
+ * Time Complexity: O(1)
+ */
+void cache_queue_push(CacheShard *shard, int queue_id, int slot) {
+    CacheQueue *queue = &shard->queues[queue_id];
+    CacheEntry *entry = &shard->entries[slot];
+    
+    entry->queue = queue_id;
+    entry->prev = CACHE_NONE;
+    entry->next = queue->head;
+    
+    if (queue->head == CACHE_NONE) {
+        queue->tail = slot;
+    } else {
+        shard->entries[queue->head].prev = slot;
+    }
+    
+    queue->head = slot;
+    queue->size++;
+}
+
+/**
+ * Remove slot from whichever queue holds it
+ * Time Complexity: O(1)
+ */
+void cache_queue_unlink(CacheShard *shard, int slot) {
+    CacheEntry *entry = &shard->entries[slot];
+    CacheQueue *queue = &shard->queues[entry->queue];
+    
+    if (entry->prev != CACHE_NONE) {
+        shard->entries[entry->prev].next = entry->next;
+    } else {
+        queue->head = entry->next;
+    }
+    
+    if (entry->next != CACHE_NONE) {
+        shard->entries[entry->next].prev = entry->prev;
+    } else {
+        queue->tail = entry->prev;
+    }
+    
+    queue->size--;
+}
+
+/**
+ * Reader-side counter update: relaxed, and skipped when unchanged so hot
+ * entries are not written on every hit
+ */
+void cache_freq_bump(CacheEntry *entry, unsigned char max) {
+    unsigned char freq = atomic_load_explicit(&entry->freq, memory_order_relaxed);
+    if (freq < max) {
+        atomic_store_explicit(&entry->freq, freq + 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * LRU: hits move the entry to the head; the tail is the victim
+ * Time Complexity: O(1)
+ */
+void lru_on_hit(CacheShard *shard, int slot) {
+    if (shard->queues[CACHE_QUEUE_MAIN].head == slot) return;
+    cache_queue_unlink(shard, slot);
+    cache_queue_push(shard, CACHE_QUEUE_MAIN, slot);
+}
+
+void lru_on_insert(CacheShard *shard, int slot) {
+    cache_queue_push(shard, CACHE_QUEUE_MAIN, slot);
+}
+
+int lru_evict(CacheShard *shard) {
+    int slot = shard->queues[CACHE_QUEUE_MAIN].tail;
+    cache_queue_unlink(shard, slot);
+    return slot;
+}
+
+/**
+ * CLOCK: hits set the reference bit
+ * Time Complexity: O(1)
+ */
+void clock_on_hit(CacheShard *shard, int slot) {
+    cache_freq_bump(&shard->entries[slot], 1);
+}
+
+/**
+ * Second chance: referenced tail entries lose their bit and go back to
+ * the head. Readers may set bits meanwhile, so after one full lap the
+ * tail is taken regardless.
+ * Time Complexity: O(1) amortized
+ */
+int clock_evict(CacheShard *shard) {
+    CacheQueue *queue = &shard->queues[CACHE_QUEUE_MAIN];
+    
+    for (int lap = queue->size; lap > 0; lap--) {
+        int slot = queue->tail;
+        CacheEntry *entry = &shard->entries[slot];
+        if (atomic_load_explicit(&entry->freq, memory_order_relaxed) == 0) break;
+        
+        atomic_store_explicit(&entry->freq, 0, memory_order_relaxed);
+        cache_queue_unlink(shard, slot);
+        cache_queue_push(shard, CACHE_QUEUE_MAIN, slot);
+    }
+    
+    return lru_evict(shard);
+}
+
+/**
+ * S3-FIFO: hits raise the 2-bit frequency
+ * Time Complexity: O(1)
+ */
+void s3fifo_on_hit(CacheShard *shard, int slot) {
+    cache_freq_bump(&shard->entries[slot], S3FIFO_MAX_FREQ);
+}
+
+/**
+ * Remember an evicted key, overwriting the oldest ghost when full
+ */
+void s3fifo_ghost_add(CacheShard *shard, int key) {
+    int pos = shard->ghost_next;
+    
+    if (shard->ghost_count == shard->ghost_capacity) {
+        int old_key = shard->ghost_keys[pos];
+        if (cache_index_get(&shard->ghost_index, old_key) == pos) {
+            cache_index_remove(&shard->ghost_index, old_key);
+        }
+    } else {
+        shard->ghost_count++;
+    }
+    
+    shard->ghost_keys[pos] = key;
+    cache_index_set(&shard->ghost_index, key, pos);
+    shard->ghost_next = (pos + 1) % shard->ghost_capacity;
+}
+
+/**
+ * New keys go to the small FIFO, ghosts straight to main
+ */
+void s3fifo_on_insert(CacheShard *shard, int slot) {
+    int key = shard->entries[slot].key;
+    
+    if (cache_index_get(&shard->ghost_index, key) != CACHE_NONE) {
+        // Evicted recently and asked for again: skip probation
+        cache_index_remove(&shard->ghost_index, key);
+        cache_queue_push(shard, CACHE_QUEUE_MAIN, slot);
+    } else {
+        cache_queue_push(shard, CACHE_QUEUE_SMALL, slot);
+    }
+}
+
+/**
+ * Evict from small while it is over its share, otherwise from main
+ * Each pass either evicts or lowers a counter, so the loop ends; the
+ * pass budget only matters while readers keep raising counters.
+ * Time Complexity: O(1) amortized
+ */
+int s3fifo_evict(CacheShard *shard) {
+    CacheQueue *small = &shard->queues[CACHE_QUEUE_SMALL];
+    CacheQueue *main_queue = &shard->queues[CACHE_QUEUE_MAIN];
+    int budget = 4 * shard->capacity;
+    
+    while (1) {
+        int from_small = small->size >= shard->small_target || main_queue->size == 0;
+        int slot = from_small ? small->tail : main_queue->tail;
+        CacheEntry *entry = &shard->entries[slot];
+        unsigned char freq = atomic_load_explicit(&entry->freq, memory_order_relaxed);
+        
+        cache_queue_unlink(shard, slot);
+        
+        if (budget-- <= 0 || freq == 0) {
+            if (from_small) {
+                s3fifo_ghost_add(shard, entry->key);
+            }
+            return slot;
+        }
+        
+        if (from_small) {
+            // Hit while on probation: promote
+            atomic_store_explicit(&entry->freq, 0, memory_order_relaxed);
+        } else {
+            atomic_store_explicit(&entry->freq, freq - 1, memory_order_relaxed);
+        }
+        cache_queue_push(shard, CACHE_QUEUE_MAIN, slot);
+    }
+}
+
+const CachePolicy CACHE_POLICY_LRU = { "lru", 1, 0, lru_on_hit, lru_on_insert, lru_evict };
+const CachePolicy CACHE_POLICY_CLOCK = { "clock", 0, 0, clock_on_hit, lru_on_insert, clock_evict };
+const CachePolicy CACHE_POLICY_S3FIFO = { "s3fifo", 0, 1, s3fifo_on_hit, s3fifo_on_insert, s3fifo_evict };
+
+/**
+ * Look up a policy by name ("lru", "clock", "s3fifo")
+ * Returns NULL for unknown names
+ */
+const CachePolicy *cache_policy_by_name(const char *name) {
+    if (strcmp(name, "lru") == 0) return &CACHE_POLICY_LRU;
+    if (strcmp(name, "clock") == 0) return &CACHE_POLICY_CLOCK;
+    if (strcmp(name, "s3fifo") == 0) return &CACHE_POLICY_S3FIFO;
+    return NULL;
+}
+
+/**
+ * Create sharded cache holding up to capacity entries in total
+ * shard_count is rounded up to a power of two; each shard gets an
+ * equal share of capacity (at least one entry).
+ * Time Complexity: O(capacity)
+ */
+ShardedCache *sharded_cache_create(int shard_count, int capacity, const CachePolicy *policy) {
+    ShardedCache *cache = (ShardedCache *)malloc(sizeof(ShardedCache));
+    cache->shard_bits = 0;
+    while ((1 << cache->shard_bits) < shard_count) {
+        cache->shard_bits++;
+    }
+    cache->shard_count = 1 << cache->shard_bits;
+    cache->policy = policy;
+    cache->shards = (CacheShard *)aligned_alloc(CACHE_LINE, cache->shard_count * sizeof(CacheShard));
+    
+    int per_shard = (capacity + cache->shard_count - 1) / cache->shard_count;
+    if (per_shard < 1) per_shard = 1;
+    
+    for (int i = 0; i < cache->shard_count; i++) {
+        CacheShard *shard = &cache->shards[i];
+        memset(shard, 0, sizeof(CacheShard));
+        atomic_init(&shard->seq, 0);
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->policy = policy;
+        shard->capacity = per_shard;
+        
+        // All entries start on the free list
+        shard->entries = (CacheEntry *)calloc(per_shard, sizeof(CacheEntry));
+        for (int e = 0; e < per_shard; e++) {
+            shard->entries[e].queue = CACHE_QUEUE_FREE;
+            shard->entries[e].next = e + 1 < per_shard ? e + 1 : CACHE_NONE;
+        }
+        shard->free_list = 0;
+        cache_index_init(&shard->index, per_shard);
+        
+        for (int q = 0; q < 2; q++) {
+            shard->queues[q].head = CACHE_NONE;
+            shard->queues[q].tail = CACHE_NONE;
+        }
+        
+        if (policy->uses_ghost) {
+            shard->small_target = per_shard * S3FIFO_SMALL_PERCENT / 100;
+            if (shard->small_target < 1) shard->small_target = 1;
+            shard->ghost_capacity = per_shard - shard->small_target;
+            if (shard->ghost_capacity < 1) shard->ghost_capacity = 1;
+            shard->ghost_keys = (int *)malloc(shard->ghost_capacity * sizeof(int));
+            cache_index_init(&shard->ghost_index, shard->ghost_capacity);
+        }
+    }
+    
+    return cache;
+}
+
+/**
+ * Shard owning a hash (top bits; the low bits pick the index slot)
+ */
+CacheShard *sharded_cache_shard_for(ShardedCache *cache, uint32_t hash) {
+    if (cache->shard_bits == 0) return &cache->shards[0];
+    return &cache->shards[hash >> (32 - cache->shard_bits)];
+}
+
+/**
+ * Enter / leave a change to the shard's index: make the sequence odd,
+ * then even again (caller holds the mutex)
+ */
+void sharded_cache_write_begin(CacheShard *shard) {
+    atomic_store(&shard->seq, atomic_load_explicit(&shard->seq, memory_order_relaxed) + 1);
+}
+
+void sharded_cache_write_end(CacheShard *shard) {
+    atomic_store(&shard->seq, atomic_load_explicit(&shard->seq, memory_order_relaxed) + 1);
+}
+
+/**
+ * Drop an entry already unlinked from its queue (inside a write)
+ */
+void sharded_cache_release(CacheShard *shard, int slot) {
+    CacheEntry *entry = &shard->entries[slot];
+    cache_index_remove(&shard->index, entry->key);
+    entry->queue = CACHE_QUEUE_FREE;
+    entry->next = shard->free_list;
+    shard->free_list = slot;
+    shard->count--;
+}
+
+/**
+ * Look up key, copying its value to value_out
+ * Lock-free unless writers keep invalidating the snapshot; LRU hits
+ * also try the mutex to reorder.
+ * Returns 1 on a hit, 0 on a miss
+ * Time Complexity: O(1) average
+ */
+int sharded_cache_get(ShardedCache *cache, int key, int *value_out) {
+    CacheShard *shard = sharded_cache_shard_for(cache, cache_hash(key));
+    const CachePolicy *policy = shard->policy;
+    
+    for (int attempt = 0; attempt < OPTIMISTIC_RETRIES; attempt++) {
+        unsigned int seq = atomic_load(&shard->seq);
+        if (seq & 1) continue;  // Writer active
+        
+        int slot = cache_index_get(&shard->index, key);
+        int value = slot >= 0 && slot < shard->capacity ? shard->entries[slot].value : 0;
+        
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load(&shard->seq) != seq) continue;
+        
+        if (slot == CACHE_NONE) return 0;
+        *value_out = value;
+        
+        // Record the hit; a bit set on a since-replaced entry is harmless
+        if (!policy->hit_needs_lock) {
+            policy->on_hit(shard, slot);
+        } else if (pthread_mutex_trylock(&shard->lock) == 0) {
+            if (shard->entries[slot].key == key && shard->entries[slot].queue != CACHE_QUEUE_FREE) {
+                policy->on_hit(shard, slot);
+            }
+            pthread_mutex_unlock(&shard->lock);
+        }
+        return 1;
+    }
+    
+    // Fall back to reading under the mutex
+    pthread_mutex_lock(&shard->lock);
+    int slot = cache_index_get(&shard->index, key);
+    if (slot != CACHE_NONE) {
+        *value_out = shard->entries[slot].value;
+        policy->on_hit(shard, slot);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    
+    return slot != CACHE_NONE;
+}
+
+/**
+ * Insert or update key; evicts one entry when the shard is full
+ * Time Complexity: O(1) average (amortized over CLOCK / S3-FIFO laps)
+ */
+void sharded_cache_put(ShardedCache *cache, int key, int value) {
+    CacheShard *shard = sharded_cache_shard_for(cache, cache_hash(key));
+    pthread_mutex_lock(&shard->lock);
+    
+    int slot = cache_index_get(&shard->index, key);
+    if (slot != CACHE_NONE) {
+        sharded_cache_write_begin(shard);
+        shard->entries[slot].value = value;
+        sharded_cache_write_end(shard);
+        shard->policy->on_hit(shard, slot);
+        pthread_mutex_unlock(&shard->lock);
+        return;
+    }
+    
+    sharded_cache_write_begin(shard);
+    
+    if (shard->count == shard->capacity) {
+        sharded_cache_release(shard, shard->policy->evict(shard));
+    }
+    
+    slot = shard->free_list;
+    CacheEntry *entry = &shard->entries[slot];
+    shard->free_list = entry->next;
+    entry->key = key;
+    entry->value = value;
+    atomic_store_explicit(&entry->freq, 0, memory_order_relaxed);
+    cache_index_set(&shard->index, key, slot);
+    shard->count++;
+    shard->policy->on_insert(shard, slot);
+    
+    sharded_cache_write_end(shard);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+/**
+ * Remove key
+ * Returns 1 if it was cached
+ * Time Complexity: O(1) average
+ */
+int sharded_cache_delete(ShardedCache *cache, int key) {
+    CacheShard *shard = sharded_cache_shard_for(cache, cache_hash(key));
+    pthread_mutex_lock(&shard->lock);
+    
+    int slot = cache_index_get(&shard->index, key);
+    if (slot != CACHE_NONE) {
+        sharded_cache_write_begin(shard);
+        cache_queue_unlink(shard, slot);
+        sharded_cache_release(shard, slot);
+        sharded_cache_write_end(shard);
+    }
+    
+    pthread_mutex_unlock(&shard->lock);
+    return slot != CACHE_NONE;
+}
+
+/**
+ * Total cached entries (not atomic across shards)
+ * Time Complexity: O(s) where s = shard count
+ */
+int sharded_cache_count(ShardedCache *cache) {
+    int count = 0;
+    for (int i = 0; i < cache->shard_count; i++) {
+        pthread_mutex_lock(&cache->shards[i].lock);
+        count += cache->shards[i].count;
+        pthread_mutex_unlock(&cache->shards[i].lock);
+    }
+    return count;
+}
+
+/**
+ * Free cache; no other thread may be using it
+ */
+void sharded_cache_free(ShardedCache *cache) {
+    for (int i = 0; i < cache->shard_count; i++) {
+        CacheShard *shard = &cache->shards[i];
+        free(shard->entries);
+        free(shard->index.slots);
+        free(shard->ghost_keys);
+        free(shard->ghost_index.slots);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+#ifndef SHARDED_CACHE_NO_MAIN
+
+#define BENCH_KEYS (1 << 20)         // distinct bookmarks
+#define BENCH_CAPACITY (1 << 16)     // cache holds 1/16 of them
+#define BENCH_SAMPLES (1 << 22)      // pre-drawn Zipf keys shared by threads
+#define BENCH_OPS_PER_THREAD 2000000
+#define BENCH_ZIPF_SKEW 0.99
+
+/**
+ * Per-thread benchmark arguments
+ */
+typedef struct {
+    ShardedCache *cache;
+    const int *samples;
+    unsigned int seed;
+    long hits;
+} BenchWorker;
+
+/**
+ * Draw BENCH_SAMPLES keys with Zipf(BENCH_ZIPF_SKEW) popularity
+ * Rank r is mapped to key r * odd constant so hot keys are not adjacent.
+ */
+int *bench_zipf_samples(void) {
+    double *cdf = (double *)malloc(BENCH_KEYS * sizeof(double));
+    double sum = 0;
+    for (int r = 0; r < BENCH_KEYS; r++) {
+        sum += 1.0 / pow(r + 1, BENCH_ZIPF_SKEW);
+        cdf[r] = sum;
+    }
+    
+    int *samples = (int *)malloc(BENCH_SAMPLES * sizeof(int));
+    unsigned int state = 88172645u;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        double target = (double)state / 4294967296.0 * sum;
+        
+        int lo = 0, hi = BENCH_KEYS - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < target) lo = mid + 1; else hi = mid;
+        }
+        samples[i] = (int)((unsigned int)lo * 2654435761u & 0x7fffffff);
+    }
+    
+    free(cdf);
+    return samples;
+}
+
+/**
+ * Benchmark worker: look up a visited bookmark, load it on a miss
+ */
+void *bench_worker_run(void *arg) {
+    BenchWorker *worker = (BenchWorker *)arg;
+    unsigned int state = worker->seed;
+    int value;
+    
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int key = worker->samples[state & (BENCH_SAMPLES - 1)];
+        
+        if (sharded_cache_get(worker->cache, key, &value)) {
+            worker->hits++;
+        } else {
+            sharded_cache_put(worker->cache, key, key);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Wall-clock seconds
+ */
+double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Run the workload under one policy on 1, 2, 4 ... max_threads threads
+ * (fresh cache each time) and print throughput and hit ratio
+ */
+void bench_policy(const CachePolicy *policy, const int *samples, int max_threads) {
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+        
+        ShardedCache *cache = sharded_cache_create(DEFAULT_SHARDS, BENCH_CAPACITY, policy);
+        pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+        BenchWorker *workers = (BenchWorker *)calloc(threads, sizeof(BenchWorker));
+        
+        double start = bench_now();
+        for (int t = 0; t < threads; t++) {
+            workers[t].cache = cache;
+            workers[t].samples = samples;
+            workers[t].seed = 2463534242u + t * 7919;
+            pthread_create(&ids[t], NULL, bench_worker_run, &workers[t]);
+        }
+        long hits = 0;
+        for (int t = 0; t < threads; t++) {
+            pthread_join(ids[t], NULL);
+            hits += workers[t].hits;
+        }
+        double elapsed = bench_now() - start;
+        
+        double ops = (double)threads * BENCH_OPS_PER_THREAD;
+        printf("%-8s %8d %12.2f %9.2f%%\n", policy->name, threads, ops / elapsed / 1e6,
+               100.0 * hits / ops);
+        
+        free(ids);
+        free(workers);
+        sharded_cache_free(cache);
+        if (threads == max_threads) break;
+    }
+}
+
+/**
+ * Demonstration program and hit-ratio / throughput benchmark
+ */
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < 1) max_threads = 1;
+    
+    printf("=== Sharded Concurrent Cache in C ===\n");
+    printf("Shards: %d, writers: per-shard mutex, lookups: seqlock snapshots\n", DEFAULT_SHARDS);
+    printf("Policies: lru, clock, s3fifo\n\n");
+    
+    // Small single-shard caches show each policy's choice of victim
+    printf("--- Eviction with 4 entries: visit 1 2 3 4, revisit 1 2, then scan 5 6 7 ---\n");
+    const CachePolicy *policies[] = { &CACHE_POLICY_LRU, &CACHE_POLICY_CLOCK, &CACHE_POLICY_S3FIFO };
+    for (int p = 0; p < 3; p++) {
+        ShardedCache *cache = sharded_cache_create(1, 4, policies[p]);
+        int value;
+        
+        for (int key = 1; key <= 4; key++) {
+            sharded_cache_put(cache, key, key * 100);
+        }
+        sharded_cache_get(cache, 1, &value);
+        sharded_cache_get(cache, 2, &value);
+        for (int key = 5; key <= 7; key++) {
+            sharded_cache_put(cache, key, key * 100);
+        }
+        
+        printf("%-8s cached:", policies[p]->name);
+        for (int key = 1; key <= 7; key++) {
+            if (sharded_cache_get(cache, key, &value)) {
+                printf(" %d", key);
+            }
+        }
+        printf("  (%d entries)\n", sharded_cache_count(cache));
+        
+        sharded_cache_free(cache);
+    }
+    
+    // Benchmark
+    printf("\n--- Benchmark: %d keys, Zipf %.2f, capacity %d, %d ops/thread ---\n",
+           BENCH_KEYS, BENCH_ZIPF_SKEW, BENCH_CAPACITY, BENCH_OPS_PER_THREAD);
+    int *samples = bench_zipf_samples();
+    
+    printf("%-8s %8s %12s %10s\n", "policy", "threads", "Mops/s", "hit ratio");
+    for (int p = 0; p < 3; p++) {
+        bench_policy(policies[p], samples, max_threads);
+    }
+    
+    free(samples);
+    printf("\nSharded cache benchmark done.\n");
+    
+    return 0;
+}
+
+#endif
@@ -0,0 +1,528 @@
+/**
+ * Sharded Concurrent Hash Table in C
+ * Thread-safe wrapper over hash_table.c for many worker threads
+ * 
+ * Keys are spread over a power-of-two number of shards by the top bits of
+ * their hash. Each shard is an ordinary HashTable guarded by a mutex that
+ * serialises writers and a sequence counter (seqlock) that writers keep
+ * odd while they modify the shard.
+ * 
+ * Readers take no lock. They snapshot the shard's slot arrays, check the
+ * sequence counter, probe the snapshot, copy the value out and check the
+ * counter again; on a mismatch they retry, and after a few failed
+ * attempts fall back to the writer mutex.
+ * 
+ * Memory a writer drops (drained generations, outgrown arenas) may still
+ * be under an optimistic reader, so it is not freed right away. Readers
+ * announce the global epoch they started in, dropped blocks are tagged
+ * with the epoch they were retired in, and a block is freed once every
+ * active reader has announced a later epoch (epoch-based reclamation).
+ * 
+ * Compile: gcc -O2 -pthread -DHASH_TABLE_NO_MAIN -o sharded_hash_table sharded_hash_table.c hash_table.c
+ * Run: ./sharded_hash_table [max_threads]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hash_table.h"
+
+#define DEFAULT_SHARDS 64
+#define CACHE_LINE 64
+#define MAX_READERS 128          // threads that can read optimistically
+#define OPTIMISTIC_RETRIES 8     // failed snapshots before taking the mutex
+#define RECLAIM_BATCH 32         // retired blocks before trying to free them
+
+/**
+ * Block dropped by a writer, freed once no reader can reach it
+ */
+typedef struct {
+    void *ptr;
+    unsigned long epoch;
+} RetiredBlock;
+
+/**
+ * One shard: a plain hash table plus its seqlock and writer mutex
+ * Aligned so neighbouring shards never share a cache line.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_uint seq;  // odd while a writer is active
+    pthread_mutex_t write_lock;
+    HashTable *ht;
+    RetiredBlock *retired;
+    int retired_count;
+    int retired_capacity;
+    long retired_total;          // blocks ever retired (stats)
+} HashShard;
+
+/**
+ * Sharded Hash Table structure
+ */
+typedef struct {
+    HashShard *shards;
+    int shard_count;   // power of two
+    int shard_bits;
+    HashFunction hash_fn;
+} ShardedHashTable;
+
+/**
+ * Epoch announced by one reader thread, 0 while it is not reading
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_ulong epoch;
+} ReaderSlot;
+
+ReaderSlot reader_slots[MAX_READERS];
+atomic_ulong global_epoch = 1;
+atomic_int reader_slots_used = 0;
+
+_Thread_local int reader_slot = -1;
+
+/**
+ * Release hook of each shard's table (context = the shard)
+ * Shard tables only drop memory under the shard's write lock, so the
+ * block is retired there and freed by sharded_reclaim.
+ * Time Complexity: O(1) amortized
+ */
+void sharded_retire(void *ptr, void *context) {
+    HashShard *shard = (HashShard *)context;
+    if (!ptr) return;
+    
+    if (shard->retired_count == shard->retired_capacity) {
+        shard->retired_capacity = shard->retired_capacity ? shard->retired_capacity * 2 : 16;
+        shard->retired = (RetiredBlock *)realloc(shard->retired,
+                                                 shard->retired_capacity * sizeof(RetiredBlock));
+    }
+    
+    RetiredBlock *block = &shard->retired[shard->retired_count++];
+    block->ptr = ptr;
+    block->epoch = atomic_fetch_add(&global_epoch, 1);
+    shard->retired_total++;
+}
+
+/**
+ * Free retired blocks that no active reader can still reach
+ * Time Complexity: O(r + t) where r = retired blocks, t = reader threads
+ */
+void sharded_reclaim(HashShard *shard) {
+    unsigned long oldest = (unsigned long)-1;
+    int readers = atomic_load(&reader_slots_used);
+    if (readers > MAX_READERS) readers = MAX_READERS;
+    
+    for (int i = 0; i < readers; i++) {
+        unsigned long epoch = atomic_load(&reader_slots[i].epoch);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    
+    int kept = 0;
+    for (int i = 0; i < shard->retired_count; i++) {
+        if (shard->retired[i].epoch < oldest) {
+            free(shard->retired[i].ptr);
+        } else {
+            shard->retired[kept++] = shard->retired[i];
+        }
+    }
+    shard->retired_count = kept;
+}
+
+/**
+ * Create sharded hash table
+ * shard_count is rounded up to a power of two
+ * Time Complexity: O(s) where s = shard count
+ */
+ShardedHashTable *sharded_hash_table_create(int shard_count, int initial_size_per_shard) {
+    ShardedHashTable *sht = (ShardedHashTable *)malloc(sizeof(ShardedHashTable));
+    sht->shard_bits = 0;
+    while ((1 << sht->shard_bits) < shard_count) {
+        sht->shard_bits++;
+    }
+    sht->shard_count = 1 << sht->shard_bits;
+    sht->hash_fn = hash_wy;
+    sht->shards = (HashShard *)aligned_alloc(CACHE_LINE, sht->shard_count * sizeof(HashShard));
+    
+    for (int i = 0; i < sht->shard_count; i++) {
+        HashShard *shard = &sht->shards[i];
+        atomic_init(&shard->seq, 0);
+        pthread_mutex_init(&shard->write_lock, NULL);
+        shard->ht = hash_table_create_with(initial_size_per_shard, sht->hash_fn, sharded_retire, shard);
+        shard->retired = NULL;
+        shard->retired_count = 0;
+        shard->retired_capacity = 0;
+        shard->retired_total = 0;
+    }
+    
+    return sht;
+}
+
+/**
+ * Shard owning a hash (top bits; the low bits pick tag and group)
+ */
+HashShard *sharded_shard_for(ShardedHashTable *sht, unsigned int hash) {
+    if (sht->shard_bits == 0) return &sht->shards[0];
+    return &sht->shards[hash >> (32 - sht->shard_bits)];
+}
+
+/**
+ * Fold a key's hash the same way the shard tables do
+ */
+unsigned int sharded_hash(ShardedHashTable *sht, const char *key, int key_len) {
+    unsigned long long hash = sht->hash_fn(key, key_len);
+    return (unsigned int)(hash ^ (hash >> 32));
+}
+
+/**
+ * Enter / leave a shard write: lock and make the sequence odd; then make
+ * it even again, free what readers can no longer reach and unlock
+ */
+void sharded_write_begin(HashShard *shard) {
+    pthread_mutex_lock(&shard->write_lock);
+    atomic_store(&shard->seq, atomic_load_explicit(&shard->seq, memory_order_relaxed) + 1);
+}
+
+void sharded_write_end(HashShard *shard) {
+    atomic_store(&shard->seq, atomic_load_explicit(&shard->seq, memory_order_relaxed) + 1);
+    
+    if (shard->retired_count >= RECLAIM_BATCH) {
+        sharded_reclaim(shard);
+    }
+    pthread_mutex_unlock(&shard->write_lock);
+}
+
+/**
+ * Insert key-value pair
+ * Time Complexity: O(1) average
+ */
+void sharded_hash_table_insert(ShardedHashTable *sht, const char *key, const char *value) {
+    if (!key || !value) return;
+    
+    HashShard *shard = sharded_shard_for(sht, sharded_hash(sht, key, strlen(key)));
+    sharded_write_begin(shard);
+    hash_table_insert(shard->ht, key, value);
+    sharded_write_end(shard);
+}
+
+/**
+ * Delete key-value pair
+ * Time Complexity: O(1) average
+ */
+int sharded_hash_table_delete(ShardedHashTable *sht, const char *key) {
+    if (!key) return 0;
+    
+    HashShard *shard = sharded_shard_for(sht, sharded_hash(sht, key, strlen(key)));
+    sharded_write_begin(shard);
+    int deleted = hash_table_delete(shard->ht, key);
+    sharded_write_end(shard);
+    return deleted;
+}
+
+/**
+ * Probe a snapshot of one generation and copy the value out
+ * Every offset read from the (possibly changing) entries is bounds
+ * checked against the snapshot, so a concurrent writer can only make the
+ * result wrong, never the access invalid.
+ * Returns 1 if found, 0 if absent, -1 if the snapshot is inconsistent
+ * Time Complexity: O(1) average
+ */
+int sharded_probe(const HashBuckets *buckets, const char *key, int key_len, unsigned int hash,
+                  char *value_out, int value_size) {
+    if (!buckets->ctrl) return 0;
+    
+    int num_groups = buckets->size / GROUP_WIDTH;
+    if (num_groups <= 0 || (num_groups & (num_groups - 1))) return -1;
+    
+    int group = hash_home_group(hash, buckets->size);
+    unsigned char tag = hash_tag(hash);
+    
+    for (int i = 0; i < num_groups; i++) {
+        const unsigned char *ctrl = buckets->ctrl + group * GROUP_WIDTH;
+        unsigned int mask = group_match(ctrl, tag);
+        
+        while (mask) {
+            HashEntry entry = buckets->entries[group * GROUP_WIDTH + __builtin_ctz(mask)];
+            mask &= mask - 1;
+            
+            if (entry.hash != hash || entry.key_len != key_len) continue;
+            if (entry.key_offset > buckets->arena.capacity ||
+                (size_t)key_len > buckets->arena.capacity - entry.key_offset) return -1;
+            if (memcmp(buckets->arena.bytes + entry.key_offset, key, key_len) != 0) continue;
+            
+            if (entry.value_len < 0 || entry.value_offset > buckets->arena.capacity ||
+                (size_t)entry.value_len > buckets->arena.capacity - entry.value_offset) return -1;
+            int len = entry.value_len < value_size - 1 ? entry.value_len : value_size - 1;
+            memcpy(value_out, buckets->arena.bytes + entry.value_offset, len);
+            value_out[len] = '\0';
+            return 1;
+        }
+        
+        if (group_match(ctrl, CTRL_EMPTY)) {
+            return 0;
+        }
+        group = (group + 1) & (num_groups - 1);
+    }
+    
+    return 0;
+}
+
+/**
+ * Reader slot of the calling thread, -1 if all slots are taken
+ */
+int sharded_reader_slot(void) {
+    if (reader_slot == -1) {
+        int slot = atomic_fetch_add(&reader_slots_used, 1);
+        reader_slot = slot < MAX_READERS ? slot : -2;
+    }
+    return reader_slot;
+}
+
+/**
+ * Retrieve value by key, copied into value_out (value_size bytes)
+ * Lock-free unless writers keep invalidating the snapshot.
+ * Returns 1 if found, 0 if not
+ * Time Complexity: O(1) average
+ */
+int sharded_hash_table_get(ShardedHashTable *sht, const char *key, char *value_out, int value_size) {
+    if (!key || value_size <= 0) return 0;
+    
+    int key_len = strlen(key);
+    unsigned int hash = sharded_hash(sht, key, key_len);
+    HashShard *shard = sharded_shard_for(sht, hash);
+    HashTable *ht = shard->ht;
+    int slot = sharded_reader_slot();
+    
+    if (slot >= 0) {
+        atomic_store(&reader_slots[slot].epoch, atomic_load(&global_epoch));
+        
+        for (int attempt = 0; attempt < OPTIMISTIC_RETRIES; attempt++) {
+            unsigned int seq = atomic_load(&shard->seq);
+            if (seq & 1) continue;  // Writer active
+            
+            HashBuckets table = ht->table;
+            HashBuckets old_table = ht->old_table;
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load(&shard->seq) != seq) continue;
+            
+            int found = sharded_probe(&table, key, key_len, hash, value_out, value_size);
+            if (found == 0) {
+                found = sharded_probe(&old_table, key, key_len, hash, value_out, value_size);
+            }
+            
+            atomic_thread_fence(memory_order_acquire);
+            if (found >= 0 && atomic_load(&shard->seq) == seq) {
+                atomic_store(&reader_slots[slot].epoch, 0);
+                return found;
+            }
+        }
+        
+        atomic_store(&reader_slots[slot].epoch, 0);
+    }
+    
+    // Fall back to reading under the writer mutex
+    pthread_mutex_lock(&shard->write_lock);
+    char *value = hash_table_get(ht, key);
+    if (value) {
+        strncpy(value_out, value, value_size - 1);
+        value_out[value_size - 1] = '\0';
+    }
+    pthread_mutex_unlock(&shard->write_lock);
+    
+    return value != NULL;
+}
+
+/**
+ * Total live entries (not atomic across shards)
+ * Time Complexity: O(s) where s = shard count
+ */
+int sharded_hash_table_count(ShardedHashTable *sht) {
+    int count = 0;
+    for (int i = 0; i < sht->shard_count; i++) {
+        pthread_mutex_lock(&sht->shards[i].write_lock);
+        count += sht->shards[i].ht->count;
+        pthread_mutex_unlock(&sht->shards[i].write_lock);
+    }
+    return count;
+}
+
+/**
+ * Free sharded table; no other thread may be using it
+ */
+void sharded_hash_table_free(ShardedHashTable *sht) {
+    for (int i = 0; i < sht->shard_count; i++) {
+        HashShard *shard = &sht->shards[i];
+        hash_table_free(shard->ht);
+        for (int j = 0; j < shard->retired_count; j++) {
+            free(shard->retired[j].ptr);
+        }
+        free(shard->retired);
+        pthread_mutex_destroy(&shard->write_lock);
+    }
+    free(sht->shards);
+    free(sht);
+}
+
+#ifndef SHARDED_HASH_TABLE_NO_MAIN
+
+#define BENCH_KEYS (1 << 18)
+#define BENCH_OPS_PER_THREAD 2000000
+
+/**
+ * Per-thread benchmark arguments
+ */
+typedef struct {
+    ShardedHashTable *sht;
+    char **keys;
+    int write_percent;
+    int churn;                   // writes delete and reinsert the key
+    unsigned int seed;
+    long hits;
+} BenchWorker;
+
+/**
+ * Benchmark worker: random lookups with a share of updates
+ * Churning writes delete the key and reinsert it with a fresh value, so
+ * tombstones, arena growth and rehashes retire blocks while readers run
+ */
+void *bench_worker_run(void *arg) {
+    BenchWorker *worker = (BenchWorker *)arg;
+    unsigned int state = worker->seed;
+    char value[64];
+    
+    for (int i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        char *key = worker->keys[state % BENCH_KEYS];
+        
+        if ((int)(state >> 25) % 100 < worker->write_percent) {
+            if (worker->churn) {
+                snprintf(value, sizeof(value), "reinserted %d", i);
+                sharded_hash_table_delete(worker->sht, key);
+                sharded_hash_table_insert(worker->sht, key, value);
+            } else {
+                sharded_hash_table_insert(worker->sht, key, "updated");
+            }
+        } else {
+            worker->hits += sharded_hash_table_get(worker->sht, key, value, sizeof(value));
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Wall-clock seconds
+ */
+double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Run the workload on 1, 2, 4 ... max_threads threads and print
+ * throughput and speedup over one thread
+ */
+void bench_scaling(ShardedHashTable *sht, char **keys, int max_threads, int write_percent, int churn) {
+    printf("\n%d%% writes%s:\n", write_percent, churn ? " (delete + reinsert)" : "");
+    printf("%8s %12s %10s\n", "threads", "Mops/s", "speedup");
+    
+    double base = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+        
+        pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+        BenchWorker *workers = (BenchWorker *)calloc(threads, sizeof(BenchWorker));
+        
+        double start = bench_now();
+        for (int t = 0; t < threads; t++) {
+            workers[t].sht = sht;
+            workers[t].keys = keys;
+            workers[t].write_percent = write_percent;
+            workers[t].churn = churn;
+            workers[t].seed = 2463534242u + t * 7919;
+            pthread_create(&ids[t], NULL, bench_worker_run, &workers[t]);
+        }
+        for (int t = 0; t < threads; t++) {
+            pthread_join(ids[t], NULL);
+        }
+        double elapsed = bench_now() - start;
+        
+        double mops = (double)threads * BENCH_OPS_PER_THREAD / elapsed / 1e6;
+        if (threads == 1) base = mops;
+        printf("%8d %12.2f %9.2fx\n", threads, mops, mops / base);
+        
+        free(ids);
+        free(workers);
+        if (threads == max_threads) break;
+    }
+}
+
+/**
+ * Demonstration program and scaling benchmark
+ */
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < 1) max_threads = 1;
+    
+    printf("=== Sharded Concurrent Hash Table in C ===\n");
+    printf("Shards: %d, writers: per-shard mutex, readers: seqlock snapshots\n\n", DEFAULT_SHARDS);
+    
+    ShardedHashTable *sht = sharded_hash_table_create(DEFAULT_SHARDS, 16);
+    
+    // Basic operations
+    printf("--- Basic operations ---\n");
+    sharded_hash_table_insert(sht, "github.com", "GitHub");
+    sharded_hash_table_insert(sht, "stackoverflow.com", "Stack Overflow");
+    sharded_hash_table_insert(sht, "mdn.io", "MDN Web Docs");
+    
+    char value[VALUE_SIZE];
+    if (sharded_hash_table_get(sht, "github.com", value, sizeof(value))) {
+        printf("✓ Found: github.com → %s\n", value);
+    }
+    sharded_hash_table_delete(sht, "mdn.io");
+    if (!sharded_hash_table_get(sht, "mdn.io", value, sizeof(value))) {
+        printf("✓ Deleted: mdn.io\n");
+    }
+    
+    // Scaling benchmark
+    printf("\n--- Scaling benchmark (%d keys, %d ops/thread) ---\n", BENCH_KEYS, BENCH_OPS_PER_THREAD);
+    char **keys = (char **)malloc(BENCH_KEYS * sizeof(char *));
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        char key[64];
+        snprintf(key, sizeof(key), "https://www.example.com/bookmark/%d", i);
+        keys[i] = (char *)malloc(strlen(key) + 1);
+        strcpy(keys[i], key);
+        sharded_hash_table_insert(sht, keys[i], "initial");
+    }
+    printf("Loaded %d entries\n", sharded_hash_table_count(sht));
+    
+    bench_scaling(sht, keys, max_threads, 0, 0);
+    bench_scaling(sht, keys, max_threads, 5, 0);
+    bench_scaling(sht, keys, max_threads, 5, 1);
+    
+    long retired = 0;
+    int pending = 0;
+    for (int i = 0; i < sht->shard_count; i++) {
+        retired += sht->shards[i].retired_total;
+        pending += sht->shards[i].retired_count;
+    }
+    printf("Retired %ld blocks, %d still awaiting reclamation\n", retired, pending);
+    printf("Entries after churn: %d\n", sharded_hash_table_count(sht));
+    
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        free(keys[i]);
+    }
+    free(keys);
+    
+    sharded_hash_table_free(sht);
+    printf("\nSharded hash table freed.\n");
+    
+    return 0;
+}
+
+#endif
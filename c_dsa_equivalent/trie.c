@@ -2,100 +2,584 @@
  * Trie (Prefix Tree) Implementation in C
  * Efficiently stores strings and enables prefix search
  * 
- * Compile: gcc -o trie trie.c
- * Run: ./trie
+ * Adaptive radix tree (ART) layout: chains of single-child nodes are
+ * collapsed into a compressed prefix stored inline after the node, and
+ * each node only carries as many child slots as it needs:
+ *   Leaf    - no children
+ *   Node4   - up to 4 sorted keys + child pointers
+ *   Node16  - up to 16 sorted keys + child pointers
+ *   Node48  - 256-byte index into 48 child pointers
+ *   Node256 - direct array of 256 child pointers
+ * Nodes grow and shrink between these types as children come and go.
+ * Keys are arbitrary bytes, so UTF-8 titles, digits and punctuation are
+ * indexed directly; a sparse title only pays for the slots it uses.
+ * 
+ * Nodes live in a NodeArena (node_arena.c) and link to each other with
+ * 32-bit handles, so a Node256 is 1 KB of links instead of 2 KB and the
+ * whole trie is released slab by slab instead of node by node.
+ * 
+ * Fuzzy completion (trie_search_fuzzy) walks the trie in step with a
+ * Levenshtein automaton over the query, so "githbu" still finds
+ * "github": only paths within the edit limit are visited, and a subtree
+ * is ranked by its max_score once its distance is settled.
+ * 
+ * Compile: gcc -O2 -o trie trie.c node_arena.c
+ * Run: ./trie [fuzzy_benchmark_words]
  */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 #include <ctype.h>
+#include <time.h>
 
-#define ALPHABET_SIZE 26
+#include "trie.h"
 
 /**
- * Trie Node structure
+ * Arena size classes: node bodies plus room for their compressed prefix
+ * (largest: Node256 with a full-length prefix)
  */
-typedef struct TrieNode {
-    struct TrieNode *children[ALPHABET_SIZE];
-    int is_end_of_word;
-    char word[256];
-} TrieNode;
+static const unsigned int TRIE_SIZE_CLASSES[] = {
+    24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536
+};
 
 /**
- * Trie structure
+ * Lowercase one code point for the scripts titles mostly use
+ * (ASCII, Latin-1, Latin Extended-A, Greek, Cyrillic). Every mapping
+ * keeps the UTF-8 encoded length, so folding never moves bytes.
  */
-typedef struct {
-    TrieNode *root;
-    int word_count;
-} Trie;
+unsigned int trie_fold_codepoint(unsigned int cp) {
+    if (cp < 0x80) return tolower(cp);
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+    if (cp >= 0x100 && cp <= 0x137) return cp | 1;
+    if (cp >= 0x139 && cp <= 0x148) return cp + (cp & 1);
+    if (cp >= 0x14A && cp <= 0x177) return cp | 1;
+    if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20;
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+    return cp;
+}
 
 /**
- * Convert character to index (a/A = 0, b/B = 1, ... z/Z = 25)
+ * Case-fold UTF-8 bytes in place
+ * Malformed sequences and code points without a mapping are kept as-is.
+ * Time Complexity: O(m) where m = length
  */
-int char_to_index(char c) {
-    return tolower(c) - 'a';
+void trie_fold_bytes(unsigned char *key, int length) {
+    for (int i = 0; i < length; ) {
+        unsigned char c = key[i];
+        
+        if (c < 0x80) {
+            key[i++] = tolower(c);
+        } else if ((c & 0xE0) == 0xC0 && i + 1 < length && (key[i + 1] & 0xC0) == 0x80) {
+            // Two-byte sequence: all folded scripts live here
+            unsigned int cp = ((c & 0x1F) << 6) | (key[i + 1] & 0x3F);
+            unsigned int folded = trie_fold_codepoint(cp);
+            if (folded >= 0x80 && folded < 0x800) {
+                key[i] = 0xC0 | (folded >> 6);
+                key[i + 1] = 0x80 | (folded & 0x3F);
+            }
+            i += 2;
+        } else {
+            i++;
+        }
+    }
 }
 
 /**
- * Create new trie node
- * Time Complexity: O(1)
+ * Copy text into key bytes, case-folding UTF-8 when the trie asks for it
+ * Returns key length, or -1 if text does not fit in MAX_WORD_LENGTH
+ * Time Complexity: O(m) where m = text length
  */
-TrieNode *trie_node_create() {
-    TrieNode *node = (TrieNode *)malloc(sizeof(TrieNode));
+int trie_fold_key(Trie *trie, const char *text, unsigned char *key) {
+    int length = strlen(text);
+    if (length >= MAX_WORD_LENGTH) return -1;
     
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        node->children[i] = NULL;
+    memcpy(key, text, length);
+    if (trie->flags & TRIE_FOLD_CASE) trie_fold_bytes(key, length);
+    return length;
+}
+
+/**
+ * Size of a node type's body, excluding the inline prefix
+ */
+size_t trie_node_body_size(int type) {
+    switch (type) {
+        case NODE4: return sizeof(TrieNode4);
+        case NODE16: return sizeof(TrieNode16);
+        case NODE48: return sizeof(TrieNode48);
+        case NODE256: return sizeof(TrieNode256);
+        default: return sizeof(TrieNode);
     }
+}
+
+/**
+ * Compressed prefix bytes of a node
+ */
+unsigned char *trie_node_prefix(TrieNode *node) {
+    return (unsigned char *)node + trie_node_body_size(node->type);
+}
+
+/**
+ * Create new trie node of the given type with a copy of prefix
+ * Time Complexity: O(p) where p = prefix length
+ */
+NodeHandle trie_node_create(Trie *trie, int type, const unsigned char *prefix, int prefix_len) {
+    size_t body = trie_node_body_size(type);
+    NodeHandle handle = node_arena_alloc(&trie->arena, body + prefix_len);
+    TrieNode *node = TRIE_NODE(trie, handle);
     
-    node->is_end_of_word = 0;
-    node->word[0] = '\0';
+    node->type = type;
+    node->prefix_len = prefix_len;
+    if (prefix_len > 0) {
+        memcpy((unsigned char *)node + body, prefix, prefix_len);
+    }
     
-    return node;
+    return handle;
 }
 
 /**
- * Create new trie
+ * Create new trie with options (TRIE_FOLD_CASE or 0 for exact bytes)
  * Time Complexity: O(1)
  */
-Trie *trie_create() {
+Trie *trie_create_with(int flags) {
     Trie *trie = (Trie *)malloc(sizeof(Trie));
-    trie->root = trie_node_create();
+    node_arena_init(&trie->arena, TRIE_SIZE_CLASSES,
+                    sizeof(TRIE_SIZE_CLASSES) / sizeof(TRIE_SIZE_CLASSES[0]));
+    trie->root = trie_node_create(trie, NODE_LEAF, NULL, 0);
     trie->word_count = 0;
+    trie->flags = flags;
     return trie;
 }
 
 /**
- * Insert word into trie
+ * Create new case-insensitive trie
+ * Time Complexity: O(1)
+ */
+Trie *trie_create(void) {
+    return trie_create_with(TRIE_FOLD_CASE);
+}
+
+/**
+ * Find the child slot for a key byte
+ * Returns pointer to the child handle, or NULL if absent
+ * Time Complexity: O(1)
+ */
+NodeHandle *trie_find_child(TrieNode *node, unsigned char byte) {
+    switch (node->type) {
+        case NODE4: {
+            TrieNode4 *n = (TrieNode4 *)node;
+            for (int i = 0; i < node->num_children; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+        }
+        case NODE16: {
+            TrieNode16 *n = (TrieNode16 *)node;
+            for (int i = 0; i < node->num_children; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+        }
+        case NODE48: {
+            TrieNode48 *n = (TrieNode48 *)node;
+            return n->child_index[byte] ? &n->children[n->child_index[byte] - 1] : NULL;
+        }
+        case NODE256: {
+            TrieNode256 *n = (TrieNode256 *)node;
+            return n->children[byte] ? &n->children[byte] : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * First child whose key byte is >= from, in byte order
+ * Stores the key byte in byte_out; returns NODE_NULL when there is none
+ * Time Complexity: O(1) for Node4/16, O(256) worst case for Node48/256
+ */
+NodeHandle trie_next_child(TrieNode *node, int from, unsigned char *byte_out) {
+    switch (node->type) {
+        case NODE4:
+        case NODE16: {
+            unsigned char *keys = node->type == NODE4 ? ((TrieNode4 *)node)->keys : ((TrieNode16 *)node)->keys;
+            NodeHandle *children = node->type == NODE4 ? ((TrieNode4 *)node)->children : ((TrieNode16 *)node)->children;
+            for (int i = 0; i < node->num_children; i++) {
+                if (keys[i] >= from) {
+                    *byte_out = keys[i];
+                    return children[i];
+                }
+            }
+            return NODE_NULL;
+        }
+        case NODE48: {
+            TrieNode48 *n = (TrieNode48 *)node;
+            for (int b = from; b < 256; b++) {
+                if (n->child_index[b]) {
+                    *byte_out = b;
+                    return n->children[n->child_index[b] - 1];
+                }
+            }
+            return NODE_NULL;
+        }
+        case NODE256: {
+            TrieNode256 *n = (TrieNode256 *)node;
+            for (int b = from; b < 256; b++) {
+                if (n->children[b]) {
+                    *byte_out = b;
+                    return n->children[b];
+                }
+            }
+            return NODE_NULL;
+        }
+        default:
+            return NODE_NULL;
+    }
+}
+
+/**
+ * Copy a node into a different type, keeping prefix, flags and children
+ * Frees the old node
+ * Time Complexity: O(c) where c = number of children
+ */
+NodeHandle trie_node_convert(Trie *trie, NodeHandle handle, int type) {
+    TrieNode *node = TRIE_NODE(trie, handle);
+    NodeHandle converted_handle = trie_node_create(trie, type, trie_node_prefix(node), node->prefix_len);
+    TrieNode *converted = TRIE_NODE(trie, converted_handle);
+    converted->is_end_of_word = node->is_end_of_word;
+    converted->score = node->score;
+    converted->max_score = node->max_score;
+    
+    unsigned char byte;
+    NodeHandle child;
+    int count = 0;
+    for (int b = 0; (child = trie_next_child(node, b, &byte)) != NODE_NULL; b = byte + 1) {
+        switch (type) {
+            case NODE4:
+                ((TrieNode4 *)converted)->keys[count] = byte;
+                ((TrieNode4 *)converted)->children[count] = child;
+                break;
+            case NODE16:
+                ((TrieNode16 *)converted)->keys[count] = byte;
+                ((TrieNode16 *)converted)->children[count] = child;
+                break;
+            case NODE48:
+                ((TrieNode48 *)converted)->child_index[byte] = count + 1;
+                ((TrieNode48 *)converted)->children[count] = child;
+                break;
+            case NODE256:
+                ((TrieNode256 *)converted)->children[byte] = child;
+                break;
+        }
+        count++;
+    }
+    converted->num_children = count;
+    
+    node_arena_free(&trie->arena, handle);
+    return converted_handle;
+}
+
+/**
+ * Add child under key byte, growing the node if it is full
+ * ref points at the parent's handle of node and is updated on growth
+ * Time Complexity: O(1) amortized
+ */
+void trie_add_child(Trie *trie, NodeHandle *ref, unsigned char byte, NodeHandle child) {
+    TrieNode *node = TRIE_NODE(trie, *ref);
+    int capacity[] = { 0, 4, 16, 48, 256 };
+    
+    if (node->num_children == capacity[node->type]) {
+        *ref = trie_node_convert(trie, *ref, node->type + 1);
+        node = TRIE_NODE(trie, *ref);
+    }
+    
+    switch (node->type) {
+        case NODE4:
+        case NODE16: {
+            unsigned char *keys = node->type == NODE4 ? ((TrieNode4 *)node)->keys : ((TrieNode16 *)node)->keys;
+            NodeHandle *children = node->type == NODE4 ? ((TrieNode4 *)node)->children : ((TrieNode16 *)node)->children;
+            int i = node->num_children;
+            // Shift larger keys right to keep keys sorted
+            while (i > 0 && keys[i - 1] > byte) {
+                keys[i] = keys[i - 1];
+                children[i] = children[i - 1];
+                i--;
+            }
+            keys[i] = byte;
+            children[i] = child;
+            break;
+        }
+        case NODE48: {
+            TrieNode48 *n = (TrieNode48 *)node;
+            int slot = 0;
+            while (n->children[slot] != NODE_NULL) slot++;
+            n->children[slot] = child;
+            n->child_index[byte] = slot + 1;
+            break;
+        }
+        case NODE256:
+            ((TrieNode256 *)node)->children[byte] = child;
+            break;
+    }
+    
+    node->num_children++;
+}
+
+/**
+ * Remove child under key byte, shrinking the node when it gets sparse
+ * Time Complexity: O(1) amortized
+ */
+void trie_remove_child(Trie *trie, NodeHandle *ref, unsigned char byte) {
+    TrieNode *node = TRIE_NODE(trie, *ref);
+    
+    switch (node->type) {
+        case NODE4:
+        case NODE16: {
+            unsigned char *keys = node->type == NODE4 ? ((TrieNode4 *)node)->keys : ((TrieNode16 *)node)->keys;
+            NodeHandle *children = node->type == NODE4 ? ((TrieNode4 *)node)->children : ((TrieNode16 *)node)->children;
+            int i = 0;
+            while (i < node->num_children && keys[i] != byte) i++;
+            if (i == node->num_children) return;
+            for (; i < node->num_children - 1; i++) {
+                keys[i] = keys[i + 1];
+                children[i] = children[i + 1];
+            }
+            break;
+        }
+        case NODE48: {
+            TrieNode48 *n = (TrieNode48 *)node;
+            if (!n->child_index[byte]) return;
+            n->children[n->child_index[byte] - 1] = NODE_NULL;
+            n->child_index[byte] = 0;
+            break;
+        }
+        case NODE256:
+            if (!((TrieNode256 *)node)->children[byte]) return;
+            ((TrieNode256 *)node)->children[byte] = NODE_NULL;
+            break;
+        default:
+            return;
+    }
+    
+    node->num_children--;
+    
+    // Shrink with some hysteresis so add/remove at a boundary doesn't thrash
+    int shrink_below[] = { 0, 1, 3, 12, 37 };
+    if (node->num_children < shrink_below[node->type]) {
+        *ref = trie_node_convert(trie, *ref, node->type - 1);
+    }
+}
+
+/**
+ * Split a node's compressed prefix at position split
+ * The node keeps the bytes after the split; a new parent holds the
+ * bytes before it and branches on the byte at the split.
+ * Time Complexity: O(p) where p = prefix length
+ */
+void trie_split_prefix(Trie *trie, NodeHandle *ref, int split) {
+    NodeHandle handle = *ref;
+    TrieNode *node = TRIE_NODE(trie, handle);
+    unsigned char *prefix = trie_node_prefix(node);
+    NodeHandle parent = trie_node_create(trie, NODE4, prefix, split);
+    TRIE_NODE(trie, parent)->max_score = node->max_score;
+    unsigned char branch = prefix[split];
+    
+    // Shortening in place leaves the slot's size class as it was
+    int rest = node->prefix_len - split - 1;
+    memmove(prefix, prefix + split + 1, rest);
+    node->prefix_len = rest;
+    
+    *ref = parent;
+    trie_add_child(trie, ref, branch, handle);
+}
+
+/**
+ * Merge a node with its only child: parent prefix + key byte + child prefix
+ * Time Complexity: O(p) where p = merged prefix length
+ */
+void trie_merge_child(Trie *trie, NodeHandle *ref) {
+    NodeHandle handle = *ref;
+    TrieNode *node = TRIE_NODE(trie, handle);
+    unsigned char byte;
+    NodeHandle child_handle = trie_next_child(node, 0, &byte);
+    TrieNode *child = TRIE_NODE(trie, child_handle);
+    
+    unsigned char merged[2 * MAX_WORD_LENGTH + 1];
+    int len = node->prefix_len;
+    memcpy(merged, trie_node_prefix(node), len);
+    merged[len++] = byte;
+    memcpy(merged + len, trie_node_prefix(child), child->prefix_len);
+    len += child->prefix_len;
+    
+    NodeHandle replacement_handle = trie_node_create(trie, child->type, merged, len);
+    TrieNode *replacement = TRIE_NODE(trie, replacement_handle);
+    size_t header = sizeof(TrieNode);
+    memcpy((unsigned char *)replacement + header, (unsigned char *)child + header,
+           trie_node_body_size(child->type) - header);
+    replacement->is_end_of_word = child->is_end_of_word;
+    replacement->num_children = child->num_children;
+    replacement->score = child->score;
+    replacement->max_score = child->max_score;
+    
+    node_arena_free(&trie->arena, child_handle);
+    node_arena_free(&trie->arena, handle);
+    *ref = replacement_handle;
+}
+
+/**
+ * Recompute a node's cached subtree max from its own score and children
+ * Time Complexity: O(c) where c = number of children
+ */
+void trie_refresh_max(Trie *trie, TrieNode *node) {
+    unsigned int best = node->is_end_of_word ? node->score : 0;
+    
+    unsigned char byte;
+    NodeHandle child;
+    for (int b = 0; (child = trie_next_child(node, b, &byte)) != NODE_NULL; b = byte + 1) {
+        unsigned int child_max = TRIE_NODE(trie, child)->max_score;
+        if (child_max > best) best = child_max;
+    }
+    
+    node->max_score = best;
+}
+
+/**
+ * Refresh cached maxima from path[deepest] back up to the root
+ * The deepest node always changed; above it, stop at the first ancestor
+ * whose max is unaffected.
+ * Time Complexity: O(d * c) where d = path length, c = children per node
+ */
+void trie_refresh_path(Trie *trie, NodeHandle *path[], int deepest) {
+    for (int i = deepest; i >= 0; i--) {
+        TrieNode *node = TRIE_NODE(trie, *path[i]);
+        unsigned int old_max = node->max_score;
+        trie_refresh_max(trie, node);
+        if (i < deepest && node->max_score == old_max) break;
+    }
+}
+
+/**
+ * Insert word into trie, or update it
+ * Any UTF-8 (or raw byte) string is accepted; see trie_fold_key.
+ * A new word gets score; an existing one only if set_score is nonzero.
  * Time Complexity: O(m) where m = word length
  */
-void trie_insert(Trie *trie, const char *word) {
+void trie_upsert(Trie *trie, const char *word, unsigned int score, int set_score) {
     if (!word || strlen(word) == 0) return;
     
-    TrieNode *current = trie->root;
+    int length = strlen(word);
+    if (length >= MAX_WORD_LENGTH) {
+        printf("Word too long: %s\n", word);
+        return;
+    }
+    
+    unsigned char key[MAX_WORD_LENGTH];
+    trie_fold_key(trie, word, key);
+    
+    NodeHandle *path[MAX_WORD_LENGTH + 1];
+    int path_len = 0;
     
-    // Traverse and create nodes for each character
-    for (int i = 0; word[i] != '\0'; i++) {
-        int index = char_to_index(word[i]);
+    NodeHandle *ref = &trie->root;
+    int depth = 0;
+    
+    while (1) {
+        path[path_len] = ref;
+        TrieNode *node = TRIE_NODE(trie, *ref);
+        unsigned char *prefix = trie_node_prefix(node);
         
-        if (index < 0 || index >= ALPHABET_SIZE) {
-            printf("Invalid character: %c\n", word[i]);
-            return;
+        // Match as much of the compressed prefix as possible
+        int matched = 0;
+        while (matched < (int)node->prefix_len && depth + matched < length &&
+               prefix[matched] == key[depth + matched]) {
+            matched++;
+        }
+        
+        if (matched < (int)node->prefix_len) {
+            trie_split_prefix(trie, ref, matched);
+            node = TRIE_NODE(trie, *ref);
+        }
+        depth += matched;
+        
+        if (depth == length) {
+            // Mark end of word if not already marked
+            if (!node->is_end_of_word) {
+                node->is_end_of_word = 1;
+                node->score = score;
+                trie->word_count++;
+            } else if (set_score) {
+                node->score = score;
+            }
+            break;
         }
         
-        // Create node if doesn't exist
-        if (current->children[index] == NULL) {
-            current->children[index] = trie_node_create();
+        NodeHandle *child = trie_find_child(node, key[depth]);
+        if (child == NULL) {
+            // Rest of the word becomes one leaf with a compressed prefix
+            NodeHandle leaf_handle = trie_node_create(trie, NODE_LEAF, key + depth + 1, length - depth - 1);
+            TrieNode *leaf = TRIE_NODE(trie, leaf_handle);
+            leaf->is_end_of_word = 1;
+            leaf->score = score;
+            leaf->max_score = score;
+            trie_add_child(trie, ref, key[depth], leaf_handle);
+            trie->word_count++;
+            break;
         }
         
-        current = current->children[index];
+        ref = child;
+        path_len++;
+        depth++;
     }
     
-    // Mark end of word if not already marked
-    if (!current->is_end_of_word) {
-        current->is_end_of_word = 1;
-        trie->word_count++;
-        strcpy(current->word, word);
+    trie_refresh_path(trie, path, path_len);
+}
+
+/**
+ * Insert word into trie with score 0; an existing word keeps its score
+ * Time Complexity: O(m) where m = word length
+ */
+void trie_insert(Trie *trie, const char *word) {
+    trie_upsert(trie, word, 0, 0);
+}
+
+/**
+ * Insert word into trie with a ranking score, replacing any previous score
+ * Time Complexity: O(m) where m = word length
+ */
+void trie_insert_scored(Trie *trie, const char *word, unsigned int score) {
+    trie_upsert(trie, word, score, 1);
+}
+
+/**
+ * Walk down to the node where key ends
+ * Returns the node, or NULL if key leaves the trie. If key ends inside a
+ * compressed prefix, *node_depth_out is the depth at which that node starts
+ * and *exact_out is 0.
+ * Time Complexity: O(m) where m = key length
+ */
+TrieNode *trie_walk(Trie *trie, const unsigned char *key, int length, int *node_depth_out, int *exact_out) {
+    TrieNode *node = TRIE_NODE(trie, trie->root);
+    int depth = 0;
+    
+    while (1) {
+        int remaining = length - depth;
+        int compare = remaining < (int)node->prefix_len ? remaining : (int)node->prefix_len;
+        
+        if (memcmp(trie_node_prefix(node), key + depth, compare) != 0) {
+            return NULL;
+        }
+        
+        if (remaining <= (int)node->prefix_len) {
+            *node_depth_out = depth;
+            *exact_out = remaining == (int)node->prefix_len;
+            return node;
+        }
+        
+        depth += node->prefix_len;
+        NodeHandle *child = trie_find_child(node, key[depth]);
+        if (child == NULL) {
+            return NULL;
+        }
+        
+        node = TRIE_NODE(trie, *child);
+        depth++;
     }
 }
 
@@ -106,42 +590,41 @@ void trie_insert(Trie *trie, const char *word) {
 int trie_search(Trie *trie, const char *word) {
     if (!word || strlen(word) == 0) return 0;
     
-    TrieNode *current = trie->root;
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, word, key);
+    if (length < 0) return 0;
     
-    for (int i = 0; word[i] != '\0'; i++) {
-        int index = char_to_index(word[i]);
-        
-        if (index < 0 || index >= ALPHABET_SIZE || current->children[index] == NULL) {
-            return 0;  // Character not found
-        }
-        
-        current = current->children[index];
-    }
+    int node_depth, exact;
+    TrieNode *node = trie_walk(trie, key, length, &node_depth, &exact);
     
     // Check if it's end of a word
-    return current->is_end_of_word;
+    return node != NULL && exact && node->is_end_of_word;
 }
 
 /**
- * Collect all words with given prefix (using DFS)
+ * Collect all words below a node (using DFS)
+ * buffer holds the key bytes leading to the node; the node's own
+ * prefix is appended here.
  * Time Complexity: O(n) where n = total characters in results
  */
-void trie_prefix_dfs(TrieNode *node, char *prefix, int prefix_len, 
-                      char results[][256], int *result_count) {
+void trie_prefix_dfs(Trie *trie, TrieNode *node, char *buffer, int buffer_len,
+                     char results[][256], int *result_count) {
     if (*result_count >= 100) return;  // Limit results
     
+    memcpy(buffer + buffer_len, trie_node_prefix(node), node->prefix_len);
+    buffer_len += node->prefix_len;
+    
     if (node->is_end_of_word) {
-        strcpy(results[*result_count], prefix);
+        memcpy(results[*result_count], buffer, buffer_len);
+        results[*result_count][buffer_len] = '\0';
         (*result_count)++;
     }
     
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i] != NULL) {
-            prefix[prefix_len] = 'a' + i;
-            prefix[prefix_len + 1] = '\0';
-            
-            trie_prefix_dfs(node->children[i], prefix, prefix_len + 1, results, result_count);
-        }
+    unsigned char byte;
+    NodeHandle child;
+    for (int b = 0; (child = trie_next_child(node, b, &byte)) != NODE_NULL; b = byte + 1) {
+        buffer[buffer_len] = byte;
+        trie_prefix_dfs(trie, TRIE_NODE(trie, child), buffer, buffer_len + 1, results, result_count);
     }
 }
 
@@ -149,31 +632,582 @@ void trie_prefix_dfs(TrieNode *node, char *prefix, int prefix_len,
  * Find all words with given prefix
  * Time Complexity: O(m + n) where m = prefix length, n = results count
  */
-int trie_search_prefix(Trie *trie, const char *prefix, 
+int trie_search_prefix(Trie *trie, const char *prefix,
                        char results[][256]) {
     if (!prefix || strlen(prefix) == 0) return 0;
     
-    TrieNode *current = trie->root;
-    int prefix_len = strlen(prefix);
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, prefix, key);
+    if (length < 0) return 0;
     
     // Navigate to end of prefix
-    for (int i = 0; i < prefix_len; i++) {
-        int index = char_to_index(prefix[i]);
+    int node_depth, exact;
+    TrieNode *node = trie_walk(trie, key, length, &node_depth, &exact);
+    if (node == NULL) return 0;  // Prefix not found
+    
+    // Collect all words from this node
+    char buffer[MAX_WORD_LENGTH];
+    memcpy(buffer, key, node_depth);
+    
+    int result_count = 0;
+    trie_prefix_dfs(trie, node, buffer, node_depth, results, &result_count);
+    
+    return result_count;
+}
+
+/**
+ * Ranked completion search state
+ * A visit is a reached node plus how it was reached, so keys can be
+ * rebuilt without copying them into every queued candidate.
+ */
+typedef struct {
+    TrieNode *node;
+    int parent;                  // index of parent visit, -1 at the start node
+    unsigned char byte;          // key byte leading from parent to node
+} TrieVisit;
+
+typedef struct {
+    unsigned int score;          // word score, or subtree bound for a node
+    int is_word;
+    int visit;
+} TrieCandidate;
+
+/**
+ * Candidate ordering for the best-first queue
+ * Higher score first; a finished word beats a subtree with the same bound.
+ */
+int trie_candidate_before(TrieCandidate *a, TrieCandidate *b) {
+    if (a->score != b->score) return a->score > b->score;
+    return a->is_word > b->is_word;
+}
+
+/**
+ * Push candidate onto a binary max-heap, growing it as needed
+ * Time Complexity: O(log n)
+ */
+void trie_candidate_push(TrieCandidate **heap, int *size, int *capacity, TrieCandidate candidate) {
+    if (*size == *capacity) {
+        *capacity *= 2;
+        *heap = (TrieCandidate *)realloc(*heap, *capacity * sizeof(TrieCandidate));
+    }
+    
+    TrieCandidate *h = *heap;
+    int i = (*size)++;
+    while (i > 0 && trie_candidate_before(&candidate, &h[(i - 1) / 2])) {
+        h[i] = h[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h[i] = candidate;
+}
+
+/**
+ * Move candidate down from slot i until both children rank below it
+ * Time Complexity: O(log n)
+ */
+void trie_candidate_sift_down(TrieCandidate *heap, int size, int i, TrieCandidate candidate) {
+    while (2 * i + 1 < size) {
+        int child = 2 * i + 1;
+        if (child + 1 < size && trie_candidate_before(&heap[child + 1], &heap[child])) child++;
+        if (!trie_candidate_before(&heap[child], &candidate)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = candidate;
+}
+
+/**
+ * Pop the best candidate from a binary max-heap
+ * Time Complexity: O(log n)
+ */
+TrieCandidate trie_candidate_pop(TrieCandidate *heap, int *size) {
+    TrieCandidate top = heap[0];
+    TrieCandidate last = heap[--(*size)];
+    trie_candidate_sift_down(heap, *size, 0, last);
+    return top;
+}
+
+/**
+ * Rebuild the full key of a visit into out (NUL-terminated)
+ * base holds the key bytes leading to the start node.
+ */
+void trie_visit_key(TrieVisit *visits, int visit, const unsigned char *base, int base_len, char *out) {
+    int chain[MAX_WORD_LENGTH + 1];
+    int chain_len = 0;
+    for (int v = visit; v >= 0; v = visits[v].parent) {
+        chain[chain_len++] = v;
+    }
+    
+    int len = base_len;
+    memcpy(out, base, base_len);
+    for (int i = chain_len - 1; i >= 0; i--) {
+        TrieVisit *v = &visits[chain[i]];
+        if (v->parent >= 0) out[len++] = v->byte;
+        memcpy(out + len, trie_node_prefix(v->node), v->node->prefix_len);
+        len += v->node->prefix_len;
+    }
+    out[len] = '\0';
+}
+
+/**
+ * Best-first ranking state shared by top-k and fuzzy search
+ * visits grows as nodes are reached; heap holds the open candidates.
+ */
+typedef struct {
+    TrieVisit *visits;
+    int visit_count;
+    int visit_capacity;
+    TrieCandidate *heap;
+    int heap_size;
+    int heap_capacity;
+} TrieRanking;
+
+void trie_ranking_init(TrieRanking *ranking) {
+    ranking->visit_count = 0;
+    ranking->visit_capacity = 64;
+    ranking->visits = (TrieVisit *)malloc(ranking->visit_capacity * sizeof(TrieVisit));
+    ranking->heap_size = 0;
+    ranking->heap_capacity = 64;
+    ranking->heap = (TrieCandidate *)malloc(ranking->heap_capacity * sizeof(TrieCandidate));
+}
+
+/**
+ * Record a reached node; returns its visit index
+ * Time Complexity: O(1) amortized
+ */
+int trie_ranking_visit(TrieRanking *ranking, TrieNode *node, int parent, unsigned char byte) {
+    if (ranking->visit_count == ranking->visit_capacity) {
+        ranking->visit_capacity *= 2;
+        ranking->visits = (TrieVisit *)realloc(ranking->visits, ranking->visit_capacity * sizeof(TrieVisit));
+    }
+    ranking->visits[ranking->visit_count] = (TrieVisit){ node, parent, byte };
+    return ranking->visit_count++;
+}
+
+void trie_ranking_push(TrieRanking *ranking, TrieCandidate candidate) {
+    trie_candidate_push(&ranking->heap, &ranking->heap_size, &ranking->heap_capacity, candidate);
+}
+
+/**
+ * Replace the open candidates with a batch, heapified in one pass
+ * Time Complexity: O(n)
+ */
+void trie_ranking_reset(TrieRanking *ranking, const TrieCandidate *candidates, int count) {
+    if (count > ranking->heap_capacity) {
+        ranking->heap_capacity = count;
+        ranking->heap = (TrieCandidate *)realloc(ranking->heap, count * sizeof(TrieCandidate));
+    }
+    if (count > 0) memcpy(ranking->heap, candidates, count * sizeof(TrieCandidate));
+    ranking->heap_size = count;
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        trie_candidate_sift_down(ranking->heap, count, i, ranking->heap[i]);
+    }
+}
+
+/**
+ * Pop candidates best-first until k words are written or the heap runs dry
+ * Subtrees are expanded only when their cached max_score can still place,
+ * so the work is bounded by the results rather than the subtree sizes.
+ * base holds the key bytes leading to visits without a parent.
+ * Time Complexity: O(k log k) (times node fan-out)
+ */
+int trie_ranking_take(Trie *trie, TrieRanking *ranking, const unsigned char *base, int base_len,
+                      int k, char results[][256], unsigned int *scores_out) {
+    int result_count = 0;
+    while (ranking->heap_size > 0 && result_count < k) {
+        TrieCandidate best = trie_candidate_pop(ranking->heap, &ranking->heap_size);
         
-        if (index < 0 || index >= ALPHABET_SIZE || current->children[index] == NULL) {
-            return 0;  // Prefix not found
+        if (best.is_word) {
+            trie_visit_key(ranking->visits, best.visit, base, base_len, results[result_count]);
+            if (scores_out) scores_out[result_count] = best.score;
+            result_count++;
+            continue;
         }
         
-        current = current->children[index];
+        // Expand the subtree: its own word plus one bound per child
+        TrieNode *node = ranking->visits[best.visit].node;
+        if (node->is_end_of_word) {
+            trie_ranking_push(ranking, (TrieCandidate){ node->score, 1, best.visit });
+        }
+        
+        unsigned char byte;
+        NodeHandle child_handle;
+        for (int b = 0; (child_handle = trie_next_child(node, b, &byte)) != NODE_NULL; b = byte + 1) {
+            TrieNode *child = TRIE_NODE(trie, child_handle);
+            int visit = trie_ranking_visit(ranking, child, best.visit, byte);
+            trie_ranking_push(ranking, (TrieCandidate){ child->max_score, 0, visit });
+        }
     }
+    return result_count;
+}
+
+void trie_ranking_free(TrieRanking *ranking) {
+    free(ranking->visits);
+    free(ranking->heap);
+}
+
+/**
+ * Find the k highest-scoring words with given prefix (best-first search)
+ * Results are ordered by descending score; scores_out may be NULL.
+ * An empty prefix ranks the whole trie.
+ * Time Complexity: O(m + k log k) for m = prefix length (times node fan-out)
+ */
+int trie_search_top_k(Trie *trie, const char *prefix, int k,
+                      char results[][256], unsigned int *scores_out) {
+    if (!prefix || k <= 0) return 0;
     
-    // Collect all words from this node
-    char buffer[256];
-    strcpy(buffer, prefix);
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, prefix, key);
+    if (length < 0) return 0;
+    
+    int node_depth, exact;
+    TrieNode *start = trie_walk(trie, key, length, &node_depth, &exact);
+    if (start == NULL) return 0;  // Prefix not found
+    
+    TrieRanking ranking;
+    trie_ranking_init(&ranking);
+    trie_ranking_visit(&ranking, start, -1, 0);
+    trie_ranking_push(&ranking, (TrieCandidate){ start->max_score, 0, 0 });
+    
+    int result_count = trie_ranking_take(trie, &ranking, key, node_depth, k, results, scores_out);
+    
+    trie_ranking_free(&ranking);
+    return result_count;
+}
+
+/**
+ * Feed one key byte to an incremental UTF-8 decoder
+ * Writes the characters it completes to out and returns how many: at
+ * most two, when this byte cuts a sequence short and is itself ASCII.
+ * Malformed input decodes to tagged values (TRIE_UTF8_BROKEN) that only
+ * ever match the same malformed bytes, so any byte string is a valid key.
+ * Time Complexity: O(1)
+ */
+int trie_utf8_feed(unsigned int *partial, int *pending, unsigned char byte, unsigned int out[2]) {
+    int count = 0;
+    if (*pending > 0) {
+        if ((byte & 0xC0) == 0x80) {
+            *partial = (*partial << 6) | (byte & 0x3F);
+            if (--*pending == 0) out[count++] = *partial;
+            return count;
+        }
+        out[count++] = *partial | TRIE_UTF8_BROKEN;
+        *pending = 0;
+    }
+    
+    if (byte < 0x80) {
+        out[count++] = byte;
+    } else if ((byte & 0xE0) == 0xC0) {
+        *partial = byte & 0x1F;
+        *pending = 1;
+    } else if ((byte & 0xF0) == 0xE0) {
+        *partial = byte & 0x0F;
+        *pending = 2;
+    } else if ((byte & 0xF8) == 0xF0) {
+        *partial = byte & 0x07;
+        *pending = 3;
+    } else {
+        out[count++] = byte | TRIE_UTF8_BROKEN;
+    }
+    return count;
+}
+
+/**
+ * Fuzzy search state
+ * rows is the Levenshtein table, one row per key character on the
+ * current path: rows[i * (m + 1) + j] is the edit distance between the
+ * first i key characters and the first j pattern characters. A DFS only
+ * ever extends or drops the last row, so the table is the automaton's
+ * state stack.
+ */
+typedef struct {
+    Trie *trie;
+    unsigned char key[MAX_WORD_LENGTH];      // folded query bytes
+    int length;
+    unsigned int pattern[MAX_WORD_LENGTH];   // the same, as characters
+    int m;
+    int max_distance;            // lowered once k matches are closer
+    int k;
+    int *rows;
+    unsigned int *chars;         // key character that produced each row
+    TrieRanking ranking;
+    TrieCandidate *matches[TRIE_MAX_FUZZY_DISTANCE + 1];   // per distance
+    int match_count[TRIE_MAX_FUZZY_DISTANCE + 1];
+    int match_capacity[TRIE_MAX_FUZZY_DISTANCE + 1];
+} TrieFuzzy;
+
+/**
+ * Position of the automaton on the current path
+ */
+typedef struct {
+    int depth;                   // key characters consumed
+    int bytes;                   // key bytes consumed
+    int best;                    // smallest distance of any key prefix so far
+    unsigned int partial;        // UTF-8 sequence in progress
+    int pending;                 // continuation bytes still expected
+} TrieFuzzyState;
+
+/**
+ * Queue a matching word or subtree under its distance
+ * Every match holds at least one word, so once k matches are within some
+ * distance, nothing farther can place and the limit drops to it.
+ * Time Complexity: O(1) amortized
+ */
+void trie_fuzzy_match(TrieFuzzy *fuzzy, int distance, TrieCandidate candidate) {
+    if (fuzzy->match_count[distance] == fuzzy->match_capacity[distance]) {
+        fuzzy->match_capacity[distance] = fuzzy->match_capacity[distance] ? fuzzy->match_capacity[distance] * 2 : 16;
+        fuzzy->matches[distance] = (TrieCandidate *)realloc(fuzzy->matches[distance],
+            fuzzy->match_capacity[distance] * sizeof(TrieCandidate));
+    }
+    fuzzy->matches[distance][fuzzy->match_count[distance]++] = candidate;
+    
+    int closer = 0;
+    for (int d = 0; d <= distance; d++) {
+        closer += fuzzy->match_count[d];
+    }
+    if (closer >= fuzzy->k && distance < fuzzy->max_distance) {
+        fuzzy->max_distance = distance;
+    }
+}
+
+/**
+ * Advance the automaton by one key character (optimal string alignment:
+ * insert, delete, substitute or swap two adjacent characters)
+ * Returns the smallest entry of the new row, a lower bound on the
+ * distance of every longer path.
+ * Time Complexity: O(m)
+ */
+int trie_fuzzy_step(TrieFuzzy *fuzzy, TrieFuzzyState *state, unsigned int c) {
+    int m = fuzzy->m;
+    int *prev = fuzzy->rows + state->depth * (m + 1);
+    int *row = prev + (m + 1);
+    int *before = state->depth > 0 ? prev - (m + 1) : NULL;
+    unsigned int last = state->depth > 0 ? fuzzy->chars[state->depth - 1] : 0;
+    
+    row[0] = prev[0] + 1;
+    int row_min = row[0];
+    for (int j = 1; j <= m; j++) {
+        int cost = fuzzy->pattern[j - 1] != c;
+        int d = prev[j - 1] + cost;
+        if (prev[j] + 1 < d) d = prev[j] + 1;
+        if (row[j - 1] + 1 < d) d = row[j - 1] + 1;
+        if (before && j > 1 && c == fuzzy->pattern[j - 2] && last == fuzzy->pattern[j - 1] &&
+            before[j - 2] + 1 < d) {
+            d = before[j - 2] + 1;
+        }
+        row[j] = d;
+        if (d < row_min) row_min = d;
+    }
+    
+    fuzzy->chars[state->depth++] = c;
+    if (row[m] < state->best) state->best = row[m];
+    return row_min;
+}
+
+#define TRIE_FUZZY_WALK 0        // a closer match may still lie below
+#define TRIE_FUZZY_PRUNED 1      // nothing below is within the limit
+#define TRIE_FUZZY_SETTLED 2     // everything below matches at state->best
+
+/**
+ * Decide a path once its distance is fixed
+ * When no longer path can beat the best prefix distance, every word below
+ * matches at exactly that distance (or none do if it exceeds the limit),
+ * so the subtree is queued whole instead of walked.
+ */
+int trie_fuzzy_verdict(TrieFuzzy *fuzzy, TrieFuzzyState *state, int row_min) {
+    int limit = state->best <= fuzzy->max_distance ? state->best : fuzzy->max_distance + 1;
+    if (row_min < limit) return TRIE_FUZZY_WALK;
+    return state->best <= fuzzy->max_distance ? TRIE_FUZZY_SETTLED : TRIE_FUZZY_PRUNED;
+}
+
+/**
+ * Feed one key byte through the decoder and the automaton
+ * Time Complexity: O(m)
+ */
+int trie_fuzzy_feed(TrieFuzzy *fuzzy, TrieFuzzyState *state, unsigned char byte) {
+    unsigned int chars[2];
+    int count = trie_utf8_feed(&state->partial, &state->pending, byte, chars);
+    state->bytes++;
+    
+    for (int c = 0; c < count; c++) {
+        int verdict = trie_fuzzy_verdict(fuzzy, state, trie_fuzzy_step(fuzzy, state, chars[c]));
+        if (verdict != TRIE_FUZZY_WALK) return verdict;
+    }
+    return TRIE_FUZZY_WALK;
+}
+
+void trie_fuzzy_match_subtree(TrieFuzzy *fuzzy, TrieFuzzyState *state, int visit) {
+    TrieNode *node = fuzzy->ranking.visits[visit].node;
+    trie_fuzzy_match(fuzzy, state->best, (TrieCandidate){ node->max_score, 0, visit });
+}
+
+void trie_fuzzy_descend(TrieFuzzy *fuzzy, int visit, TrieFuzzyState state);
+
+/**
+ * Take the edge to a child and descend if the path survives
+ * A pruned edge is dropped before the child node is even read.
+ */
+void trie_fuzzy_child(TrieFuzzy *fuzzy, int visit, TrieFuzzyState state, NodeHandle child, unsigned char byte) {
+    int verdict = trie_fuzzy_feed(fuzzy, &state, byte);
+    if (verdict == TRIE_FUZZY_PRUNED) return;
+    
+    int child_visit = trie_ranking_visit(&fuzzy->ranking, TRIE_NODE(fuzzy->trie, child), visit, byte);
+    if (verdict == TRIE_FUZZY_SETTLED) {
+        trie_fuzzy_match_subtree(fuzzy, &state, child_visit);
+    } else {
+        trie_fuzzy_descend(fuzzy, child_visit, state);
+    }
+}
+
+/**
+ * Walk a visit's prefix through the automaton, then recurse into its
+ * children while a better distance is still reachable
+ * The child that continues the query unchanged goes first: its matches
+ * are the closest, so they lower the limit before the typo branches run.
+ * Time Complexity: O(m) per key character on the explored paths
+ */
+void trie_fuzzy_descend(TrieFuzzy *fuzzy, int visit, TrieFuzzyState state) {
+    TrieNode *node = fuzzy->ranking.visits[visit].node;
+    unsigned char *prefix = trie_node_prefix(node);
+    
+    for (int i = 0; i < (int)node->prefix_len; i++) {
+        int verdict = trie_fuzzy_feed(fuzzy, &state, prefix[i]);
+        if (verdict == TRIE_FUZZY_SETTLED) trie_fuzzy_match_subtree(fuzzy, &state, visit);
+        if (verdict != TRIE_FUZZY_WALK) return;
+    }
+    
+    if (node->is_end_of_word) {
+        // A word cut short mid-sequence ends with one broken character
+        TrieFuzzyState end = state;
+        if (end.pending > 0) trie_fuzzy_step(fuzzy, &end, end.partial | TRIE_UTF8_BROKEN);
+        if (end.best <= fuzzy->max_distance) {
+            trie_fuzzy_match(fuzzy, end.best, (TrieCandidate){ node->score, 1, visit });
+        }
+    }
+    
+    int preferred = state.bytes < fuzzy->length ? fuzzy->key[state.bytes] : -1;
+    NodeHandle *exact = preferred >= 0 ? trie_find_child(node, preferred) : NULL;
+    if (exact != NULL) {
+        trie_fuzzy_child(fuzzy, visit, state, *exact, preferred);
+    }
+    
+    unsigned char byte;
+    NodeHandle child;
+    for (int b = 0; (child = trie_next_child(node, b, &byte)) != NODE_NULL; b = byte + 1) {
+        if (byte != preferred) trie_fuzzy_child(fuzzy, visit, state, child, byte);
+    }
+}
+
+/**
+ * Find every word or subtree within limit edits, grouped by distance
+ * Time Complexity: O(m) per key character within limit edits of the query
+ */
+void trie_fuzzy_collect(TrieFuzzy *fuzzy, int limit) {
+    fuzzy->max_distance = limit;
+    for (int distance = 0; distance <= TRIE_MAX_FUZZY_DISTANCE; distance++) {
+        fuzzy->match_count[distance] = 0;
+    }
+    
+    fuzzy->ranking.visit_count = 0;
+    TrieNode *root = TRIE_NODE(fuzzy->trie, fuzzy->trie->root);
+    int root_visit = trie_ranking_visit(&fuzzy->ranking, root, -1, 0);
+    
+    TrieFuzzyState state = { 0, 0, fuzzy->m, 0, 0 };
+    int verdict = trie_fuzzy_verdict(fuzzy, &state, 0);
+    if (verdict == TRIE_FUZZY_SETTLED) {
+        trie_fuzzy_match_subtree(fuzzy, &state, root_visit);
+    } else {
+        trie_fuzzy_descend(fuzzy, root_visit, state);
+    }
+}
+
+/**
+ * Rank the collected matches one distance class at a time
+ * Time Complexity: O(n + k log k) for n = collected matches
+ */
+int trie_fuzzy_rank(TrieFuzzy *fuzzy, int k, char results[][256], unsigned int *scores_out, int *distances_out) {
+    int result_count = 0;
+    for (int distance = 0; distance <= fuzzy->max_distance && result_count < k; distance++) {
+        trie_ranking_reset(&fuzzy->ranking, fuzzy->matches[distance], fuzzy->match_count[distance]);
+        
+        int found = trie_ranking_take(fuzzy->trie, &fuzzy->ranking, fuzzy->key, 0, k - result_count,
+                                      results + result_count, scores_out ? scores_out + result_count : NULL);
+        if (distances_out) {
+            for (int i = 0; i < found; i++) {
+                distances_out[result_count + i] = distance;
+            }
+        }
+        result_count += found;
+    }
+    return result_count;
+}
+
+/**
+ * Find the k best words with a prefix within max_distance edits of the
+ * given prefix (typo-tolerant autocomplete)
+ * A word's distance is the smallest distance between the query and any
+ * prefix of it; an insertion, deletion, substitution or swap of two
+ * adjacent characters costs 1, counted in UTF-8 characters after case
+ * folding. Results are ordered by distance, then by descending score;
+ * scores_out and distances_out may be NULL. max_distance is clamped to
+ * [0, TRIE_MAX_FUZZY_DISTANCE].
+ * The trie is walked in step with a Levenshtein automaton: a path is
+ * dropped as soon as its last row shows it cannot come within the limit,
+ * and a subtree is queued whole as soon as its distance can no longer
+ * improve, so only the query's edit neighborhood is visited. Distance
+ * classes are then ranked best-first like trie_search_top_k, stopping
+ * once k words are found; the edit limit grows from 0 only while fewer
+ * than k words are within it.
+ * Time Complexity: O(m * v + k log k) for m = query length and
+ * v = nodes within max_distance edits of a query prefix
+ */
+int trie_search_fuzzy(Trie *trie, const char *prefix, int max_distance, int k,
+                      char results[][256], unsigned int *scores_out, int *distances_out) {
+    if (!prefix || k <= 0) return 0;
+    if (max_distance < 0) max_distance = 0;
+    if (max_distance > TRIE_MAX_FUZZY_DISTANCE) max_distance = TRIE_MAX_FUZZY_DISTANCE;
+    
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, prefix, key);
+    if (length < 0) return 0;
+    
+    TrieFuzzy *fuzzy = (TrieFuzzy *)calloc(1, sizeof(TrieFuzzy));
+    fuzzy->trie = trie;
+    memcpy(fuzzy->key, key, length);
+    fuzzy->length = length;
+    fuzzy->k = k;
+    
+    unsigned int partial = 0;
+    int pending = 0;
+    for (int i = 0; i < length; i++) {
+        fuzzy->m += trie_utf8_feed(&partial, &pending, key[i], fuzzy->pattern + fuzzy->m);
+    }
+    if (pending > 0) fuzzy->pattern[fuzzy->m++] = partial | TRIE_UTF8_BROKEN;
     
+    // Rows past m + max_distance + 1 characters are all above the limit
+    int m = fuzzy->m;
+    int max_depth = m + max_distance + 2;
+    fuzzy->rows = (int *)malloc((max_depth + 1) * (m + 1) * sizeof(int));
+    fuzzy->chars = (unsigned int *)malloc(max_depth * sizeof(unsigned int));
+    for (int j = 0; j <= m; j++) {
+        fuzzy->rows[j] = j;
+    }
+    
+    trie_ranking_init(&fuzzy->ranking);
+    // Deepen one edit at a time: most keystrokes fill k without typos or
+    // with one, and each pass costs a fraction of the next
     int result_count = 0;
-    trie_prefix_dfs(current, buffer, prefix_len, results, &result_count);
+    for (int limit = 0; limit <= max_distance && result_count < k; limit++) {
+        trie_fuzzy_collect(fuzzy, limit);
+        result_count = trie_fuzzy_rank(fuzzy, k, results, scores_out, distances_out);
+    }
     
+    for (int distance = 0; distance <= TRIE_MAX_FUZZY_DISTANCE; distance++) {
+        free(fuzzy->matches[distance]);
+    }
+    trie_ranking_free(&fuzzy->ranking);
+    free(fuzzy->rows);
+    free(fuzzy->chars);
+    free(fuzzy);
     return result_count;
 }
 
@@ -187,10 +1221,10 @@ void trie_print(Trie *trie) {
     
     // Simple traversal to collect all words
     char results[100][256];
-    char buffer[256];
+    char buffer[MAX_WORD_LENGTH];
     int result_count = 0;
     
-    trie_prefix_dfs(trie->root, buffer, 0, results, &result_count);
+    trie_prefix_dfs(trie, TRIE_NODE(trie, trie->root), buffer, 0, results, &result_count);
     
     for (int i = 0; i < result_count; i++) {
         printf("  - %s\n", results[i]);
@@ -198,66 +1232,219 @@ void trie_print(Trie *trie) {
 }
 
 /**
- * Delete word from trie (mark as not end of word)
- * Time Complexity: O(m) where m = word length
+ * Record the child slots leading to an exact word
+ * path[0] is the root slot and path[n] the word's node; branch[i] is the
+ * key byte taken out of path[i]. Returns n, or -1 if the word is absent.
+ * Time Complexity: O(m) where m = key length
  */
-void trie_delete(Trie *trie, const char *word) {
-    if (!word || strlen(word) == 0) return;
-    
-    TrieNode *current = trie->root;
+int trie_find_path(Trie *trie, const unsigned char *key, int length,
+                   NodeHandle *path[], unsigned char branch[]) {
+    NodeHandle *ref = &trie->root;
+    int path_len = 0;
+    int depth = 0;
     
-    for (int i = 0; word[i] != '\0'; i++) {
-        int index = char_to_index(word[i]);
+    while (1) {
+        TrieNode *node = TRIE_NODE(trie, *ref);
+        if (length - depth < (int)node->prefix_len ||
+            memcmp(trie_node_prefix(node), key + depth, node->prefix_len) != 0) {
+            return -1;
+        }
+        depth += node->prefix_len;
+        path[path_len] = ref;
         
-        if (index < 0 || index >= ALPHABET_SIZE || current->children[index] == NULL) {
-            return;  // Word not found
+        if (depth == length) {
+            return node->is_end_of_word ? path_len : -1;
         }
         
-        current = current->children[index];
+        NodeHandle *child = trie_find_child(node, key[depth]);
+        if (child == NULL) return -1;
+        
+        branch[path_len++] = key[depth];
+        ref = child;
+        depth++;
     }
+}
+
+/**
+ * Change the score of an existing word
+ * Returns 1 if the word was found, 0 otherwise
+ * Time Complexity: O(m) where m = word length
+ */
+int trie_set_score(Trie *trie, const char *word, unsigned int score) {
+    if (!word || strlen(word) == 0) return 0;
     
-    if (current->is_end_of_word) {
-        current->is_end_of_word = 0;
-        trie->word_count--;
-    }
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, word, key);
+    if (length < 0) return 0;
+    
+    NodeHandle *path[MAX_WORD_LENGTH + 1];
+    unsigned char branch[MAX_WORD_LENGTH + 1];
+    int path_len = trie_find_path(trie, key, length, path, branch);
+    if (path_len < 0) return 0;
+    
+    TRIE_NODE(trie, *path[path_len])->score = score;
+    trie_refresh_path(trie, path, path_len);
+    return 1;
 }
 
 /**
- * Free trie memory (recursive)
+ * Delete word from trie
+ * Frees nodes that no longer lead to any word and re-merges single-child
+ * chains so the tree stays path-compressed.
+ * Time Complexity: O(m) where m = word length
  */
-void trie_free_recursive(TrieNode *node) {
-    if (!node) return;
+void trie_delete(Trie *trie, const char *word) {
+    if (!word || strlen(word) == 0) return;
     
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i] != NULL) {
-            trie_free_recursive(node->children[i]);
-        }
+    unsigned char key[MAX_WORD_LENGTH];
+    int length = trie_fold_key(trie, word, key);
+    if (length < 0) return;
+    
+    // Remember the path of child slots for cleanup on the way back up
+    NodeHandle *path[MAX_WORD_LENGTH + 1];
+    unsigned char branch[MAX_WORD_LENGTH + 1];
+    int path_len = trie_find_path(trie, key, length, path, branch);
+    if (path_len < 0) return;  // Word not found
+    
+    NodeHandle *ref = path[path_len];
+    TrieNode *node = TRIE_NODE(trie, *ref);
+    
+    node->is_end_of_word = 0;
+    node->score = 0;
+    trie->word_count--;
+    
+    // Drop the node if it leads nowhere, then tidy its parent
+    if (node->num_children == 0 && path_len > 0) {
+        node_arena_free(&trie->arena, *ref);
+        ref = path[--path_len];
+        trie_remove_child(trie, ref, branch[path_len]);
+        node = TRIE_NODE(trie, *ref);
     }
     
-    free(node);
+    if (!node->is_end_of_word && node->num_children == 1 && path_len > 0) {
+        trie_merge_child(trie, ref);
+    }
+    
+    trie_refresh_path(trie, path, path_len);
+}
+
+/**
+ * Bytes reserved for nodes (arena slabs)
+ * Time Complexity: O(1)
+ */
+size_t trie_memory_usage(Trie *trie) {
+    return node_arena_bytes(&trie->arena);
 }
 
 /**
  * Free entire trie
+ * Releases the arena slabs; nodes are not visited one by one.
+ * Time Complexity: O(s) where s = number of slabs
  */
 void trie_free(Trie *trie) {
-    trie_free_recursive(trie->root);
+    node_arena_destroy(&trie->arena);
     free(trie);
 }
 
+#ifndef TRIE_NO_MAIN
+static const char *DEMO_SYLLABLES[] = {
+    "ka", "to", "ri", "mu", "sen", "lo", "git", "hub", "news", "docs", "map", "tar", "vel", "qui", "ze",
+    "an", "pro", "ex", "dev", "ops", "ma", "li", "ber", "for", "cal", "in", "tu", "ne", "wa", "shi",
+};
+
+void trie_demo_word(char *out) {
+    int syllables = sizeof(DEMO_SYLLABLES) / sizeof(DEMO_SYLLABLES[0]);
+    out[0] = '\0';
+    for (int i = 1 + rand() % 3; i > 0; i--) {
+        strcat(out, DEMO_SYLLABLES[rand() % syllables]);
+    }
+}
+
+double trie_demo_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int trie_demo_compare_latency(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Per-keystroke fuzzy latency over a trie of random titles
+ * Each query is a title prefix of 1-14 bytes with a random typo
+ * (substitution, swap or dropped byte) in three out of four cases.
+ */
+void trie_demo_fuzzy_benchmark(int word_count) {
+    printf("--- Fuzzy keystroke latency, %d titles ---\n", word_count);
+    Trie *trie = trie_create();
+    char (*titles)[128] = malloc(word_count * sizeof(*titles));
+    
+    srand(3);
+    for (int i = 0; i < word_count; i++) {
+        char word[32];
+        titles[i][0] = '\0';
+        for (int w = 1 + rand() % 4; w > 0; w--) {
+            trie_demo_word(word);
+            if (titles[i][0]) strcat(titles[i], " ");
+            strcat(titles[i], word);
+        }
+        trie_insert_scored(trie, titles[i], rand() % 1000);
+    }
+    
+    int queries = 20000;
+    double *latency = malloc(queries * sizeof(double));
+    char results[10][256];
+    for (int max_distance = 1; max_distance <= TRIE_MAX_FUZZY_DISTANCE; max_distance++) {
+        long found = 0;
+        for (int q = 0; q < queries; q++) {
+            const char *title = titles[rand() % word_count];
+            int length = 1 + rand() % 14;
+            if (length > (int)strlen(title)) length = strlen(title);
+            
+            char query[16];
+            memcpy(query, title, length);
+            query[length] = '\0';
+            int typo = rand() % 4, at = length > 2 ? rand() % (length - 1) : -1;
+            if (at >= 0 && typo == 1) query[at] = 'a' + rand() % 26;
+            if (at >= 0 && typo == 2) { char c = query[at]; query[at] = query[at + 1]; query[at + 1] = c; }
+            if (at >= 0 && typo == 3) memmove(query + at, query + at + 1, length - at);
+            
+            double start = trie_demo_seconds();
+            found += trie_search_fuzzy(trie, query, max_distance, 10, results, NULL, NULL);
+            latency[q] = trie_demo_seconds() - start;
+        }
+        
+        qsort(latency, queries, sizeof(double), trie_demo_compare_latency);
+        printf("distance %d: p50 %.0f us, p99 %.0f us, %.1f results/query\n", max_distance,
+               latency[queries / 2] * 1e6, latency[queries * 99 / 100] * 1e6, (double)found / queries);
+    }
+    
+    free(latency);
+    free(titles);
+    trie_free(trie);
+}
+
 /**
  * Demonstration program
  */
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        trie_demo_fuzzy_benchmark(atoi(argv[1]));
+        return 0;
+    }
+    
     printf("=== Trie (Prefix Tree) Implementation in C ===\n");
-    printf("Data Structure: Trie for prefix matching and autocomplete\n");
-    printf("Operations: Insert O(m), Search O(m), Prefix Search O(m+k)\n\n");
+    printf("Data Structure: Adaptive radix trie for prefix matching and autocomplete\n");
+    printf("Operations: Insert O(m), Search O(m), Prefix Search O(m+k), Top-K O(m + k log k)\n\n");
     
     Trie *trie = trie_create();
     
     // Insert sample words
     printf("--- Inserting words ---\n");
-    const char *words[] = {"cat", "car", "card", "care", "careful", "apple", "app", "apply"};
+    const char *words[] = {"cat", "car", "card", "care", "careful", "apple", "app", "apply",
+                           "C++ Reference", "Café Menu", "Москва 2024"};
     int word_count = sizeof(words) / sizeof(words[0]);
     
     for (int i = 0; i < word_count; i++) {
@@ -303,6 +1490,50 @@ int main() {
         printf("  - %s\n", results[i]);
     }
     
+    // Case folding covers non-ASCII letters too
+    count = trie_search_prefix(trie, "МОСК", results);
+    printf("\nWords starting with 'МОСК': %d\n", count);
+    for (int i = 0; i < count; i++) {
+        printf("  - %s\n", results[i]);
+    }
+    
+    if (trie_search(trie, "CAFÉ MENU")) {
+        printf("✓ Found: 'CAFÉ MENU'\n");
+    }
+    
+    // Ranked completion by visit count
+    printf("\n--- Top-K completion (ranked by visits) ---\n");
+    const char *visited[] = {"careful", "card", "apple", "cat"};
+    unsigned int visits[] = {12, 7, 30, 3};
+    for (int i = 0; i < 4; i++) {
+        trie_set_score(trie, visited[i], visits[i]);
+    }
+    
+    unsigned int scores[100];
+    count = trie_search_top_k(trie, "ca", 3, results, scores);
+    printf("Top 3 for 'ca':\n");
+    for (int i = 0; i < count; i++) {
+        printf("  - %s (%u visits)\n", results[i], scores[i]);
+    }
+    
+    count = trie_search_top_k(trie, "", 2, results, scores);
+    printf("Top 2 overall:\n");
+    for (int i = 0; i < count; i++) {
+        printf("  - %s (%u visits)\n", results[i], scores[i]);
+    }
+    
+    // Typo-tolerant completion: closest first, then most visited
+    printf("\n--- Fuzzy completion (up to 2 typos) ---\n");
+    const char *typos[] = {"carefl", "aplp", "мсоква"};
+    int distances[100];
+    for (int t = 0; t < 3; t++) {
+        count = trie_search_fuzzy(trie, typos[t], 2, 4, results, scores, distances);
+        printf("Best 4 for '%s':\n", typos[t]);
+        for (int i = 0; i < count; i++) {
+            printf("  - %s (distance %d, %u visits)\n", results[i], distances[i], scores[i]);
+        }
+    }
+    
     // Delete and verify
     printf("\n--- Deleting 'car' ---\n");
     trie_delete(trie, "car");
@@ -313,9 +1544,15 @@ int main() {
     
     trie_print(trie);
     
+    // Memory footprint
+    printf("\n--- Memory usage ---\n");
+    printf("Trie nodes: %zu live in %zu arena bytes for %d words\n",
+           node_arena_live(&trie->arena), trie_memory_usage(trie), trie->word_count);
+    
     // Cleanup
     trie_free(trie);
     printf("\nTrie freed.\n");
     
     return 0;
 }
+#endif
@@ -0,0 +1,107 @@
+/**
+ * Trie Interface
+ * Types and functions shared by trie.c and the modules built on it
+ * (see trie.c for implementation notes)
+ */
+
+#ifndef TRIE_H
+#define TRIE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "node_arena.h"
+
+#define MAX_WORD_LENGTH 256
+
+#define TRIE_FOLD_CASE 1
+
+#define TRIE_MAX_FUZZY_DISTANCE 2
+#define TRIE_UTF8_BROKEN 0x80000000u    // tags characters decoded from malformed UTF-8
+
+#define NODE_LEAF 0
+#define NODE4 1
+#define NODE16 2
+#define NODE48 3
+#define NODE256 4
+
+/**
+ * Trie Node header, shared by every node type
+ * The compressed prefix (prefix_len bytes) follows the type's body.
+ * max_score caches the best word score anywhere in the subtree so ranked
+ * completion can skip subtrees that cannot beat what it already has.
+ */
+typedef struct TrieNode {
+    unsigned char type;
+    unsigned char is_end_of_word;
+    unsigned short num_children;
+    unsigned int prefix_len;
+    unsigned int score;          // word score (visit count, recency, ...) if end of word
+    unsigned int max_score;      // max score of any word in this subtree
+} TrieNode;
+
+typedef struct {
+    TrieNode header;
+    unsigned char keys[4];       // sorted
+    NodeHandle children[4];
+} TrieNode4;
+
+typedef struct {
+    TrieNode header;
+    unsigned char keys[16];      // sorted
+    NodeHandle children[16];
+} TrieNode16;
+
+typedef struct {
+    TrieNode header;
+    unsigned char child_index[256];  // 0 = absent, else slot + 1
+    NodeHandle children[48];
+} TrieNode48;
+
+typedef struct {
+    TrieNode header;
+    NodeHandle children[256];
+} TrieNode256;
+
+/**
+ * Trie structure
+ */
+typedef struct {
+    NodeArena arena;
+    NodeHandle root;
+    int word_count;
+    int flags;          // TRIE_FOLD_CASE
+} Trie;
+
+#define TRIE_NODE(trie, handle) ((TrieNode *)node_arena_get(&(trie)->arena, (handle)))
+
+// Keys
+void trie_fold_bytes(unsigned char *key, int length);
+int trie_fold_key(Trie *trie, const char *text, unsigned char *key);
+
+// Node internals, for modules that assemble tries directly (bookmark_build.c)
+unsigned char *trie_node_prefix(TrieNode *node);
+NodeHandle trie_node_create(Trie *trie, int type, const unsigned char *prefix, int prefix_len);
+NodeHandle trie_next_child(TrieNode *node, int from, unsigned char *byte_out);
+void trie_add_child(Trie *trie, NodeHandle *ref, unsigned char byte, NodeHandle child);
+void trie_refresh_max(Trie *trie, TrieNode *node);
+
+// Trie operations
+Trie *trie_create(void);
+Trie *trie_create_with(int flags);
+void trie_insert(Trie *trie, const char *word);
+void trie_insert_scored(Trie *trie, const char *word, unsigned int score);
+int trie_search(Trie *trie, const char *word);
+int trie_search_prefix(Trie *trie, const char *prefix, char results[][256]);
+int trie_search_top_k(Trie *trie, const char *prefix, int k,
+                      char results[][256], unsigned int *scores_out);
+int trie_search_fuzzy(Trie *trie, const char *prefix, int max_distance, int k,
+                      char results[][256], unsigned int *scores_out, int *distances_out);
+int trie_set_score(Trie *trie, const char *word, unsigned int score);
+void trie_delete(Trie *trie, const char *word);
+void trie_print(Trie *trie);
+size_t trie_memory_usage(Trie *trie);
+void trie_free(Trie *trie);
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * B+ Tree Implementation
+ * Used to keep bookmarks sorted by recency, name and visits between
+ * renders, instead of sorting the whole list every time
+ *
+ * Items sit in leaves of up to LEAF_MAX, linked left to right, so a page
+ * is a walk along one or two leaves. Inner nodes keep, per child, the
+ * smallest item below it and how many items are below it; the counts
+ * find "items 200-250" in O(log n) without visiting skipped leaves.
+ *
+ * Items are ordered by the compare function given to the constructor,
+ * which must never call two different items equal (break ties by id).
+ * An item must be deleted before a field its order depends on changes,
+ * and inserted again afterwards. Separators always name items still in
+ * the tree, so compare never sees an item that was changed after it
+ * left.
+ */
+
+const LEAF_MAX = 32;
+const BRANCH_MAX = 32;
+
+class BPlusTree {
+    constructor(compare) {
+        this.compare = compare;
+        this.root = { leaf: true, items: [], next: null };
+        this.size = 0;
+    }
+
+    /**
+     * First index in a sorted array holding an item >= item
+     * Time Complexity: O(log n)
+     */
+    lowerBound(items, item) {
+        let low = 0;
+        let high = items.length;
+        while (low < high) {
+            const mid = (low + high) >> 1;
+            if (this.compare(items[mid], item) < 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    /**
+     * Child of an inner node whose range holds item
+     * Time Complexity: O(log BRANCH_MAX)
+     */
+    childIndex(branch, item) {
+        let low = 1;
+        let high = branch.children.length;
+        while (low < high) {
+            const mid = (low + high) >> 1;
+            if (this.compare(branch.lows[mid], item) <= 0) low = mid + 1;
+            else high = mid;
+        }
+        return low - 1;
+    }
+
+    /**
+     * Walk from the root to the leaf for item
+     * Returns the leaf and the { node, slot } steps taken to reach it
+     */
+    descend(item) {
+        const path = [];
+        let node = this.root;
+        while (!node.leaf) {
+            const slot = this.childIndex(node, item);
+            path.push({ node, slot });
+            node = node.children[slot];
+        }
+        return { leaf: node, path };
+    }
+
+    /**
+     * Items below an inner node
+     */
+    static total(branch) {
+        return branch.sizes.reduce((sum, size) => sum + size, 0);
+    }
+
+    /**
+     * Insert an item; returns false if it is already in the tree
+     * Time Complexity: O(log n)
+     */
+    insert(item) {
+        const { leaf, path } = this.descend(item);
+        const at = this.lowerBound(leaf.items, item);
+        if (leaf.items[at] === item) return false;
+
+        path.forEach(({ node, slot }) => node.sizes[slot]++);
+        this.size++;
+        leaf.items.splice(at, 0, item);
+        if (leaf.items.length <= LEAF_MAX) return true;
+
+        // Split the overfull leaf and hand its right half up
+        const right = { leaf: true, items: leaf.items.splice(leaf.items.length >> 1), next: leaf.next };
+        leaf.next = right;
+        let sibling = right;
+        let low = right.items[0];
+        let siblingSize = right.items.length;
+        let leftSize = leaf.items.length;
+
+        for (let level = path.length - 1; level >= 0; level--) {
+            const { node, slot } = path[level];
+            node.sizes[slot] = leftSize;
+            node.children.splice(slot + 1, 0, sibling);
+            node.lows.splice(slot + 1, 0, low);
+            node.sizes.splice(slot + 1, 0, siblingSize);
+            if (node.children.length <= BRANCH_MAX) return true;
+
+            const half = node.children.length >> 1;
+            const split = {
+                leaf: false,
+                children: node.children.splice(half),
+                lows: node.lows.splice(half),
+                sizes: node.sizes.splice(half)
+            };
+            sibling = split;
+            low = split.lows[0];
+            siblingSize = BPlusTree.total(split);
+            leftSize = BPlusTree.total(node);
+        }
+
+        // The root split: grow a level
+        this.root = {
+            leaf: false,
+            children: [this.root, sibling],
+            lows: [null, low],
+            sizes: [leftSize, siblingSize]
+        };
+        return true;
+    }
+
+    /**
+     * Delete an item (with the fields it was inserted with)
+     * Returns false if it was not in the tree
+     * Time Complexity: O(log n)
+     */
+    delete(item) {
+        const { leaf, path } = this.descend(item);
+        const at = this.lowerBound(leaf.items, item);
+        if (leaf.items[at] !== item) return false;
+
+        leaf.items.splice(at, 1);
+        path.forEach(({ node, slot }) => node.sizes[slot]--);
+        this.size--;
+
+        // A subtree's smallest item is named by the deepest ancestor
+        // reached through a child other than its first
+        if (at === 0 && leaf.items.length > 0) {
+            for (let level = path.length - 1; level >= 0; level--) {
+                if (path[level].slot === 0) continue;
+                path[level].node.lows[path[level].slot] = leaf.items[0];
+                break;
+            }
+        }
+
+        for (let level = path.length - 1; level >= 0; level--) {
+            if (!this.rebalance(path[level].node, path[level].slot)) break;
+        }
+        if (!this.root.leaf && this.root.children.length === 1) {
+            this.root = this.root.children[0];
+        }
+        return true;
+    }
+
+    /**
+     * Refill child slot of parent if it is under half full: borrow from a
+     * sibling that can spare one, else merge with it
+     * Returns true if parent lost a child
+     */
+    rebalance(parent, slot) {
+        const count = node => (node.leaf ? node.items.length : node.children.length);
+        const child = parent.children[slot];
+        const min = (child.leaf ? LEAF_MAX : BRANCH_MAX) >> 1;
+        if (count(child) >= min) return false;
+
+        if (slot > 0) {
+            const left = parent.children[slot - 1];
+            if (count(left) <= min) {
+                this.merge(parent, slot - 1);
+                return true;
+            }
+            let moved = 1;
+            if (child.leaf) {
+                child.items.unshift(left.items.pop());
+                parent.lows[slot] = child.items[0];
+            } else {
+                moved = left.sizes.pop();
+                child.lows[0] = parent.lows[slot];
+                child.children.unshift(left.children.pop());
+                child.lows.unshift(left.lows.pop());
+                child.sizes.unshift(moved);
+                parent.lows[slot] = child.lows[0];
+            }
+            parent.sizes[slot - 1] -= moved;
+            parent.sizes[slot] += moved;
+            return false;
+        }
+
+        const right = parent.children[slot + 1];
+        if (count(right) <= min) {
+            this.merge(parent, slot);
+            return true;
+        }
+        let moved = 1;
+        if (child.leaf) {
+            child.items.push(right.items.shift());
+        } else {
+            moved = right.sizes.shift();
+            child.children.push(right.children.shift());
+            child.lows.push(parent.lows[slot + 1]);
+            child.sizes.push(moved);
+            right.lows.shift();
+        }
+        parent.lows[slot + 1] = right.leaf ? right.items[0] : right.lows[0];
+        parent.sizes[slot] += moved;
+        parent.sizes[slot + 1] -= moved;
+        return false;
+    }
+
+    /**
+     * Merge child slot + 1 of parent into child slot
+     */
+    merge(parent, slot) {
+        const left = parent.children[slot];
+        const right = parent.children[slot + 1];
+        if (left.leaf) {
+            left.items.push(...right.items);
+            left.next = right.next;
+        } else {
+            right.lows[0] = parent.lows[slot + 1];
+            left.children.push(...right.children);
+            left.lows.push(...right.lows);
+            left.sizes.push(...right.sizes);
+        }
+        parent.sizes[slot] += parent.sizes[slot + 1];
+        parent.children.splice(slot + 1, 1);
+        parent.lows.splice(slot + 1, 1);
+        parent.sizes.splice(slot + 1, 1);
+    }
+
+    /**
+     * Replace the contents with items, sorted once and packed bottom-up
+     * Time Complexity: O(n log n) for the sort, O(n) to pack
+     */
+    build(items) {
+        const sorted = [...items].sort(this.compare);
+        const pack = (nodes, max, make) => {
+            const groups = Math.max(1, Math.ceil(nodes.length / max));
+            const packed = [];
+            for (let g = 0, at = 0; g < groups; g++) {
+                const take = Math.floor(nodes.length / groups) + (g < nodes.length % groups ? 1 : 0);
+                packed.push(make(nodes.slice(at, at + take)));
+                at += take;
+            }
+            return packed;
+        };
+
+        let level = pack(sorted, LEAF_MAX, group => ({ leaf: true, items: group, next: null }));
+        level.forEach((leaf, i) => { leaf.next = level[i + 1] || null; });
+        const lowOf = node => (node.leaf ? node.items[0] : node.lows[0]);
+        const sizeOf = node => (node.leaf ? node.items.length : BPlusTree.total(node));
+        while (level.length > 1) {
+            level = pack(level, BRANCH_MAX, group => ({
+                leaf: false,
+                children: group,
+                lows: group.map(lowOf),
+                sizes: group.map(sizeOf)
+            }));
+        }
+
+        this.root = level[0];
+        this.size = sorted.length;
+    }
+
+    /**
+     * Call visit(item) for items in order from position offset until it
+     * returns false
+     * Time Complexity: O(log n + items visited)
+     */
+    forEach(visit, offset = 0) {
+        if (offset >= this.size) return;
+        let node = this.root;
+        while (!node.leaf) {
+            let slot = 0;
+            while (offset >= node.sizes[slot]) offset -= node.sizes[slot++];
+            node = node.children[slot];
+        }
+        for (; node; node = node.next, offset = 0) {
+            for (let i = offset; i < node.items.length; i++) {
+                if (visit(node.items[i]) === false) return;
+            }
+        }
+    }
+
+    /**
+     * Items at positions offset .. offset + limit - 1
+     * Time Complexity: O(log n + limit)
+     */
+    slice(offset = 0, limit = Infinity) {
+        const items = [];
+        if (limit <= 0) return items;
+        this.forEach(item => {
+            items.push(item);
+            return items.length < limit;
+        }, offset);
+        return items;
+    }
+
+    /**
+     * Position item has (or would have) in sorted order
+     * Time Complexity: O(log n)
+     */
+    rank(item) {
+        let position = 0;
+        let node = this.root;
+        while (!node.leaf) {
+            const slot = this.childIndex(node, item);
+            for (let i = 0; i < slot; i++) position += node.sizes[i];
+            node = node.children[slot];
+        }
+        return position + this.lowerBound(node.items, item);
+    }
+
+    /**
+     * Number of items
+     * Time Complexity: O(1)
+     */
+    getSize() {
+        return this.size;
+    }
+}
+
+// Export for use in browser and Node.js
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = BPlusTree;
+}
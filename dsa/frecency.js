@@ -0,0 +1,57 @@
+/**
+ * Frecency Implementation
+ * Used to rank bookmarks by "frequently AND recently" visited
+ *
+ * Each visit is worth 1 when it happens and half as much every
+ * half-life after. Decaying every score as time passes would mean
+ * rescoring every bookmark; instead a bookmark stores
+ * SCALE * log2 of its visits' weights measured at a fixed epoch, plus
+ * OFFSET so 0 can mean "never visited". Time moving on scales every
+ * weight by the same factor, a constant shift of every stored score, so
+ * stored scores keep their order forever: the heap and trie rank on
+ * them directly, a visit rewrites one score, and decay is only applied
+ * when a value is read (value).
+ */
+
+const FRECENCY_HALF_LIFE_MS = 30 * 24 * 60 * 60 * 1000; // a visit's weight halves every 30 days
+const FRECENCY_SCALE = 4096; // score units per half-life
+const FRECENCY_OFFSET = 2 ** 30; // score of a single visit at the epoch
+const FRECENCY_MAX = 2 ** 31 - 1;
+
+class Frecency {
+    constructor(halfLife = FRECENCY_HALF_LIFE_MS, epoch = Date.now()) {
+        this.halfLife = halfLife; // ms
+        this.epoch = epoch;       // ms; scores are relative to it
+    }
+
+    /**
+     * Fold a visit at time (ms) into a score (0 = never visited)
+     * Two scores combine as max + SCALE * log2(1 + 2^(-gap / SCALE)),
+     * the log of the sum of their weights, so visits may come in any order
+     * Time Complexity: O(1)
+     */
+    add(score, time = Date.now()) {
+        let result = FRECENCY_OFFSET + FRECENCY_SCALE * (time - this.epoch) / this.halfLife;
+        if (score > 0) {
+            const high = Math.max(score, result);
+            const low = Math.min(score, result);
+            result = high + FRECENCY_SCALE * Math.log2(1 + 2 ** ((low - high) / FRECENCY_SCALE));
+        }
+        return Math.min(Math.max(Math.round(result), 1), FRECENCY_MAX);
+    }
+
+    /**
+     * Decayed value of a score at time now: the sum of the visits'
+     * weights, each halved once per half-life since it happened
+     * Time Complexity: O(1)
+     */
+    value(score, now = Date.now()) {
+        if (!score) return 0;
+        return 2 ** ((score - FRECENCY_OFFSET) / FRECENCY_SCALE - (now - this.epoch) / this.halfLife);
+    }
+}
+
+// Export for use in browser and Node.js
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = Frecency;
+}
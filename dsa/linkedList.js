@@ -1,14 +1,18 @@
 /**
- * Singly Linked List Implementation
- * Used to store recently visited bookmarks (newest first - stack behavior)
+ * Doubly Linked List Implementation
+ * Used to store recently visited bookmarks (newest first - LRU order)
  * 
  * Each node stores: bookmark data + timestamp
  * Maximum capacity: configurable
+ *
+ * Nodes link both ways and a Map indexes them by URL, so lookup,
+ * move-to-front, delete and evicting the oldest are all O(1)
  */
 
 class LinkedListNode {
     constructor(bookmarkData) {
         this.data = bookmarkData; // {url, title, category, visitCount, timestamp}
+        this.prev = null;
         this.next = null;
     }
 }
@@ -19,23 +23,62 @@ class LinkedList {
         this.tail = null;
         this.size = 0;
         this.maxSize = maxSize; // Maximum number of recent items to keep
+        this.nodes = new Map(); // url -> node
     }
 
     /**
-     * Insert bookmark at the beginning (most recent)
+     * Detach node from its neighbours
      * Time Complexity: O(1)
      */
-    insertAtBeginning(bookmarkData) {
-        const newNode = new LinkedListNode(bookmarkData);
+    unlink(node) {
+        if (node.prev !== null) {
+            node.prev.next = node.next;
+        } else {
+            this.head = node.next;
+        }
+
+        if (node.next !== null) {
+            node.next.prev = node.prev;
+        } else {
+            this.tail = node.prev;
+        }
+
+        node.prev = null;
+        node.next = null;
+    }
+
+    /**
+     * Attach a detached node before the head
+     * Time Complexity: O(1)
+     */
+    linkFront(node) {
+        node.next = this.head;
 
         if (this.head === null) {
-            this.head = newNode;
-            this.tail = newNode;
+            this.tail = node;
         } else {
-            newNode.next = this.head;
-            this.head = newNode;
+            this.head.prev = node;
         }
 
+        this.head = node;
+    }
+
+    /**
+     * Insert bookmark at the beginning (most recent)
+     * A bookmark already in the list is moved up and its data replaced.
+     * Time Complexity: O(1)
+     */
+    insertAtBeginning(bookmarkData) {
+        const existing = this.nodes.get(bookmarkData.url);
+        if (existing) {
+            existing.data = bookmarkData;
+            this.moveToFront(bookmarkData.url);
+            return;
+        }
+
+        const newNode = new LinkedListNode(bookmarkData);
+        this.linkFront(newNode);
+        this.nodes.set(bookmarkData.url, newNode);
         this.size++;
 
         // Remove oldest if exceeds max size
@@ -46,63 +89,31 @@ class LinkedList {
 
     /**
      * Move bookmark to front (mark as recently accessed)
-     * Time Complexity: O(n) - needs to find node
+     * Time Complexity: O(1)
      */
     moveToFront(bookmarkURL) {
-        let current = this.head;
-        let prev = null;
+        const node = this.nodes.get(bookmarkURL);
+        if (!node) return false;
 
-        // Find the node
-        while (current !== null) {
-            if (current.data.url === bookmarkURL) {
-                // Remove from current position
-                if (prev !== null) {
-                    prev.next = current.next;
-                } else {
-                    this.head = current.next;
-                }
-
-                if (current === this.tail) {
-                    this.tail = prev;
-                }
-
-                this.size--;
-
-                // Insert at beginning
-                this.insertAtBeginning(current.data);
-                return true;
-            }
-            prev = current;
-            current = current.next;
+        if (node !== this.head) {
+            this.unlink(node);
+            this.linkFront(node);
         }
-        return false;
+        return true;
     }
 
     /**
      * Remove from end (oldest bookmark)
-     * Time Complexity: O(n) - single linked list
+     * Time Complexity: O(1)
      */
     removeFromEnd() {
-        if (this.head === null) return null;
-
-        if (this.head === this.tail) {
-            const data = this.head.data;
-            this.head = null;
-            this.tail = null;
-            this.size--;
-            return data;
-        }
+        if (this.tail === null) return null;
 
-        let current = this.head;
-        while (current.next !== this.tail) {
-            current = current.next;
-        }
-
-        const data = this.tail.data;
-        current.next = null;
-        this.tail = current;
+        const node = this.tail;
+        this.unlink(node);
+        this.nodes.delete(node.data.url);
         this.size--;
-        return data;
+        return node.data;
     }
 
     /**
@@ -123,55 +134,24 @@ class LinkedList {
 
     /**
      * Check if bookmark exists in list
-     * Time Complexity: O(n)
+     * Time Complexity: O(1)
      */
     contains(bookmarkURL) {
-        let current = this.head;
-
-        while (current !== null) {
-            if (current.data.url === bookmarkURL) {
-                return true;
-            }
-            current = current.next;
-        }
-
-        return false;
+        return this.nodes.has(bookmarkURL);
     }
 
     /**
      * Delete specific bookmark by URL
-     * Time Complexity: O(n)
+     * Time Complexity: O(1)
      */
     delete(bookmarkURL) {
-        if (this.head === null) return false;
-
-        // If head needs to be deleted
-        if (this.head.data.url === bookmarkURL) {
-            this.head = this.head.next;
-            if (this.size === 1) {
-                this.tail = null;
-            }
-            this.size--;
-            return true;
-        }
+        const node = this.nodes.get(bookmarkURL);
+        if (!node) return false;
 
-        let current = this.head;
-        let prev = null;
-
-        while (current !== null) {
-            if (current.data.url === bookmarkURL) {
-                prev.next = current.next;
-                if (current === this.tail) {
-                    this.tail = prev;
-                }
-                this.size--;
-                return true;
-            }
-            prev = current;
-            current = current.next;
-        }
-
-        return false;
+        this.unlink(node);
+        this.nodes.delete(bookmarkURL);
+        this.size--;
+        return true;
     }
 
     /**
@@ -182,6 +162,7 @@ class LinkedList {
         this.head = null;
         this.tail = null;
         this.size = 0;
+        this.nodes = new Map();
     }
 
     /**
@@ -4,11 +4,19 @@
  * 
  * Root element is always the minimum (least visited bookmark)
  * Useful for eviction strategies and analytics
+ *
+ * Indexed heap: positions maps each bookmark URL to its slot, so
+ * updates and deletes by URL are O(log n) instead of a linear scan
+ *
+ * Ordered on one numeric field of the bookmark, visitCount unless the
+ * constructor names another (e.g. 'frecency')
  */
 
 class MinHeap {
-    constructor() {
+    constructor(key = 'visitCount') {
         this.heap = [];
+        this.positions = new Map(); // url -> index in heap
+        this.key = key; // bookmark field the heap orders on
     }
 
     /**
@@ -37,15 +45,44 @@ class MinHeap {
      */
     swap(index1, index2) {
         [this.heap[index1], this.heap[index2]] = [this.heap[index2], this.heap[index1]];
+        this.positions.set(this.heap[index1].url, index1);
+        this.positions.set(this.heap[index2].url, index2);
     }
 
     /**
-     * Insert bookmark into min heap based on visit count
+     * Insert bookmark into min heap based on its key
      * Time Complexity: O(log n)
      */
     insert(bookmarkData) {
+        if (this.positions.has(bookmarkData.url)) {
+            return this.updateBookmark(bookmarkData.url, bookmarkData[this.key]);
+        }
+
         this.heap.push(bookmarkData);
+        this.positions.set(bookmarkData.url, this.heap.length - 1);
         this.heapifyUp(this.heap.length - 1);
+        return true;
+    }
+
+    /**
+     * Replace heap contents with bookmarks in one pass (bottom-up heapify)
+     * Sifting down from the last parent to the root is O(n) in total,
+     * against O(n log n) for n separate inserts. Repeated URLs keep the
+     * first entry.
+     * Time Complexity: O(n)
+     */
+    build(bookmarks) {
+        this.clear();
+
+        for (const bookmark of bookmarks) {
+            if (this.positions.has(bookmark.url)) continue;
+            this.positions.set(bookmark.url, this.heap.length);
+            this.heap.push(bookmark);
+        }
+
+        for (let i = this.getParentIndex(this.heap.length - 1); i >= 0; i--) {
+            this.heapifyDown(i);
+        }
     }
 
     /**
@@ -56,8 +93,8 @@ class MinHeap {
         while (index > 0) {
             const parentIndex = this.getParentIndex(index);
 
-            // If parent's visitCount > current's visitCount, swap
-            if (this.heap[parentIndex].visitCount > this.heap[index].visitCount) {
+            // If parent's key > current's key, swap
+            if (this.heap[parentIndex][this.key] > this.heap[index][this.key]) {
                 this.swap(parentIndex, index);
                 index = parentIndex;
             } else {
@@ -72,14 +109,29 @@ class MinHeap {
      */
     extractMin() {
         if (this.heap.length === 0) return null;
-        if (this.heap.length === 1) return this.heap.pop();
 
         const min = this.heap[0];
-        this.heap[0] = this.heap.pop();
-        this.heapifyDown(0);
+        this.removeAt(0);
         return min;
     }
 
+    /**
+     * Remove the element at index and restore heap order
+     * Time Complexity: O(log n)
+     */
+    removeAt(index) {
+        this.positions.delete(this.heap[index].url);
+        const last = this.heap.pop();
+
+        // Move last element into the hole unless it was the removed one
+        if (index < this.heap.length) {
+            this.heap[index] = last;
+            this.positions.set(last.url, index);
+            this.heapifyUp(index);
+            this.heapifyDown(index);
+        }
+    }
+
     /**
      * Move element down to maintain min heap property
      * Time Complexity: O(log n)
@@ -93,7 +145,7 @@ class MinHeap {
             // Check left child
             if (
                 leftChildIndex < this.heap.length &&
-                this.heap[leftChildIndex].visitCount < this.heap[minIndex].visitCount
+                this.heap[leftChildIndex][this.key] < this.heap[minIndex][this.key]
             ) {
                 minIndex = leftChildIndex;
             }
@@ -101,7 +153,7 @@ class MinHeap {
             // Check right child
             if (
                 rightChildIndex < this.heap.length &&
-                this.heap[rightChildIndex].visitCount < this.heap[minIndex].visitCount
+                this.heap[rightChildIndex][this.key] < this.heap[minIndex][this.key]
             ) {
                 minIndex = rightChildIndex;
             }
@@ -125,50 +177,29 @@ class MinHeap {
     }
 
     /**
-     * Update a bookmark's visit count and re-heapify
-     * Time Complexity: O(n) in worst case, but typically faster
+     * Update a bookmark's key and re-heapify
+     * The key may already have been changed on the shared bookmark
+     * object, so both directions are checked instead of comparing
+     * against the old key.
+     * Time Complexity: O(log n)
      */
-    updateBookmark(bookmarkURL, newVisitCount) {
-        let index = -1;
-
-        // Find bookmark index
-        for (let i = 0; i < this.heap.length; i++) {
-            if (this.heap[i].url === bookmarkURL) {
-                index = i;
-                break;
-            }
-        }
+    updateBookmark(bookmarkURL, newKey) {
+        const index = this.positions.get(bookmarkURL);
+        if (index === undefined) return false; // Not found
 
-        if (index === -1) return false; // Not found
-
-        const oldCount = this.heap[index].visitCount;
-        this.heap[index].visitCount = newVisitCount;
-
-        // Re-heapify based on whether count increased or decreased
-        if (newVisitCount < oldCount) {
-            this.heapifyUp(index);
-        } else if (newVisitCount > oldCount) {
-            this.heapifyDown(index);
-        }
+        this.heap[index][this.key] = newKey;
+        this.heapifyUp(index);
+        this.heapifyDown(this.positions.get(bookmarkURL));
 
         return true;
     }
 
     /**
-     * Get all bookmarks sorted by visit count (ascending)
-     * Time Complexity: O(n log n) due to repeated extractMin
+     * Get all bookmarks sorted by key (ascending)
+     * Time Complexity: O(n log n)
      */
     getAllSorted() {
-        const sorted = [];
-        const tempHeap = [...this.heap]; // Make copy
-
-        while (this.heap.length > 0) {
-            sorted.push(this.extractMin());
-        }
-
-        // Restore original heap
-        this.heap = tempHeap;
-        return sorted;
+        return [...this.heap].sort((a, b) => a[this.key] - b[this.key]);
     }
 
     /**
@@ -181,29 +212,21 @@ class MinHeap {
 
     /**
      * Check if bookmark exists
-     * Time Complexity: O(n)
+     * Time Complexity: O(1)
      */
     contains(bookmarkURL) {
-        return this.heap.some(bookmark => bookmark.url === bookmarkURL);
+        return this.positions.has(bookmarkURL);
     }
 
     /**
      * Delete bookmark by URL and re-heapify
-     * Time Complexity: O(n)
+     * Time Complexity: O(log n)
      */
     delete(bookmarkURL) {
-        const index = this.heap.findIndex(item => item.url === bookmarkURL);
-        if (index === -1) return false;
-
-        // Move last element to deleted position
-        this.heap[index] = this.heap.pop();
-
-        // Re-heapify if not the last element
-        if (index < this.heap.length) {
-            this.heapifyUp(index);
-            this.heapifyDown(index);
-        }
+        const index = this.positions.get(bookmarkURL);
+        if (index === undefined) return false;
 
+        this.removeAt(index);
         return true;
     }
 
@@ -219,14 +242,65 @@ class MinHeap {
      */
     clear() {
         this.heap = [];
+        this.positions.clear();
+    }
+
+    /**
+     * Get the k least visited bookmarks in order without modifying the heap
+     * Walks the heap best-first with a small frontier heap of indexes:
+     * start at the root, and each index taken adds its two children.
+     * Time Complexity: O(k log k)
+     */
+    extractK(k) {
+        const result = [];
+        if (this.heap.length === 0 || k <= 0) return result;
+
+        const keyAt = (index) => this.heap[index][this.key];
+        const frontier = [0];
+
+        while (result.length < k && frontier.length > 0) {
+            // Pop the frontier index with the smallest key
+            const index = frontier[0];
+            const last = frontier.pop();
+            if (frontier.length > 0) {
+                let hole = 0;
+                while (true) {
+                    let child = 2 * hole + 1;
+                    if (child >= frontier.length) break;
+                    if (child + 1 < frontier.length && keyAt(frontier[child + 1]) < keyAt(frontier[child])) {
+                        child++;
+                    }
+                    if (keyAt(frontier[child]) >= keyAt(last)) break;
+                    frontier[hole] = frontier[child];
+                    hole = child;
+                }
+                frontier[hole] = last;
+            }
+
+            result.push(this.heap[index]);
+
+            // Its children are the next candidates
+            for (const child of [this.getLeftChildIndex(index), this.getRightChildIndex(index)]) {
+                if (child >= this.heap.length) continue;
+                let slot = frontier.length;
+                frontier.push(child);
+                while (slot > 0 && keyAt(frontier[(slot - 1) >> 1]) > keyAt(child)) {
+                    frontier[slot] = frontier[(slot - 1) >> 1];
+                    slot = (slot - 1) >> 1;
+                }
+                frontier[slot] = child;
+            }
+        }
+
+        return result;
     }
 
     /**
      * Get least visited bookmarks (bottom of heap)
-     * Time Complexity: O(k) where k = count
+     * Time Complexity: O(k log k) where k = count
      */
     getLeastVisited(count = 5) {
-        return this.getAllSorted().slice(0, count);
+        return this.extractK(count);
     }
 }
 
@@ -0,0 +1,357 @@
+/**
+ * Roaring Bitmap Implementation
+ * Used to keep the bookmark ids of each category for instant filtering
+ *
+ * Ids are split into a high 16-bit key and a low 16-bit value. Each key
+ * owns one container with the low values:
+ * - Array:  sorted Uint16Array while it holds up to ARRAY_MAX values
+ * - Bitmap: 65536 bits in a Uint32Array once it holds more
+ * Sparse categories cost 2 bytes per bookmark, dense ones 1 bit, and
+ * union / intersection combine whole containers instead of scanning
+ * every bookmark. Sizes are kept per container, so counts are O(1).
+ */
+
+const ARRAY_MAX = 4096;
+const BITMAP_WORDS = 2048; // 32-bit words per 65536-bit container
+
+class RoaringBitmap {
+    constructor() {
+        this.keys = [];       // sorted high halves
+        this.containers = []; // parallel to keys: { bits, values, size }
+        this.cardinality = 0;
+    }
+
+    /**
+     * Index of key in keys, or -(insertion point) - 1
+     * Time Complexity: O(log c) where c = containers
+     */
+    findKey(key) {
+        let low = 0;
+        let high = this.keys.length - 1;
+        while (low <= high) {
+            const mid = (low + high) >> 1;
+            if (this.keys[mid] === key) return mid;
+            if (this.keys[mid] < key) low = mid + 1;
+            else high = mid - 1;
+        }
+        return -low - 1;
+    }
+
+    /**
+     * First index in a sorted array container holding a value >= low
+     * Time Complexity: O(log n)
+     */
+    static lowerBound(container, low) {
+        let lo = 0;
+        let hi = container.size;
+        while (lo < hi) {
+            const mid = (lo + hi) >> 1;
+            if (container.values[mid] < low) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    /**
+     * Does a container hold low?
+     * Time Complexity: O(1) for bitmaps, O(log n) for arrays
+     */
+    static containerHas(container, low) {
+        if (container.bits) return ((container.bits[low >>> 5] >>> (low & 31)) & 1) === 1;
+        const at = RoaringBitmap.lowerBound(container, low);
+        return at < container.size && container.values[at] === low;
+    }
+
+    /**
+     * Bits of any container
+     * Time Complexity: O(BITMAP_WORDS + n)
+     */
+    static expand(container) {
+        if (container.bits) return container.bits;
+        const bits = new Uint32Array(BITMAP_WORDS);
+        for (let i = 0; i < container.size; i++) bits[container.values[i] >>> 5] |= 1 << (container.values[i] & 31);
+        return bits;
+    }
+
+    /**
+     * Container from sorted values (bitmap once above ARRAY_MAX)
+     */
+    static fromValues(values, size) {
+        if (size <= ARRAY_MAX) return { bits: null, values: values.slice(0, size), size };
+        return { bits: RoaringBitmap.expand({ values, size }), values: null, size };
+    }
+
+    /**
+     * Container from bits (array form when at most ARRAY_MAX are set)
+     */
+    static fromBits(bits, size) {
+        if (size > ARRAY_MAX) return { bits, values: null, size };
+
+        const values = new Uint16Array(size);
+        let count = 0;
+        for (let w = 0; w < BITMAP_WORDS; w++) {
+            for (let word = bits[w]; word !== 0; word &= word - 1) {
+                values[count++] = (w << 5) | (31 - Math.clz32(word & -word));
+            }
+        }
+        return { bits: null, values, size };
+    }
+
+    /**
+     * Set bits in a 32-bit word
+     */
+    static popcount(word) {
+        word -= (word >>> 1) & 0x55555555;
+        word = (word & 0x33333333) + ((word >>> 2) & 0x33333333);
+        return (((word + (word >>> 4)) & 0x0f0f0f0f) * 0x01010101) >>> 24;
+    }
+
+    /**
+     * Add id; returns true if it was not in the set
+     * Time Complexity: O(log c + ARRAY_MAX); ids added in increasing order shift nothing
+     */
+    add(id) {
+        const key = id >>> 16;
+        const low = id & 0xffff;
+        let index = this.findKey(key);
+        if (index < 0) {
+            index = -index - 1;
+            this.keys.splice(index, 0, key);
+            this.containers.splice(index, 0, { bits: null, values: new Uint16Array(4), size: 0 });
+        }
+
+        const container = this.containers[index];
+        if (container.bits) {
+            if (RoaringBitmap.containerHas(container, low)) return false;
+            container.bits[low >>> 5] |= 1 << (low & 31);
+        } else {
+            const at = RoaringBitmap.lowerBound(container, low);
+            if (at < container.size && container.values[at] === low) return false;
+
+            if (container.size === ARRAY_MAX) {
+                this.containers[index] = { bits: RoaringBitmap.expand(container), values: null, size: container.size };
+                return this.add(id);
+            }
+            if (container.size === container.values.length) {
+                const grown = new Uint16Array(Math.min(container.values.length * 2, ARRAY_MAX));
+                grown.set(container.values);
+                container.values = grown;
+            }
+            container.values.copyWithin(at + 1, at, container.size);
+            container.values[at] = low;
+        }
+        container.size++;
+        this.cardinality++;
+        return true;
+    }
+
+    /**
+     * Remove id; returns true if it was in the set
+     * Time Complexity: O(log c + ARRAY_MAX)
+     */
+    remove(id) {
+        const index = this.findKey(id >>> 16);
+        if (index < 0) return false;
+        const container = this.containers[index];
+        const low = id & 0xffff;
+
+        if (container.bits) {
+            if (!RoaringBitmap.containerHas(container, low)) return false;
+            container.bits[low >>> 5] &= ~(1 << (low & 31));
+            container.size--;
+            // Back to an array at half the limit, so the boundary does not flip-flop
+            if (container.size <= ARRAY_MAX / 2) {
+                this.containers[index] = RoaringBitmap.fromBits(container.bits, container.size);
+            }
+        } else {
+            const at = RoaringBitmap.lowerBound(container, low);
+            if (at === container.size || container.values[at] !== low) return false;
+            container.values.copyWithin(at, at + 1, container.size);
+            container.size--;
+        }
+
+        if (container.size === 0) {
+            this.keys.splice(index, 1);
+            this.containers.splice(index, 1);
+        }
+        this.cardinality--;
+        return true;
+    }
+
+    /**
+     * Check whether id is in the set
+     * Time Complexity: O(log c + log ARRAY_MAX)
+     */
+    has(id) {
+        const index = this.findKey(id >>> 16);
+        return index >= 0 && RoaringBitmap.containerHas(this.containers[index], id & 0xffff);
+    }
+
+    /**
+     * Number of ids in the set
+     * Time Complexity: O(1)
+     */
+    getCardinality() {
+        return this.cardinality;
+    }
+
+    /**
+     * Combine two containers with the same key ('and', 'or' or 'andNot')
+     * Returns null when the result is empty
+     * Time Complexity: O(n + m) for two arrays, O(BITMAP_WORDS) otherwise
+     */
+    static combineContainers(a, b, op) {
+        if (!a.bits && !b.bits) {
+            // Merge two sorted arrays
+            const out = new Uint16Array(a.size + b.size);
+            let i = 0, j = 0, count = 0;
+            while (i < a.size && j < b.size) {
+                if (a.values[i] < b.values[j]) {
+                    if (op !== 'and') out[count++] = a.values[i];
+                    i++;
+                } else if (a.values[i] > b.values[j]) {
+                    if (op === 'or') out[count++] = b.values[j];
+                    j++;
+                } else {
+                    if (op !== 'andNot') out[count++] = a.values[i];
+                    i++;
+                    j++;
+                }
+            }
+            if (op !== 'and') while (i < a.size) out[count++] = a.values[i++];
+            if (op === 'or') while (j < b.size) out[count++] = b.values[j++];
+            return count > 0 ? RoaringBitmap.fromValues(out, count) : null;
+        }
+
+        if (!a.bits && op !== 'or') {
+            // Keep a's values that b has ('and') or lacks ('andNot')
+            const out = new Uint16Array(a.size);
+            let count = 0;
+            for (let i = 0; i < a.size; i++) {
+                if (RoaringBitmap.containerHas(b, a.values[i]) === (op === 'and')) out[count++] = a.values[i];
+            }
+            return count > 0 ? RoaringBitmap.fromValues(out, count) : null;
+        }
+        if (!b.bits && op === 'and') return RoaringBitmap.combineContainers(b, a, op);
+
+        // Word by word on bits (an array side is expanded first)
+        const wordsA = RoaringBitmap.expand(a);
+        const wordsB = RoaringBitmap.expand(b);
+        const bits = new Uint32Array(BITMAP_WORDS);
+        let size = 0;
+        for (let w = 0; w < BITMAP_WORDS; w++) {
+            const word = op === 'and' ? wordsA[w] & wordsB[w]
+                : op === 'or' ? wordsA[w] | wordsB[w]
+                    : wordsA[w] & ~wordsB[w];
+            bits[w] = word;
+            size += RoaringBitmap.popcount(word);
+        }
+        return size > 0 ? RoaringBitmap.fromBits(bits, size) : null;
+    }
+
+    /**
+     * New bitmap this <op> other, op = 'and', 'or' or 'andNot'
+     * Walks both key lists in order; containers on one side only are
+     * skipped or copied without looking inside.
+     * Time Complexity: O(c + container work)
+     */
+    combine(other, op) {
+        const result = new RoaringBitmap();
+        const append = (key, container) => {
+            if (!container) return;
+            result.keys.push(key);
+            result.containers.push(container);
+            result.cardinality += container.size;
+        };
+        const copy = container => ({
+            bits: container.bits && container.bits.slice(),
+            values: container.values && container.values.slice(0, container.size),
+            size: container.size
+        });
+
+        let i = 0, j = 0;
+        while (i < this.keys.length || j < other.keys.length) {
+            if (j === other.keys.length || (i < this.keys.length && this.keys[i] < other.keys[j])) {
+                if (op !== 'and') append(this.keys[i], copy(this.containers[i]));
+                i++;
+            } else if (i === this.keys.length || other.keys[j] < this.keys[i]) {
+                if (op === 'or') append(other.keys[j], copy(other.containers[j]));
+                j++;
+            } else {
+                append(this.keys[i], RoaringBitmap.combineContainers(this.containers[i], other.containers[j], op));
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Ids in either set
+     */
+    or(other) {
+        return this.combine(other, 'or');
+    }
+
+    /**
+     * Ids in both sets
+     */
+    and(other) {
+        return this.combine(other, 'and');
+    }
+
+    /**
+     * Ids in this set but not in other
+     */
+    andNot(other) {
+        return this.combine(other, 'andNot');
+    }
+
+    /**
+     * Union of any number of bitmaps
+     * Time Complexity: O(k * union size) for k bitmaps
+     */
+    static orMany(bitmaps) {
+        return bitmaps.reduce((union, bitmap) => union.or(bitmap), new RoaringBitmap());
+    }
+
+    /**
+     * Ids in increasing order, skipping offset of them, at most limit
+     * Containers inside the offset are skipped by their size.
+     * Time Complexity: O(c + BITMAP_WORDS + limit)
+     */
+    toArray(offset = 0, limit = Infinity) {
+        const ids = [];
+        for (let c = 0; c < this.containers.length && ids.length < limit; c++) {
+            const container = this.containers[c];
+            if (offset >= container.size) {
+                offset -= container.size;
+                continue;
+            }
+
+            const high = this.keys[c] * 65536;
+            if (!container.bits) {
+                for (let v = offset; v < container.size && ids.length < limit; v++) {
+                    ids.push(high + container.values[v]);
+                }
+            } else {
+                for (let w = 0; w < BITMAP_WORDS && ids.length < limit; w++) {
+                    for (let word = container.bits[w]; word !== 0 && ids.length < limit; word &= word - 1) {
+                        if (offset > 0) {
+                            offset--;
+                            continue;
+                        }
+                        ids.push(high + ((w << 5) | (31 - Math.clz32(word & -word))));
+                    }
+                }
+            }
+            offset = 0;
+        }
+        return ids;
+    }
+}
+
+// Export for use in browser and Node.js
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = RoaringBitmap;
+}
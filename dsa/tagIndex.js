@@ -0,0 +1,235 @@
+/**
+ * Tag Index Implementation
+ * Used to give a bookmark any number of tags and filter by
+ * "tag A AND tag B NOT tag C"
+ *
+ * Tag names are interned to small integer ids. Each tag keeps a sorted
+ * array of the bookmark ids carrying it (its length is the tag's count),
+ * and each bookmark keeps the ids of its tags, so untagging or deleting
+ * a bookmark only touches its own tags' arrays.
+ *
+ * Queries start from the rarest required tag, narrow it with each other
+ * required tag (AND) and then drop each excluded tag (NOT). Arrays of
+ * similar length are merged in one pass; when one is GALLOP_RATIO times
+ * shorter, its ids gallop (exponential then binary search) through the
+ * longer one, so a rare tag never walks a common tag's whole array.
+ */
+
+const TAG_MAX_NAME = 64;
+const GALLOP_RATIO = 32;
+
+class TagIndex {
+    constructor() {
+        this.names = [];          // tag id -> name
+        this.ids = new Map();     // name -> tag id
+        this.postings = [];       // tag id -> sorted bookmark ids
+        this.tagsById = [];       // bookmark id -> tag ids, in the order added
+    }
+
+    /**
+     * Trim a name and cut it to TAG_MAX_NAME characters
+     */
+    static normalize(name) {
+        return String(name).trim().slice(0, TAG_MAX_NAME);
+    }
+
+    /**
+     * Tag id of a name, or -1 if it was never used
+     * Time Complexity: O(m) where m = name length
+     */
+    find(name) {
+        const id = this.ids.get(TagIndex.normalize(name));
+        return id === undefined ? -1 : id;
+    }
+
+    /**
+     * Tag id of a name, creating the tag if it is new (-1 for an empty name)
+     * Time Complexity: O(m)
+     */
+    intern(name) {
+        const normalized = TagIndex.normalize(name);
+        if (normalized.length === 0) return -1;
+        let id = this.ids.get(normalized);
+        if (id === undefined) {
+            id = this.names.length;
+            this.names.push(normalized);
+            this.ids.set(normalized, id);
+            this.postings.push([]);
+        }
+        return id;
+    }
+
+    /**
+     * First index in a sorted array, at or after from, holding a value >= value
+     * Steps 1, 2, 4, ... from from, then binary searches the last step
+     * Time Complexity: O(log d) where d = distance moved
+     */
+    static gallop(array, from, value) {
+        let step = 1;
+        let low = from;
+        let high = from;
+        while (high < array.length && array[high] < value) {
+            low = high + 1;
+            high = from + step;
+            step *= 2;
+        }
+        high = Math.min(high, array.length);
+        while (low < high) {
+            const mid = (low + high) >> 1;
+            if (array[mid] < value) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    /**
+     * Give a bookmark a tag; returns false if it already has it
+     * Time Complexity: O(k + log p) where k = the bookmark's tags,
+     * p = bookmarks with the tag (plus the shift, unless id is the largest)
+     */
+    add(id, tag) {
+        if (tag < 0 || tag >= this.names.length) return false;
+        const tags = this.tagsById[id] || (this.tagsById[id] = []);
+        if (tags.includes(tag)) return false;
+
+        tags.push(tag);
+        const posting = this.postings[tag];
+        if (posting.length === 0 || posting[posting.length - 1] < id) {
+            posting.push(id);
+        } else {
+            posting.splice(TagIndex.gallop(posting, 0, id), 0, id);
+        }
+        return true;
+    }
+
+    /**
+     * Take a tag off a bookmark; returns false if it did not have it
+     * Time Complexity: O(k + p)
+     */
+    remove(id, tag) {
+        const tags = this.tagsById[id];
+        const at = tags ? tags.indexOf(tag) : -1;
+        if (at < 0) return false;
+
+        tags.splice(at, 1);
+        const posting = this.postings[tag];
+        posting.splice(TagIndex.gallop(posting, 0, id), 1);
+        return true;
+    }
+
+    /**
+     * Take every tag off a bookmark (before its id is reused)
+     * Time Complexity: O(k * p)
+     */
+    clear(id) {
+        const tags = this.tagsById[id];
+        if (!tags) return;
+        [...tags].forEach(tag => this.remove(id, tag));
+        this.tagsById[id] = undefined;
+    }
+
+    /**
+     * Names of a bookmark's tags, in the order they were added
+     * Time Complexity: O(k)
+     */
+    tagsOf(id) {
+        return (this.tagsById[id] || []).map(tag => this.names[tag]);
+    }
+
+    /**
+     * Bookmarks with a tag (the length of its posting array)
+     * Time Complexity: O(1)
+     */
+    count(tag) {
+        return tag >= 0 && tag < this.postings.length ? this.postings[tag].length : 0;
+    }
+
+    /**
+     * Every tag with its count, in first-use order
+     * Time Complexity: O(t) where t = tags
+     */
+    getTags() {
+        return this.names.map((name, tag) => ({ tag, name, count: this.postings[tag].length }));
+    }
+
+    /**
+     * Ids in a and in b (or, with exclude, in a and not in b)
+     * Both arrays must be sorted; the result is sorted
+     * Time Complexity: O(a + b), or O(s log(l / s)) when one array is
+     * GALLOP_RATIO times shorter (s = shorter, l = longer)
+     */
+    static merge(a, b, exclude = false) {
+        const out = [];
+        if (a.length * GALLOP_RATIO < b.length) {
+            // Few ids in a: look each one up in b
+            let j = 0;
+            for (const id of a) {
+                j = TagIndex.gallop(b, j, id);
+                if ((j < b.length && b[j] === id) !== exclude) out.push(id);
+            }
+            return out;
+        }
+        if (b.length * GALLOP_RATIO < a.length) {
+            // Few ids in b: jump through a from one to the next
+            let i = 0;
+            for (const id of b) {
+                const at = TagIndex.gallop(a, i, id);
+                if (exclude) {
+                    for (; i < at; i++) out.push(a[i]);
+                } else if (at < a.length && a[at] === id) {
+                    out.push(id);
+                }
+                i = at < a.length && a[at] === id ? at + 1 : at;
+            }
+            if (exclude) for (; i < a.length; i++) out.push(a[i]);
+            return out;
+        }
+
+        let i = 0;
+        let j = 0;
+        while (i < a.length && j < b.length) {
+            if (a[i] < b[j]) {
+                if (exclude) out.push(a[i]);
+                i++;
+            } else if (a[i] > b[j]) {
+                j++;
+            } else {
+                if (!exclude) out.push(a[i]);
+                i++;
+                j++;
+            }
+        }
+        if (exclude) for (; i < a.length; i++) out.push(a[i]);
+        return out;
+    }
+
+    /**
+     * Sorted ids with every tag named in all and none named in none
+     * An unknown name in all matches nothing; unknown names in none are
+     * ignored. With no names in all, the query starts from everyIds
+     * (sorted ids of every bookmark).
+     * Time Complexity: O(r) for r = bookmarks with the rarest required
+     * tag, plus one merge per other tag
+     */
+    query(all, none = [], everyIds = []) {
+        const required = all.map(name => this.find(name));
+        if (required.includes(-1)) return [];
+
+        // Rarest first: every later merge is bounded by the running result
+        required.sort((x, y) => this.postings[x].length - this.postings[y].length);
+        let result = required.length > 0 ? [...this.postings[required[0]]] : [...everyIds];
+        for (let t = 1; t < required.length && result.length > 0; t++) {
+            result = TagIndex.merge(result, this.postings[required[t]]);
+        }
+        for (const name of none) {
+            const tag = this.find(name);
+            if (tag >= 0 && result.length > 0) result = TagIndex.merge(result, this.postings[tag], true);
+        }
+        return result;
+    }
+}
+
+// Export for use in browser and Node.js
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = TagIndex;
+}
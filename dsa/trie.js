@@ -10,6 +10,8 @@ class TrieNode {
         this.children = {}; // Map of character -> TrieNode
         this.isEndOfWord = false;
         this.bookmarkURL = null; // Store reference to bookmark when at end of word
+        this.score = 0; // Ranking score (e.g. visit count) when at end of word
+        this.maxScore = 0; // Best score anywhere in this subtree
     }
 }
 
@@ -21,10 +23,12 @@ class Trie {
 
     /**
      * Insert a word (bookmark title) into the trie
+     * score is optional; an existing word keeps its score when omitted
      * Time Complexity: O(m) where m = word length
      */
-    insert(word, bookmarkURL) {
+    insert(word, bookmarkURL, score) {
         let node = this.root;
+        const path = [node];
 
         // Traverse/create path for each character
         for (let char of word.toLowerCase()) {
@@ -32,14 +36,72 @@ class Trie {
                 node.children[char] = new TrieNode();
             }
             node = node.children[char];
+            path.push(node);
         }
 
         // Mark end of word and store bookmark reference
         if (!node.isEndOfWord) {
             this.wordCount++;
+            node.score = 0;
         }
         node.isEndOfWord = true;
         node.bookmarkURL = bookmarkURL;
+        if (score !== undefined) {
+            node.score = score;
+        }
+
+        this.refreshPath(path);
+    }
+
+    /**
+     * Change the ranking score of an existing word
+     * Time Complexity: O(m) where m = word length
+     */
+    setScore(word, score) {
+        let node = this.root;
+        const path = [node];
+
+        for (let char of word.toLowerCase()) {
+            if (!node.children[char]) {
+                return false;
+            }
+            node = node.children[char];
+            path.push(node);
+        }
+
+        if (!node.isEndOfWord) {
+            return false;
+        }
+
+        node.score = score;
+        this.refreshPath(path);
+        return true;
+    }
+
+    /**
+     * Recompute a node's cached subtree max from its own score and children
+     * Time Complexity: O(c) where c = number of children
+     */
+    refreshMax(node) {
+        let best = node.isEndOfWord ? node.score : 0;
+        for (let char in node.children) {
+            best = Math.max(best, node.children[char].maxScore);
+        }
+        node.maxScore = best;
+    }
+
+    /**
+     * Refresh cached maxima from the last node in path back to the root
+     * Stops at the first ancestor whose max is unaffected
+     */
+    refreshPath(path) {
+        for (let i = path.length - 1; i >= 0; i--) {
+            const oldMax = path[i].maxScore;
+            this.refreshMax(path[i]);
+            if (i < path.length - 1 && path[i].maxScore === oldMax) {
+                break;
+            }
+        }
     }
 
     /**
@@ -64,6 +126,80 @@ class Trie {
         return results;
     }
 
+    /**
+     * Find the k highest-scoring words with given prefix (best-first search)
+     * Subtrees are only expanded while their cached maxScore can still
+     * place, so short prefixes don't walk the whole subtree.
+     * Time Complexity: O(m + k log k) where m = prefix length
+     */
+    topK(prefix, k) {
+        let node = this.root;
+        prefix = prefix.toLowerCase();
+
+        // Navigate to end of prefix
+        for (let char of prefix) {
+            if (!node.children[char]) {
+                return []; // Prefix not found
+            }
+            node = node.children[char];
+        }
+
+        // Max-heap of { score, isWord, node, word }; words win score ties
+        const heap = [];
+        const before = (a, b) => a.score !== b.score ? a.score > b.score : a.isWord && !b.isWord;
+        const push = (item) => {
+            let i = heap.length;
+            heap.push(item);
+            while (i > 0 && before(item, heap[(i - 1) >> 1])) {
+                heap[i] = heap[(i - 1) >> 1];
+                i = (i - 1) >> 1;
+            }
+            heap[i] = item;
+        };
+        const pop = () => {
+            const top = heap[0];
+            const last = heap.pop();
+            if (heap.length > 0) {
+                let i = 0;
+                while (2 * i + 1 < heap.length) {
+                    let child = 2 * i + 1;
+                    if (child + 1 < heap.length && before(heap[child + 1], heap[child])) child++;
+                    if (!before(heap[child], last)) break;
+                    heap[i] = heap[child];
+                    i = child;
+                }
+                heap[i] = last;
+            }
+            return top;
+        };
+
+        const results = [];
+        push({ score: node.maxScore, isWord: false, node, word: prefix });
+
+        while (heap.length > 0 && results.length < k) {
+            const best = pop();
+
+            if (best.isWord) {
+                results.push({
+                    word: best.word,
+                    bookmarkURL: best.node.bookmarkURL,
+                    score: best.score
+                });
+                continue;
+            }
+
+            if (best.node.isEndOfWord) {
+                push({ score: best.node.score, isWord: true, node: best.node, word: best.word });
+            }
+            for (let char in best.node.children) {
+                const child = best.node.children[char];
+                push({ score: child.maxScore, isWord: false, node: child, word: best.word + char });
+            }
+        }
+
+        return results;
+    }
+
     /**
      * DFS helper to collect all words from a node
      * Time Complexity: O(n) where n = number of words from node
@@ -117,7 +253,9 @@ class Trie {
                 return false; // Word not found
             }
             node.isEndOfWord = false;
+            node.score = 0;
             this.wordCount--;
+            this.refreshMax(node);
             return Object.keys(node.children).length === 0;
         }
 
@@ -134,10 +272,10 @@ class Trie {
 
         if (shouldDeleteChild) {
             delete node.children[char];
-            return Object.keys(node.children).length === 0 && !node.isEndOfWord;
         }
+        this.refreshMax(node);
 
-        return false;
+        return shouldDeleteChild && Object.keys(node.children).length === 0 && !node.isEndOfWord;
     }
 
     /**
@@ -4,8 +4,12 @@
  * Uses ES6 JavaScript with:
  * - Hash Table: Fast bookmark lookup by URL
  * - Trie: Autocomplete search by title
- * - Linked List: Recently visited bookmarks (LIFO)
- * - Min Heap: Track least frequently used bookmarks
+ * - Linked List: Recently visited bookmarks (LRU order)
+ * - Min Heap: Track least used bookmarks (lowest frecency)
+ * - Frecency: Visit scores that decay with age, ranking the heap and autocomplete
+ * - Roaring Bitmap: Bookmark ids per category for filtering
+ * - B+ Tree: Bookmarks kept in each sort order, read one page at a time
+ * - Tag Index: Sorted bookmark ids per tag for "A AND B NOT C" filters
  */
 
 // ============================================
@@ -15,12 +19,32 @@
 let bookmarkHashTable = new HashTable(100); // URL -> Bookmark data
 let titleTrie = new Trie(); // Title autocomplete
 let recentBookmarks = new LinkedList(20); // Recently visited (max 20)
-let leastUsedHeap = new MinHeap(); // Min heap by visit count
+let frecency = new Frecency(); // Decayed visit scores, relative to this session's epoch
+let leastUsedHeap = new MinHeap('frecency'); // Min heap by frecency
+
+let bookmarksById = []; // id -> bookmark (undefined once deleted)
+let freeBookmarkIds = []; // ids of deleted bookmarks, reused first
+let liveBookmarkIds = new RoaringBitmap(); // ids of every bookmark not deleted
+let categoryIndex = new Map(); // category -> RoaringBitmap of bookmark ids
+let tagIndex = new TagIndex(); // tag -> sorted bookmark ids, bookmark id -> tags
+
+// Sorted views, one per sort option; ties fall back to id so no two
+// bookmarks compare equal
+const titleCollator = new Intl.Collator();
+const sortedViews = {
+    recent: new BPlusTree((a, b) =>
+        (b.lastVisited || b.createdAt) - (a.lastVisited || a.createdAt) || a.id - b.id),
+    name: new BPlusTree((a, b) => titleCollator.compare(a.title, b.title) || a.id - b.id),
+    visits: new BPlusTree((a, b) => b.visitCount - a.visitCount || a.id - b.id)
+};
 
 let allCategories = new Set(['Uncategorized']); // All available categories
 let activeFilters = new Set(); // Currently active category filters
+let tagFilters = new Map(); // tag -> 'require' or 'exclude'
 let currentSort = 'recent'; // Current sort method
+let currentPage = 0; // Page of the bookmark list shown
 const MAX_BOOKMARKS = 100; // Maximum bookmarks allowed
+const PAGE_SIZE = 12; // Bookmark cards per page
 
 // ============================================
 // DOM ELEMENTS
@@ -28,11 +52,13 @@ const MAX_BOOKMARKS = 100; // Maximum bookmarks allowed
 
 const bookmarkForm = document.getElementById('bookmarkForm');
 const bookmarksList = document.getElementById('bookmarksList');
+const bookmarksPager = document.getElementById('bookmarksPager');
 const searchInput = document.getElementById('searchInput');
 const autocompleteDropdown = document.getElementById('autocompleteDropdown');
 const recentList = document.getElementById('recentList');
 const leastUsedList = document.getElementById('leastUsedList');
 const categoryFilters = document.getElementById('categoryFilters');
+const tagFiltersList = document.getElementById('tagFilters');
 const bookmarkCount = document.getElementById('bookmarkCount');
 const formMessage = document.getElementById('formMessage');
 const sortSelect = document.getElementById('sortSelect');
@@ -58,20 +84,25 @@ const statStorage = document.getElementById('statStorage');
 function initializeApp() {
     // Load sample bookmarks
     const sampleBookmarks = [
-        { title: 'GitHub', url: 'https://github.com', category: 'Development' },
-        { title: 'Stack Overflow', url: 'https://stackoverflow.com', category: 'Development' },
-        { title: 'MDN Web Docs', url: 'https://developer.mozilla.org', category: 'Learning' },
-        { title: 'YouTube', url: 'https://youtube.com', category: 'Entertainment' },
-        { title: 'Twitter', url: 'https://twitter.com', category: 'Social' },
-        { title: 'LinkedIn', url: 'https://linkedin.com', category: 'Professional' },
-        { title: 'Medium', url: 'https://medium.com', category: 'Learning' },
-        { title: 'Figma', url: 'https://figma.com', category: 'Design' },
+        { title: 'GitHub', url: 'https://github.com', category: 'Development', tags: ['work', 'code'] },
+        { title: 'Stack Overflow', url: 'https://stackoverflow.com', category: 'Development', tags: ['code', 'reference'] },
+        { title: 'MDN Web Docs', url: 'https://developer.mozilla.org', category: 'Learning', tags: ['code', 'reference'] },
+        { title: 'YouTube', url: 'https://youtube.com', category: 'Entertainment', tags: ['video'] },
+        { title: 'Twitter', url: 'https://twitter.com', category: 'Social', tags: [] },
+        { title: 'LinkedIn', url: 'https://linkedin.com', category: 'Professional', tags: ['work'] },
+        { title: 'Medium', url: 'https://medium.com', category: 'Learning', tags: ['reading'] },
+        { title: 'Figma', url: 'https://figma.com', category: 'Design', tags: ['work'] },
     ];
 
     sampleBookmarks.forEach(bookmark => {
-        addBookmarkInternal(bookmark.title, bookmark.url, bookmark.category, true);
+        addBookmarkInternal(bookmark.title, bookmark.url, bookmark.category, bookmark.tags, true);
     });
 
+    // Rank the loaded bookmarks in one O(n) heapify, and sort each view once
+    const loaded = sampleBookmarks.map(bookmark => bookmarkHashTable.get(bookmark.url)).filter(Boolean);
+    leastUsedHeap.build(loaded);
+    Object.values(sortedViews).forEach(view => view.build(loaded));
+
     // Simulate some visits to populate recent and least used lists
     for (let i = 0; i < Math.min(5, sampleBookmarks.length); i++) {
         const bm = sampleBookmarks[i];
@@ -109,9 +140,10 @@ function formatTime(timestamp) {
 
 /**
  * Add bookmark to all data structures
- * Time Complexity: O(m) where m = title length (dominant factor in trie insert)
+ * Time Complexity: O(m + log n) where m = title length (trie), n = bookmarks (views),
+ * plus O(log p) per tag for p = bookmarks with the tag
  */
-function addBookmarkInternal(title, url, category, isInitializing = false) {
+function addBookmarkInternal(title, url, category, tags = [], isInitializing = false) {
     // Validate inputs
     if (!title || !url || !category) {
         showMessage('All fields are required!', 'error');
@@ -130,12 +162,14 @@ function addBookmarkInternal(title, url, category, isInitializing = false) {
         return false;
     }
 
-    // Create bookmark object
+    // Create bookmark object; the small integer id is its key in category bitmaps
     const bookmark = {
+        id: freeBookmarkIds.length > 0 ? freeBookmarkIds.pop() : bookmarksById.length,
         title: title.trim(),
         url: url.trim(),
         category: category.trim(),
         visitCount: 0,
+        frecency: 0, // never visited
         createdAt: Date.now(),
         lastVisited: null
     };
@@ -144,17 +178,33 @@ function addBookmarkInternal(title, url, category, isInitializing = false) {
     bookmarkHashTable.put(url, bookmark);
 
     // Insert title into Trie (for autocomplete)
-    titleTrie.insert(title, url);
+    titleTrie.insert(bookmark.title, url, bookmark.frecency);
+
+    // Add to Min Heap (for least used tracking) and the sorted views;
+    // startup builds them in bulk
+    if (!isInitializing) {
+        leastUsedHeap.insert(bookmark);
+        Object.values(sortedViews).forEach(view => view.insert(bookmark));
+    }
 
-    // Add to Min Heap (for least used tracking)
-    leastUsedHeap.insert(bookmark);
+    // Add to its category bitmap
+    bookmarksById[bookmark.id] = bookmark;
+    liveBookmarkIds.add(bookmark.id);
+    if (!categoryIndex.has(bookmark.category)) {
+        categoryIndex.set(bookmark.category, new RoaringBitmap());
+    }
+    categoryIndex.get(bookmark.category).add(bookmark.id);
 
     // Add category to set
     allCategories.add(category);
 
+    // Tags: one posting array entry per tag, whatever the category
+    tags.forEach(tag => tagIndex.add(bookmark.id, tagIndex.intern(tag)));
+
     // Update UI elements
     updateCategorySelect();
     updateCategoryFilters();
+    updateTagFilters();
 
     if (!isInitializing) {
         showMessage('Bookmark added successfully!', 'success');
@@ -165,7 +215,8 @@ function addBookmarkInternal(title, url, category, isInitializing = false) {
 
 /**
  * Delete bookmark from all data structures
- * Time Complexity: O(m + n) where m = title length (trie), n = heap size
+ * Time Complexity: O(m + log n) where m = title length (trie), n = heap size
+ * (plus O(4096) at worst to shift a category bitmap container)
  */
 function deleteBookmark(url) {
     const bookmark = bookmarkHashTable.get(url);
@@ -183,28 +234,50 @@ function deleteBookmark(url) {
     // Remove from min heap
     leastUsedHeap.delete(url);
 
+    // Remove from the sorted views
+    Object.values(sortedViews).forEach(view => view.delete(bookmark));
+
+    // Remove from its category bitmap and its tags; the id is handed out again
+    categoryIndex.get(bookmark.category).remove(bookmark.id);
+    tagIndex.clear(bookmark.id);
+    bookmarksById[bookmark.id] = undefined;
+    liveBookmarkIds.remove(bookmark.id);
+    freeBookmarkIds.push(bookmark.id);
+
     showMessage('Bookmark deleted!', 'success');
     return true;
 }
 
 /**
  * Record visit to bookmark
- * Updates visit count and adds to recent list
- * Time Complexity: O(log h) where h = heap size (heapify operation)
+ * Updates visit count and frecency and adds to recent list
+ * Time Complexity: O(log n) (heap and the recent / visits views)
  */
 function recordBookmarkVisit(url) {
     const bookmark = bookmarkHashTable.get(url);
     if (!bookmark) return;
 
-    // Increment visit count
+    // Take it out of the views its new counts move it in, while the
+    // views can still find it by the old ones
+    sortedViews.recent.delete(bookmark);
+    sortedViews.visits.delete(bookmark);
+
+    // Increment visit count and fold the visit into the frecency score
     bookmark.visitCount++;
     bookmark.lastVisited = Date.now();
+    bookmark.frecency = frecency.add(bookmark.frecency, bookmark.lastVisited);
+
+    sortedViews.recent.insert(bookmark);
+    sortedViews.visits.insert(bookmark);
 
     // Update in hash table
     bookmarkHashTable.put(url, bookmark);
 
     // Update in min heap
-    leastUsedHeap.updateBookmark(url, bookmark.visitCount);
+    leastUsedHeap.updateBookmark(url, bookmark.frecency);
+
+    // Re-rank title in autocomplete
+    titleTrie.setScore(bookmark.title, bookmark.frecency);
 
     // Add to recent visited list (moves to front if exists)
     if (recentBookmarks.contains(url)) {
@@ -220,7 +293,8 @@ function recordBookmarkVisit(url) {
 
 /**
  * Search bookmarks by title prefix using Trie
- * Time Complexity: O(m + k) where m = query length, k = results count
+ * Shows the most visited matches first
+ * Time Complexity: O(m + k log k) where m = query length, k = results shown
  */
 function searchByPrefix(query) {
     if (query.length === 0) {
@@ -228,8 +302,8 @@ function searchByPrefix(query) {
         return;
     }
 
-    // Use Trie to find all titles starting with query
-    const results = titleTrie.searchByPrefix(query);
+    // Use Trie to find the top titles starting with query
+    const results = titleTrie.topK(query, 8);
 
     if (results.length === 0) {
         autocompleteDropdown.classList.remove('active');
@@ -238,7 +312,6 @@ function searchByPrefix(query) {
 
     // Display dropdown with results
     autocompleteDropdown.innerHTML = results
-        .slice(0, 8) // Limit to 8 results
         .map(result => {
             const bm = bookmarkHashTable.get(result.bookmarkURL);
             return `
@@ -276,37 +349,80 @@ function selectBookmark(url) {
 // ============================================
 
 /**
- * Get filtered and sorted bookmarks
- * Time Complexity: O(n log n) for sorting
+ * Bookmarks matching the active tag filters, as a bitmap
+ * With a required tag the tag index narrows its postings; with only
+ * excluded tags their bookmarks are cut out of the live-id bitmap.
+ * Time Complexity: O(r + merges) (see TagIndex.query), or O(e + c) when
+ * no tag is required (e = bookmarks with an excluded tag, c = containers)
  */
-function getFilteredAndSortedBookmarks() {
-    const allBookmarks = bookmarkHashTable.values();
+function getTagMatches() {
+    const required = [];
+    const excluded = [];
+    tagFilters.forEach((mode, tag) => (mode === 'require' ? required : excluded).push(tag));
+
+    if (required.length === 0) {
+        const excludedIds = new RoaringBitmap();
+        excluded.forEach(tag => tagIndex.query([tag]).forEach(id => excludedIds.add(id)));
+        return liveBookmarkIds.andNot(excludedIds);
+    }
 
-    // Apply category filters
-    let filtered = allBookmarks;
+    const matches = new RoaringBitmap();
+    tagIndex.query(required, excluded).forEach(id => matches.add(id));
+    return matches;
+}
+
+/**
+ * Get one page of the filtered bookmarks in the current sort order
+ * Returns { bookmarks, total } where total counts every match
+ * The view for the sort is already in order, so no filter means reading
+ * the page straight out of it. With filters (the union of the active
+ * categories' bitmaps, intersected with the tag query) a few matches are
+ * sorted by themselves, and many are found by walking the view and
+ * keeping members until the page fills.
+ * Time Complexity: O(log n + limit) unfiltered; filtered O(f * c + m log m)
+ * when sparse, O(f * c + position of the page's last match) otherwise,
+ * where f = active filters, c = bitmap containers, m = matching bookmarks
+ */
+function getFilteredAndSortedBookmarks(offset = 0, limit = Infinity) {
+    const view = sortedViews[currentSort];
+    if (activeFilters.size === 0 && tagFilters.size === 0) {
+        return { bookmarks: view.slice(offset, limit), total: view.getSize() };
+    }
+
+    let matches = null;
     if (activeFilters.size > 0) {
-        filtered = allBookmarks.filter(bm => activeFilters.has(bm.category));
+        const selected = Array.from(activeFilters)
+            .map(cat => categoryIndex.get(cat))
+            .filter(Boolean);
+        matches = RoaringBitmap.orMany(selected);
     }
+    if (tagFilters.size > 0) {
+        matches = matches ? matches.and(getTagMatches()) : getTagMatches();
+    }
+    const total = matches.getCardinality();
 
-    // Apply sorting
-    switch (currentSort) {
-        case 'recent':
-            filtered.sort((a, b) => (b.lastVisited || b.createdAt) - (a.lastVisited || a.createdAt));
-            break;
-        case 'name':
-            filtered.sort((a, b) => a.title.localeCompare(b.title));
-            break;
-        case 'visits':
-            filtered.sort((a, b) => b.visitCount - a.visitCount);
-            break;
+    if (total * 8 < view.getSize()) {
+        const sorted = matches.toArray().map(id => bookmarksById[id]).sort(view.compare);
+        return { bookmarks: sorted.slice(offset, offset + limit), total };
     }
 
-    return filtered;
+    const bookmarks = [];
+    let skip = offset;
+    view.forEach(bookmark => {
+        if (!matches.has(bookmark.id)) return true;
+        if (skip > 0) {
+            skip--;
+            return true;
+        }
+        bookmarks.push(bookmark);
+        return bookmarks.length < limit;
+    });
+    return { bookmarks, total };
 }
 
 /**
  * Toggle category filter
- * Time Complexity: O(n log n) (UI update triggers sort)
+ * Time Complexity: O(f * c + m log m) for the first page of matches
  */
 function toggleCategoryFilter(category) {
     if (activeFilters.has(category)) {
@@ -314,9 +430,37 @@ function toggleCategoryFilter(category) {
     } else {
         activeFilters.add(category);
     }
+    currentPage = 0;
     updateUI();
 }
 
+/**
+ * Cycle a tag filter: off -> required -> excluded -> off
+ * Time Complexity: O(r + merges) for the tag query
+ */
+function cycleTagFilter(tag) {
+    const mode = tagFilters.get(tag);
+    if (mode === undefined) {
+        tagFilters.set(tag, 'require');
+    } else if (mode === 'require') {
+        tagFilters.set(tag, 'exclude');
+    } else {
+        tagFilters.delete(tag);
+    }
+    currentPage = 0;
+    updateTagFilters();
+    updateUI();
+}
+
+/**
+ * Move the bookmark list to another page
+ * Time Complexity: O(log n + PAGE_SIZE) without filters
+ */
+function goToPage(page) {
+    currentPage = page;
+    renderBookmarks();
+}
+
 // ============================================
 // UI RENDERING
 // ============================================
@@ -344,8 +488,17 @@ function updateCategorySelect() {
 }
 
 /**
- * Update category filter buttons
- * Time Complexity: O(k) where k = number of categories
+ * Bookmarks in a category (bitmap cardinality)
+ * Time Complexity: O(1)
+ */
+function getCategoryCount(category) {
+    const ids = categoryIndex.get(category);
+    return ids ? ids.getCardinality() : 0;
+}
+
+/**
+ * Update category filter buttons with their bookmark counts
+ * Time Complexity: O(k log k) where k = number of categories
  */
 function updateCategoryFilters() {
     categoryFilters.innerHTML = Array.from(allCategories)
@@ -355,24 +508,62 @@ function updateCategoryFilters() {
                 class="filter-btn ${activeFilters.has(cat) ? 'active' : ''}"
                 onclick="toggleCategoryFilter('${cat}')"
             >
-                ${cat}
+                ${cat} (${getCategoryCount(cat)})
             </button>
         `)
         .join('');
 }
 
 /**
- * Render all bookmarks
- * Time Complexity: O(n) where n = number of bookmarks
+ * Update tag filter buttons with their bookmark counts (posting lengths)
+ * Tags left on no bookmark are hidden unless a filter still names them
+ * Time Complexity: O(t log t) where t = number of tags
+ */
+function updateTagFilters() {
+    const tags = tagIndex.getTags()
+        .filter(({ name, count }) => count > 0 || tagFilters.has(name))
+        .sort((a, b) => titleCollator.compare(a.name, b.name));
+    if (tags.length === 0) {
+        tagFiltersList.innerHTML = '<p class="section-desc">No tags yet</p>';
+        return;
+    }
+
+    tagFiltersList.innerHTML = tags
+        .map(({ tag, name, count }) => {
+            const mode = tagFilters.get(name);
+            return `
+                <button
+                    class="filter-btn tag-filter ${mode || ''}"
+                    title="Click to require, again to exclude, again to clear"
+                    onclick="cycleTagFilter(tagIndex.names[${tag}])"
+                >
+                    ${mode === 'exclude' ? 'NOT ' : ''}#${escapeHtml(name)} (${count})
+                </button>
+            `;
+        })
+        .join('');
+}
+
+/**
+ * Render the current page of bookmarks and the pager below it
+ * Time Complexity: O(log n + PAGE_SIZE) without filters
  */
 function renderBookmarks() {
-    const bookmarks = getFilteredAndSortedBookmarks();
+    let page = getFilteredAndSortedBookmarks(currentPage * PAGE_SIZE, PAGE_SIZE);
+    const pages = Math.max(1, Math.ceil(page.total / PAGE_SIZE));
+    if (currentPage >= pages) {
+        // Deletes or a new filter can leave us past the end
+        currentPage = pages - 1;
+        page = getFilteredAndSortedBookmarks(currentPage * PAGE_SIZE, PAGE_SIZE);
+    }
+    renderPager(pages);
 
+    const bookmarks = page.bookmarks;
     if (bookmarks.length === 0) {
         bookmarksList.innerHTML = `
             <div class="empty-state">
                 <div class="empty-state-icon">No bookmarks</div>
-                <p>No bookmarks found. ${activeFilters.size > 0 ? 'Try changing filters.' : 'Add one to get started!'}</p>
+                <p>No bookmarks found. ${activeFilters.size + tagFilters.size > 0 ? 'Try changing filters.' : 'Add one to get started!'}</p>
             </div>
         `;
         return;
@@ -384,6 +575,7 @@ function renderBookmarks() {
                 <div class="bookmark-title">${escapeHtml(bm.title)}</div>
                 <a href="${bm.url}" class="bookmark-url" target="_blank">${bm.url}</a>
                 <span class="bookmark-category">${bm.category}</span>
+                <div class="bookmark-tags">${tagIndex.tagsOf(bm.id).map(tag => `<span class="tag-chip">#${escapeHtml(tag)}</span>`).join('')}</div>
                 
                 <div class="bookmark-stats">
                     <div class="bookmark-stat">${bm.visitCount} visits</div>
@@ -403,6 +595,27 @@ function renderBookmarks() {
         .join('');
 }
 
+/**
+ * Render previous / next buttons when the list spans several pages
+ * Time Complexity: O(1)
+ */
+function renderPager(pages) {
+    if (pages <= 1) {
+        bookmarksPager.innerHTML = '';
+        return;
+    }
+
+    bookmarksPager.innerHTML = `
+        <button class="btn-secondary" onclick="goToPage(${currentPage - 1})" ${currentPage === 0 ? 'disabled' : ''}>
+            Previous
+        </button>
+        <span>Page ${currentPage + 1} of ${pages}</span>
+        <button class="btn-secondary" onclick="goToPage(${currentPage + 1})" ${currentPage === pages - 1 ? 'disabled' : ''}>
+            Next
+        </button>
+    `;
+}
+
 /**
  * Render recently visited bookmarks (from Linked List)
  * Time Complexity: O(m) where m = recent list size (max 20)
@@ -458,14 +671,14 @@ function renderLeastUsedBookmarks() {
                 <div class="recent-item-info">
                     <div class="recent-item-title">${escapeHtml(bm.title)}</div>
                     <div class="recent-item-meta">
-                        ${bm.category}
+                        ${bm.category} • ${bm.visitCount} visits
                     </div>
                 </div>
                 <div style="text-align: right;">
                     <div style="font-size: 1.5em; font-weight: 700; color: #16a085;">
-                        ${bm.visitCount}
+                        ${frecency.value(bm.frecency).toFixed(1)}
                     </div>
-                    <div style="font-size: 0.8em; color: #999;">visits</div>
+                    <div style="font-size: 0.8em; color: #999;">frecency</div>
                 </div>
             </div>
         `)
@@ -509,8 +722,9 @@ bookmarkForm.addEventListener('submit', (e) => {
     const title = document.getElementById('bookmarkTitle').value;
     const url = document.getElementById('bookmarkURL').value;
     const category = document.getElementById('bookmarkCategory').value;
+    const tags = document.getElementById('bookmarkTags').value.split(',');
 
-    if (addBookmarkInternal(title, url, category)) {
+    if (addBookmarkInternal(title, url, category, tags)) {
         bookmarkForm.reset();
         updateUI();
     }
@@ -565,6 +779,7 @@ clearSearchBtn.addEventListener('click', () => {
  */
 sortSelect.addEventListener('change', (e) => {
     currentSort = e.target.value;
+    currentPage = 0;
     updateUI();
 });
 
@@ -574,7 +789,7 @@ sortSelect.addEventListener('change', (e) => {
 
 /**
  * Visit bookmark and record visit
- * Time Complexity: O(log h) where h = heap size
+ * Time Complexity: O(log n)
  */
 function visitBookmark(url) {
     recordBookmarkVisit(url);
@@ -589,6 +804,7 @@ function visitBookmark(url) {
 function deleteAndRefresh(url) {
     if (confirm('Are you sure you want to delete this bookmark?')) {
         deleteBookmark(url);
+        updateTagFilters();
         updateUI();
     }
 }